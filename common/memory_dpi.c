@@ -18,6 +18,25 @@ extern int sv_memory_dpi_write(uint64_t virt_addr, uint8_t byte_mask,
                               uint64_t data, uint32_t* timestamp);
 extern int sv_memory_dpi_tlb_load(uint64_t virt_base, uint64_t phys_base,
                                  uint32_t* timestamp);
+extern int sv_memory_dpi_tlb_load_range(uint64_t virt_base, uint64_t phys_base,
+                                       int span_bits, uint32_t* timestamp);
+extern int sv_memory_dpi_tlb_flush(int all, uint64_t virt_addr, uint32_t* timestamp);
+extern int sv_memory_dpi_tlb_read_entry(int slot, int* valid, uint64_t* virt_base,
+                                       uint64_t* phys_base, int* span_bits, int* asid);
+extern int sv_memory_dpi_tlb_check_entry(int slot, int span_bits, int asid);
+extern int sv_memory_dpi_tlb_write_entry(int slot, int valid, uint64_t virt_base,
+                                        uint64_t phys_base, int span_bits, int asid);
+extern int sv_memory_dpi_tlb_set_write_index(int index);
+extern int sv_memory_dpi_set_asid(int asid, uint32_t* timestamp);
+extern int sv_memory_dpi_get_asid(void);
+
+// Wide data travels as a 512-bit bit vector: svBitVecVal chunks of 32 bits,
+// least significant first
+#define MEM_DPI_WIDE_CHUNKS (MEM_DPI_MAX_DATA_BYTES / 4)
+extern int sv_memory_dpi_read_wide(uint64_t virt_addr, uint64_t byte_mask,
+                                  uint32_t* data, uint32_t* timestamp);
+extern int sv_memory_dpi_write_wide(uint64_t virt_addr, uint64_t byte_mask,
+                                   const uint32_t* data, uint32_t* timestamp);
 
 extern int sv_memory_dpi_get_response(int ctx_id, int* status,
                                      uint64_t* data, uint32_t* timestamp);
@@ -147,6 +166,49 @@ int memory_dpi_write_async(uint64_t virt_addr, uint8_t byte_mask,
     return (status == MEM_DPI_OK) ? 0 : -1;
 }
 
+// Wide-word operations
+mem_dpi_status_e memory_dpi_read_wide(uint64_t virt_addr, uint64_t byte_mask,
+                                      uint8_t* data, uint32_t data_bytes,
+                                      uint32_t* timestamp) {
+    if (!check_initialized()) return MEM_DPI_ERR_ACCESS;
+    if (!data || !timestamp || data_bytes == 0 || data_bytes > MEM_DPI_MAX_DATA_BYTES) {
+        fprintf(stderr, "Error: bad buffer or width in memory_dpi_read_wide\n");
+        return MEM_DPI_ERR_ACCESS;
+    }
+    
+    if (trace_enabled) {
+        printf("DPI READ_WIDE: addr=0x%lx mask=0x%016lx bytes=%u\n", virt_addr, byte_mask, data_bytes);
+    }
+    
+    uint32_t chunks[MEM_DPI_WIDE_CHUNKS] = {0};
+    int sv_status = sv_memory_dpi_read_wide(virt_addr, byte_mask, chunks, timestamp);
+    for (uint32_t i = 0; i < data_bytes; i++) {
+        data[i] = (uint8_t)(chunks[i / 4] >> ((i % 4) * 8));
+    }
+    return (mem_dpi_status_e)sv_status;
+}
+
+mem_dpi_status_e memory_dpi_write_wide(uint64_t virt_addr, uint64_t byte_mask,
+                                       const uint8_t* data, uint32_t data_bytes,
+                                       uint32_t* timestamp) {
+    if (!check_initialized()) return MEM_DPI_ERR_ACCESS;
+    if (!data || !timestamp || data_bytes == 0 || data_bytes > MEM_DPI_MAX_DATA_BYTES) {
+        fprintf(stderr, "Error: bad buffer or width in memory_dpi_write_wide\n");
+        return MEM_DPI_ERR_ACCESS;
+    }
+    
+    if (trace_enabled) {
+        printf("DPI WRITE_WIDE: addr=0x%lx mask=0x%016lx bytes=%u\n", virt_addr, byte_mask, data_bytes);
+    }
+    
+    uint32_t chunks[MEM_DPI_WIDE_CHUNKS] = {0};
+    for (uint32_t i = 0; i < data_bytes; i++) {
+        chunks[i / 4] |= (uint32_t)data[i] << ((i % 4) * 8);
+    }
+    int sv_status = sv_memory_dpi_write_wide(virt_addr, byte_mask, chunks, timestamp);
+    return (mem_dpi_status_e)sv_status;
+}
+
 // TLB operations
 mem_dpi_status_e memory_dpi_tlb_load(uint64_t virt_base, uint64_t phys_base,
                                      uint32_t* timestamp) {
@@ -164,6 +226,138 @@ mem_dpi_status_e memory_dpi_tlb_load(uint64_t virt_base, uint64_t phys_base,
     return (mem_dpi_status_e)sv_status;
 }
 
+mem_dpi_status_e memory_dpi_tlb_load_range(uint64_t virt_base, uint64_t phys_base,
+                                           uint32_t span_bits, uint32_t* timestamp) {
+    if (!check_initialized()) return MEM_DPI_ERR_ACCESS;
+    if (!timestamp) {
+        fprintf(stderr, "Error: NULL timestamp pointer in memory_dpi_tlb_load_range\n");
+        return MEM_DPI_ERR_ACCESS;
+    }
+    
+    if (trace_enabled) {
+        printf("DPI TLB_LOAD_RANGE: virt=0x%lx phys=0x%lx span=%u\n", virt_base, phys_base, span_bits);
+    }
+    
+    int sv_status = sv_memory_dpi_tlb_load_range(virt_base, phys_base, (int)span_bits, timestamp);
+    return (mem_dpi_status_e)sv_status;
+}
+
+mem_dpi_status_e memory_dpi_tlb_flush(uint32_t* timestamp) {
+    if (!check_initialized()) return MEM_DPI_ERR_ACCESS;
+    if (!timestamp) {
+        fprintf(stderr, "Error: NULL timestamp pointer in memory_dpi_tlb_flush\n");
+        return MEM_DPI_ERR_ACCESS;
+    }
+    
+    if (trace_enabled) {
+        printf("DPI TLB_FLUSH: all\n");
+    }
+    
+    return (mem_dpi_status_e)sv_memory_dpi_tlb_flush(1, 0, timestamp);
+}
+
+mem_dpi_status_e memory_dpi_tlb_flush_page(uint64_t virt_addr, uint32_t* timestamp) {
+    if (!check_initialized()) return MEM_DPI_ERR_ACCESS;
+    if (!timestamp) {
+        fprintf(stderr, "Error: NULL timestamp pointer in memory_dpi_tlb_flush_page\n");
+        return MEM_DPI_ERR_ACCESS;
+    }
+    
+    if (trace_enabled) {
+        printf("DPI TLB_FLUSH: addr=0x%lx\n", virt_addr);
+    }
+    
+    return (mem_dpi_status_e)sv_memory_dpi_tlb_flush(0, virt_addr, timestamp);
+}
+
+mem_dpi_status_e memory_dpi_tlb_export(mem_dpi_tlb_entry_t* entries, uint32_t capacity,
+                                       uint32_t* count_out, uint32_t* write_index_out) {
+    if (!check_initialized()) return MEM_DPI_ERR_ACCESS;
+    if (!entries || !count_out) return MEM_DPI_ERR_ACCESS;
+    
+    // The bridge rejects slots past PT_ENTRIES, which ends the walk
+    uint32_t slot = 0;
+    for (; slot < capacity; slot++) {
+        int valid = 0;
+        int span_bits = 0;
+        int asid = 0;
+        uint64_t virt_base = 0;
+        uint64_t phys_base = 0;
+        if (sv_memory_dpi_tlb_read_entry((int)slot, &valid, &virt_base, &phys_base, &span_bits, &asid) != 0) {
+            break;
+        }
+        entries[slot].valid = valid;
+        entries[slot].span_bits = (uint32_t)span_bits;
+        entries[slot].asid = (uint32_t)asid;
+        entries[slot].virt_base = virt_base;
+        entries[slot].phys_base = phys_base;
+    }
+    *count_out = slot;
+    if (write_index_out) {
+        *write_index_out = sv_memory_dpi_get_tlb_entries();
+    }
+    
+    if (trace_enabled) {
+        printf("DPI TLB_EXPORT: %u slots\n", slot);
+    }
+    return MEM_DPI_OK;
+}
+
+mem_dpi_status_e memory_dpi_tlb_import(const mem_dpi_tlb_entry_t* entries, uint32_t count,
+                                       uint32_t write_index) {
+    if (!check_initialized()) return MEM_DPI_ERR_ACCESS;
+    if (!entries && count > 0) return MEM_DPI_ERR_ACCESS;
+    
+    // Check every entry and the write index before touching the TLB
+    if (write_index >= count && sv_memory_dpi_tlb_check_entry((int)write_index, -1, 0) != 0) {
+        return MEM_DPI_ERR_ACCESS;
+    }
+    for (uint32_t slot = 0; slot < count; slot++) {
+        int span_bits = entries[slot].valid ? (int)entries[slot].span_bits : -1;
+        if (entries[slot].asid > INT32_MAX ||
+            sv_memory_dpi_tlb_check_entry((int)slot, span_bits, (int)entries[slot].asid) != 0) {
+            return MEM_DPI_ERR_ACCESS;
+        }
+    }
+    
+    for (uint32_t slot = 0; slot < count; slot++) {
+        const mem_dpi_tlb_entry_t* entry = &entries[slot];
+        if (sv_memory_dpi_tlb_write_entry((int)slot, entry->valid, entry->virt_base,
+                                          entry->phys_base, (int)entry->span_bits, (int)entry->asid) != 0) {
+            return MEM_DPI_ERR_ACCESS;
+        }
+    }
+    // Clear the remaining slots; the bridge rejects the first one past PT_ENTRIES
+    for (int slot = (int)count; sv_memory_dpi_tlb_write_entry(slot, 0, 0, 0, 0, 0) == 0; slot++) {
+    }
+    sv_memory_dpi_tlb_set_write_index((int)write_index);
+    
+    if (trace_enabled) {
+        printf("DPI TLB_IMPORT: %u slots, write index %u\n", count, write_index);
+    }
+    return MEM_DPI_OK;
+}
+
+mem_dpi_status_e memory_dpi_set_asid(uint32_t asid, uint32_t* timestamp) {
+    if (!check_initialized()) return MEM_DPI_ERR_ACCESS;
+    if (!timestamp) {
+        fprintf(stderr, "Error: NULL timestamp pointer in memory_dpi_set_asid\n");
+        return MEM_DPI_ERR_ACCESS;
+    }
+    if (asid > INT32_MAX) return MEM_DPI_ERR_ACCESS;
+    
+    if (trace_enabled) {
+        printf("DPI SET_ASID: asid=%u\n", asid);
+    }
+    
+    return (mem_dpi_status_e)sv_memory_dpi_set_asid((int)asid, timestamp);
+}
+
+uint32_t memory_dpi_get_asid(void) {
+    if (!check_initialized()) return 0;
+    return (uint32_t)sv_memory_dpi_get_asid();
+}
+
 int memory_dpi_tlb_load_async(uint64_t virt_base, uint64_t phys_base,
                              mem_dpi_context_t* ctx) {
     if (!check_initialized()) return -1;
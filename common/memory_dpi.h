@@ -19,6 +19,9 @@ typedef enum {
     MEM_DPI_PENDING   = 0xF
 } mem_dpi_status_e;
 
+// Widest data word carried by the wide-word calls (matches the C model)
+#define MEM_DPI_MAX_DATA_BYTES 64
+
 // Transaction context for tracking pending operations
 typedef struct {
     uint64_t virt_addr;
@@ -27,6 +30,18 @@ typedef struct {
     uint32_t timestamp;
 } mem_dpi_context_t;
 
+// Largest PT_ENTRIES the RTL supports; sizes TLB export buffers
+#define MEM_DPI_MAX_TLB_ENTRIES 256
+
+// One TLB slot for bulk import/export (tlb_entry_t in memory_pkg.sv plus span and ASID)
+typedef struct {
+    int      valid;
+    uint32_t span_bits;  // log2 of the mapped span in address units
+    uint32_t asid;       // address space the entry belongs to
+    uint64_t virt_base;
+    uint64_t phys_base;
+} mem_dpi_tlb_entry_t;
+
 // DPI initialization and control
 extern int memory_dpi_init(const char* rtl_module_path);
 extern void memory_dpi_reset(void);
@@ -44,9 +59,36 @@ extern mem_dpi_status_e memory_dpi_write(uint64_t virt_addr, uint8_t byte_mask,
 extern int memory_dpi_write_async(uint64_t virt_addr, uint8_t byte_mask,
                                  uint64_t data, mem_dpi_context_t* ctx);
 
+// Wide-word operations (DATA_WIDTH up to 512). data holds data_bytes bytes,
+// least significant first; bit i of byte_mask enables byte i.
+extern mem_dpi_status_e memory_dpi_read_wide(uint64_t virt_addr, uint64_t byte_mask,
+                                            uint8_t* data, uint32_t data_bytes,
+                                            uint32_t* timestamp);
+extern mem_dpi_status_e memory_dpi_write_wide(uint64_t virt_addr, uint64_t byte_mask,
+                                             const uint8_t* data, uint32_t data_bytes,
+                                             uint32_t* timestamp);
+
 // TLB operations
 extern mem_dpi_status_e memory_dpi_tlb_load(uint64_t virt_base, uint64_t phys_base,
                                            uint32_t* timestamp);
+// One entry covering 2^span_bits addresses (see memory_model_load_tlb_range());
+// returns MEM_DPI_ERR_ACCESS if the RTL's TLB_SPAN_WIDTH cannot hold the span.
+extern mem_dpi_status_e memory_dpi_tlb_load_range(uint64_t virt_base, uint64_t phys_base,
+                                                 uint32_t span_bits, uint32_t* timestamp);
+// MEM_FLUSH of the whole TLB, or of the current ASID's entries that translate virt_addr
+extern mem_dpi_status_e memory_dpi_tlb_flush(uint32_t* timestamp);
+extern mem_dpi_status_e memory_dpi_tlb_flush_page(uint64_t virt_addr, uint32_t* timestamp);
+// Whole-table copies in slot order, taking no simulation time. Export fills
+// up to capacity slots and reports how many the RTL has in count_out; import
+// writes count slots, clears the rest and sets the round-robin write index.
+extern mem_dpi_status_e memory_dpi_tlb_export(mem_dpi_tlb_entry_t* entries, uint32_t capacity,
+                                             uint32_t* count_out, uint32_t* write_index_out);
+extern mem_dpi_status_e memory_dpi_tlb_import(const mem_dpi_tlb_entry_t* entries, uint32_t count,
+                                             uint32_t write_index);
+// MEM_SET_ASID: switch address space without flushing; returns
+// MEM_DPI_ERR_ACCESS if asid does not fit the RTL's ASID_WIDTH
+extern mem_dpi_status_e memory_dpi_set_asid(uint32_t asid, uint32_t* timestamp);
+extern uint32_t memory_dpi_get_asid(void);
 extern int memory_dpi_tlb_load_async(uint64_t virt_base, uint64_t phys_base,
                                     mem_dpi_context_t* ctx);
 
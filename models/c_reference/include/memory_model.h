@@ -9,6 +9,74 @@
 extern "C" {
 #endif
 
+/** @brief Widest supported data word, in bits and in bytes. */
+#define MEMORY_MODEL_MAX_DATA_WIDTH 512U
+#define MEMORY_MODEL_MAX_WORD_BYTES (MEMORY_MODEL_MAX_DATA_WIDTH / 8U)
+#define MEMORY_MODEL_MAX_ASID 0xFFFFU
+#define MEMORY_MODEL_MAX_PT_LEVELS 5U
+
+/** @brief Page-table entry flag bits; see memory_model_page_table_t. */
+#define MEMORY_MODEL_PTE_VALID 0x1U
+#define MEMORY_MODEL_PTE_LEAF 0x2U
+
+/**
+ * @brief Instruction-set ceiling for the masked wide-word kernels.
+ *
+ * AUTO selects the best kernel the CPU supports. Any other value caps the
+ * selection at that level; a level the CPU lacks falls back to the next one
+ * it has.
+ */
+typedef enum {
+    MEMORY_MODEL_SIMD_AUTO = 0,
+    MEMORY_MODEL_SIMD_SCALAR = 1,
+    MEMORY_MODEL_SIMD_SSE41 = 2,
+    MEMORY_MODEL_SIMD_AVX2 = 3,
+    MEMORY_MODEL_SIMD_AVX512 = 4
+} memory_model_simd_t;
+
+/**
+ * @brief Victim selection for TLB fills made by the page-table walker.
+ *
+ * ROUND_ROBIN shares the write pointer of memory_model_load_tlb(), as the RTL
+ * does. The other policies fill an empty slot first and otherwise evict the
+ * least recently used entry (LRU), the slot a tree of direction bits points
+ * at (PLRU), a pseudo-random slot (RANDOM) or the oldest fill (FIFO). Explicit
+ * loads always take the round-robin slot, whatever the policy.
+ */
+typedef enum {
+    MEMORY_MODEL_TLB_POLICY_ROUND_ROBIN = 0,
+    MEMORY_MODEL_TLB_POLICY_LRU = 1,
+    MEMORY_MODEL_TLB_POLICY_PLRU = 2,
+    MEMORY_MODEL_TLB_POLICY_RANDOM = 3,
+    MEMORY_MODEL_TLB_POLICY_FIFO = 4
+} memory_model_tlb_policy_t;
+
+/**
+ * @brief Write handling of the optional data cache.
+ *
+ * WRITE_BACK allocates a line on a write miss and marks written lines dirty;
+ * a dirty line costs a writeback when it is evicted or flushed. WRITE_THROUGH
+ * sends every write to memory and does not allocate on a write miss.
+ */
+typedef enum {
+    MEMORY_MODEL_CACHE_WRITE_BACK = 0,
+    MEMORY_MODEL_CACHE_WRITE_THROUGH = 1
+} memory_model_cache_write_t;
+
+/**
+ * @brief Outcome of one access in the data cache.
+ *
+ * NONE means the access never reached memory (a fault or an empty write
+ * mask) or the model has no cache. MISS_WRITEBACK is a miss whose fill
+ * evicted a dirty line.
+ */
+typedef enum {
+    MEMORY_MODEL_CACHE_NONE = 0,
+    MEMORY_MODEL_CACHE_HIT = 1,
+    MEMORY_MODEL_CACHE_MISS = 2,
+    MEMORY_MODEL_CACHE_MISS_WRITEBACK = 3
+} memory_model_cache_result_t;
+
 /**
  * @brief Configuration parameters for the C reference memory model.
  */
@@ -16,9 +84,19 @@ typedef struct {
     uint32_t virt_addr_width; /**< Width of the virtual address space in bits */
     uint32_t phys_addr_width; /**< Width of the physical address space in bits */
     uint32_t page_size;       /**< Size of a page in bytes (must be a power of two) */
-    uint32_t data_width;      /**< Data width in bits (must be a multiple of 8, up to 64) */
-    uint32_t mem_depth;       /**< Number of addressable entries in the backing store */
+    uint32_t data_width;      /**< Data width in bits (a multiple of 8, up to MEMORY_MODEL_MAX_DATA_WIDTH) */
+    uint64_t mem_depth;       /**< Number of addressable entries in the backing store */
     uint32_t tlb_entries;     /**< Number of translation entries tracked in the TLB */
+    uint32_t tlb_ways;        /**< Ways per set; 0 keeps the TLB fully associative */
+    bool sparse;              /**< Allocate backing pages on first write instead of up front */
+    bool concurrent;          /**< Allow transactions and TLB loads from multiple threads */
+    memory_model_simd_t simd; /**< Kernel ceiling for wide masked accesses */
+    memory_model_tlb_policy_t tlb_policy; /**< Victim selection for page-table walker fills */
+    uint64_t cache_size;      /**< Data cache capacity in bytes; 0 models no cache */
+    uint32_t cache_line_size; /**< Cache line size in bytes */
+    uint32_t cache_ways;      /**< Lines per cache set; 0 makes the cache fully associative */
+    memory_model_cache_write_t cache_write_policy; /**< Write-back or write-through */
+    memory_model_tlb_policy_t cache_policy;        /**< Line replacement within a set */
 } memory_model_config_t;
 
 /**
@@ -42,11 +120,138 @@ typedef enum {
     MEMORY_MODEL_ERROR_UNSUPPORTED = -3
 } memory_model_error_t;
 
+/**
+ * @brief Transaction opcodes; values mirror mem_command_e in memory_pkg.sv.
+ */
+typedef enum {
+    MEMORY_MODEL_OP_READ = 0x0,
+    MEMORY_MODEL_OP_WRITE = 0x1,
+    MEMORY_MODEL_OP_FLUSH = 0x2,
+    MEMORY_MODEL_OP_TLB_LOAD = 0x3,
+    MEMORY_MODEL_OP_SET_ASID = 0x4
+} memory_model_op_t;
+
+/**
+ * @brief Single transaction descriptor for memory_model_execute().
+ *
+ * For MEMORY_MODEL_OP_TLB_LOAD, @c virt_addr carries the virtual base and
+ * @c data the physical base of the mapping; @c byte_mask is ignored.
+ * MEMORY_MODEL_OP_FLUSH flushes the whole TLB when @c byte_mask is zero and
+ * only the entries covering @c virt_addr otherwise.
+ * MEMORY_MODEL_OP_SET_ASID switches to the address space in @c data.
+ */
+typedef struct {
+    memory_model_op_t op;
+    uint64_t virt_addr;
+    uint32_t byte_mask;
+    uint64_t data;
+} memory_model_transaction_t;
+
+/**
+ * @brief Outcome of a single transaction. @c data holds read data, zero otherwise.
+ */
+typedef struct {
+    memory_model_status_t status;
+    uint64_t data;
+} memory_model_result_t;
+
+/**
+ * @brief Struct-of-arrays batch of transactions for memory_model_execute_batch().
+ *
+ * Every column holds @c count elements and uses the same per-operation meaning
+ * as memory_model_transaction_t. @c byte_mask and @c data may be NULL, in which
+ * case every operation sees zero for that field.
+ */
+typedef struct {
+    size_t count;
+    const uint8_t *op;          /**< memory_model_op_t values */
+    const uint64_t *virt_addr;
+    const uint32_t *byte_mask;
+    const uint64_t *data;
+} memory_model_batch_t;
+
+/**
+ * @brief Caller-owned result columns for memory_model_execute_batch().
+ */
+typedef struct {
+    memory_model_status_t *status;
+    uint64_t *data;
+} memory_model_batch_results_t;
+
+/**
+ * @brief Aggregate activity counters returned by memory_model_get_stats().
+ *
+ * Reads and writes count every issued transaction, including failed ones.
+ * Hits and misses count translations from reads, writes and direct
+ * memory_model_translate() calls.
+ */
+typedef struct {
+    uint64_t read_count;
+    uint64_t write_count;
+    uint64_t tlb_load_count;
+    uint64_t tlb_hits;
+    uint64_t tlb_misses;
+    uint64_t tlb_evictions;  /**< Loads and walker fills that replaced a live entry */
+    uint64_t walk_count;     /**< Page-table walks, including faulting ones */
+    uint64_t walk_pte_reads; /**< PTEs read by those walks; the sum of their depths */
+    uint64_t walk_faults;    /**< Walks that ended in a page fault */
+    uint64_t cache_read_hits;
+    uint64_t cache_read_misses;
+    uint64_t cache_write_hits;
+    uint64_t cache_write_misses;
+    uint64_t cache_writebacks; /**< Dirty lines written back by evictions and flushes */
+} memory_model_stats_t;
+
+/**
+ * @brief Translation misses recorded against one virtual page number.
+ */
+typedef struct {
+    uint64_t virt_page;
+    uint64_t misses;
+} memory_model_miss_entry_t;
+
+/**
+ * @brief One TLB slot for memory_model_export_tlb() and memory_model_import_tlb().
+ *
+ * Mirrors tlb_entry_t in memory_pkg.sv, plus the span of range entries and the ASID.
+ */
+typedef struct {
+    bool valid;
+    uint32_t span_bits; /**< log2 of the mapped span; 0 on import means one page */
+    uint32_t asid;      /**< address space the entry belongs to */
+    uint64_t virt_base;
+    uint64_t phys_base;
+} memory_model_tlb_entry_t;
+
+/**
+ * @brief Radix page-table layout for memory_model_set_page_table().
+ *
+ * Tables live in the model's own backing store. A table is 2^@c index_bits
+ * consecutive words starting at a page-aligned physical word address, one
+ * page-table entry (PTE) per word, read as memory_model_read() would return
+ * it. MEMORY_MODEL_PTE_VALID marks a valid PTE and MEMORY_MODEL_PTE_LEAF a
+ * leaf; the PTE with its low log2(page_size) bits cleared is the physical
+ * address of the next-level table or, for a leaf, of the mapped frame.
+ *
+ * Level 0 is indexed by the top @c index_bits of the virtual page number,
+ * and each later level by the next @c index_bits below them.
+ */
+typedef struct {
+    uint64_t root;       /**< Physical word address of the level-0 table */
+    uint32_t levels;     /**< Number of table levels; 0 detaches the walker */
+    uint32_t index_bits; /**< Virtual page number bits resolved per level */
+} memory_model_page_table_t;
+
 /**
  * @brief Opaque handle to an instantiated memory model.
  */
 typedef struct memory_model memory_model_t;
 
+/**
+ * @brief Opaque handle to a saved model state.
+ */
+typedef struct memory_model_snapshot memory_model_snapshot_t;
+
 /**
  * @brief Convenience helper that returns the default configuration used by the RTL.
  */
@@ -55,10 +260,31 @@ memory_model_config_t memory_model_config_default(void);
 /**
  * @brief Construct a memory model instance using the provided configuration.
  *
+ * With config->concurrent set, translate, read, write, execute, execute_batch,
+ * the TLB load, flush, import, export, ASID and page-table calls and the query functions may be
+ * called from any number of threads at once, and each transaction or TLB
+ * update is linearizable. Reset, fork,
+ * snapshot, restore and destroy still require exclusive access.
+ *
+ * With config->tlb_ways set, slot s belongs to set s / tlb_ways, and an entry
+ * of span S may only occupy the set chosen by the low bits of its virtual
+ * address above bit S. Loads and walker fills replace a way of that set.
+ *
+ * With config->cache_size set, every word access that reaches the backing
+ * store also looks up a data cache of that many bytes; see
+ * memory_model_read_cached(). The cache tracks tags only, so data and
+ * statuses are the same with or without it.
+ *
  * @param config   Pointer to configuration parameters. If NULL, defaults are used.
  * @param model_out Pointer that receives the allocated model on success.
  *
- * @return MEMORY_MODEL_ERROR_OK on success or an error code otherwise.
+ * @return MEMORY_MODEL_ERROR_OK on success or an error code otherwise. A
+ *         @c tlb_ways that does not divide @c tlb_entries into a power-of-two
+ *         number of sets is a bad argument, as is a tree PLRU policy with a
+ *         @c tlb_ways that is not a power of two. The same rules apply to
+ *         @c cache_ways and the cache's lines, and @c cache_line_size must be
+ *         a power-of-two number of words dividing @c cache_size. A cache in a
+ *         concurrent model is unsupported.
  */
 memory_model_error_t memory_model_create(const memory_model_config_t *config,
                                           memory_model_t **model_out);
@@ -70,28 +296,216 @@ void memory_model_destroy(memory_model_t *model);
 
 /**
  * @brief Reset memory contents and translation state to power-on defaults.
+ *
+ * Independent of mem_depth: pages and TLB entries are invalidated by
+ * generation and zeroed lazily when next touched, and allocated pages are
+ * kept for reuse. TLB replacement state is cleared in O(tlb_entries) and the
+ * data cache, if configured, in O(cache lines).
  */
 memory_model_error_t memory_model_reset(memory_model_t *model);
 
+/**
+ * @brief Create an independent copy of @p model that shares memory copy-on-write.
+ *
+ * The fork receives its own TLB and page directory; backing-store pages are
+ * shared with the parent until either side writes to them. Parent and fork may
+ * be destroyed in any order.
+ */
+memory_model_error_t memory_model_fork(const memory_model_t *model, memory_model_t **fork_out);
+
+/**
+ * @brief Capture the current TLB and memory state of @p model.
+ *
+ * Like memory_model_fork(), the snapshot shares pages copy-on-write, so taking
+ * one costs a TLB copy plus page-table references.
+ */
+memory_model_error_t memory_model_snapshot(const memory_model_t *model,
+                                           memory_model_snapshot_t **snapshot_out);
+
+/**
+ * @brief Return @p model to the state captured in @p snapshot.
+ *
+ * The snapshot stays valid and can be restored any number of times, into the
+ * model it came from or any other model with an identical configuration.
+ *
+ * @return MEMORY_MODEL_ERROR_BAD_ARGUMENT if the configurations differ.
+ */
+memory_model_error_t memory_model_restore(memory_model_t *model, const memory_model_snapshot_t *snapshot);
+
+/**
+ * @brief Release a snapshot and its references to shared pages.
+ */
+void memory_model_snapshot_destroy(memory_model_snapshot_t *snapshot);
+
 /**
  * @brief Load a virtual-to-physical mapping into the model's TLB.
  *
  * The implementation follows the RTL behaviour: entries are written using a
  * round-robin pointer that wraps after the configured capacity is reached.
+ * The entry is tagged with the current ASID and only translates while that
+ * ASID is current.
  */
 memory_model_error_t memory_model_load_tlb(memory_model_t *model,
                                            uint64_t virt_base,
                                            uint64_t phys_base);
 
 /**
- * @brief Perform a pure translation without touching memory storage.
+ * @brief Load a mapping that covers 2^@p span_bits addresses with one entry.
+ *
+ * Behaves like memory_model_load_tlb() but the entry translates every address
+ * whose upper bits match @p virt_base above bit @p span_bits; the low
+ * @p span_bits bits pass through unchanged. Spans are in address units
+ * (words), so a 2 MB huge page of 8-byte words is span_bits = 18.
+ * memory_model_load_tlb() is equivalent to passing log2(page_size).
+ *
+ * When several live entries match, the one with the smallest span wins, and
+ * the lowest slot among those; a plain page can therefore carve an exception
+ * out of a larger range. This matches the RTL with TLB_SPAN_WIDTH > 0.
+ *
+ * @return MEMORY_MODEL_ERROR_BAD_ARGUMENT unless log2(page_size) <=
+ *         @p span_bits <= min(virt_addr_width, phys_addr_width, 63).
+ */
+memory_model_error_t memory_model_load_tlb_range(memory_model_t *model,
+                                                 uint64_t virt_base,
+                                                 uint64_t phys_base,
+                                                 uint32_t span_bits);
+
+/**
+ * @brief Make @p asid the current address space.
+ *
+ * Lookups only match entries tagged with the current ASID and new loads are
+ * tagged with it, so entries of other address spaces stay resident and
+ * become usable again when their ASID returns. A switch is O(1) and flushes
+ * nothing. The ASID is 0 after creation and after memory_model_reset().
+ *
+ * @return MEMORY_MODEL_ERROR_BAD_ARGUMENT if @p asid > MEMORY_MODEL_MAX_ASID.
+ */
+memory_model_error_t memory_model_set_asid(memory_model_t *model, uint32_t asid);
+
+/**
+ * @brief The current ASID, or 0 for a NULL model.
+ */
+uint32_t memory_model_current_asid(const memory_model_t *model);
+
+/**
+ * @brief Attach a page-table walker that refills the TLB on a miss.
+ *
+ * While a walker is attached, a translation that misses walks @p table and
+ * loads the leaf into the slot chosen by config->tlb_policy, tagged with the
+ * current ASID, then completes; a read or write to an unmapped page therefore needs
+ * no separate TLB load and retry. A leaf found above the last level maps
+ * log2(page_size) + index_bits * (levels below it) bits, as
+ * memory_model_load_tlb_range() would. An invalid PTE, a non-leaf PTE at the
+ * last level, a PTE outside the backing store or an unsupported leaf span is
+ * a page fault, and the access fails with MEMORY_MODEL_STATUS_ERR_ADDR as an
+ * unwalked miss does.
+ *
+ * Editing the tables or moving the root does not flush the TLB. Pass NULL or
+ * @c levels = 0 to detach. No walker is attached after creation or after
+ * memory_model_reset(). Note that with a walker attached,
+ * memory_model_translate() and the read calls can update the TLB.
+ *
+ * @return MEMORY_MODEL_ERROR_BAD_ARGUMENT unless levels <=
+ *         MEMORY_MODEL_MAX_PT_LEVELS, 1 <= index_bits <= log2(page_size),
+ *         page_size >= 4 and log2(page_size) + levels * index_bits >=
+ *         virt_addr_width.
+ */
+memory_model_error_t memory_model_set_page_table(memory_model_t *model, const memory_model_page_table_t *table);
+
+/**
+ * @brief Walk the page tables for @p virt_addr and load the result into the TLB.
+ *
+ * Walks whether or not the TLB already translates the address, like a
+ * hardware prefetch. @p depth_out, if not NULL, receives the number of PTEs
+ * the walk read, from 1 for a leaf in the root table up to the level count,
+ * including for a faulting walk.
+ *
+ * @return MEMORY_MODEL_STATUS_ERR_ADDR on a page fault or with no walker
+ *         attached; @p phys_addr_out is then 0.
+ */
+memory_model_status_t memory_model_walk(memory_model_t *model,
+                                        uint64_t virt_addr,
+                                        uint64_t *phys_addr_out,
+                                        uint32_t *depth_out);
+
+/**
+ * @brief Invalidate every TLB entry, in every address space, without touching memory.
+ *
+ * O(1): stale entries are discarded by generation, as in memory_model_reset().
+ * The round-robin write index returns to zero; the current ASID is kept.
+ */
+memory_model_error_t memory_model_flush_tlb(memory_model_t *model);
+
+/**
+ * @brief Invalidate every TLB entry that translates @p virt_addr.
+ *
+ * Plain pages and range entries of the current ASID covering the address are
+ * all dropped, so the address misses afterwards. Other entries, including
+ * those of other address spaces, and the write index are unchanged.
+ */
+memory_model_error_t memory_model_flush_tlb_page(memory_model_t *model, uint64_t virt_addr);
+
+/**
+ * @brief Copy the whole TLB out in slot order.
+ *
+ * Fills memory_model_tlb_capacity() entries of @p entries_out; empty slots
+ * have @c valid cleared. @p write_index_out, if not NULL, receives the
+ * round-robin write index so that an import can resume exactly.
+ *
+ * @return MEMORY_MODEL_ERROR_BAD_ARGUMENT if @p capacity is too small.
+ */
+memory_model_error_t memory_model_export_tlb(const memory_model_t *model,
+                                             memory_model_tlb_entry_t *entries_out,
+                                             uint32_t capacity,
+                                             uint32_t *write_index_out);
+
+/**
+ * @brief Replace the whole TLB in one call.
+ *
+ * Slot i receives @p entries[i] for i < @p count; later slots are left
+ * empty. The round-robin write index is set to @p write_index. Imports do not
+ * count as TLB loads in the statistics. In a set-associative TLB every valid
+ * entry must sit in its own set, and only the set holding @p write_index
+ * resumes from it; every other set restarts at way 0.
+ *
+ * @return MEMORY_MODEL_ERROR_BAD_ARGUMENT, leaving the TLB unchanged, if
+ *         @p count exceeds the capacity, @p write_index is out of range or a
+ *         valid entry has an unsupported span or ASID or sits in the wrong set.
+ */
+memory_model_error_t memory_model_import_tlb(memory_model_t *model,
+                                             const memory_model_tlb_entry_t *entries,
+                                             uint32_t count,
+                                             uint32_t write_index);
+
+/**
+ * @brief Translate without touching memory contents.
+ *
+ * A miss walks the page tables when a walker is attached; see
+ * memory_model_set_page_table().
  */
 memory_model_status_t memory_model_translate(const memory_model_t *model,
                                               uint64_t virt_addr,
                                               uint64_t *phys_addr_out);
 
+/**
+ * @brief Translate through the TLB alone, without side effects.
+ *
+ * Unlike memory_model_translate() this never walks, counts or updates
+ * replacement state, so observers such as timing models can ask where an
+ * access landed without perturbing the model. A miss returns
+ * MEMORY_MODEL_STATUS_ERR_ADDR even while a walker is attached.
+ */
+memory_model_status_t memory_model_lookup(const memory_model_t *model,
+                                          uint64_t virt_addr,
+                                          uint64_t *phys_addr_out);
+
 /**
  * @brief Issue a masked read transaction using a virtual address.
+ *
+ * On models wider than 64 bits the 64-bit calls (read, write, execute and the
+ * batch executors) access the low eight bytes of each word, and @p byte_mask
+ * may only select those bytes. Use memory_model_read_wide() and
+ * memory_model_write_wide() for whole wide words.
  */
 memory_model_status_t memory_model_read(const memory_model_t *model,
                                          uint64_t virt_addr,
@@ -106,6 +520,182 @@ memory_model_status_t memory_model_write(memory_model_t *model,
                                           uint32_t byte_mask,
                                           uint64_t data);
 
+/**
+ * @brief memory_model_read() that also reports what the access did in the data cache.
+ *
+ * The cache is indexed by physical word address: a line holds
+ * cache_line_size / (data_width / 8) consecutive words, and its set is the
+ * line number modulo the number of sets. A miss fills a line chosen by
+ * config->cache_policy within the set, an empty line first. The read,
+ * write, wide, block and batch calls update the cache the same way; a block
+ * counts one access per word. Page-table walks bypass the cache.
+ *
+ * @param cache_out Receives the cache outcome; may be NULL.
+ */
+memory_model_status_t memory_model_read_cached(const memory_model_t *model,
+                                                uint64_t virt_addr,
+                                                uint32_t byte_mask,
+                                                uint64_t *data_out,
+                                                memory_model_cache_result_t *cache_out);
+
+/**
+ * @brief memory_model_write() that also reports what the access did in the data cache.
+ *
+ * @param cache_out Receives the cache outcome; may be NULL.
+ */
+memory_model_status_t memory_model_write_cached(memory_model_t *model,
+                                                 uint64_t virt_addr,
+                                                 uint32_t byte_mask,
+                                                 uint64_t data,
+                                                 memory_model_cache_result_t *cache_out);
+
+/**
+ * @brief Write back every dirty cache line and empty the cache.
+ *
+ * Each dirty line counts as one writeback in the statistics. A no-op for a
+ * model without a cache. memory_model_reset() empties the cache without
+ * writebacks.
+ */
+memory_model_error_t memory_model_flush_cache(memory_model_t *model);
+
+/**
+ * @brief Masked read of one whole word of any supported width.
+ *
+ * @p data_out receives data_width / 8 bytes in little-endian byte order; bytes
+ * not selected by @p byte_mask read as zero. Bit i of @p byte_mask selects
+ * byte i, and a zero mask selects the whole word. Status codes match
+ * memory_model_read().
+ */
+memory_model_status_t memory_model_read_wide(const memory_model_t *model,
+                                              uint64_t virt_addr,
+                                              uint64_t byte_mask,
+                                              void *data_out);
+
+/**
+ * @brief Masked write of one whole word of any supported width.
+ *
+ * @p data holds data_width / 8 bytes in the layout of memory_model_read_wide().
+ * Only the bytes selected by @p byte_mask are written; a zero mask writes
+ * nothing. Status codes match memory_model_write().
+ */
+memory_model_status_t memory_model_write_wide(memory_model_t *model,
+                                               uint64_t virt_addr,
+                                               uint64_t byte_mask,
+                                               const void *data);
+
+/**
+ * @brief Report the kernel level chosen for this model's wide masked accesses.
+ */
+memory_model_simd_t memory_model_get_simd(const memory_model_t *model);
+
+/**
+ * @brief Read @p length bytes starting at virtual word address @p virt_addr.
+ *
+ * Words are read from consecutive virtual addresses, which may cross page
+ * boundaries and map to unrelated physical frames. The buffer holds each word
+ * in little-endian byte order, back to back; a @p length that is not a whole
+ * number of words ends with a partial word. Translation happens once per page.
+ *
+ * @return The status of the first failing word, or MEMORY_MODEL_STATUS_OK. On
+ *         failure the buffer from that word onward is zeroed.
+ */
+memory_model_status_t memory_model_read_block(const memory_model_t *model,
+                                               uint64_t virt_addr,
+                                               void *buffer,
+                                               size_t length);
+
+/**
+ * @brief Write @p length bytes starting at virtual word address @p virt_addr.
+ *
+ * The buffer layout matches memory_model_read_block(). A partial final word
+ * updates only its leading bytes. On failure, words before the failing one
+ * have been written and the rest of the block has not.
+ */
+memory_model_status_t memory_model_write_block(memory_model_t *model,
+                                                uint64_t virt_addr,
+                                                const void *buffer,
+                                                size_t length);
+
+/**
+ * @brief Host view of backing-store words returned by memory_model_get_direct().
+ */
+typedef struct {
+    uint8_t *host;      /**< Word at virt_base; words are data_width / 8 bytes apart, little-endian */
+    uint64_t virt_base; /**< First virtual word address covered */
+    uint64_t phys_base; /**< Physical word address of virt_base */
+    uint64_t words;     /**< Consecutive words covered; at least one */
+} memory_model_direct_t;
+
+/**
+ * @brief Grant host access to the backing store around a translated address.
+ *
+ * Looks @p virt_addr up in the TLB as memory_model_lookup() does, without
+ * walking, and returns the longest run of words around it that lies within
+ * one TLB entry and one contiguous piece of the store (stores are allocated
+ * in pages of 1024 words, so a larger TLB page yields several grants). The
+ * words are materialised as for a write: allocated, unshared from forks and
+ * zeroed if stale. Accesses through the pointer bypass the statistics and
+ * the data cache, and use the layout of memory_model_read_block().
+ *
+ * A grant stays valid until memory_model_direct_epoch() changes, which it
+ * does whenever a TLB entry is overwritten or flushed, a new entry overrides
+ * an existing translation, the ASID changes, or the model is reset, forked,
+ * snapshotted, restored or imported into.
+ *
+ * @return MEMORY_MODEL_STATUS_ERR_ADDR on a TLB miss;
+ *         MEMORY_MODEL_STATUS_ERR_ACCESS for a NULL argument, a concurrent
+ *         model, an address beyond the store or a failed allocation.
+ */
+memory_model_status_t memory_model_get_direct(memory_model_t *model,
+                                              uint64_t virt_addr,
+                                              memory_model_direct_t *direct_out);
+
+/**
+ * @brief Counter that advances whenever a memory_model_get_direct() grant may
+ * have gone stale.
+ */
+uint64_t memory_model_direct_epoch(const memory_model_t *model);
+
+/**
+ * @brief Execute one transaction described by @p transaction.
+ *
+ * @return The transaction status, which is also stored in @p result.
+ */
+memory_model_status_t memory_model_execute(memory_model_t *model,
+                                            const memory_model_transaction_t *transaction,
+                                            memory_model_result_t *result);
+
+/**
+ * @brief Execute a batch of transactions in program order.
+ *
+ * Handle and column validation happens once per call rather than once per
+ * operation. Each result row receives exactly what the matching single-op API
+ * would have returned, including per-operation error statuses.
+ *
+ * @return MEMORY_MODEL_ERROR_BAD_ARGUMENT if a required column is missing,
+ *         MEMORY_MODEL_ERROR_OK otherwise.
+ */
+memory_model_error_t memory_model_execute_batch(memory_model_t *model,
+                                                const memory_model_batch_t *batch,
+                                                const memory_model_batch_results_t *results);
+
+/**
+ * @brief Execute a batch on up to @p threads threads with serial-order semantics.
+ *
+ * Operations are grouped by backing-store page between TLB loads and the groups
+ * run on a work-stealing pool. Statuses, read data, final memory contents and
+ * statistics are identical to memory_model_execute_batch(). The call needs
+ * exclusive access to the model, even in concurrent mode. While a page-table
+ * walker is attached the batch runs serially, since any miss may refill the TLB.
+ *
+ * @param threads Worker count including the caller; 0 uses every online CPU.
+ *                Small batches run serially on the calling thread.
+ */
+memory_model_error_t memory_model_execute_batch_parallel(memory_model_t *model,
+                                                         const memory_model_batch_t *batch,
+                                                         const memory_model_batch_results_t *results,
+                                                         uint32_t threads);
+
 /**
  * @brief Query the number of active (valid) TLB entries.
  */
@@ -113,6 +703,9 @@ uint32_t memory_model_active_entries(const memory_model_t *model);
 
 /**
  * @brief Retrieve the round-robin write index used for the next TLB insertion.
+ *
+ * In a set-associative TLB each set keeps its own round-robin way, and this
+ * is the slot the next load into the most recently loaded set would use.
  */
 uint32_t memory_model_tlb_write_index(const memory_model_t *model);
 
@@ -121,6 +714,50 @@ uint32_t memory_model_tlb_write_index(const memory_model_t *model);
  */
 uint32_t memory_model_tlb_capacity(const memory_model_t *model);
 
+/**
+ * @brief Bytes of backing store currently allocated.
+ *
+ * Dense models report the full store; sparse models report the pages that
+ * have been written at least once, including pages retained across resets.
+ */
+size_t memory_model_resident_bytes(const memory_model_t *model);
+
+/**
+ * @brief Retrieve aggregate activity counters.
+ *
+ * Counters are per instance and persist across memory_model_reset() and
+ * memory_model_restore(); forks start from zero.
+ *
+ * @return MEMORY_MODEL_ERROR_UNSUPPORTED if the library was built with
+ *         MEMORY_MODEL_ENABLE_STATS=0.
+ */
+memory_model_error_t memory_model_get_stats(const memory_model_t *model, memory_model_stats_t *stats_out);
+
+/**
+ * @brief Copy per-slot TLB hit counts for the first @p count slots.
+ *
+ * Counts accumulate per slot index, independent of which mapping occupied it.
+ */
+memory_model_error_t memory_model_get_tlb_slot_hits(const memory_model_t *model,
+                                                    uint64_t *hits_out,
+                                                    uint32_t count);
+
+/**
+ * @brief Retrieve the translation-miss histogram by virtual page.
+ *
+ * If @p capacity is large enough, fills @p entries_out sorted by descending
+ * miss count. In every case returns the number of distinct pages that missed,
+ * so a call with @p capacity 0 sizes the buffer.
+ */
+size_t memory_model_get_miss_histogram(const memory_model_t *model,
+                                       memory_model_miss_entry_t *entries_out,
+                                       size_t capacity);
+
+/**
+ * @brief Zero all activity counters, per-slot hits and the miss histogram.
+ */
+memory_model_error_t memory_model_reset_stats(memory_model_t *model);
+
 /**
  * @brief Access the configuration associated with the instance.
  */
@@ -0,0 +1,666 @@
+#ifndef MEMORY_MODEL_HPP
+#define MEMORY_MODEL_HPP
+
+/**
+ * @file memory_model.hpp
+ * @brief Header-only C++ reference memory model with compile-time geometry.
+ *
+ * MemoryModel<> mirrors the translation and data paths of memory_model.c bit
+ * for bit, but every mask, shift and bound is a constant expression, so a
+ * caller that holds the model by value gets translate + access inlined and
+ * folded into its own code. Status codes and transaction descriptors are the
+ * C API's own types, so either model can sit behind the same caller.
+ *
+ * Differences from the C model: words are at most 64 bits, the backing store
+ * is always dense, the TLB is fully associative with round-robin walker
+ * fills, and the model keeps no activity counters, forks or snapshots. Use the C API where
+ * those are needed.
+ */
+
+#include "memory_model.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+
+namespace memory_model_detail {
+
+constexpr uint32_t bit_width(uint64_t value)
+{
+    return value == 0U ? 0U : 1U + bit_width(value >> 1U);
+}
+
+constexpr uint32_t ceil_log2(uint64_t value)
+{
+    return value <= 1U ? 0U : bit_width(value - 1U);
+}
+
+constexpr uint64_t mask_from_width(uint32_t width)
+{
+    return width == 0U ? 0ULL : (width >= 64U ? UINT64_MAX : (1ULL << width) - 1ULL);
+}
+
+constexpr bool is_power_of_two(uint64_t value)
+{
+    return value != 0U && (value & (value - 1U)) == 0U;
+}
+
+/* Expand a per-byte enable mask into a per-bit data mask. */
+inline uint64_t expand_byte_mask(uint32_t byte_mask)
+{
+    static const uint32_t nibble_to_byte_mask[16] = {
+        0x00000000U, 0x000000FFU, 0x0000FF00U, 0x0000FFFFU,
+        0x00FF0000U, 0x00FF00FFU, 0x00FFFF00U, 0x00FFFFFFU,
+        0xFF000000U, 0xFF0000FFU, 0xFF00FF00U, 0xFF00FFFFU,
+        0xFFFF0000U, 0xFFFF00FFU, 0xFFFFFF00U, 0xFFFFFFFFU,
+    };
+    return static_cast<uint64_t>(nibble_to_byte_mask[byte_mask & 0xFU]) |
+           (static_cast<uint64_t>(nibble_to_byte_mask[(byte_mask >> 4U) & 0xFU]) << 32U);
+}
+
+/* Narrowest unsigned type that holds one data word. */
+template <uint32_t DataWidth>
+struct word_storage {
+    typedef typename std::conditional<
+        (DataWidth <= 8U), uint8_t,
+        typename std::conditional<
+            (DataWidth <= 16U), uint16_t,
+            typename std::conditional<(DataWidth <= 32U), uint32_t, uint64_t>::type>::type>::type type;
+};
+
+} // namespace memory_model_detail
+
+/**
+ * @brief Reference memory model with geometry fixed at compile time.
+ *
+ * The template parameters match the fields of memory_model_config_t and are
+ * validated with the same rules as memory_model_create(). The model owns its
+ * TLB and backing store and is move-only; a moved-from model may only be
+ * destroyed or assigned to.
+ */
+template <uint32_t VirtBits, uint32_t PhysBits, uint32_t PageSize, uint32_t DataWidth,
+          uint64_t MemDepth, uint32_t TlbEntries>
+class MemoryModel
+{
+public:
+    static_assert(DataWidth != 0U && DataWidth % 8U == 0U && DataWidth <= 64U,
+                  "data width must be a non-zero multiple of 8, up to 64");
+    static_assert(memory_model_detail::is_power_of_two(PageSize), "page size must be a power of two");
+    static_assert(MemDepth != 0U && TlbEntries != 0U, "memory depth and TLB entries must be non-zero");
+    static_assert(VirtBits != 0U && VirtBits <= 64U, "virtual address width must be 1..64");
+    static_assert(PhysBits != 0U && PhysBits <= 64U, "physical address width must be 1..64");
+
+    typedef typename memory_model_detail::word_storage<DataWidth>::type word_type;
+
+    static constexpr uint32_t kPageOffsetBits = memory_model_detail::ceil_log2(PageSize);
+    static constexpr uint64_t kPageOffsetMask = memory_model_detail::mask_from_width(kPageOffsetBits);
+    static constexpr uint64_t kVirtAddrMask = memory_model_detail::mask_from_width(VirtBits);
+    static constexpr uint64_t kPhysAddrMask = memory_model_detail::mask_from_width(PhysBits);
+    static constexpr uint64_t kDataMask = memory_model_detail::mask_from_width(DataWidth);
+    static constexpr uint32_t kBytesPerWord = DataWidth / 8U;
+    static constexpr uint32_t kWordByteMask = (1U << kBytesPerWord) - 1U;
+    static constexpr bool kMemDepthPow2 = memory_model_detail::is_power_of_two(MemDepth);
+    static constexpr uint64_t kMemAddrMask =
+        kMemDepthPow2 ? MemDepth - 1U : memory_model_detail::mask_from_width(memory_model_detail::ceil_log2(MemDepth));
+
+    static_assert(kPageOffsetBits <= VirtBits && kPageOffsetBits <= PhysBits,
+                  "page offset must fit both address widths");
+    static_assert(MemDepth <= SIZE_MAX / sizeof(word_type), "backing store does not fit in memory");
+
+    MemoryModel() : state_(new State()), store_(new word_type[static_cast<size_t>(MemDepth)]())
+    {
+    }
+
+    MemoryModel(MemoryModel &&other) noexcept = default;
+    MemoryModel &operator=(MemoryModel &&other) noexcept = default;
+    MemoryModel(const MemoryModel &) = delete;
+    MemoryModel &operator=(const MemoryModel &) = delete;
+
+    /** @brief The equivalent runtime configuration for memory_model_create(). */
+    static memory_model_config_t config()
+    {
+        memory_model_config_t cfg = memory_model_config_default();
+        cfg.virt_addr_width = VirtBits;
+        cfg.phys_addr_width = PhysBits;
+        cfg.page_size = PageSize;
+        cfg.data_width = DataWidth;
+        cfg.mem_depth = MemDepth;
+        cfg.tlb_entries = TlbEntries;
+        cfg.sparse = false;
+        cfg.concurrent = false;
+        return cfg;
+    }
+
+    /** @brief False only for a moved-from model. */
+    bool valid() const { return state_ != nullptr; }
+
+    /** @brief Clear memory and the TLB; see memory_model_reset(). */
+    void reset()
+    {
+        flush_tlb();
+        state_->asid = 0U;
+        state_->page_table = memory_model_page_table_t();
+        std::fill(store_.get(), store_.get() + MemDepth, word_type());
+    }
+
+    /** @brief Switch address space; see memory_model_set_asid(). */
+    memory_model_error_t set_asid(uint32_t asid)
+    {
+        if (asid > MEMORY_MODEL_MAX_ASID) {
+            return MEMORY_MODEL_ERROR_BAD_ARGUMENT;
+        }
+        state_->asid = asid;
+        return MEMORY_MODEL_ERROR_OK;
+    }
+
+    uint32_t current_asid() const { return state_->asid; }
+
+    /** @brief Attach or, with NULL, detach a page-table walker; see memory_model_set_page_table(). */
+    memory_model_error_t set_page_table(const memory_model_page_table_t *table)
+    {
+        if (table == nullptr || table->levels == 0U) {
+            state_->page_table = memory_model_page_table_t();
+            return MEMORY_MODEL_ERROR_OK;
+        }
+        if (table->levels > MEMORY_MODEL_MAX_PT_LEVELS || table->index_bits == 0U ||
+            table->index_bits > kPageOffsetBits || kPageOffsetBits < 2U ||
+            kPageOffsetBits + table->levels * table->index_bits < VirtBits) {
+            return MEMORY_MODEL_ERROR_BAD_ARGUMENT;
+        }
+        state_->page_table = *table;
+        return MEMORY_MODEL_ERROR_OK;
+    }
+
+    /** @brief Walk and fill regardless of the TLB; see memory_model_walk(). */
+    memory_model_status_t walk(uint64_t virt_addr, uint64_t *phys_addr_out, uint32_t *depth_out)
+    {
+        return walk_and_fill(virt_addr, phys_addr_out, depth_out);
+    }
+
+    /** @brief Invalidate every TLB entry in O(TlbEntries); see memory_model_flush_tlb(). */
+    void flush_tlb()
+    {
+        State &s = *state_;
+        std::fill(s.tlb, s.tlb + TlbEntries, TlbEntry());
+        std::fill(s.index, s.index + (1U << kIndexBits), IndexBucket());
+        s.write_ptr = 0U;
+        s.active_entries = 0U;
+        s.span_classes = 0U;
+        std::fill(s.span_live, s.span_live + kMaxSpanBits + 1U, 0U);
+    }
+
+    /** @brief Invalidate every entry translating @p virt_addr; see memory_model_flush_tlb_page(). */
+    void flush_tlb_page(uint64_t virt_addr)
+    {
+        uint64_t masked_virt = virt_addr & kVirtAddrMask;
+        uint32_t asid = state_->asid;
+        for (uint64_t classes = state_->span_classes; classes != 0U; classes &= classes - 1U) {
+            uint32_t span_bits = static_cast<uint32_t>(__builtin_ctzll(classes));
+            uint64_t virt_page = masked_virt >> span_bits;
+            if (index_find(virt_page, span_bits, asid) == nullptr) {
+                continue;
+            }
+            for (uint32_t i = 0U; i < TlbEntries; ++i) {
+                const TlbEntry &entry = state_->tlb[i];
+                if (entry.valid && entry.span_bits == span_bits && entry.virt_page == virt_page &&
+                    entry.asid == asid) {
+                    evict(i);
+                }
+            }
+        }
+    }
+
+    /** @brief Copy the TLB out in slot order; see memory_model_export_tlb(). */
+    memory_model_error_t export_tlb(memory_model_tlb_entry_t *entries_out, uint32_t capacity,
+                                    uint32_t *write_index_out) const
+    {
+        if (entries_out == nullptr || capacity < TlbEntries) {
+            return MEMORY_MODEL_ERROR_BAD_ARGUMENT;
+        }
+        for (uint32_t i = 0U; i < TlbEntries; ++i) {
+            const TlbEntry &entry = state_->tlb[i];
+            memory_model_tlb_entry_t &out = entries_out[i];
+            std::memset(&out, 0, sizeof(out));
+            if (entry.valid) {
+                out.valid = true;
+                out.span_bits = entry.span_bits;
+                out.asid = entry.asid;
+                out.virt_base = entry.virt_base;
+                out.phys_base = entry.phys_base;
+            }
+        }
+        if (write_index_out != nullptr) {
+            *write_index_out = state_->write_ptr;
+        }
+        return MEMORY_MODEL_ERROR_OK;
+    }
+
+    /** @brief Replace the whole TLB; see memory_model_import_tlb(). */
+    memory_model_error_t import_tlb(const memory_model_tlb_entry_t *entries, uint32_t count, uint32_t write_index)
+    {
+        if ((entries == nullptr && count != 0U) || count > TlbEntries || write_index >= TlbEntries) {
+            return MEMORY_MODEL_ERROR_BAD_ARGUMENT;
+        }
+        for (uint32_t i = 0U; i < count; ++i) {
+            if (entries[i].valid && ((entries[i].span_bits != 0U && !span_supported(entries[i].span_bits)) ||
+                                     entries[i].asid > MEMORY_MODEL_MAX_ASID)) {
+                return MEMORY_MODEL_ERROR_BAD_ARGUMENT;
+            }
+        }
+
+        flush_tlb();
+        for (uint32_t i = 0U; i < count; ++i) {
+            if (entries[i].valid) {
+                install(i, entries[i].virt_base, entries[i].phys_base,
+                        entries[i].span_bits != 0U ? entries[i].span_bits : kPageOffsetBits, entries[i].asid);
+            }
+        }
+        state_->write_ptr = write_index;
+        return MEMORY_MODEL_ERROR_OK;
+    }
+
+    /** @brief Insert a mapping at the round-robin write index; see memory_model_load_tlb(). */
+    void load_tlb(uint64_t virt_base, uint64_t phys_base) { load_entry(virt_base, phys_base, kPageOffsetBits); }
+
+    /** @brief Insert a 2^@p span_bits mapping; see memory_model_load_tlb_range(). */
+    memory_model_error_t load_tlb_range(uint64_t virt_base, uint64_t phys_base, uint32_t span_bits)
+    {
+        if (!span_supported(span_bits)) {
+            return MEMORY_MODEL_ERROR_BAD_ARGUMENT;
+        }
+        load_entry(virt_base, phys_base, span_bits);
+        return MEMORY_MODEL_ERROR_OK;
+    }
+
+    /**
+     * @brief TLB-only translation that never walks or refills; see
+     * memory_model_lookup(). A miss returns MEMORY_MODEL_STATUS_ERR_ADDR.
+     */
+    memory_model_status_t lookup(uint64_t virt_addr, uint64_t *phys_addr_out) const
+    {
+        uint64_t masked_virt = virt_addr & kVirtAddrMask;
+        uint32_t asid = state_->asid;
+        for (uint64_t classes = state_->span_classes; classes != 0U; classes &= classes - 1U) {
+            uint32_t span_bits = static_cast<uint32_t>(__builtin_ctzll(classes));
+            const IndexBucket *bucket = index_find(masked_virt >> span_bits, span_bits, asid);
+            if (bucket != nullptr) {
+                const TlbEntry &entry = state_->tlb[bucket->slot];
+                *phys_addr_out = (entry.phys_frame | (masked_virt & entry.offset_mask)) & kPhysAddrMask;
+                return MEMORY_MODEL_STATUS_OK;
+            }
+        }
+        *phys_addr_out = 0U;
+        return MEMORY_MODEL_STATUS_ERR_ADDR;
+    }
+
+    /**
+     * @brief Translate without touching memory; see memory_model_translate().
+     * Not const: with a walker attached a miss walks and refills the TLB.
+     */
+    memory_model_status_t translate(uint64_t virt_addr, uint64_t *phys_addr_out)
+    {
+        memory_model_status_t status = lookup(virt_addr, phys_addr_out);
+        if (status != MEMORY_MODEL_STATUS_OK && state_->page_table.levels != 0U) {
+            return walk_and_fill(virt_addr, phys_addr_out, nullptr);
+        }
+        return status;
+    }
+
+    /** @brief Masked read; see memory_model_read(). Not const, as translate() is not. */
+    memory_model_status_t read(uint64_t virt_addr, uint32_t byte_mask, uint64_t *data_out)
+    {
+        *data_out = 0U;
+        if ((byte_mask & ~kWordByteMask) != 0U) {
+            return MEMORY_MODEL_STATUS_ERR_ACCESS;
+        }
+
+        uint64_t phys_addr;
+        memory_model_status_t status = translate(virt_addr, &phys_addr);
+        if (status != MEMORY_MODEL_STATUS_OK) {
+            return status;
+        }
+
+        uint64_t mem_index = phys_addr & kMemAddrMask;
+        if (!kMemDepthPow2 && mem_index >= MemDepth) {
+            return MEMORY_MODEL_STATUS_ERR_ACCESS;
+        }
+
+        uint64_t value = store_[mem_index];
+        if (byte_mask != 0U && byte_mask != kWordByteMask) {
+            value &= memory_model_detail::expand_byte_mask(byte_mask);
+        }
+        *data_out = value;
+        return MEMORY_MODEL_STATUS_OK;
+    }
+
+    /** @brief Masked write; see memory_model_write(). */
+    memory_model_status_t write(uint64_t virt_addr, uint32_t byte_mask, uint64_t data)
+    {
+        if ((byte_mask & ~kWordByteMask) != 0U) {
+            return MEMORY_MODEL_STATUS_ERR_WRITE;
+        }
+
+        uint64_t phys_addr;
+        memory_model_status_t status = translate(virt_addr, &phys_addr);
+        if (status != MEMORY_MODEL_STATUS_OK || byte_mask == 0U) {
+            return status;
+        }
+
+        uint64_t mem_index = phys_addr & kMemAddrMask;
+        if (!kMemDepthPow2 && mem_index >= MemDepth) {
+            return MEMORY_MODEL_STATUS_ERR_ACCESS;
+        }
+
+        word_type &word = store_[mem_index];
+        if (byte_mask == kWordByteMask) {
+            word = static_cast<word_type>(data & kDataMask);
+        } else {
+            uint64_t bit_mask = memory_model_detail::expand_byte_mask(byte_mask);
+            word = static_cast<word_type>((word & ~bit_mask) | (data & bit_mask));
+        }
+        return MEMORY_MODEL_STATUS_OK;
+    }
+
+    /** @brief Run one transaction; see memory_model_execute(). */
+    memory_model_result_t execute(const memory_model_transaction_t &transaction)
+    {
+        memory_model_result_t result;
+        result.data = 0U;
+        switch (transaction.op) {
+        case MEMORY_MODEL_OP_READ:
+            result.status = read(transaction.virt_addr, transaction.byte_mask, &result.data);
+            break;
+        case MEMORY_MODEL_OP_WRITE:
+            result.status = write(transaction.virt_addr, transaction.byte_mask, transaction.data);
+            break;
+        case MEMORY_MODEL_OP_TLB_LOAD:
+            load_tlb(transaction.virt_addr, transaction.data);
+            result.status = MEMORY_MODEL_STATUS_OK;
+            break;
+        case MEMORY_MODEL_OP_FLUSH:
+            if (transaction.byte_mask != 0U) {
+                flush_tlb_page(transaction.virt_addr);
+            } else {
+                flush_tlb();
+            }
+            result.status = MEMORY_MODEL_STATUS_OK;
+            break;
+        case MEMORY_MODEL_OP_SET_ASID:
+            result.status = transaction.data <= MEMORY_MODEL_MAX_ASID &&
+                                    set_asid(static_cast<uint32_t>(transaction.data)) == MEMORY_MODEL_ERROR_OK
+                                ? MEMORY_MODEL_STATUS_OK
+                                : MEMORY_MODEL_STATUS_ERR_ACCESS;
+            break;
+        default:
+            result.status = MEMORY_MODEL_STATUS_ERR_ACCESS;
+            break;
+        }
+        return result;
+    }
+
+    uint32_t active_entries() const { return state_->active_entries; }
+    uint32_t tlb_write_index() const { return state_->write_ptr; }
+    static constexpr uint32_t tlb_capacity() { return TlbEntries; }
+
+private:
+    struct TlbEntry {
+        bool valid;
+        uint32_t span_bits;
+        uint32_t asid;
+        uint64_t virt_base;
+        uint64_t phys_base;
+        uint64_t virt_page;
+        uint64_t phys_frame;
+        uint64_t offset_mask;
+    };
+
+    /* Same open-addressed (ASID, span, page) index as memory_model.c; count == 0 marks an empty bucket. */
+    struct IndexBucket {
+        uint64_t virt_page;
+        uint32_t span_bits;
+        uint32_t asid;
+        uint32_t slot;
+        uint32_t count;
+    };
+
+    static constexpr uint32_t kMaxSpanBits = 63U;
+
+    static constexpr uint32_t kIndexBits =
+        memory_model_detail::ceil_log2(TlbEntries) + 1U < 2U ? 2U : memory_model_detail::ceil_log2(TlbEntries) + 1U;
+    static constexpr uint32_t kIndexMask = (1U << kIndexBits) - 1U;
+
+    struct State {
+        TlbEntry tlb[TlbEntries];
+        IndexBucket index[1U << kIndexBits];
+        uint32_t write_ptr;
+        uint32_t active_entries;
+        uint64_t span_classes; /* bit s set while a live entry has span_bits == s */
+        uint32_t span_live[kMaxSpanBits + 1U];
+        uint32_t asid;
+        memory_model_page_table_t page_table; /* levels == 0 while no walker is attached */
+
+        State()
+            : tlb(), index(), write_ptr(0U), active_entries(0U), span_classes(0U), span_live(), asid(0U),
+              page_table()
+        {
+        }
+    };
+
+    static bool span_supported(uint32_t span_bits)
+    {
+        return span_bits >= kPageOffsetBits && span_bits <= kMaxSpanBits && span_bits <= VirtBits &&
+               span_bits <= PhysBits;
+    }
+
+    /* Invalidate valid slot @p index, as tlb_evict(). */
+    void evict(uint32_t index)
+    {
+        State &s = *state_;
+        TlbEntry &entry = s.tlb[index];
+        entry.valid = false;
+        index_release(entry.virt_page, entry.span_bits, entry.asid, index);
+        if (--s.span_live[entry.span_bits] == 0U) {
+            s.span_classes &= ~(1ULL << entry.span_bits);
+        }
+        s.active_entries--;
+    }
+
+    void install(uint32_t index, uint64_t virt_base, uint64_t phys_base, uint32_t span_bits, uint32_t asid)
+    {
+        State &s = *state_;
+        TlbEntry &entry = s.tlb[index];
+        if (entry.valid) {
+            evict(index);
+        }
+
+        entry.valid = true;
+        entry.span_bits = span_bits;
+        entry.asid = asid;
+        entry.virt_base = virt_base & kVirtAddrMask;
+        entry.phys_base = phys_base & kPhysAddrMask;
+        entry.offset_mask = memory_model_detail::mask_from_width(span_bits);
+        entry.virt_page = entry.virt_base >> span_bits;
+        entry.phys_frame = entry.phys_base & ~entry.offset_mask;
+        index_insert(entry.virt_page, span_bits, asid, index);
+        if (s.span_live[span_bits]++ == 0U) {
+            s.span_classes |= 1ULL << span_bits;
+        }
+        s.active_entries++;
+    }
+
+    void load_entry(uint64_t virt_base, uint64_t phys_base, uint32_t span_bits)
+    {
+        State &s = *state_;
+        uint32_t index = s.write_ptr;
+        install(index, virt_base, phys_base, span_bits, s.asid);
+        s.write_ptr = index + 1U < TlbEntries ? index + 1U : 0U;
+    }
+
+    /* Same walk as walk_and_fill() in memory_model.c; @p depth_out may be null. */
+    memory_model_status_t walk_and_fill(uint64_t virt_addr, uint64_t *phys_addr_out, uint32_t *depth_out)
+    {
+        const memory_model_page_table_t &table = state_->page_table;
+        constexpr uint64_t frame_mask = kPhysAddrMask & ~kPageOffsetMask;
+        uint64_t masked_virt = virt_addr & kVirtAddrMask;
+        uint64_t virt_page = masked_virt >> kPageOffsetBits;
+        uint64_t table_base = table.root & frame_mask;
+        uint32_t depth = 0U;
+
+        *phys_addr_out = 0U;
+        for (uint32_t level = 0U; level < table.levels; ++level) {
+            uint32_t shift = table.index_bits * (table.levels - 1U - level);
+            uint64_t index = shift < 64U ? (virt_page >> shift) & memory_model_detail::mask_from_width(table.index_bits)
+                                         : 0U;
+            uint64_t mem_index = ((table_base + index) & kPhysAddrMask) & kMemAddrMask;
+
+            depth++;
+            if (!kMemDepthPow2 && mem_index >= MemDepth) {
+                break;
+            }
+            uint64_t pte = store_[mem_index];
+            if ((pte & MEMORY_MODEL_PTE_VALID) == 0U) {
+                break;
+            }
+            if ((pte & MEMORY_MODEL_PTE_LEAF) != 0U) {
+                uint32_t span_bits = kPageOffsetBits + shift;
+                if (!span_supported(span_bits)) {
+                    break;
+                }
+                uint64_t offset_mask = memory_model_detail::mask_from_width(span_bits);
+                load_entry(masked_virt & ~offset_mask, pte & frame_mask, span_bits);
+                *phys_addr_out = ((pte & frame_mask & ~offset_mask) | (masked_virt & offset_mask)) & kPhysAddrMask;
+                if (depth_out != nullptr) {
+                    *depth_out = depth;
+                }
+                return MEMORY_MODEL_STATUS_OK;
+            }
+            table_base = pte & frame_mask;
+        }
+        if (depth_out != nullptr) {
+            *depth_out = depth;
+        }
+        return MEMORY_MODEL_STATUS_ERR_ADDR;
+    }
+
+    static uint32_t index_hash(uint64_t virt_page, uint32_t span_bits, uint32_t asid)
+    {
+        uint64_t tag = (static_cast<uint64_t>(asid) << 6U) | span_bits;
+        return static_cast<uint32_t>(((virt_page ^ (tag << 42U)) * 0x9E3779B97F4A7C15ULL) >> (64U - kIndexBits));
+    }
+
+    IndexBucket *index_find(uint64_t virt_page, uint32_t span_bits, uint32_t asid) const
+    {
+        uint32_t pos = index_hash(virt_page, span_bits, asid);
+        for (;;) {
+            IndexBucket &bucket = state_->index[pos];
+            if (bucket.count == 0U) {
+                return nullptr;
+            }
+            if (bucket.virt_page == virt_page && bucket.span_bits == span_bits && bucket.asid == asid) {
+                return &bucket;
+            }
+            pos = (pos + 1U) & kIndexMask;
+        }
+    }
+
+    void index_insert(uint64_t virt_page, uint32_t span_bits, uint32_t asid, uint32_t slot)
+    {
+        uint32_t pos = index_hash(virt_page, span_bits, asid);
+        for (;;) {
+            IndexBucket &bucket = state_->index[pos];
+            if (bucket.count == 0U) {
+                bucket.virt_page = virt_page;
+                bucket.span_bits = span_bits;
+                bucket.asid = asid;
+                bucket.slot = slot;
+                bucket.count = 1U;
+                return;
+            }
+            if (bucket.virt_page == virt_page && bucket.span_bits == span_bits && bucket.asid == asid) {
+                if (slot < bucket.slot) {
+                    bucket.slot = slot;
+                }
+                bucket.count++;
+                return;
+            }
+            pos = (pos + 1U) & kIndexMask;
+        }
+    }
+
+    /* Backward-shift deletion, as tlb_index_erase(). */
+    void index_erase(uint32_t hole)
+    {
+        IndexBucket *index = state_->index;
+        uint32_t pos = hole;
+        for (;;) {
+            pos = (pos + 1U) & kIndexMask;
+            if (index[pos].count == 0U) {
+                break;
+            }
+            uint32_t home = index_hash(index[pos].virt_page, index[pos].span_bits, index[pos].asid);
+            bool home_in_range = (hole <= pos) ? (home > hole && home <= pos) : (home > hole || home <= pos);
+            if (!home_in_range) {
+                index[hole] = index[pos];
+                hole = pos;
+            }
+        }
+        index[hole].count = 0U;
+    }
+
+    /* Drop @p slot's reference to @p virt_page; the slot is already invalid. */
+    void index_release(uint64_t virt_page, uint32_t span_bits, uint32_t asid, uint32_t slot)
+    {
+        IndexBucket *bucket = index_find(virt_page, span_bits, asid);
+        if (bucket == nullptr) {
+            return;
+        }
+        if (bucket->count <= 1U) {
+            index_erase(static_cast<uint32_t>(bucket - state_->index));
+            return;
+        }
+
+        bucket->count--;
+        if (bucket->slot != slot) {
+            return;
+        }
+        for (uint32_t i = 0U; i < TlbEntries; ++i) {
+            const TlbEntry &entry = state_->tlb[i];
+            if (entry.valid && entry.virt_page == virt_page && entry.span_bits == span_bits && entry.asid == asid) {
+                bucket->slot = i;
+                return;
+            }
+        }
+    }
+
+    std::unique_ptr<State> state_;
+    std::unique_ptr<word_type[]> store_;
+};
+
+template <uint32_t V, uint32_t P, uint32_t S, uint32_t D, uint64_t M, uint32_t T>
+constexpr uint32_t MemoryModel<V, P, S, D, M, T>::kPageOffsetBits;
+template <uint32_t V, uint32_t P, uint32_t S, uint32_t D, uint64_t M, uint32_t T>
+constexpr uint64_t MemoryModel<V, P, S, D, M, T>::kPageOffsetMask;
+template <uint32_t V, uint32_t P, uint32_t S, uint32_t D, uint64_t M, uint32_t T>
+constexpr uint64_t MemoryModel<V, P, S, D, M, T>::kVirtAddrMask;
+template <uint32_t V, uint32_t P, uint32_t S, uint32_t D, uint64_t M, uint32_t T>
+constexpr uint64_t MemoryModel<V, P, S, D, M, T>::kPhysAddrMask;
+template <uint32_t V, uint32_t P, uint32_t S, uint32_t D, uint64_t M, uint32_t T>
+constexpr uint64_t MemoryModel<V, P, S, D, M, T>::kDataMask;
+template <uint32_t V, uint32_t P, uint32_t S, uint32_t D, uint64_t M, uint32_t T>
+constexpr uint32_t MemoryModel<V, P, S, D, M, T>::kBytesPerWord;
+template <uint32_t V, uint32_t P, uint32_t S, uint32_t D, uint64_t M, uint32_t T>
+constexpr uint32_t MemoryModel<V, P, S, D, M, T>::kWordByteMask;
+template <uint32_t V, uint32_t P, uint32_t S, uint32_t D, uint64_t M, uint32_t T>
+constexpr bool MemoryModel<V, P, S, D, M, T>::kMemDepthPow2;
+template <uint32_t V, uint32_t P, uint32_t S, uint32_t D, uint64_t M, uint32_t T>
+constexpr uint64_t MemoryModel<V, P, S, D, M, T>::kMemAddrMask;
+
+/**
+ * @brief The geometry of the RTL defaults (memory_model_config_default()).
+ */
+typedef MemoryModel<32U, 28U, 4096U, 64U, 16384U, 256U> RtlMemoryModel;
+
+#endif /* MEMORY_MODEL_HPP */
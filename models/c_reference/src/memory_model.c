@@ -1,24 +1,305 @@
+#define _POSIX_C_SOURCE 200809L
+
 #include "memory_model.h"
 
 #include <limits.h>
+#include <pthread.h>
+#include <stdatomic.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define MEMORY_MODEL_X86_KERNELS 1
+#include <immintrin.h>
+#else
+#define MEMORY_MODEL_X86_KERNELS 0
+#endif
 
+/*
+ * Reset is O(1): the model bumps a generation counter instead of clearing
+ * state. TLB entries, index buckets and backing-store pages record the
+ * generation they were last written in, and anything older is treated as
+ * invalid (TLB) or all-zero (store). The counters are 64 bits wide and never
+ * wrap in practice.
+ */
 struct tlb_entry {
     bool valid;
+    uint32_t span_bits; /* log2 of the mapped span; page_offset_bits for a plain page */
+    uint32_t asid;
+    uint64_t generation;
     uint64_t virt_base;
     uint64_t phys_base;
+    uint64_t virt_page;   /* virt_base pre-shifted down by span_bits */
+    uint64_t phys_frame;  /* phys_base with the span offset bits cleared */
+    uint64_t offset_mask; /* low span_bits bits */
+};
+
+/*
+ * Open-addressed index from (ASID, span, virtual page number) to TLB slot. Each
+ * bucket tracks the lowest slot currently holding the page, so lookups return
+ * the same entry as the RTL priority loop even when round-robin overwrites
+ * leave duplicate mappings behind. A bucket with count == 0 is empty.
+ *
+ * Range entries share the index with plain pages: a lookup probes once per
+ * span size in use, smallest first, so the most specific mapping wins. A TLB
+ * holding only plain pages therefore costs a single probe as before.
+ *
+ * The ASID is part of the key, so entries of other address spaces simply
+ * never match and switching ASID touches nothing but model->tlb_asid.
+ */
+struct tlb_index_bucket {
+    uint64_t virt_page;
+    uint64_t generation;
+    uint32_t span_bits;
+    uint32_t asid;
+    uint32_t slot;
+    uint32_t count;
+};
+
+#define TLB_MAX_SPAN_BITS 63U
+
+/*
+ * Replacement state for walker fills under cfg.tlb_policy. LRU and FIFO keep
+ * a per-slot stamp from a model-wide clock: the last hit or fill for LRU, the
+ * fill alone for FIFO. PLRU keeps one direction bit per node of a binary tree
+ * over the slots, heap-ordered from node 1, each pointing away from the most
+ * recent access below it. Hits update this state from the const lookup paths,
+ * so like the counters it sits behind a pointer; concurrent models update it
+ * with relaxed atomics and get approximate recency. Round-robin models have
+ * none.
+ */
+struct tlb_recency {
+    _Atomic uint64_t clock;
+    _Atomic uint64_t *stamps; /* NULL unless LRU or FIFO */
+    _Atomic uint8_t *plru;    /* NULL unless PLRU */
+    uint32_t plru_leaves;     /* tlb_entries rounded up to a power of two */
+};
+
+#define TLB_RANDOM_SEED 0x9E3779B97F4A7C15ULL
+
+/*
+ * Set-associative TLBs (cfg.tlb_ways) give each set its own round-robin way.
+ * A cursor from an older TLB generation reads as way 0, so flushes stay O(1).
+ * Lookups do not need the set: the index already finds any entry in one probe
+ * per span, and placement alone decides which entries survive.
+ */
+struct tlb_set_cursor {
+    uint64_t generation;
+    uint32_t way;
+};
+
+/*
+ * The backing store is split into pages of STORE_PAGE_WORDS words reached
+ * through a two-level directory: store_dir[l1] points at an L2 table of
+ * STORE_DIR_L2_ENTRIES page pointers. A NULL L2 table or page reads as zero,
+ * as does a page from an older generation; writes zero a stale page before
+ * reusing it. Dense models populate every page up front; sparse models
+ * allocate a page (and its L2 table) on the first write that touches it.
+ *
+ * Pages are reference counted so that forks and snapshots can share them
+ * copy-on-write: a write to a page with refs > 1 first installs a private
+ * copy in the writer's directory.
+ */
+#define STORE_PAGE_WORD_BITS 10U
+#define STORE_PAGE_WORDS (1ULL << STORE_PAGE_WORD_BITS)
+#define STORE_DIR_L2_BITS 10U
+#define STORE_DIR_L2_ENTRIES (1U << STORE_DIR_L2_BITS)
+#define STORE_DIR_MAX_L1_ENTRIES (1U << 20U)
+
+struct store_page {
+    uint64_t generation;
+    _Atomic uint32_t refs; /* shared across models, which may run on different threads */
+    _Alignas(8) uint8_t data[]; /* aligned so seqlock copies can move whole 64-bit words */
+};
+
+/*
+ * Directory pointers are published with release stores and read with acquire
+ * loads so that lock-free readers in concurrent mode never observe a table or
+ * page before its initialisation.
+ */
+#define DIR_LOAD(ptr) __atomic_load_n(&(ptr), __ATOMIC_ACQUIRE)
+#define DIR_STORE(ptr, value) __atomic_store_n(&(ptr), (value), __ATOMIC_RELEASE)
+
+/*
+ * State that seqlock readers load while a writer may be storing it (TLB
+ * entries, index buckets, the fields tlb_lookup() consults and backing-store
+ * words) is accessed with relaxed atomics on both sides, so a torn read is a
+ * stale value the sequence check rejects rather than a data race. The writer
+ * holding the lock may read it plainly. Both compile to ordinary moves.
+ */
+#define SEQ_LOAD(field) __atomic_load_n(&(field), __ATOMIC_RELAXED)
+#define SEQ_STORE(field, value) __atomic_store_n(&(field), (value), __ATOMIC_RELAXED)
+
+/*
+ * Optional data cache (cfg.cache_size != 0). It holds tags, dirty bits and
+ * replacement state only; data always lives in the backing store, so the
+ * cache changes statistics but never results. The ways of a set are
+ * consecutive entries of each array, and tags hold the physical line number
+ * (mem_index >> line_bits), CACHE_LINE_EMPTY for an invalid line. Like the
+ * counters it sits behind a pointer so that the const read paths can update
+ * it. Concurrent models have no cache, so nothing here is atomic.
+ */
+#define CACHE_LINE_EMPTY UINT64_MAX
+
+struct data_cache {
+    uint64_t *tags;
+    uint64_t *stamps;    /* last use (LRU) or fill (FIFO); NULL for other policies */
+    uint8_t *plru;       /* ways direction bits per set, heap-ordered from node 1; NULL unless PLRU */
+    uint32_t *next_way;  /* round-robin way per set; NULL unless ROUND_ROBIN */
+    bool *dirty;
+    uint64_t clock;
+    uint64_t random;     /* xorshift state for MEMORY_MODEL_TLB_POLICY_RANDOM */
+    uint64_t lines;
+    uint64_t set_mask;   /* sets - 1 */
+    uint64_t line_words; /* words per line, a power of two */
+    uint32_t line_bits;  /* log2(line_words) */
+    uint32_t ways;
+};
+
+/*
+ * Concurrent mode (cfg.concurrent). TLB updates are serialised by a sequence
+ * lock: load_tlb makes tlb_seq odd for the duration of the update and readers
+ * retry any lookup that overlapped one. Backing-store data is guarded the same
+ * way per stripe of pages, except that writers also hold the stripe (odd
+ * sequence) for the read-modify-write, so masked writes to different bytes of
+ * one word never lose each other's updates. Page and L2-table allocation is
+ * additionally serialised by dir_lock.
+ */
+#define SYNC_ALIGNMENT 64U
+#define SYNC_STRIPE_BITS 6U
+#define SYNC_STRIPES (1U << SYNC_STRIPE_BITS)
+
+struct sync_stripe {
+    _Alignas(SYNC_ALIGNMENT) _Atomic uint64_t seq;
+};
+
+struct model_sync {
+    _Alignas(SYNC_ALIGNMENT) _Atomic uint64_t tlb_seq;
+    _Alignas(SYNC_ALIGNMENT) atomic_flag dir_lock;
+    struct sync_stripe stripes[SYNC_STRIPES];
+};
+
+struct memory_model_snapshot {
+    memory_model_t *state;
+};
+
+/*
+ * Activity counters live in their own cache-line-aligned block so that the
+ * const read/translate paths can update them without dirtying the lines that
+ * hold the read-mostly model geometry. Concurrent models keep one shard per
+ * group of threads so that counting does not serialise them; queries sum the
+ * shards. Build with MEMORY_MODEL_ENABLE_STATS=0 to compile every update out
+ * of the hot paths.
+ */
+#ifndef MEMORY_MODEL_ENABLE_STATS
+#define MEMORY_MODEL_ENABLE_STATS 1
+#endif
+
+#define COUNTERS_ALIGNMENT 64U
+#define COUNTER_SHARDS 16U
+#define MISS_TABLE_MIN_BITS 6U
+
+/* Open-addressed per-page miss counts; misses == 0 marks an empty bucket. */
+struct miss_bucket {
+    uint64_t virt_page;
+    uint64_t misses;
+};
+
+struct counter_shard {
+    _Alignas(COUNTERS_ALIGNMENT) _Atomic uint64_t reads;
+    _Atomic uint64_t writes;
+    _Atomic uint64_t tlb_loads;
+    _Atomic uint64_t tlb_hits;
+    _Atomic uint64_t tlb_misses;
+    _Atomic uint64_t tlb_evictions;
+    _Atomic uint64_t walks;
+    _Atomic uint64_t walk_pte_reads;
+    _Atomic uint64_t walk_faults;
+    _Atomic uint64_t cache_read_hits;
+    _Atomic uint64_t cache_read_misses;
+    _Atomic uint64_t cache_write_hits;
+    _Atomic uint64_t cache_write_misses;
+    _Atomic uint64_t cache_writebacks;
+};
+
+struct model_counters {
+    struct counter_shard *shards;
+    _Atomic uint64_t *slot_hits; /* shard_count rows of tlb_entries */
+    uint32_t shard_count;
+    uint32_t tlb_entries;
+
+    atomic_flag miss_lock; /* taken in concurrent mode only */
+    struct miss_bucket *miss_table;
+    uint32_t miss_bits;
+    size_t miss_pages;
+};
+
+#if MEMORY_MODEL_ENABLE_STATS
+#define COUNT(model, field) counter_add((model), &counter_shard_for((model))->field)
+#define COUNT_N(model, field, amount) counter_add_n((model), &counter_shard_for((model))->field, (amount))
+#define COUNT_SLOT_HIT(model, slot) \
+    counter_add((model), &(model)->counters->slot_hits[(size_t)counter_shard_index((model)) * \
+                                                          (model)->cfg.tlb_entries + (slot)])
+#else
+#define COUNT(model, field) ((void)0)
+#define COUNT_N(model, field, amount) ((void)0)
+#define COUNT_SLOT_HIT(model, slot) ((void)0)
+#endif
+
+/*
+ * Masked kernels for words wider than 64 bits, selected per model at create
+ * time. A read keeps the selected bytes of a stored word and zeroes the rest;
+ * a write blends the selected input bytes into the stored word.
+ */
+typedef void (*wide_read_fn)(uint8_t *out, const uint8_t *word, uint64_t byte_mask, uint32_t bytes);
+typedef void (*wide_write_fn)(uint8_t *word, const uint8_t *in, uint64_t byte_mask, uint32_t bytes);
+
+struct wide_kernels {
+    memory_model_simd_t level;
+    wide_read_fn read;
+    wide_write_fn write;
 };
 
 struct memory_model {
     memory_model_config_t cfg;
     struct tlb_entry *tlb;
-    uint8_t *memory;
+    struct tlb_index_bucket *tlb_index;
+    struct model_counters *counters;
+    struct model_sync *sync; /* NULL unless cfg.concurrent */
+    struct tlb_recency *recency; /* NULL for round-robin replacement */
+    struct data_cache *cache;    /* NULL unless cfg.cache_size */
+
+    struct store_page ***store_dir;
+    uint32_t store_l1_entries;
+    uint64_t store_pages;
+    size_t store_page_bytes;
+    size_t resident_pages;
+
+    uint32_t tlb_index_bits;
+    uint64_t tlb_index_mask;
+
+    uint64_t tlb_generation;
+    uint64_t store_generation;
+    uint64_t direct_epoch; /* advances whenever a memory_model_get_direct() grant may go stale */
 
     uint32_t tlb_write_ptr;
     uint32_t active_entries;
+    uint32_t tlb_fill_cursor; /* where policy fills resume looking for an empty slot */
+    uint32_t tlb_ways;        /* slots per set; tlb_entries when fully associative */
+    uint64_t tlb_set_mask;    /* sets - 1 */
+    struct tlb_set_cursor *tlb_set_next; /* NULL when fully associative */
+    uint64_t tlb_random;      /* xorshift state for MEMORY_MODEL_TLB_POLICY_RANDOM */
+
+    uint64_t tlb_span_classes; /* bit s set while a live entry has span_bits == s */
+    uint32_t tlb_span_live[TLB_MAX_SPAN_BITS + 1U];
+    uint32_t tlb_asid; /* lookups match and loads tag this ASID */
+    memory_model_page_table_t page_table; /* levels == 0 while no walker is attached */
 
     uint32_t bytes_per_word;
+    uint32_t lane_bytes;     /* bytes reached by the 64-bit API: min(bytes_per_word, 8) */
+    uint32_t word_byte_mask; /* valid byte_mask bits for the 64-bit API */
+    const struct wide_kernels *wide;
     uint32_t page_offset_bits;
     uint32_t mem_addr_bits;
 
@@ -31,7 +312,7 @@ struct memory_model {
     uint64_t data_mask;
 };
 
-static bool is_power_of_two(uint32_t value)
+static bool is_power_of_two(uint64_t value)
 {
     return value != 0U && (value & (value - 1U)) == 0U;
 }
@@ -51,6 +332,21 @@ static uint32_t ceil_log2_u32(uint32_t value)
     return width;
 }
 
+static uint32_t ceil_log2_u64(uint64_t value)
+{
+    if (value <= 1U) {
+        return 0U;
+    }
+
+    uint32_t width = 0U;
+    uint64_t tmp = value - 1U;
+    while (tmp > 0U) {
+        tmp >>= 1U;
+        width++;
+    }
+    return width;
+}
+
 static uint64_t mask_from_width(uint32_t width)
 {
     if (width == 0U) {
@@ -73,293 +369,3621 @@ static uint32_t byte_mask_for_word(uint32_t bytes_per_word)
     return (1U << bytes_per_word) - 1U;
 }
 
-memory_model_config_t memory_model_config_default(void)
+static uint32_t tlb_index_hash(const memory_model_t *model, uint64_t virt_page, uint32_t span_bits,
+                               uint32_t asid)
 {
-    memory_model_config_t cfg;
-    cfg.virt_addr_width = 32U;
-    cfg.phys_addr_width = 28U;
-    cfg.page_size = 4096U;
-    cfg.data_width = 64U;
-    cfg.mem_depth = 16384U;
-    cfg.tlb_entries = 256U;
-    return cfg;
+    /* Fibonacci hashing: the top bits of the product are well mixed. */
+    uint64_t tag = ((uint64_t)asid << 6U) | span_bits;
+    uint64_t product = (virt_page ^ (tag << 42U)) * 0x9E3779B97F4A7C15ULL;
+    return (uint32_t)(product >> (64U - model->tlb_index_bits));
 }
 
-memory_model_error_t memory_model_create(const memory_model_config_t *config,
-                                          memory_model_t **model_out)
+static inline bool tlb_entry_live(const memory_model_t *model, const struct tlb_entry *entry)
 {
-    if (model_out == NULL) {
-        return MEMORY_MODEL_ERROR_BAD_ARGUMENT;
-    }
-
-    *model_out = NULL;
+    return SEQ_LOAD(entry->valid) && SEQ_LOAD(entry->generation) == SEQ_LOAD(model->tlb_generation);
+}
 
-    memory_model_config_t local_cfg = config != NULL ? *config : memory_model_config_default();
+static inline bool tlb_bucket_empty(const memory_model_t *model, const struct tlb_index_bucket *bucket)
+{
+    return SEQ_LOAD(bucket->count) == 0U || SEQ_LOAD(bucket->generation) != SEQ_LOAD(model->tlb_generation);
+}
 
-    if (local_cfg.data_width == 0U || (local_cfg.data_width % 8U) != 0U || local_cfg.data_width > 64U) {
-        return MEMORY_MODEL_ERROR_UNSUPPORTED;
-    }
-    if (local_cfg.page_size == 0U || !is_power_of_two(local_cfg.page_size)) {
-        return MEMORY_MODEL_ERROR_BAD_ARGUMENT;
-    }
-    if (local_cfg.mem_depth == 0U || local_cfg.tlb_entries == 0U) {
-        return MEMORY_MODEL_ERROR_BAD_ARGUMENT;
-    }
-    if (local_cfg.virt_addr_width == 0U || local_cfg.virt_addr_width > 64U) {
-        return MEMORY_MODEL_ERROR_BAD_ARGUMENT;
+static struct tlb_index_bucket *tlb_index_find(const memory_model_t *model, uint64_t virt_page,
+                                               uint32_t span_bits, uint32_t asid)
+{
+    uint32_t pos = tlb_index_hash(model, virt_page, span_bits, asid);
+    /* The index is at most half full; the bound only matters to racing readers. */
+    for (uint64_t probes = 0U; probes <= model->tlb_index_mask; ++probes) {
+        struct tlb_index_bucket *bucket = &model->tlb_index[pos];
+        if (tlb_bucket_empty(model, bucket)) {
+            return NULL;
+        }
+        if (SEQ_LOAD(bucket->virt_page) == virt_page && SEQ_LOAD(bucket->span_bits) == span_bits &&
+            SEQ_LOAD(bucket->asid) == asid) {
+            return bucket;
+        }
+        pos = (uint32_t)((pos + 1U) & model->tlb_index_mask);
     }
-    if (local_cfg.phys_addr_width == 0U || local_cfg.phys_addr_width > 64U) {
-        return MEMORY_MODEL_ERROR_BAD_ARGUMENT;
+    return NULL;
+}
+
+static void tlb_index_insert(memory_model_t *model, uint64_t virt_page, uint32_t span_bits, uint32_t asid,
+                             uint32_t slot)
+{
+    uint32_t pos = tlb_index_hash(model, virt_page, span_bits, asid);
+    for (;;) {
+        struct tlb_index_bucket *bucket = &model->tlb_index[pos];
+        if (tlb_bucket_empty(model, bucket)) {
+            SEQ_STORE(bucket->virt_page, virt_page);
+            SEQ_STORE(bucket->generation, model->tlb_generation);
+            SEQ_STORE(bucket->span_bits, span_bits);
+            SEQ_STORE(bucket->asid, asid);
+            SEQ_STORE(bucket->slot, slot);
+            SEQ_STORE(bucket->count, 1U);
+            return;
+        }
+        if (bucket->virt_page == virt_page && bucket->span_bits == span_bits && bucket->asid == asid) {
+            if (slot < bucket->slot) {
+                SEQ_STORE(bucket->slot, slot);
+            }
+            SEQ_STORE(bucket->count, bucket->count + 1U);
+            return;
+        }
+        pos = (uint32_t)((pos + 1U) & model->tlb_index_mask);
     }
+}
 
-    uint32_t page_offset_bits = ceil_log2_u32(local_cfg.page_size);
-    if (page_offset_bits > local_cfg.virt_addr_width || page_offset_bits > local_cfg.phys_addr_width) {
-        return MEMORY_MODEL_ERROR_BAD_ARGUMENT;
+/* Backward-shift deletion keeps probe chains intact without tombstones. */
+static void tlb_index_erase(memory_model_t *model, struct tlb_index_bucket *bucket)
+{
+    uint32_t hole = (uint32_t)(bucket - model->tlb_index);
+    uint32_t pos = hole;
+
+    for (;;) {
+        pos = (uint32_t)((pos + 1U) & model->tlb_index_mask);
+        struct tlb_index_bucket *next = &model->tlb_index[pos];
+        if (tlb_bucket_empty(model, next)) {
+            break;
+        }
+        uint32_t home = tlb_index_hash(model, next->virt_page, next->span_bits, next->asid);
+        /* Move the entry back only if its home slot does not lie in (hole, pos]. */
+        bool home_in_range = (hole <= pos) ? (home > hole && home <= pos)
+                                           : (home > hole || home <= pos);
+        if (!home_in_range) {
+            struct tlb_index_bucket *dst = &model->tlb_index[hole];
+            SEQ_STORE(dst->virt_page, next->virt_page);
+            SEQ_STORE(dst->generation, next->generation);
+            SEQ_STORE(dst->span_bits, next->span_bits);
+            SEQ_STORE(dst->asid, next->asid);
+            SEQ_STORE(dst->slot, next->slot);
+            SEQ_STORE(dst->count, next->count);
+            hole = pos;
+        }
     }
 
-    memory_model_t *model = calloc(1U, sizeof(*model));
-    if (model == NULL) {
-        return MEMORY_MODEL_ERROR_OUT_OF_MEMORY;
+    SEQ_STORE(model->tlb_index[hole].count, 0U);
+}
+
+/*
+ * Drop the reference that TLB slot @slot holds on @virt_page at @span_bits in
+ * @asid. The slot must already be marked invalid so that a rescan for the
+ * next-lowest duplicate does not find it again.
+ */
+static void tlb_index_release(memory_model_t *model, uint64_t virt_page, uint32_t span_bits, uint32_t asid,
+                              uint32_t slot)
+{
+    struct tlb_index_bucket *bucket = tlb_index_find(model, virt_page, span_bits, asid);
+    if (bucket == NULL) {
+        return;
     }
 
-    model->cfg = local_cfg;
-    model->bytes_per_word = (uint32_t)(local_cfg.data_width / 8U);
-    model->page_offset_bits = page_offset_bits;
-    model->page_offset_mask = mask_from_width(page_offset_bits);
-    model->virt_addr_mask = mask_from_width(local_cfg.virt_addr_width);
-    model->phys_addr_mask = mask_from_width(local_cfg.phys_addr_width);
-    model->data_mask = mask_from_width(local_cfg.data_width);
+    if (bucket->count <= 1U) {
+        tlb_index_erase(model, bucket);
+        return;
+    }
 
-    model->mem_addr_bits = ceil_log2_u32(local_cfg.mem_depth);
-    model->mem_depth_pow2 = is_power_of_two(local_cfg.mem_depth);
-    if (model->mem_depth_pow2 && local_cfg.mem_depth > 0U) {
-        model->mem_addr_mask = (uint64_t)local_cfg.mem_depth - 1ULL;
-    } else if (model->mem_addr_bits >= 64U) {
-        model->mem_addr_mask = UINT64_MAX;
-    } else if (model->mem_addr_bits == 0U) {
-        model->mem_addr_mask = 0ULL;
-    } else {
-        model->mem_addr_mask = (1ULL << model->mem_addr_bits) - 1ULL;
+    SEQ_STORE(bucket->count, bucket->count - 1U);
+    if (bucket->slot != slot) {
+        return;
     }
 
-    size_t total_bytes = (size_t)local_cfg.mem_depth * (size_t)model->bytes_per_word;
-    if (local_cfg.mem_depth != 0U && model->bytes_per_word != 0U) {
-        if (total_bytes / local_cfg.mem_depth != (size_t)model->bytes_per_word) {
-            free(model);
-            return MEMORY_MODEL_ERROR_UNSUPPORTED;
+    for (uint32_t i = 0U; i < model->cfg.tlb_entries; ++i) {
+        const struct tlb_entry *entry = &model->tlb[i];
+        if (tlb_entry_live(model, entry) && entry->virt_page == virt_page && entry->span_bits == span_bits &&
+            entry->asid == asid) {
+            SEQ_STORE(bucket->slot, i);
+            return;
         }
     }
+}
 
-    model->memory = calloc(total_bytes, 1U);
-    if (model->memory == NULL) {
-        free(model);
-        return MEMORY_MODEL_ERROR_OUT_OF_MEMORY;
+static struct model_counters *counters_create(uint32_t tlb_entries, bool concurrent)
+{
+#if MEMORY_MODEL_ENABLE_STATS
+    struct model_counters *counters = calloc(1U, sizeof(*counters));
+    if (counters == NULL) {
+        return NULL;
     }
 
-    model->tlb = calloc(local_cfg.tlb_entries, sizeof(struct tlb_entry));
-    if (model->tlb == NULL) {
-        free(model->memory);
-        free(model);
-        return MEMORY_MODEL_ERROR_OUT_OF_MEMORY;
+    counters->shard_count = concurrent ? COUNTER_SHARDS : 1U;
+    counters->tlb_entries = tlb_entries;
+    counters->miss_bits = MISS_TABLE_MIN_BITS;
+    atomic_flag_clear(&counters->miss_lock);
+
+    counters->shards = aligned_alloc(COUNTERS_ALIGNMENT, sizeof(struct counter_shard) * counters->shard_count);
+    counters->slot_hits = calloc((size_t)counters->shard_count * tlb_entries, sizeof(*counters->slot_hits));
+    counters->miss_table = calloc((size_t)1U << counters->miss_bits, sizeof(struct miss_bucket));
+    if (counters->shards == NULL || counters->slot_hits == NULL || counters->miss_table == NULL) {
+        free(counters->shards);
+        free(counters->slot_hits);
+        free(counters->miss_table);
+        free(counters);
+        return NULL;
     }
+    memset(counters->shards, 0, sizeof(struct counter_shard) * counters->shard_count);
+    return counters;
+#else
+    (void)tlb_entries;
+    (void)concurrent;
+    /* Any non-NULL value; the block is never dereferenced when stats are off. */
+    static struct model_counters unused;
+    return &unused;
+#endif
+}
 
-    memory_model_error_t reset_status = memory_model_reset(model);
-    if (reset_status != MEMORY_MODEL_ERROR_OK) {
-        memory_model_destroy(model);
-        return reset_status;
+static void counters_destroy(struct model_counters *counters)
+{
+#if MEMORY_MODEL_ENABLE_STATS
+    if (counters == NULL) {
+        return;
     }
+    free(counters->shards);
+    free(counters->slot_hits);
+    free(counters->miss_table);
+    free(counters);
+#else
+    (void)counters;
+#endif
+}
 
-    *model_out = model;
-    return MEMORY_MODEL_ERROR_OK;
+static bool tlb_policy_tracks_hits(memory_model_tlb_policy_t policy)
+{
+    return policy == MEMORY_MODEL_TLB_POLICY_LRU || policy == MEMORY_MODEL_TLB_POLICY_PLRU;
 }
 
-void memory_model_destroy(memory_model_t *model)
+static bool tlb_policy_has_recency(memory_model_tlb_policy_t policy)
 {
-    if (model == NULL) {
+    return tlb_policy_tracks_hits(policy) || policy == MEMORY_MODEL_TLB_POLICY_FIFO;
+}
+
+static void recency_destroy(struct tlb_recency *recency)
+{
+    if (recency == NULL) {
         return;
     }
-
-    free(model->tlb);
-    free(model->memory);
-    free(model);
+    free(recency->stamps);
+    free(recency->plru);
+    free(recency);
 }
 
-memory_model_error_t memory_model_reset(memory_model_t *model)
+/* Allocate replacement state for @policy, copying @source when not NULL. */
+static struct tlb_recency *recency_create(memory_model_tlb_policy_t policy, uint32_t tlb_entries,
+                                          const struct tlb_recency *source)
 {
-    if (model == NULL) {
-        return MEMORY_MODEL_ERROR_BAD_ARGUMENT;
+    struct tlb_recency *recency = calloc(1U, sizeof(*recency));
+    if (recency == NULL) {
+        return NULL;
     }
 
-    size_t total_bytes = (size_t)model->cfg.mem_depth * (size_t)model->bytes_per_word;
-    if (model->memory != NULL && total_bytes > 0U) {
-        memset(model->memory, 0, total_bytes);
+    recency->plru_leaves = 1U;
+    while (recency->plru_leaves < tlb_entries) {
+        recency->plru_leaves <<= 1U;
     }
-    if (model->tlb != NULL && model->cfg.tlb_entries > 0U) {
-        memset(model->tlb, 0, sizeof(struct tlb_entry) * (size_t)model->cfg.tlb_entries);
+    if (policy == MEMORY_MODEL_TLB_POLICY_PLRU) {
+        recency->plru = calloc(recency->plru_leaves, sizeof(*recency->plru));
+        if (recency->plru == NULL) {
+            recency_destroy(recency);
+            return NULL;
+        }
+    } else {
+        recency->stamps = calloc(tlb_entries, sizeof(*recency->stamps));
+        if (recency->stamps == NULL) {
+            recency_destroy(recency);
+            return NULL;
+        }
     }
 
-    model->tlb_write_ptr = 0U;
-    model->active_entries = 0U;
+    if (source != NULL) {
+        atomic_store_explicit(&recency->clock, atomic_load_explicit(&source->clock, memory_order_relaxed),
+                              memory_order_relaxed);
+        if (recency->plru != NULL) {
+            memcpy((void *)recency->plru, (const void *)source->plru, recency->plru_leaves * sizeof(*recency->plru));
+        } else {
+            memcpy((void *)recency->stamps, (const void *)source->stamps, tlb_entries * sizeof(*recency->stamps));
+        }
+    }
+    return recency;
+}
 
-    return MEMORY_MODEL_ERROR_OK;
+static inline void spin_pause(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
 }
 
-memory_model_error_t memory_model_load_tlb(memory_model_t *model,
-                                           uint64_t virt_base,
-                                           uint64_t phys_base)
+static inline void spin_lock(atomic_flag *lock)
 {
-    if (model == NULL || model->tlb == NULL || model->cfg.tlb_entries == 0U) {
-        return MEMORY_MODEL_ERROR_BAD_ARGUMENT;
+    while (atomic_flag_test_and_set_explicit(lock, memory_order_acquire)) {
+        spin_pause();
     }
+}
 
-    uint32_t index = model->tlb_write_ptr;
-    struct tlb_entry *entry = &model->tlb[index];
+static inline void spin_unlock(atomic_flag *lock)
+{
+    atomic_flag_clear_explicit(lock, memory_order_release);
+}
 
-    bool was_valid = entry->valid;
-    entry->valid = true;
-    entry->virt_base = virt_base & model->virt_addr_mask;
-    entry->phys_base = phys_base & model->phys_addr_mask;
+#if MEMORY_MODEL_ENABLE_STATS
+/* Threads are assigned counter shards round-robin on first use. */
+static _Thread_local uint32_t thread_counter_shard;
+static atomic_uint next_counter_shard;
 
-    if (!was_valid && model->active_entries < model->cfg.tlb_entries) {
-        model->active_entries++;
+static inline uint32_t counter_shard_index(const memory_model_t *model)
+{
+    if (model->sync == NULL) {
+        return 0U;
     }
-
-    if (index + 1U < model->cfg.tlb_entries) {
-        model->tlb_write_ptr = index + 1U;
-    } else {
-        model->tlb_write_ptr = 0U;
+    if (thread_counter_shard == 0U) {
+        thread_counter_shard = atomic_fetch_add_explicit(&next_counter_shard, 1U, memory_order_relaxed) + 1U;
     }
+    return (thread_counter_shard - 1U) & (COUNTER_SHARDS - 1U);
+}
 
-    return MEMORY_MODEL_ERROR_OK;
+static inline struct counter_shard *counter_shard_for(const memory_model_t *model)
+{
+    return &model->counters->shards[counter_shard_index(model)];
 }
 
-memory_model_status_t memory_model_translate(const memory_model_t *model,
-                                              uint64_t virt_addr,
-                                              uint64_t *phys_addr_out)
+/* Single-threaded models use plain load/store; only shared shards pay for a locked add. */
+static inline void counter_add_n(const memory_model_t *model, _Atomic uint64_t *counter, uint64_t amount)
 {
-    if (phys_addr_out == NULL || model == NULL) {
-        if (phys_addr_out != NULL) {
-            *phys_addr_out = 0ULL;
-        }
-        return MEMORY_MODEL_STATUS_ERR_ACCESS;
+    if (model->sync != NULL) {
+        atomic_fetch_add_explicit(counter, amount, memory_order_relaxed);
+    } else {
+        atomic_store_explicit(counter, atomic_load_explicit(counter, memory_order_relaxed) + amount,
+                              memory_order_relaxed);
     }
+}
 
-    uint64_t masked_virt = virt_addr & model->virt_addr_mask;
-    uint64_t virt_page = masked_virt >> model->page_offset_bits;
-    uint64_t page_offset = masked_virt & model->page_offset_mask;
-
-    for (uint32_t i = 0U; i < model->cfg.tlb_entries; ++i) {
-        const struct tlb_entry *entry = &model->tlb[i];
-        if (!entry->valid) {
-            continue;
-        }
+static inline void counter_add(const memory_model_t *model, _Atomic uint64_t *counter)
+{
+    counter_add_n(model, counter, 1U);
+}
 
-        uint64_t entry_page = (entry->virt_base & model->virt_addr_mask) >> model->page_offset_bits;
-        if (entry_page == virt_page) {
-            uint64_t phys_base = entry->phys_base & model->phys_addr_mask;
-            uint64_t combined = (phys_base & ~model->page_offset_mask) | page_offset;
-            *phys_addr_out = combined & model->phys_addr_mask;
-            return MEMORY_MODEL_STATUS_OK;
-        }
+static uint64_t counter_sum(const struct model_counters *counters, size_t offset)
+{
+    uint64_t total = 0U;
+    for (uint32_t shard = 0U; shard < counters->shard_count; ++shard) {
+        const _Atomic uint64_t *counter =
+            (const _Atomic uint64_t *)((const char *)&counters->shards[shard] + offset);
+        total += atomic_load_explicit(counter, memory_order_relaxed);
     }
+    return total;
+}
 
-    *phys_addr_out = 0ULL;
-    return MEMORY_MODEL_STATUS_ERR_ADDR;
+static uint32_t miss_table_hash(uint64_t virt_page, uint32_t bits)
+{
+    return (uint32_t)((virt_page * 0x9E3779B97F4A7C15ULL) >> (64U - bits));
 }
 
-memory_model_status_t memory_model_read(const memory_model_t *model,
-                                         uint64_t virt_addr,
-                                         uint32_t byte_mask,
-                                         uint64_t *data_out)
+static struct miss_bucket *miss_table_slot(struct miss_bucket *table, uint32_t bits, uint64_t virt_page)
 {
-    if (data_out == NULL || model == NULL) {
-        if (data_out != NULL) {
-            *data_out = 0ULL;
-        }
-        return MEMORY_MODEL_STATUS_ERR_ACCESS;
+    uint32_t mask = (1U << bits) - 1U;
+    uint32_t pos = miss_table_hash(virt_page, bits);
+    while (table[pos].misses != 0U && table[pos].virt_page != virt_page) {
+        pos = (pos + 1U) & mask;
     }
+    return &table[pos];
+}
 
-    uint32_t valid_mask = byte_mask_for_word(model->bytes_per_word);
-    if ((byte_mask & ~valid_mask) != 0U) {
-        *data_out = 0ULL;
-        return MEMORY_MODEL_STATUS_ERR_ACCESS;
+/* Translation misses are the slow path, so the histogram may allocate here. */
+static void counters_record_miss_locked(struct model_counters *counters, uint64_t virt_page)
+{
+    if ((counters->miss_pages + 1U) * 2U > ((size_t)1U << counters->miss_bits)) {
+        uint32_t bits = counters->miss_bits + 1U;
+        struct miss_bucket *table = calloc((size_t)1U << bits, sizeof(*table));
+        if (table == NULL) {
+            return; /* keep the totals, drop the per-page detail */
+        }
+        for (size_t i = 0U; i < ((size_t)1U << counters->miss_bits); ++i) {
+            if (counters->miss_table[i].misses != 0U) {
+                *miss_table_slot(table, bits, counters->miss_table[i].virt_page) = counters->miss_table[i];
+            }
+        }
+        free(counters->miss_table);
+        counters->miss_table = table;
+        counters->miss_bits = bits;
     }
 
-    uint32_t effective_mask = byte_mask;
-    if (effective_mask == 0U) {
-        effective_mask = valid_mask;
+    struct miss_bucket *bucket = miss_table_slot(counters->miss_table, counters->miss_bits, virt_page);
+    if (bucket->misses == 0U) {
+        bucket->virt_page = virt_page;
+        counters->miss_pages++;
     }
+    bucket->misses++;
+}
 
-    uint64_t phys_addr = 0ULL;
-    memory_model_status_t translate_status = memory_model_translate(model, virt_addr, &phys_addr);
-    if (translate_status != MEMORY_MODEL_STATUS_OK) {
-        *data_out = 0ULL;
-        return translate_status;
+static void counters_record_miss(const memory_model_t *model, uint64_t virt_page)
+{
+    struct model_counters *counters = model->counters;
+    COUNT(model, tlb_misses);
+    if (model->sync != NULL) {
+        spin_lock(&counters->miss_lock);
+        counters_record_miss_locked(counters, virt_page);
+        spin_unlock(&counters->miss_lock);
+    } else {
+        counters_record_miss_locked(counters, virt_page);
     }
+}
+#endif
 
-    size_t mem_index = (size_t)(phys_addr & model->mem_addr_mask);
-    if (!model->mem_depth_pow2 && mem_index >= model->cfg.mem_depth) {
-        *data_out = 0ULL;
-        return MEMORY_MODEL_STATUS_ERR_ACCESS;
+static struct model_sync *sync_create(void)
+{
+    struct model_sync *sync = aligned_alloc(SYNC_ALIGNMENT, sizeof(*sync));
+    if (sync == NULL) {
+        return NULL;
     }
+    memset(sync, 0, sizeof(*sync));
+    atomic_flag_clear(&sync->dir_lock);
+    return sync;
+}
 
-    size_t offset = mem_index * (size_t)model->bytes_per_word;
-    uint64_t value = 0ULL;
-
-    for (uint32_t i = 0U; i < model->bytes_per_word; ++i) {
-        if ((effective_mask & (1U << i)) == 0U) {
-            continue;
+/*
+ * Sequence-lock primitives. A writer owns the lock while the sequence is odd;
+ * readers snapshot an even sequence, read, and retry if it has moved.
+ */
+static inline void seq_write_begin(_Atomic uint64_t *seq)
+{
+    uint64_t value = atomic_load_explicit(seq, memory_order_relaxed);
+    for (;;) {
+        if ((value & 1U) == 0U &&
+            atomic_compare_exchange_weak_explicit(seq, &value, value + 1U, memory_order_acquire,
+                                                  memory_order_relaxed)) {
+            break;
         }
-        uint64_t byte_val = (uint64_t)model->memory[offset + i];
-        value |= byte_val << (i * 8U);
+        spin_pause();
+        value = atomic_load_explicit(seq, memory_order_relaxed);
     }
+    atomic_thread_fence(memory_order_release);
+}
 
-    value &= model->data_mask;
-    *data_out = value;
-    return MEMORY_MODEL_STATUS_OK;
+static inline void seq_write_end(_Atomic uint64_t *seq)
+{
+    atomic_fetch_add_explicit(seq, 1U, memory_order_release);
 }
 
-memory_model_status_t memory_model_write(memory_model_t *model,
-                                          uint64_t virt_addr,
-                                          uint32_t byte_mask,
-                                          uint64_t data)
+static inline uint64_t seq_read_begin(_Atomic uint64_t *seq)
 {
-    if (model == NULL) {
-        return MEMORY_MODEL_STATUS_ERR_ACCESS;
+    uint64_t value = atomic_load_explicit(seq, memory_order_acquire);
+    while ((value & 1U) != 0U) {
+        spin_pause();
+        value = atomic_load_explicit(seq, memory_order_acquire);
     }
+    return value;
+}
 
-    uint32_t valid_mask = byte_mask_for_word(model->bytes_per_word);
-    if ((byte_mask & ~valid_mask) != 0U) {
+static inline bool seq_read_retry(_Atomic uint64_t *seq, uint64_t start)
+{
+    atomic_thread_fence(memory_order_acquire);
+    return atomic_load_explicit(seq, memory_order_relaxed) != start;
+}
+
+static inline _Atomic uint64_t *sync_stripe_seq(const memory_model_t *model, uint64_t mem_index)
+{
+    uint64_t page = mem_index >> STORE_PAGE_WORD_BITS;
+    return &model->sync->stripes[page & (SYNC_STRIPES - 1U)].seq;
+}
+
+/*
+ * Word-granular data kernels. Backing-store words are kept in little-endian
+ * byte order (byte i of a word holds data bits [8*i+7:8*i]), so on little-endian
+ * hosts a word maps directly onto a native integer load/store; other hosts fall
+ * back to assembling the value with shifts.
+ */
+static const uint32_t nibble_to_byte_mask[16] = {
+    0x00000000U, 0x000000FFU, 0x0000FF00U, 0x0000FFFFU,
+    0x00FF0000U, 0x00FF00FFU, 0x00FFFF00U, 0x00FFFFFFU,
+    0xFF000000U, 0xFF0000FFU, 0xFF00FF00U, 0xFF00FFFFU,
+    0xFFFF0000U, 0xFFFF00FFU, 0xFFFFFF00U, 0xFFFFFFFFU,
+};
+
+/* Expand a per-byte enable mask into a per-bit data mask. */
+static inline uint64_t expand_byte_mask(uint32_t byte_mask)
+{
+    return (uint64_t)nibble_to_byte_mask[byte_mask & 0xFU] |
+           ((uint64_t)nibble_to_byte_mask[(byte_mask >> 4U) & 0xFU] << 32U);
+}
+
+#if defined(__BYTE_ORDER__) && defined(__ORDER_LITTLE_ENDIAN__) && \
+    __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define MEMORY_MODEL_HOST_LITTLE_ENDIAN 1
+#else
+#define MEMORY_MODEL_HOST_LITTLE_ENDIAN 0
+#endif
+
+static inline uint64_t load_word(const uint8_t *src, uint32_t bytes)
+{
+#if MEMORY_MODEL_HOST_LITTLE_ENDIAN
+    uint64_t value = 0ULL;
+    if (bytes == 8U) {
+        memcpy(&value, src, 8U);
+    } else {
+        memcpy(&value, src, bytes);
+    }
+    return value;
+#else
+    uint64_t value = 0ULL;
+    for (uint32_t i = 0U; i < bytes; ++i) {
+        value |= (uint64_t)src[i] << (i * 8U);
+    }
+    return value;
+#endif
+}
+
+static inline void store_word(uint8_t *dst, uint64_t value, uint32_t bytes)
+{
+#if MEMORY_MODEL_HOST_LITTLE_ENDIAN
+    if (bytes == 8U) {
+        memcpy(dst, &value, 8U);
+    } else {
+        memcpy(dst, &value, bytes);
+    }
+#else
+    for (uint32_t i = 0U; i < bytes; ++i) {
+        dst[i] = (uint8_t)(value >> (i * 8U));
+    }
+#endif
+}
+
+/*
+ * Seqlock copies of backing-store bytes: relaxed atomic loads from (or stores
+ * to) the store, 64 bits at a time once @store is aligned. seq_copy_out()
+ * with a NULL @src writes zeros.
+ */
+static inline void seq_copy_in(uint8_t *dst, const uint8_t *store, size_t bytes)
+{
+    size_t i = 0U;
+    for (; i < bytes && ((uintptr_t)(store + i) & 7U) != 0U; ++i) {
+        dst[i] = SEQ_LOAD(store[i]);
+    }
+    for (; i + 8U <= bytes; i += 8U) {
+        uint64_t value = __atomic_load_n((const uint64_t *)(const void *)(store + i), __ATOMIC_RELAXED);
+        memcpy(dst + i, &value, 8U);
+    }
+    for (; i < bytes; ++i) {
+        dst[i] = SEQ_LOAD(store[i]);
+    }
+}
+
+static inline void seq_copy_out(uint8_t *store, const uint8_t *src, size_t bytes)
+{
+    size_t i = 0U;
+    for (; i < bytes && ((uintptr_t)(store + i) & 7U) != 0U; ++i) {
+        SEQ_STORE(store[i], src != NULL ? src[i] : (uint8_t)0U);
+    }
+    for (; i + 8U <= bytes; i += 8U) {
+        uint64_t value = 0ULL;
+        if (src != NULL) {
+            memcpy(&value, src + i, 8U);
+        }
+        __atomic_store_n((uint64_t *)(void *)(store + i), value, __ATOMIC_RELAXED);
+    }
+    for (; i < bytes; ++i) {
+        SEQ_STORE(store[i], src != NULL ? src[i] : (uint8_t)0U);
+    }
+}
+
+static inline uint64_t wide_mask_for_bytes(uint32_t bytes)
+{
+    return bytes >= 64U ? UINT64_MAX : (1ULL << bytes) - 1ULL;
+}
+
+/*
+ * Each kernel level handles whole vectors and passes the tail to the next
+ * narrower level. The scalar kernel works eight bytes at a time with the same
+ * mask expansion as the 64-bit path. AVX-512BW masks bytes directly, so one
+ * masked load/store covers any word of up to 64 bytes.
+ */
+static void wide_read_scalar(uint8_t *out, const uint8_t *word, uint64_t byte_mask, uint32_t bytes)
+{
+    for (uint32_t i = 0U; i < bytes; i += 8U) {
+        uint32_t chunk = bytes - i < 8U ? bytes - i : 8U;
+        uint64_t value = load_word(word + i, chunk) & expand_byte_mask((uint32_t)(byte_mask >> i) & 0xFFU);
+        store_word(out + i, value, chunk);
+    }
+}
+
+static void wide_write_scalar(uint8_t *word, const uint8_t *in, uint64_t byte_mask, uint32_t bytes)
+{
+    for (uint32_t i = 0U; i < bytes; i += 8U) {
+        uint32_t chunk = bytes - i < 8U ? bytes - i : 8U;
+        uint64_t bit_mask = expand_byte_mask((uint32_t)(byte_mask >> i) & 0xFFU);
+        uint64_t merged = (load_word(word + i, chunk) & ~bit_mask) | (load_word(in + i, chunk) & bit_mask);
+        store_word(word + i, merged, chunk);
+    }
+}
+
+#if MEMORY_MODEL_X86_KERNELS
+/* Broadcast byte k of the mask word to the lanes it governs, then test one bit per lane. */
+__attribute__((target("sse4.1"))) static inline __m128i sse_byte_mask(uint32_t bits)
+{
+    const __m128i select = _mm_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1);
+    const __m128i bit = _mm_set1_epi64x((long long)0x8040201008040201ULL);
+    __m128i lanes = _mm_shuffle_epi8(_mm_cvtsi32_si128((int)bits), select);
+    return _mm_cmpeq_epi8(_mm_and_si128(lanes, bit), bit);
+}
+
+__attribute__((target("sse4.1"))) static void wide_read_sse41(uint8_t *out, const uint8_t *word,
+                                                                uint64_t byte_mask, uint32_t bytes)
+{
+    uint32_t i = 0U;
+    for (; i + 16U <= bytes; i += 16U) {
+        __m128i mask = sse_byte_mask((uint32_t)(byte_mask >> i) & 0xFFFFU);
+        __m128i value = _mm_loadu_si128((const __m128i *)(const void *)(word + i));
+        _mm_storeu_si128((__m128i *)(void *)(out + i), _mm_and_si128(value, mask));
+    }
+    if (i < bytes) {
+        wide_read_scalar(out + i, word + i, byte_mask >> i, bytes - i);
+    }
+}
+
+__attribute__((target("sse4.1"))) static void wide_write_sse41(uint8_t *word, const uint8_t *in,
+                                                                 uint64_t byte_mask, uint32_t bytes)
+{
+    uint32_t i = 0U;
+    for (; i + 16U <= bytes; i += 16U) {
+        __m128i mask = sse_byte_mask((uint32_t)(byte_mask >> i) & 0xFFFFU);
+        __m128i old = _mm_loadu_si128((const __m128i *)(const void *)(word + i));
+        __m128i value = _mm_loadu_si128((const __m128i *)(const void *)(in + i));
+        _mm_storeu_si128((__m128i *)(void *)(word + i), _mm_blendv_epi8(old, value, mask));
+    }
+    if (i < bytes) {
+        wide_write_scalar(word + i, in + i, byte_mask >> i, bytes - i);
+    }
+}
+
+__attribute__((target("avx2"))) static inline __m256i avx2_byte_mask(uint32_t bits)
+{
+    /* In-lane shuffle: both 128-bit lanes hold the broadcast mask word. */
+    const __m256i select = _mm256_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1,
+                                            2, 2, 2, 2, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3);
+    const __m256i bit = _mm256_set1_epi64x((long long)0x8040201008040201ULL);
+    __m256i lanes = _mm256_shuffle_epi8(_mm256_set1_epi32((int)bits), select);
+    return _mm256_cmpeq_epi8(_mm256_and_si256(lanes, bit), bit);
+}
+
+__attribute__((target("avx2"))) static void wide_read_avx2(uint8_t *out, const uint8_t *word,
+                                                             uint64_t byte_mask, uint32_t bytes)
+{
+    uint32_t i = 0U;
+    for (; i + 32U <= bytes; i += 32U) {
+        __m256i mask = avx2_byte_mask((uint32_t)(byte_mask >> i));
+        __m256i value = _mm256_loadu_si256((const __m256i *)(const void *)(word + i));
+        _mm256_storeu_si256((__m256i *)(void *)(out + i), _mm256_and_si256(value, mask));
+    }
+    if (i < bytes) {
+        wide_read_sse41(out + i, word + i, byte_mask >> i, bytes - i);
+    }
+}
+
+__attribute__((target("avx2"))) static void wide_write_avx2(uint8_t *word, const uint8_t *in,
+                                                              uint64_t byte_mask, uint32_t bytes)
+{
+    uint32_t i = 0U;
+    for (; i + 32U <= bytes; i += 32U) {
+        __m256i mask = avx2_byte_mask((uint32_t)(byte_mask >> i));
+        __m256i old = _mm256_loadu_si256((const __m256i *)(const void *)(word + i));
+        __m256i value = _mm256_loadu_si256((const __m256i *)(const void *)(in + i));
+        _mm256_storeu_si256((__m256i *)(void *)(word + i), _mm256_blendv_epi8(old, value, mask));
+    }
+    if (i < bytes) {
+        wide_write_sse41(word + i, in + i, byte_mask >> i, bytes - i);
+    }
+}
+
+__attribute__((target("avx512f,avx512bw"))) static void wide_read_avx512(uint8_t *out, const uint8_t *word,
+                                                                          uint64_t byte_mask, uint32_t bytes)
+{
+    __mmask64 limit = (__mmask64)wide_mask_for_bytes(bytes);
+    __m512i value = _mm512_maskz_loadu_epi8((__mmask64)byte_mask & limit, word);
+    _mm512_mask_storeu_epi8(out, limit, value);
+}
+
+__attribute__((target("avx512f,avx512bw"))) static void wide_write_avx512(uint8_t *word, const uint8_t *in,
+                                                                           uint64_t byte_mask, uint32_t bytes)
+{
+    __mmask64 select = (__mmask64)byte_mask & (__mmask64)wide_mask_for_bytes(bytes);
+    _mm512_mask_storeu_epi8(word, select, _mm512_maskz_loadu_epi8(select, in));
+}
+#endif
+
+static const struct wide_kernels wide_kernels_scalar = {MEMORY_MODEL_SIMD_SCALAR, wide_read_scalar,
+                                                         wide_write_scalar};
+#if MEMORY_MODEL_X86_KERNELS
+static const struct wide_kernels wide_kernels_sse41 = {MEMORY_MODEL_SIMD_SSE41, wide_read_sse41, wide_write_sse41};
+static const struct wide_kernels wide_kernels_avx2 = {MEMORY_MODEL_SIMD_AVX2, wide_read_avx2, wide_write_avx2};
+static const struct wide_kernels wide_kernels_avx512 = {MEMORY_MODEL_SIMD_AVX512, wide_read_avx512,
+                                                         wide_write_avx512};
+#endif
+
+/* Best kernel set the CPU supports, capped at @ceiling unless that is AUTO. */
+static const struct wide_kernels *wide_kernels_select(memory_model_simd_t ceiling)
+{
+    memory_model_simd_t limit = ceiling == MEMORY_MODEL_SIMD_AUTO ? MEMORY_MODEL_SIMD_AVX512 : ceiling;
+#if MEMORY_MODEL_X86_KERNELS
+    __builtin_cpu_init();
+    if (limit >= MEMORY_MODEL_SIMD_AVX512 && __builtin_cpu_supports("avx512bw")) {
+        return &wide_kernels_avx512;
+    }
+    if (limit >= MEMORY_MODEL_SIMD_AVX2 && __builtin_cpu_supports("avx2")) {
+        return &wide_kernels_avx2;
+    }
+    if (limit >= MEMORY_MODEL_SIMD_SSE41 && __builtin_cpu_supports("sse4.1")) {
+        return &wide_kernels_sse41;
+    }
+#else
+    (void)limit;
+#endif
+    return &wide_kernels_scalar;
+}
+
+/* Masked copy out of a stored word; words of up to 64 bits stay on the 64-bit path. */
+static inline void masked_read_bytes(const memory_model_t *model, uint8_t *out, const uint8_t *word,
+                                     uint64_t byte_mask, uint32_t bytes)
+{
+    if (byte_mask == wide_mask_for_bytes(bytes)) {
+        memcpy(out, word, bytes);
+    } else if (bytes <= 8U) {
+        store_word(out, load_word(word, bytes) & expand_byte_mask((uint32_t)byte_mask), bytes);
+    } else {
+        model->wide->read(out, word, byte_mask, bytes);
+    }
+}
+
+static inline void masked_write_bytes(const memory_model_t *model, uint8_t *word, const uint8_t *in,
+                                      uint64_t byte_mask, uint32_t bytes)
+{
+    if (byte_mask == wide_mask_for_bytes(bytes)) {
+        memcpy(word, in, bytes);
+    } else if (bytes <= 8U) {
+        uint64_t bit_mask = expand_byte_mask((uint32_t)byte_mask);
+        store_word(word, (load_word(word, bytes) & ~bit_mask) | (load_word(in, bytes) & bit_mask), bytes);
+    } else {
+        model->wide->write(word, in, byte_mask, bytes);
+    }
+}
+
+static struct store_page *store_page_create(const memory_model_t *model)
+{
+    struct store_page *data = calloc(1U, sizeof(struct store_page) + model->store_page_bytes);
+    if (data == NULL) {
+        return NULL;
+    }
+    data->generation = model->store_generation;
+    atomic_init(&data->refs, 1U);
+    return data;
+}
+
+static struct store_page *store_page_alloc_locked(memory_model_t *model, uint64_t page)
+{
+    struct store_page **l2 = model->store_dir[page >> STORE_DIR_L2_BITS];
+    if (l2 == NULL) {
+        l2 = calloc(STORE_DIR_L2_ENTRIES, sizeof(*l2));
+        if (l2 == NULL) {
+            return NULL;
+        }
+        DIR_STORE(model->store_dir[page >> STORE_DIR_L2_BITS], l2);
+    }
+
+    struct store_page **slot = &l2[page & (STORE_DIR_L2_ENTRIES - 1U)];
+    if (*slot == NULL) {
+        struct store_page *data = store_page_create(model);
+        if (data == NULL) {
+            return NULL;
+        }
+        DIR_STORE(*slot, data);
+        model->resident_pages++;
+    }
+    return *slot;
+}
+
+static struct store_page *store_page_alloc(memory_model_t *model, uint64_t page)
+{
+    if (model->sync == NULL) {
+        return store_page_alloc_locked(model, page);
+    }
+
+    spin_lock(&model->sync->dir_lock);
+    struct store_page *data = store_page_alloc_locked(model, page);
+    spin_unlock(&model->sync->dir_lock);
+    return data;
+}
+
+/* Release every page and L2 table, leaving an empty L1 directory. */
+static void store_release(memory_model_t *model)
+{
+    if (model->store_dir == NULL) {
+        return;
+    }
+
+    for (uint32_t l1 = 0U; l1 < model->store_l1_entries; ++l1) {
+        struct store_page **l2 = model->store_dir[l1];
+        if (l2 == NULL) {
+            continue;
+        }
+        for (uint32_t i = 0U; i < STORE_DIR_L2_ENTRIES; ++i) {
+            if (l2[i] != NULL && atomic_fetch_sub_explicit(&l2[i]->refs, 1U, memory_order_acq_rel) == 1U) {
+                free(l2[i]);
+            }
+        }
+        free(l2);
+        model->store_dir[l1] = NULL;
+    }
+    model->resident_pages = 0U;
+}
+
+static memory_model_error_t store_populate(memory_model_t *model)
+{
+    for (uint64_t page = 0U; page < model->store_pages; ++page) {
+        if (store_page_alloc(model, page) == NULL) {
+            return MEMORY_MODEL_ERROR_OUT_OF_MEMORY;
+        }
+    }
+    return MEMORY_MODEL_ERROR_OK;
+}
+
+/* Returns NULL for words on pages not written since the last reset. */
+static inline const uint8_t *store_word_for_read(const memory_model_t *model, uint64_t mem_index)
+{
+    uint64_t page = mem_index >> STORE_PAGE_WORD_BITS;
+    struct store_page **l2 = DIR_LOAD(model->store_dir[page >> STORE_DIR_L2_BITS]);
+    if (l2 == NULL) {
+        return NULL;
+    }
+    const struct store_page *data = DIR_LOAD(l2[page & (STORE_DIR_L2_ENTRIES - 1U)]);
+    if (data == NULL || SEQ_LOAD(data->generation) != model->store_generation) {
+        return NULL;
+    }
+    return data->data + (size_t)(mem_index & (STORE_PAGE_WORDS - 1U)) * model->bytes_per_word;
+}
+
+/* Zero a stale page in place and make it current; readers may be racing in concurrent mode. */
+static void store_page_clear(const memory_model_t *model, struct store_page *data)
+{
+    if (model->sync != NULL) {
+        seq_copy_out(data->data, NULL, model->store_page_bytes);
+    } else {
+        memset(data->data, 0, model->store_page_bytes);
+    }
+    SEQ_STORE(data->generation, model->store_generation);
+}
+
+/*
+ * Replace a shared page in this model's directory with a private copy. The
+ * other holders may be dropping their references concurrently; if this model
+ * turns out to be the last one, it keeps the original page instead, which is
+ * never freed while concurrent readers of this model might still hold it.
+ */
+static struct store_page *store_page_unshare(memory_model_t *model, struct store_page **slot)
+{
+    struct store_page *shared = *slot;
+    struct store_page *copy = malloc(sizeof(struct store_page) + model->store_page_bytes);
+    if (copy == NULL) {
+        return NULL;
+    }
+
+    /* A page that is stale for this model carries no data worth copying. */
+    if (shared->generation == model->store_generation) {
+        memcpy(copy->data, shared->data, model->store_page_bytes);
+    } else {
+        memset(copy->data, 0, model->store_page_bytes);
+    }
+    copy->generation = model->store_generation;
+    atomic_init(&copy->refs, 1U);
+
+    if (atomic_fetch_sub_explicit(&shared->refs, 1U, memory_order_acq_rel) == 1U) {
+        atomic_store_explicit(&shared->refs, 1U, memory_order_relaxed);
+        free(copy);
+        if (shared->generation != model->store_generation) {
+            store_page_clear(model, shared);
+        }
+        return shared;
+    }
+
+    DIR_STORE(*slot, copy);
+    return copy;
+}
+
+/* Returns NULL only if a page could not be allocated or unshared. */
+static inline uint8_t *store_word_for_write(memory_model_t *model, uint64_t mem_index)
+{
+    uint64_t page = mem_index >> STORE_PAGE_WORD_BITS;
+    struct store_page **l2 = DIR_LOAD(model->store_dir[page >> STORE_DIR_L2_BITS]);
+    struct store_page *data = l2 != NULL ? l2[page & (STORE_DIR_L2_ENTRIES - 1U)] : NULL;
+    if (data == NULL) {
+        data = store_page_alloc(model, page);
+        if (data == NULL) {
+            return NULL;
+        }
+    } else if (atomic_load_explicit(&data->refs, memory_order_acquire) > 1U) {
+        data = store_page_unshare(model, &l2[page & (STORE_DIR_L2_ENTRIES - 1U)]);
+        if (data == NULL) {
+            return NULL;
+        }
+    } else if (data->generation != model->store_generation) {
+        store_page_clear(model, data);
+    }
+    return data->data + (size_t)(mem_index & (STORE_PAGE_WORDS - 1U)) * model->bytes_per_word;
+}
+
+static inline uint64_t read_word_masked(const memory_model_t *model, uint64_t mem_index, uint32_t effective_mask)
+{
+    const uint8_t *word = store_word_for_read(model, mem_index);
+    if (word == NULL) {
+        return 0ULL;
+    }
+
+    uint64_t value = load_word(word, model->lane_bytes);
+    if (effective_mask != model->word_byte_mask) {
+        value &= expand_byte_mask(effective_mask);
+    }
+    return value;
+}
+
+static inline void write_word_masked(const memory_model_t *model, uint8_t *word, uint32_t byte_mask, uint64_t data)
+{
+    if (byte_mask == model->word_byte_mask) {
+        store_word(word, data, model->lane_bytes);
+    } else {
+        uint64_t bit_mask = expand_byte_mask(byte_mask);
+        uint64_t merged = (load_word(word, model->lane_bytes) & ~bit_mask) | (data & bit_mask);
+        store_word(word, merged, model->lane_bytes);
+    }
+}
+
+static void cache_destroy(struct data_cache *cache)
+{
+    if (cache == NULL) {
+        return;
+    }
+    free(cache->tags);
+    free(cache->stamps);
+    free(cache->plru);
+    free(cache->next_way);
+    free(cache->dirty);
+    free(cache);
+}
+
+/* Return every line to empty and the replacement state to power-on. O(lines). */
+static void cache_clear(struct data_cache *cache)
+{
+    for (uint64_t i = 0U; i < cache->lines; ++i) {
+        cache->tags[i] = CACHE_LINE_EMPTY;
+    }
+    memset(cache->dirty, 0, cache->lines * sizeof(*cache->dirty));
+    if (cache->stamps != NULL) {
+        memset(cache->stamps, 0, cache->lines * sizeof(*cache->stamps));
+    }
+    if (cache->plru != NULL) {
+        memset(cache->plru, 0, cache->lines * sizeof(*cache->plru));
+    }
+    if (cache->next_way != NULL) {
+        memset(cache->next_way, 0, (cache->set_mask + 1U) * sizeof(*cache->next_way));
+    }
+    cache->clock = 0U;
+    cache->random = TLB_RANDOM_SEED;
+}
+
+/* Allocate the cache for a validated @cfg, copying @source when not NULL. */
+static struct data_cache *cache_create(const memory_model_config_t *cfg, uint32_t bytes_per_word,
+                                       const struct data_cache *source)
+{
+    struct data_cache *cache = calloc(1U, sizeof(*cache));
+    if (cache == NULL) {
+        return NULL;
+    }
+
+    cache->lines = cfg->cache_size / cfg->cache_line_size;
+    cache->ways = cfg->cache_ways != 0U ? cfg->cache_ways : (uint32_t)cache->lines;
+    cache->set_mask = cache->lines / cache->ways - 1U;
+    cache->line_words = cfg->cache_line_size / bytes_per_word;
+    cache->line_bits = ceil_log2_u64(cache->line_words);
+
+    size_t sets = (size_t)(cache->set_mask + 1U);
+    cache->tags = malloc((size_t)cache->lines * sizeof(*cache->tags));
+    cache->dirty = malloc((size_t)cache->lines * sizeof(*cache->dirty));
+    bool ok = cache->tags != NULL && cache->dirty != NULL;
+    switch (cfg->cache_policy) {
+    case MEMORY_MODEL_TLB_POLICY_LRU:
+    case MEMORY_MODEL_TLB_POLICY_FIFO:
+        cache->stamps = malloc((size_t)cache->lines * sizeof(*cache->stamps));
+        ok = ok && cache->stamps != NULL;
+        break;
+    case MEMORY_MODEL_TLB_POLICY_PLRU:
+        cache->plru = malloc((size_t)cache->lines * sizeof(*cache->plru));
+        ok = ok && cache->plru != NULL;
+        break;
+    case MEMORY_MODEL_TLB_POLICY_ROUND_ROBIN:
+        cache->next_way = malloc(sets * sizeof(*cache->next_way));
+        ok = ok && cache->next_way != NULL;
+        break;
+    default:
+        break;
+    }
+    if (!ok) {
+        cache_destroy(cache);
+        return NULL;
+    }
+
+    if (source == NULL) {
+        cache_clear(cache);
+        return cache;
+    }
+    memcpy(cache->tags, source->tags, (size_t)cache->lines * sizeof(*cache->tags));
+    memcpy(cache->dirty, source->dirty, (size_t)cache->lines * sizeof(*cache->dirty));
+    if (cache->stamps != NULL) {
+        memcpy(cache->stamps, source->stamps, (size_t)cache->lines * sizeof(*cache->stamps));
+    }
+    if (cache->plru != NULL) {
+        memcpy(cache->plru, source->plru, (size_t)cache->lines * sizeof(*cache->plru));
+    }
+    if (cache->next_way != NULL) {
+        memcpy(cache->next_way, source->next_way, sets * sizeof(*cache->next_way));
+    }
+    cache->clock = source->clock;
+    cache->random = source->random;
+    return cache;
+}
+
+/* Record a use of @way in the set starting at line @first: a hit, or a fill when @fill is set. */
+static inline void cache_touch(const memory_model_t *model, uint64_t first, uint32_t way, bool fill)
+{
+    struct data_cache *cache = model->cache;
+    if (cache->stamps != NULL) {
+        if (fill || model->cfg.cache_policy == MEMORY_MODEL_TLB_POLICY_LRU) {
+            cache->stamps[first + way] = ++cache->clock;
+        }
+    } else if (cache->plru != NULL) {
+        uint8_t *tree = &cache->plru[first];
+        uint32_t node = 1U;
+        for (uint32_t half = cache->ways >> 1U; half != 0U; half >>= 1U) {
+            uint32_t right = (way & half) != 0U ? 1U : 0U;
+            tree[node] = (uint8_t)(right ^ 1U);
+            node = 2U * node + right;
+        }
+    }
+}
+
+/*
+ * Way to fill in the set starting at line @first. Round-robin cycles the
+ * set's ways; the other policies take an empty way first. LRU and FIFO scan
+ * the set's stamps, O(ways) like the tag compare itself.
+ */
+static uint32_t cache_victim(const memory_model_t *model, uint64_t first)
+{
+    struct data_cache *cache = model->cache;
+    const uint32_t ways = cache->ways;
+    if (cache->next_way != NULL) {
+        uint32_t *next = &cache->next_way[first / ways];
+        uint32_t way = *next;
+        *next = way + 1U < ways ? way + 1U : 0U;
+        return way;
+    }
+    for (uint32_t way = 0U; way < ways; ++way) {
+        if (cache->tags[first + way] == CACHE_LINE_EMPTY) {
+            return way;
+        }
+    }
+
+    if (cache->plru != NULL) {
+        const uint8_t *tree = &cache->plru[first];
+        uint32_t way = 0U;
+        uint32_t node = 1U;
+        for (uint32_t half = ways >> 1U; half != 0U; half >>= 1U) {
+            uint32_t right = tree[node];
+            way += right * half;
+            node = 2U * node + right;
+        }
+        return way;
+    }
+    if (cache->stamps == NULL) {
+        uint64_t x = cache->random;
+        x ^= x << 13U;
+        x ^= x >> 7U;
+        x ^= x << 17U;
+        cache->random = x;
+        return (uint32_t)(((x >> 32U) * ways) >> 32U);
+    }
+
+    uint32_t victim = 0U;
+    uint64_t oldest = UINT64_MAX;
+    for (uint32_t way = 0U; way < ways; ++way) {
+        if (cache->stamps[first + way] < oldest) {
+            oldest = cache->stamps[first + way];
+            victim = way;
+        }
+    }
+    return victim;
+}
+
+/* Look up the line holding backing-store word @mem_index, filling it on a miss that allocates. */
+static memory_model_cache_result_t cache_access(const memory_model_t *model, uint64_t mem_index, bool write)
+{
+    struct data_cache *cache = model->cache;
+    const uint64_t line = mem_index >> cache->line_bits;
+    const uint64_t first = (line & cache->set_mask) * cache->ways;
+    const bool write_back = model->cfg.cache_write_policy == MEMORY_MODEL_CACHE_WRITE_BACK;
+    uint64_t *tags = &cache->tags[first];
+
+    for (uint32_t way = 0U; way < cache->ways; ++way) {
+        if (tags[way] == line) {
+            if (write) {
+                COUNT(model, cache_write_hits);
+                cache->dirty[first + way] = cache->dirty[first + way] || write_back;
+            } else {
+                COUNT(model, cache_read_hits);
+            }
+            cache_touch(model, first, way, false);
+            return MEMORY_MODEL_CACHE_HIT;
+        }
+    }
+
+    if (write) {
+        COUNT(model, cache_write_misses);
+        if (!write_back) {
+            return MEMORY_MODEL_CACHE_MISS;
+        }
+    } else {
+        COUNT(model, cache_read_misses);
+    }
+
+    uint32_t way = cache_victim(model, first);
+    memory_model_cache_result_t result = MEMORY_MODEL_CACHE_MISS;
+    if (tags[way] != CACHE_LINE_EMPTY && cache->dirty[first + way]) {
+        COUNT(model, cache_writebacks);
+        result = MEMORY_MODEL_CACHE_MISS_WRITEBACK;
+    }
+    tags[way] = line;
+    cache->dirty[first + way] = write;
+    cache_touch(model, first, way, true);
+    return result;
+}
+
+/* Account @words consecutive words from @mem_index as one access each, probing once per line. */
+static void cache_access_run(const memory_model_t *model, uint64_t mem_index, uint64_t words, bool write)
+{
+    const struct data_cache *cache = model->cache;
+    const bool allocates = !write || model->cfg.cache_write_policy == MEMORY_MODEL_CACHE_WRITE_BACK;
+    while (words > 0U) {
+        uint64_t left_in_line = cache->line_words - (mem_index & (cache->line_words - 1U));
+        uint64_t run = words < left_in_line ? words : left_in_line;
+        memory_model_cache_result_t result = cache_access(model, mem_index, write);
+
+        /* The rest of the run hits the line just probed, unless a write miss left it out. */
+        if (run > 1U) {
+            if (result == MEMORY_MODEL_CACHE_HIT || allocates) {
+                if (write) {
+                    COUNT_N(model, cache_write_hits, run - 1U);
+                } else {
+                    COUNT_N(model, cache_read_hits, run - 1U);
+                }
+            } else {
+                COUNT_N(model, cache_write_misses, run - 1U);
+            }
+        }
+        mem_index += run;
+        words -= run;
+    }
+}
+
+/* One word access to the store at @mem_index; @cache_out, if not NULL, receives the outcome. */
+static inline void cache_note(const memory_model_t *model, uint64_t mem_index, bool write,
+                              memory_model_cache_result_t *cache_out)
+{
+    if (model->cache != NULL) {
+        memory_model_cache_result_t result = cache_access(model, mem_index, write);
+        if (cache_out != NULL) {
+            *cache_out = result;
+        }
+    }
+}
+
+memory_model_config_t memory_model_config_default(void)
+{
+    memory_model_config_t cfg;
+    cfg.virt_addr_width = 32U;
+    cfg.phys_addr_width = 28U;
+    cfg.page_size = 4096U;
+    cfg.data_width = 64U;
+    cfg.mem_depth = 16384U;
+    cfg.tlb_entries = 256U;
+    cfg.tlb_ways = 0U;
+    cfg.sparse = false;
+    cfg.concurrent = false;
+    cfg.simd = MEMORY_MODEL_SIMD_AUTO;
+    cfg.tlb_policy = MEMORY_MODEL_TLB_POLICY_ROUND_ROBIN;
+    cfg.cache_size = 0U;
+    cfg.cache_line_size = 64U;
+    cfg.cache_ways = 8U;
+    cfg.cache_write_policy = MEMORY_MODEL_CACHE_WRITE_BACK;
+    cfg.cache_policy = MEMORY_MODEL_TLB_POLICY_LRU;
+    return cfg;
+}
+
+memory_model_error_t memory_model_create(const memory_model_config_t *config,
+                                          memory_model_t **model_out)
+{
+    if (model_out == NULL) {
+        return MEMORY_MODEL_ERROR_BAD_ARGUMENT;
+    }
+
+    *model_out = NULL;
+
+    memory_model_config_t local_cfg = config != NULL ? *config : memory_model_config_default();
+
+    if (local_cfg.data_width == 0U || (local_cfg.data_width % 8U) != 0U ||
+        local_cfg.data_width > MEMORY_MODEL_MAX_DATA_WIDTH) {
+        return MEMORY_MODEL_ERROR_UNSUPPORTED;
+    }
+    if ((uint32_t)local_cfg.simd > (uint32_t)MEMORY_MODEL_SIMD_AVX512 ||
+        (uint32_t)local_cfg.tlb_policy > (uint32_t)MEMORY_MODEL_TLB_POLICY_FIFO) {
+        return MEMORY_MODEL_ERROR_BAD_ARGUMENT;
+    }
+    if (local_cfg.tlb_ways != 0U &&
+        (local_cfg.tlb_ways > local_cfg.tlb_entries || local_cfg.tlb_entries % local_cfg.tlb_ways != 0U ||
+         !is_power_of_two(local_cfg.tlb_entries / local_cfg.tlb_ways) ||
+         (local_cfg.tlb_policy == MEMORY_MODEL_TLB_POLICY_PLRU && !is_power_of_two(local_cfg.tlb_ways)))) {
+        return MEMORY_MODEL_ERROR_BAD_ARGUMENT;
+    }
+    if (local_cfg.page_size == 0U || !is_power_of_two(local_cfg.page_size)) {
+        return MEMORY_MODEL_ERROR_BAD_ARGUMENT;
+    }
+    if (local_cfg.cache_size != 0U) {
+        uint32_t bytes_per_word = local_cfg.data_width / 8U;
+        uint64_t lines = local_cfg.cache_line_size != 0U ? local_cfg.cache_size / local_cfg.cache_line_size : 0U;
+        uint64_t ways = local_cfg.cache_ways != 0U ? local_cfg.cache_ways : lines;
+        if ((uint32_t)local_cfg.cache_write_policy > (uint32_t)MEMORY_MODEL_CACHE_WRITE_THROUGH ||
+            (uint32_t)local_cfg.cache_policy > (uint32_t)MEMORY_MODEL_TLB_POLICY_FIFO ||
+            local_cfg.cache_line_size % bytes_per_word != 0U ||
+            !is_power_of_two(local_cfg.cache_line_size / bytes_per_word) || lines == 0U ||
+            local_cfg.cache_size % local_cfg.cache_line_size != 0U || ways > lines || ways > UINT32_MAX ||
+            lines % ways != 0U || !is_power_of_two(lines / ways) ||
+            (local_cfg.cache_policy == MEMORY_MODEL_TLB_POLICY_PLRU && !is_power_of_two(ways))) {
+            return MEMORY_MODEL_ERROR_BAD_ARGUMENT;
+        }
+        if (local_cfg.concurrent) {
+            return MEMORY_MODEL_ERROR_UNSUPPORTED;
+        }
+    }
+    if (local_cfg.mem_depth == 0U || local_cfg.tlb_entries == 0U) {
+        return MEMORY_MODEL_ERROR_BAD_ARGUMENT;
+    }
+    if (local_cfg.virt_addr_width == 0U || local_cfg.virt_addr_width > 64U) {
+        return MEMORY_MODEL_ERROR_BAD_ARGUMENT;
+    }
+    if (local_cfg.phys_addr_width == 0U || local_cfg.phys_addr_width > 64U) {
+        return MEMORY_MODEL_ERROR_BAD_ARGUMENT;
+    }
+
+    uint32_t page_offset_bits = ceil_log2_u64(local_cfg.page_size);
+    if (page_offset_bits > local_cfg.virt_addr_width || page_offset_bits > local_cfg.phys_addr_width) {
+        return MEMORY_MODEL_ERROR_BAD_ARGUMENT;
+    }
+
+    memory_model_t *model = calloc(1U, sizeof(*model));
+    if (model == NULL) {
+        return MEMORY_MODEL_ERROR_OUT_OF_MEMORY;
+    }
+
+    model->cfg = local_cfg;
+    model->bytes_per_word = (uint32_t)(local_cfg.data_width / 8U);
+    model->lane_bytes = model->bytes_per_word < 8U ? model->bytes_per_word : 8U;
+    model->word_byte_mask = byte_mask_for_word(model->lane_bytes);
+    model->wide = wide_kernels_select(local_cfg.simd);
+    model->page_offset_bits = page_offset_bits;
+    model->page_offset_mask = mask_from_width(page_offset_bits);
+    model->virt_addr_mask = mask_from_width(local_cfg.virt_addr_width);
+    model->phys_addr_mask = mask_from_width(local_cfg.phys_addr_width);
+    model->data_mask = mask_from_width(local_cfg.data_width);
+
+    model->mem_addr_bits = ceil_log2_u64(local_cfg.mem_depth);
+    model->mem_depth_pow2 = is_power_of_two(local_cfg.mem_depth);
+    if (model->mem_depth_pow2 && local_cfg.mem_depth > 0U) {
+        model->mem_addr_mask = local_cfg.mem_depth - 1ULL;
+    } else if (model->mem_addr_bits >= 64U) {
+        model->mem_addr_mask = UINT64_MAX;
+    } else if (model->mem_addr_bits == 0U) {
+        model->mem_addr_mask = 0ULL;
+    } else {
+        model->mem_addr_mask = (1ULL << model->mem_addr_bits) - 1ULL;
+    }
+
+    model->store_page_bytes = (size_t)STORE_PAGE_WORDS * model->bytes_per_word;
+    model->store_pages = (local_cfg.mem_depth >> STORE_PAGE_WORD_BITS) +
+                         ((local_cfg.mem_depth & (STORE_PAGE_WORDS - 1U)) != 0U ? 1U : 0U);
+    uint64_t l1_entries = (model->store_pages + STORE_DIR_L2_ENTRIES - 1U) >> STORE_DIR_L2_BITS;
+    if (l1_entries > STORE_DIR_MAX_L1_ENTRIES) {
+        free(model);
+        return MEMORY_MODEL_ERROR_UNSUPPORTED;
+    }
+    if (!local_cfg.sparse && model->store_pages > SIZE_MAX / model->store_page_bytes) {
+        free(model);
+        return MEMORY_MODEL_ERROR_UNSUPPORTED;
+    }
+
+    model->store_l1_entries = (uint32_t)l1_entries;
+    model->store_dir = calloc(model->store_l1_entries, sizeof(*model->store_dir));
+    model->tlb = calloc(local_cfg.tlb_entries, sizeof(struct tlb_entry));
+
+    /* Keep the index at most half full so probe sequences stay short. */
+    model->tlb_index_bits = ceil_log2_u32(local_cfg.tlb_entries) + 1U;
+    if (model->tlb_index_bits < 2U) {
+        model->tlb_index_bits = 2U;
+    }
+    model->tlb_index_mask = mask_from_width(model->tlb_index_bits);
+    model->tlb_index = calloc((size_t)1U << model->tlb_index_bits, sizeof(struct tlb_index_bucket));
+    model->counters = counters_create(local_cfg.tlb_entries, local_cfg.concurrent);
+    model->sync = local_cfg.concurrent ? sync_create() : NULL;
+    bool has_recency = tlb_policy_has_recency(local_cfg.tlb_policy);
+    model->recency = has_recency ? recency_create(local_cfg.tlb_policy, local_cfg.tlb_entries, NULL) : NULL;
+
+    /* One set of every way is the fully associative TLB, without per-set cursors. */
+    bool set_associative = local_cfg.tlb_ways != 0U && local_cfg.tlb_ways < local_cfg.tlb_entries;
+    model->tlb_ways = set_associative ? local_cfg.tlb_ways : local_cfg.tlb_entries;
+    model->tlb_set_mask = local_cfg.tlb_entries / model->tlb_ways - 1U;
+    model->tlb_set_next =
+        set_associative ? calloc(local_cfg.tlb_entries / model->tlb_ways, sizeof(struct tlb_set_cursor)) : NULL;
+    model->cache = local_cfg.cache_size != 0U ? cache_create(&local_cfg, model->bytes_per_word, NULL) : NULL;
+
+    if (model->store_dir == NULL || model->tlb == NULL || model->tlb_index == NULL || model->counters == NULL ||
+        (local_cfg.concurrent && model->sync == NULL) || (has_recency && model->recency == NULL) ||
+        (set_associative && model->tlb_set_next == NULL) || (local_cfg.cache_size != 0U && model->cache == NULL)) {
+        memory_model_destroy(model);
+        return MEMORY_MODEL_ERROR_OUT_OF_MEMORY;
+    }
+
+    /* Freshly allocated state is already in its reset condition. */
+    model->tlb_generation = 1U;
+    model->store_generation = 1U;
+    model->tlb_random = TLB_RANDOM_SEED;
+
+    if (!local_cfg.sparse && store_populate(model) != MEMORY_MODEL_ERROR_OK) {
+        memory_model_destroy(model);
+        return MEMORY_MODEL_ERROR_OUT_OF_MEMORY;
+    }
+
+    *model_out = model;
+    return MEMORY_MODEL_ERROR_OK;
+}
+
+void memory_model_destroy(memory_model_t *model)
+{
+    if (model == NULL) {
+        return;
+    }
+
+    store_release(model);
+    free(model->store_dir);
+    free(model->tlb_index);
+    free(model->tlb);
+    counters_destroy(model->counters);
+    free(model->sync);
+    recency_destroy(model->recency);
+    free(model->tlb_set_next);
+    cache_destroy(model->cache);
+    free(model);
+}
+
+/* Invalidate every TLB entry and index bucket at once by moving to a new generation. */
+static void tlb_flush_all(memory_model_t *model)
+{
+    SEQ_STORE(model->tlb_generation, model->tlb_generation + 1U);
+    SEQ_STORE(model->direct_epoch, model->direct_epoch + 1U);
+    SEQ_STORE(model->tlb_write_ptr, 0U);
+    model->tlb_fill_cursor = 0U;
+    SEQ_STORE(model->active_entries, 0U);
+    SEQ_STORE(model->tlb_span_classes, 0U);
+    memset(model->tlb_span_live, 0, sizeof(model->tlb_span_live));
+}
+
+memory_model_error_t memory_model_reset(memory_model_t *model)
+{
+    if (model == NULL) {
+        return MEMORY_MODEL_ERROR_BAD_ARGUMENT;
+    }
+
+    /* Stale pages and TLB entries are invalidated lazily on their next use. */
+    model->store_generation++;
+    tlb_flush_all(model);
+    model->tlb_asid = 0U;
+    memset(&model->page_table, 0, sizeof(model->page_table));
+    model->tlb_random = TLB_RANDOM_SEED;
+    if (model->recency != NULL) {
+        /* O(tlb_entries) rather than O(1), but the replacement state is tiny beside the store. */
+        struct tlb_recency *recency = model->recency;
+        atomic_store_explicit(&recency->clock, 0U, memory_order_relaxed);
+        if (recency->plru != NULL) {
+            memset((void *)recency->plru, 0, recency->plru_leaves * sizeof(*recency->plru));
+        } else {
+            memset((void *)recency->stamps, 0, model->cfg.tlb_entries * sizeof(*recency->stamps));
+        }
+    }
+    if (model->cache != NULL) {
+        /* Stale lines would point at zeroed memory; dirty data is discarded, not written back. */
+        cache_clear(model->cache);
+    }
+
+    return MEMORY_MODEL_ERROR_OK;
+}
+
+/*
+ * Build a copy of @source that shares every backing-store page copy-on-write.
+ * Only the TLB, its index and the page directory are duplicated.
+ */
+static memory_model_error_t model_clone(const memory_model_t *source, memory_model_t **clone_out)
+{
+    memory_model_t *clone = malloc(sizeof(*clone));
+    if (clone == NULL) {
+        return MEMORY_MODEL_ERROR_OUT_OF_MEMORY;
+    }
+
+    *clone = *source;
+    clone->store_dir = calloc(source->store_l1_entries, sizeof(*clone->store_dir));
+    clone->tlb = malloc(sizeof(struct tlb_entry) * (size_t)source->cfg.tlb_entries);
+    clone->tlb_index = malloc(sizeof(struct tlb_index_bucket) << source->tlb_index_bits);
+    clone->counters = counters_create(source->cfg.tlb_entries, source->cfg.concurrent);
+    clone->sync = source->cfg.concurrent ? sync_create() : NULL;
+    clone->recency = source->recency != NULL
+                         ? recency_create(source->cfg.tlb_policy, source->cfg.tlb_entries, source->recency)
+                         : NULL;
+    size_t set_cursor_bytes = (size_t)(source->tlb_set_mask + 1U) * sizeof(struct tlb_set_cursor);
+    clone->tlb_set_next = source->tlb_set_next != NULL ? malloc(set_cursor_bytes) : NULL;
+    clone->cache = source->cache != NULL ? cache_create(&source->cfg, source->bytes_per_word, source->cache) : NULL;
+    if (clone->store_dir == NULL || clone->tlb == NULL || clone->tlb_index == NULL || clone->counters == NULL ||
+        (source->cfg.concurrent && clone->sync == NULL) || (source->recency != NULL && clone->recency == NULL) ||
+        (source->tlb_set_next != NULL && clone->tlb_set_next == NULL) ||
+        (source->cache != NULL && clone->cache == NULL)) {
+        free(clone->store_dir);
+        free(clone->tlb);
+        free(clone->tlb_index);
+        counters_destroy(clone->counters);
+        free(clone->sync);
+        recency_destroy(clone->recency);
+        free(clone->tlb_set_next);
+        cache_destroy(clone->cache);
+        free(clone);
+        return MEMORY_MODEL_ERROR_OUT_OF_MEMORY;
+    }
+
+    memcpy(clone->tlb, source->tlb, sizeof(struct tlb_entry) * (size_t)source->cfg.tlb_entries);
+    memcpy(clone->tlb_index, source->tlb_index, sizeof(struct tlb_index_bucket) << source->tlb_index_bits);
+    if (clone->tlb_set_next != NULL) {
+        memcpy(clone->tlb_set_next, source->tlb_set_next, set_cursor_bytes);
+    }
+
+    /*
+     * Shared pages must not be written in place, so direct grants on the
+     * source lapse; concurrent models hand out none.
+     */
+    if (source->sync == NULL) {
+        ((memory_model_t *)source)->direct_epoch++;
+    }
+    for (uint32_t l1 = 0U; l1 < source->store_l1_entries; ++l1) {
+        struct store_page *const *src_l2 = source->store_dir[l1];
+        if (src_l2 == NULL) {
+            continue;
+        }
+        struct store_page **l2 = malloc(STORE_DIR_L2_ENTRIES * sizeof(*l2));
+        if (l2 == NULL) {
+            memory_model_destroy(clone);
+            return MEMORY_MODEL_ERROR_OUT_OF_MEMORY;
+        }
+        for (uint32_t i = 0U; i < STORE_DIR_L2_ENTRIES; ++i) {
+            l2[i] = src_l2[i];
+            if (l2[i] != NULL) {
+                atomic_fetch_add_explicit(&l2[i]->refs, 1U, memory_order_relaxed);
+            }
+        }
+        clone->store_dir[l1] = l2;
+    }
+
+    *clone_out = clone;
+    return MEMORY_MODEL_ERROR_OK;
+}
+
+static bool config_equal(const memory_model_config_t *a, const memory_model_config_t *b)
+{
+    return a->virt_addr_width == b->virt_addr_width && a->phys_addr_width == b->phys_addr_width &&
+           a->page_size == b->page_size && a->data_width == b->data_width &&
+           a->mem_depth == b->mem_depth && a->tlb_entries == b->tlb_entries && a->sparse == b->sparse &&
+           a->concurrent == b->concurrent && a->tlb_policy == b->tlb_policy && a->tlb_ways == b->tlb_ways &&
+           a->cache_size == b->cache_size && (a->cache_size == 0U || (a->cache_line_size == b->cache_line_size &&
+                                                                      a->cache_ways == b->cache_ways &&
+                                                                      a->cache_write_policy == b->cache_write_policy &&
+                                                                      a->cache_policy == b->cache_policy));
+}
+
+memory_model_error_t memory_model_fork(const memory_model_t *model, memory_model_t **fork_out)
+{
+    if (fork_out == NULL) {
+        return MEMORY_MODEL_ERROR_BAD_ARGUMENT;
+    }
+    *fork_out = NULL;
+    if (model == NULL) {
+        return MEMORY_MODEL_ERROR_BAD_ARGUMENT;
+    }
+
+    return model_clone(model, fork_out);
+}
+
+memory_model_error_t memory_model_snapshot(const memory_model_t *model,
+                                           memory_model_snapshot_t **snapshot_out)
+{
+    if (snapshot_out == NULL) {
+        return MEMORY_MODEL_ERROR_BAD_ARGUMENT;
+    }
+    *snapshot_out = NULL;
+    if (model == NULL) {
+        return MEMORY_MODEL_ERROR_BAD_ARGUMENT;
+    }
+
+    memory_model_snapshot_t *snapshot = malloc(sizeof(*snapshot));
+    if (snapshot == NULL) {
+        return MEMORY_MODEL_ERROR_OUT_OF_MEMORY;
+    }
+
+    memory_model_error_t status = model_clone(model, &snapshot->state);
+    if (status != MEMORY_MODEL_ERROR_OK) {
+        free(snapshot);
+        return status;
+    }
+
+    *snapshot_out = snapshot;
+    return MEMORY_MODEL_ERROR_OK;
+}
+
+memory_model_error_t memory_model_restore(memory_model_t *model, const memory_model_snapshot_t *snapshot)
+{
+    if (model == NULL || snapshot == NULL) {
+        return MEMORY_MODEL_ERROR_BAD_ARGUMENT;
+    }
+    if (!config_equal(&model->cfg, &snapshot->state->cfg)) {
+        return MEMORY_MODEL_ERROR_BAD_ARGUMENT;
+    }
+
+    /* Clone first so that a failed allocation leaves the model untouched. */
+    memory_model_t *restored = NULL;
+    memory_model_error_t status = model_clone(snapshot->state, &restored);
+    if (status != MEMORY_MODEL_ERROR_OK) {
+        return status;
+    }
+
+    /* Counters and locks belong to the instance, not the state, so they survive. */
+    struct model_counters *counters = model->counters;
+    struct model_sync *sync = model->sync;
+    uint64_t direct_epoch = model->direct_epoch;
+    store_release(model);
+    free(model->store_dir);
+    free(model->tlb_index);
+    free(model->tlb);
+    recency_destroy(model->recency);
+    free(model->tlb_set_next);
+    cache_destroy(model->cache);
+
+    counters_destroy(restored->counters);
+    free(restored->sync);
+    *model = *restored;
+    model->counters = counters;
+    model->sync = sync;
+    model->direct_epoch = direct_epoch + 1U;
+    free(restored);
+    return MEMORY_MODEL_ERROR_OK;
+}
+
+void memory_model_snapshot_destroy(memory_model_snapshot_t *snapshot)
+{
+    if (snapshot == NULL) {
+        return;
+    }
+
+    memory_model_destroy(snapshot->state);
+    free(snapshot);
+}
+
+static void tlb_span_retain(memory_model_t *model, uint32_t span_bits)
+{
+    if (model->tlb_span_live[span_bits]++ == 0U) {
+        SEQ_STORE(model->tlb_span_classes, model->tlb_span_classes | (1ULL << span_bits));
+    }
+}
+
+static void tlb_span_release(memory_model_t *model, uint32_t span_bits)
+{
+    if (--model->tlb_span_live[span_bits] == 0U) {
+        SEQ_STORE(model->tlb_span_classes, model->tlb_span_classes & ~(1ULL << span_bits));
+    }
+}
+
+static bool tlb_span_supported(const memory_model_t *model, uint32_t span_bits)
+{
+    return span_bits >= model->page_offset_bits && span_bits <= TLB_MAX_SPAN_BITS &&
+           span_bits <= model->cfg.virt_addr_width && span_bits <= model->cfg.phys_addr_width;
+}
+
+static inline void recency_stamp(const memory_model_t *model, uint32_t index)
+{
+    struct tlb_recency *recency = model->recency;
+    uint64_t now;
+    if (model->sync != NULL) {
+        now = atomic_fetch_add_explicit(&recency->clock, 1U, memory_order_relaxed) + 1U;
+    } else {
+        now = atomic_load_explicit(&recency->clock, memory_order_relaxed) + 1U;
+        atomic_store_explicit(&recency->clock, now, memory_order_relaxed);
+    }
+    atomic_store_explicit(&recency->stamps[index], now, memory_order_relaxed);
+}
+
+/* Point every tree node on the path to @index away from it. */
+static inline void plru_touch(const struct tlb_recency *recency, uint32_t index)
+{
+    uint32_t node = 1U;
+    for (uint32_t half = recency->plru_leaves >> 1U; half != 0U; half >>= 1U) {
+        uint32_t right = (index & half) != 0U ? 1U : 0U;
+        atomic_store_explicit(&recency->plru[node], (uint8_t)(right ^ 1U), memory_order_relaxed);
+        node = 2U * node + right;
+    }
+}
+
+/* Record an access to slot @index: a hit, or a fill when @fill is set. */
+static inline void tlb_touch(const memory_model_t *model, uint32_t index, bool fill)
+{
+    const struct tlb_recency *recency = model->recency;
+    if (recency == NULL) {
+        return;
+    }
+    if (recency->plru != NULL) {
+        plru_touch(recency, index);
+    } else if (fill || model->cfg.tlb_policy == MEMORY_MODEL_TLB_POLICY_LRU) {
+        recency_stamp(model, index);
+    }
+}
+
+/* Invalidate live slot @index; the caller holds the TLB sequence lock if any. */
+static void tlb_evict(memory_model_t *model, uint32_t index)
+{
+    struct tlb_entry *entry = &model->tlb[index];
+    SEQ_STORE(entry->valid, false);
+    SEQ_STORE(model->direct_epoch, model->direct_epoch + 1U);
+    tlb_index_release(model, entry->virt_page, entry->span_bits, entry->asid, index);
+    tlb_span_release(model, entry->span_bits);
+    SEQ_STORE(model->active_entries, model->active_entries - 1U);
+}
+
+/* True if a live entry of @asid already translates @virt_addr. */
+static bool tlb_covers(const memory_model_t *model, uint64_t virt_addr, uint32_t asid)
+{
+    uint64_t masked_virt = virt_addr & model->virt_addr_mask;
+    uint64_t classes = model->tlb_span_classes;
+    while (classes != 0U) {
+        uint32_t span_bits = (uint32_t)__builtin_ctzll(classes);
+        classes &= classes - 1U;
+        if (tlb_index_find(model, masked_virt >> span_bits, span_bits, asid) != NULL) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* Write a mapping into slot @index, replacing whatever it held. */
+static void tlb_install(memory_model_t *model, uint32_t index, uint64_t virt_base, uint64_t phys_base,
+                        uint32_t span_bits, uint32_t asid)
+{
+    struct tlb_entry *entry = &model->tlb[index];
+    if (tlb_entry_live(model, entry)) {
+        tlb_evict(model, index);
+    } else if (tlb_covers(model, virt_base, asid)) {
+        /*
+         * Any entry the new one could override covers its base: a larger
+         * span it shadows, or a duplicate it outranks from a lower slot.
+         */
+        SEQ_STORE(model->direct_epoch, model->direct_epoch + 1U);
+    }
+
+    uint64_t masked_virt = virt_base & model->virt_addr_mask;
+    uint64_t masked_phys = phys_base & model->phys_addr_mask;
+    uint64_t offset_mask = mask_from_width(span_bits);
+    SEQ_STORE(entry->valid, true);
+    SEQ_STORE(entry->span_bits, span_bits);
+    SEQ_STORE(entry->asid, asid);
+    SEQ_STORE(entry->generation, model->tlb_generation);
+    SEQ_STORE(entry->virt_base, masked_virt);
+    SEQ_STORE(entry->phys_base, masked_phys);
+    SEQ_STORE(entry->offset_mask, offset_mask);
+    SEQ_STORE(entry->virt_page, masked_virt >> span_bits);
+    SEQ_STORE(entry->phys_frame, masked_phys & ~offset_mask);
+    tlb_index_insert(model, entry->virt_page, span_bits, asid, index);
+    tlb_span_retain(model, span_bits);
+    SEQ_STORE(model->active_entries, model->active_entries + 1U);
+    tlb_touch(model, index, true);
+}
+
+/* First slot of the set that a @span_bits entry at @virt_base belongs to; 0 when fully associative. */
+static inline uint32_t tlb_set_first(const memory_model_t *model, uint64_t virt_base, uint32_t span_bits)
+{
+    uint64_t set = ((virt_base & model->virt_addr_mask) >> span_bits) & model->tlb_set_mask;
+    return (uint32_t)set * model->tlb_ways;
+}
+
+/* Take the round-robin slot for a new entry and advance the pointer. */
+static uint32_t tlb_round_robin_slot(memory_model_t *model, uint64_t virt_base, uint32_t span_bits)
+{
+    uint32_t index = model->tlb_write_ptr;
+    if (model->tlb_set_next == NULL) {
+        SEQ_STORE(model->tlb_write_ptr, index + 1U < model->cfg.tlb_entries ? index + 1U : 0U);
+        return index;
+    }
+
+    uint32_t first = tlb_set_first(model, virt_base, span_bits);
+    struct tlb_set_cursor *cursor = &model->tlb_set_next[first / model->tlb_ways];
+    uint32_t way = cursor->generation == model->tlb_generation ? cursor->way : 0U;
+    cursor->generation = model->tlb_generation;
+    cursor->way = way + 1U < model->tlb_ways ? way + 1U : 0U;
+    SEQ_STORE(model->tlb_write_ptr, first + cursor->way);
+    return first + way;
+}
+
+/*
+ * Slot for a policy fill within the tlb_ways slots from @first: an empty slot
+ * while there is one, else the policy's victim. A fully associative TLB
+ * resumes its search for empty slots at the fill cursor. LRU and FIFO scan
+ * every stamp in the set, so a fill into a full set costs O(ways); PLRU and
+ * RANDOM are O(log ways) and O(1).
+ */
+static uint32_t tlb_victim(memory_model_t *model, uint32_t first)
+{
+    const uint32_t entries = model->cfg.tlb_entries;
+    const uint32_t ways = model->tlb_ways;
+    if (model->tlb_set_next != NULL) {
+        for (uint32_t way = 0U; way < ways; ++way) {
+            if (!tlb_entry_live(model, &model->tlb[first + way])) {
+                return first + way;
+            }
+        }
+    } else if (model->active_entries < entries) {
+        for (uint32_t n = 0U; n < entries; ++n) {
+            uint32_t index = model->tlb_fill_cursor;
+            model->tlb_fill_cursor = index + 1U < entries ? index + 1U : 0U;
+            if (!tlb_entry_live(model, &model->tlb[index])) {
+                return index;
+            }
+        }
+    }
+
+    const struct tlb_recency *recency = model->recency;
+    switch (model->cfg.tlb_policy) {
+    case MEMORY_MODEL_TLB_POLICY_PLRU: {
+        /* A set is an aligned subtree; a fully associative TLB is the whole, rounded-up tree. */
+        uint32_t size = model->tlb_set_next != NULL ? ways : recency->plru_leaves;
+        uint32_t node = recency->plru_leaves / size + first / size;
+        for (uint32_t half = size >> 1U; half != 0U; half >>= 1U) {
+            /* Subtrees past the last slot only exist to round the tree up. */
+            uint32_t right = atomic_load_explicit(&recency->plru[node], memory_order_relaxed) != 0U &&
+                                     first + half < entries
+                                 ? 1U
+                                 : 0U;
+            first += right * half;
+            node = 2U * node + right;
+        }
+        return first;
+    }
+    case MEMORY_MODEL_TLB_POLICY_RANDOM: {
+        uint64_t x = model->tlb_random;
+        x ^= x << 13U;
+        x ^= x >> 7U;
+        x ^= x << 17U;
+        model->tlb_random = x;
+        return first + (uint32_t)(((x >> 32U) * ways) >> 32U);
+    }
+    default: {
+        uint32_t victim = first;
+        uint64_t oldest = UINT64_MAX;
+        for (uint32_t index = first; index < first + ways; ++index) {
+            uint64_t stamp = atomic_load_explicit(&recency->stamps[index], memory_order_relaxed);
+            if (stamp < oldest) {
+                oldest = stamp;
+                victim = index;
+            }
+        }
+        return victim;
+    }
+    }
+}
+
+/*
+ * Install a mapping in the current ASID; the caller holds the TLB lock if any.
+ * Explicit loads take the round-robin slot and walker fills (@demand) the
+ * slot cfg.tlb_policy picks, in both cases within the entry's set.
+ */
+static void tlb_fill(memory_model_t *model, uint64_t virt_base, uint64_t phys_base, uint32_t span_bits,
+                     bool demand)
+{
+    uint32_t index;
+    if (demand && model->cfg.tlb_policy != MEMORY_MODEL_TLB_POLICY_ROUND_ROBIN) {
+        index = tlb_victim(model, tlb_set_first(model, virt_base, span_bits));
+    } else {
+        index = tlb_round_robin_slot(model, virt_base, span_bits);
+    }
+
+    if (tlb_entry_live(model, &model->tlb[index])) {
+        COUNT(model, tlb_evictions);
+    }
+    tlb_install(model, index, virt_base, phys_base, span_bits, model->tlb_asid);
+}
+
+static memory_model_error_t tlb_load(memory_model_t *model, uint64_t virt_base, uint64_t phys_base,
+                                     uint32_t span_bits)
+{
+    if (model == NULL || model->tlb == NULL || model->cfg.tlb_entries == 0U) {
+        return MEMORY_MODEL_ERROR_BAD_ARGUMENT;
+    }
+    if (!tlb_span_supported(model, span_bits)) {
+        return MEMORY_MODEL_ERROR_BAD_ARGUMENT;
+    }
+
+    if (model->sync != NULL) {
+        seq_write_begin(&model->sync->tlb_seq);
+    }
+
+    COUNT(model, tlb_loads);
+    tlb_fill(model, virt_base, phys_base, span_bits, false);
+
+    if (model->sync != NULL) {
+        seq_write_end(&model->sync->tlb_seq);
+    }
+
+    return MEMORY_MODEL_ERROR_OK;
+}
+
+memory_model_error_t memory_model_load_tlb(memory_model_t *model,
+                                           uint64_t virt_base,
+                                           uint64_t phys_base)
+{
+    if (model == NULL) {
+        return MEMORY_MODEL_ERROR_BAD_ARGUMENT;
+    }
+    return tlb_load(model, virt_base, phys_base, model->page_offset_bits);
+}
+
+memory_model_error_t memory_model_load_tlb_range(memory_model_t *model,
+                                                 uint64_t virt_base,
+                                                 uint64_t phys_base,
+                                                 uint32_t span_bits)
+{
+    return tlb_load(model, virt_base, phys_base, span_bits);
+}
+
+memory_model_error_t memory_model_set_asid(memory_model_t *model, uint32_t asid)
+{
+    if (model == NULL || asid > MEMORY_MODEL_MAX_ASID) {
+        return MEMORY_MODEL_ERROR_BAD_ARGUMENT;
+    }
+
+    if (model->sync != NULL) {
+        seq_write_begin(&model->sync->tlb_seq);
+    }
+    if (asid != model->tlb_asid) {
+        SEQ_STORE(model->direct_epoch, model->direct_epoch + 1U);
+    }
+    SEQ_STORE(model->tlb_asid, asid);
+    if (model->sync != NULL) {
+        seq_write_end(&model->sync->tlb_seq);
+    }
+    return MEMORY_MODEL_ERROR_OK;
+}
+
+memory_model_error_t memory_model_set_page_table(memory_model_t *model, const memory_model_page_table_t *table)
+{
+    if (model == NULL) {
+        return MEMORY_MODEL_ERROR_BAD_ARGUMENT;
+    }
+
+    memory_model_page_table_t page_table;
+    memset(&page_table, 0, sizeof(page_table));
+    if (table != NULL && table->levels != 0U) {
+        /* The two PTE flag bits sit below the frame address, so pages need at least four words. */
+        if (table->levels > MEMORY_MODEL_MAX_PT_LEVELS || table->index_bits == 0U ||
+            table->index_bits > model->page_offset_bits || model->page_offset_bits < 2U ||
+            model->page_offset_bits + table->levels * table->index_bits < model->cfg.virt_addr_width ||
+            model->tlb == NULL || model->cfg.tlb_entries == 0U) {
+            return MEMORY_MODEL_ERROR_BAD_ARGUMENT;
+        }
+        page_table = *table;
+    }
+
+    if (model->sync != NULL) {
+        seq_write_begin(&model->sync->tlb_seq);
+    }
+    SEQ_STORE(model->page_table.root, page_table.root);
+    SEQ_STORE(model->page_table.levels, page_table.levels);
+    SEQ_STORE(model->page_table.index_bits, page_table.index_bits);
+    if (model->sync != NULL) {
+        seq_write_end(&model->sync->tlb_seq);
+    }
+    return MEMORY_MODEL_ERROR_OK;
+}
+
+memory_model_error_t memory_model_flush_tlb(memory_model_t *model)
+{
+    if (model == NULL) {
+        return MEMORY_MODEL_ERROR_BAD_ARGUMENT;
+    }
+
+    if (model->sync != NULL) {
+        seq_write_begin(&model->sync->tlb_seq);
+    }
+    tlb_flush_all(model);
+    if (model->sync != NULL) {
+        seq_write_end(&model->sync->tlb_seq);
+    }
+    return MEMORY_MODEL_ERROR_OK;
+}
+
+memory_model_error_t memory_model_flush_tlb_page(memory_model_t *model, uint64_t virt_addr)
+{
+    if (model == NULL || model->tlb == NULL) {
+        return MEMORY_MODEL_ERROR_BAD_ARGUMENT;
+    }
+
+    if (model->sync != NULL) {
+        seq_write_begin(&model->sync->tlb_seq);
+    }
+
+    /* Drop every entry of the current ASID that covers virt_addr, whatever its span. */
+    uint64_t masked_virt = virt_addr & model->virt_addr_mask;
+    uint64_t classes = model->tlb_span_classes;
+    uint32_t asid = model->tlb_asid;
+    while (classes != 0U) {
+        uint32_t span_bits = (uint32_t)__builtin_ctzll(classes);
+        classes &= classes - 1U;
+
+        uint64_t virt_page = masked_virt >> span_bits;
+        if (tlb_index_find(model, virt_page, span_bits, asid) == NULL) {
+            continue;
+        }
+        for (uint32_t i = 0U; i < model->cfg.tlb_entries; ++i) {
+            const struct tlb_entry *entry = &model->tlb[i];
+            if (tlb_entry_live(model, entry) && entry->span_bits == span_bits && entry->virt_page == virt_page &&
+                entry->asid == asid) {
+                tlb_evict(model, i);
+            }
+        }
+    }
+
+    if (model->sync != NULL) {
+        seq_write_end(&model->sync->tlb_seq);
+    }
+    return MEMORY_MODEL_ERROR_OK;
+}
+
+static void tlb_export_locked(const memory_model_t *model, memory_model_tlb_entry_t *entries_out,
+                              uint32_t *write_index_out)
+{
+    for (uint32_t i = 0U; i < model->cfg.tlb_entries; ++i) {
+        const struct tlb_entry *entry = &model->tlb[i];
+        memory_model_tlb_entry_t *out = &entries_out[i];
+        if (tlb_entry_live(model, entry)) {
+            out->valid = true;
+            out->span_bits = SEQ_LOAD(entry->span_bits);
+            out->asid = SEQ_LOAD(entry->asid);
+            out->virt_base = SEQ_LOAD(entry->virt_base);
+            out->phys_base = SEQ_LOAD(entry->phys_base);
+        } else {
+            memset(out, 0, sizeof(*out));
+        }
+    }
+    if (write_index_out != NULL) {
+        *write_index_out = SEQ_LOAD(model->tlb_write_ptr);
+    }
+}
+
+memory_model_error_t memory_model_export_tlb(const memory_model_t *model,
+                                             memory_model_tlb_entry_t *entries_out,
+                                             uint32_t capacity,
+                                             uint32_t *write_index_out)
+{
+    if (model == NULL || entries_out == NULL || capacity < model->cfg.tlb_entries) {
+        return MEMORY_MODEL_ERROR_BAD_ARGUMENT;
+    }
+
+    if (model->sync == NULL) {
+        tlb_export_locked(model, entries_out, write_index_out);
+        return MEMORY_MODEL_ERROR_OK;
+    }
+
+    uint64_t seq;
+    do {
+        seq = seq_read_begin(&model->sync->tlb_seq);
+        tlb_export_locked(model, entries_out, write_index_out);
+    } while (seq_read_retry(&model->sync->tlb_seq, seq));
+    return MEMORY_MODEL_ERROR_OK;
+}
+
+memory_model_error_t memory_model_import_tlb(memory_model_t *model,
+                                             const memory_model_tlb_entry_t *entries,
+                                             uint32_t count,
+                                             uint32_t write_index)
+{
+    if (model == NULL || model->tlb == NULL || (entries == NULL && count != 0U) ||
+        count > model->cfg.tlb_entries || write_index >= model->cfg.tlb_entries) {
+        return MEMORY_MODEL_ERROR_BAD_ARGUMENT;
+    }
+    /* Validate everything first so that a rejected import leaves the TLB untouched. */
+    for (uint32_t i = 0U; i < count; ++i) {
+        if (!entries[i].valid) {
+            continue;
+        }
+        uint32_t span_bits = entries[i].span_bits != 0U ? entries[i].span_bits : model->page_offset_bits;
+        if (!tlb_span_supported(model, span_bits) || entries[i].asid > MEMORY_MODEL_MAX_ASID ||
+            tlb_set_first(model, entries[i].virt_base, span_bits) != i - i % model->tlb_ways) {
+            return MEMORY_MODEL_ERROR_BAD_ARGUMENT;
+        }
+    }
+
+    if (model->sync != NULL) {
+        seq_write_begin(&model->sync->tlb_seq);
+    }
+
+    tlb_flush_all(model);
+    for (uint32_t i = 0U; i < count; ++i) {
+        if (entries[i].valid) {
+            uint32_t span_bits = entries[i].span_bits != 0U ? entries[i].span_bits : model->page_offset_bits;
+            tlb_install(model, i, entries[i].virt_base, entries[i].phys_base, span_bits, entries[i].asid);
+        }
+    }
+    SEQ_STORE(model->tlb_write_ptr, write_index);
+    if (model->tlb_set_next != NULL) {
+        struct tlb_set_cursor *cursor = &model->tlb_set_next[write_index / model->tlb_ways];
+        cursor->generation = model->tlb_generation;
+        cursor->way = write_index % model->tlb_ways;
+    }
+
+    if (model->sync != NULL) {
+        seq_write_end(&model->sync->tlb_seq);
+    }
+    return MEMORY_MODEL_ERROR_OK;
+}
+
+/*
+ * Unchecked transaction kernels. Callers validate the model handle and output
+ * pointers; the kernels only perform the data-dependent checks the RTL does.
+ */
+static inline void count_translation(const memory_model_t *model, bool hit, uint64_t virt_addr, uint32_t slot)
+{
+    if (hit) {
+        tlb_touch(model, slot, false);
+    }
+#if MEMORY_MODEL_ENABLE_STATS
+    if (hit) {
+        COUNT(model, tlb_hits);
+        COUNT_SLOT_HIT(model, slot);
+    } else {
+        counters_record_miss(model, (virt_addr & model->virt_addr_mask) >> model->page_offset_bits);
+    }
+#else
+    (void)model;
+    (void)hit;
+    (void)virt_addr;
+    (void)slot;
+#endif
+}
+
+/* Pure TLB lookup; concurrent callers validate the result against tlb_seq. */
+static inline bool tlb_lookup(const memory_model_t *model, uint64_t virt_addr, uint64_t *phys_addr_out,
+                              uint32_t *slot_out)
+{
+    uint64_t masked_virt = virt_addr & model->virt_addr_mask;
+    uint64_t classes = SEQ_LOAD(model->tlb_span_classes);
+    uint32_t asid = SEQ_LOAD(model->tlb_asid);
+
+    /* Smallest span first: the longest matching prefix wins, as in the RTL. */
+    while (classes != 0U) {
+        uint32_t span_bits = (uint32_t)__builtin_ctzll(classes);
+        classes &= classes - 1U;
+
+        const struct tlb_index_bucket *bucket = tlb_index_find(model, masked_virt >> span_bits, span_bits, asid);
+        if (bucket == NULL) {
+            continue;
+        }
+
+        uint32_t slot = SEQ_LOAD(bucket->slot);
+        if (slot >= model->cfg.tlb_entries) {
+            return false; /* torn read of a bucket being moved; the caller retries */
+        }
+        const struct tlb_entry *entry = &model->tlb[slot];
+        *slot_out = slot;
+        *phys_addr_out = (SEQ_LOAD(entry->phys_frame) | (masked_virt & SEQ_LOAD(entry->offset_mask))) &
+                         model->phys_addr_mask;
+        return true;
+    }
+    return false;
+}
+
+/*
+ * Page-table walker. PTEs are read straight from the backing store, as the
+ * RTL would over its own memory port, and the leaf is filled through the same
+ * round-robin pointer as memory_model_load_tlb(). The lookup paths take a
+ * const model, so a fill from a translate or read casts it back to mutable:
+ * with a walker attached the TLB is a cache of the tables, not caller state.
+ */
+struct page_walk {
+    uint64_t virt_base;
+    uint64_t phys_base;
+    uint32_t span_bits;
+    uint32_t depth; /* PTEs read */
+};
+
+static bool pte_read(const memory_model_t *model, uint64_t phys_addr, uint64_t *pte_out)
+{
+    uint64_t mem_index = phys_addr & model->mem_addr_mask;
+    if (!model->mem_depth_pow2 && mem_index >= model->cfg.mem_depth) {
+        return false;
+    }
+
+    if (model->sync == NULL) {
+        *pte_out = read_word_masked(model, mem_index, model->word_byte_mask);
+        return true;
+    }
+
+    _Atomic uint64_t *stripe_seq = sync_stripe_seq(model, mem_index);
+    uint8_t lane[8] = {0};
+    uint64_t seq;
+    do {
+        seq = seq_read_begin(stripe_seq);
+        const uint8_t *word = store_word_for_read(model, mem_index);
+        if (word != NULL) {
+            seq_copy_in(lane, word, model->lane_bytes);
+        } else {
+            memset(lane, 0, sizeof(lane));
+        }
+    } while (seq_read_retry(stripe_seq, seq));
+    *pte_out = load_word(lane, model->lane_bytes);
+    return true;
+}
+
+/* Walk @table for @virt_addr; false on a page fault. walk->depth is valid either way. */
+static bool page_walk(const memory_model_t *model, const memory_model_page_table_t *table, uint64_t virt_addr,
+                      struct page_walk *walk)
+{
+    uint64_t masked_virt = virt_addr & model->virt_addr_mask;
+    uint64_t virt_page = masked_virt >> model->page_offset_bits;
+    uint64_t index_mask = mask_from_width(table->index_bits);
+    uint64_t frame_mask = model->phys_addr_mask & ~model->page_offset_mask;
+    uint64_t table_base = table->root & frame_mask;
+
+    walk->depth = 0U;
+    for (uint32_t level = 0U; level < table->levels; ++level) {
+        uint32_t shift = table->index_bits * (table->levels - 1U - level);
+        uint64_t index = shift < 64U ? (virt_page >> shift) & index_mask : 0U;
+        uint64_t pte = 0ULL;
+
+        walk->depth++;
+        if (!pte_read(model, (table_base + index) & model->phys_addr_mask, &pte) ||
+            (pte & MEMORY_MODEL_PTE_VALID) == 0U) {
+            return false;
+        }
+        if ((pte & MEMORY_MODEL_PTE_LEAF) != 0U) {
+            uint32_t span_bits = model->page_offset_bits + shift;
+            if (!tlb_span_supported(model, span_bits)) {
+                return false;
+            }
+            walk->span_bits = span_bits;
+            walk->virt_base = masked_virt & ~mask_from_width(span_bits);
+            walk->phys_base = pte & frame_mask;
+            return true;
+        }
+        table_base = pte & frame_mask;
+    }
+    return false; /* the last level held a pointer, not a leaf */
+}
+
+static memory_model_page_table_t page_table_snapshot(const memory_model_t *model)
+{
+    if (model->sync == NULL) {
+        return model->page_table;
+    }
+
+    memory_model_page_table_t table;
+    uint64_t seq;
+    do {
+        seq = seq_read_begin(&model->sync->tlb_seq);
+        table.root = SEQ_LOAD(model->page_table.root);
+        table.levels = SEQ_LOAD(model->page_table.levels);
+        table.index_bits = SEQ_LOAD(model->page_table.index_bits);
+    } while (seq_read_retry(&model->sync->tlb_seq, seq));
+    return table;
+}
+
+/* Walk for @virt_addr and fill the TLB. @depth_out may be NULL. */
+static memory_model_status_t walk_and_fill(const memory_model_t *model,
+                                           uint64_t virt_addr,
+                                           uint64_t *phys_addr_out,
+                                           uint32_t *depth_out)
+{
+    memory_model_page_table_t table = page_table_snapshot(model);
+    struct page_walk walk;
+    walk.depth = 0U;
+
+    bool mapped = table.levels != 0U && page_walk(model, &table, virt_addr, &walk);
+    if (depth_out != NULL) {
+        *depth_out = walk.depth;
+    }
+    if (table.levels != 0U) {
+        COUNT(model, walks);
+        COUNT_N(model, walk_pte_reads, walk.depth);
+    }
+    if (!mapped) {
+        if (table.levels != 0U) {
+            COUNT(model, walk_faults);
+        }
+        *phys_addr_out = 0ULL;
+        return MEMORY_MODEL_STATUS_ERR_ADDR;
+    }
+
+    memory_model_t *cache = (memory_model_t *)model;
+    if (cache->sync != NULL) {
+        /* Another thread may have filled the page while this one walked. */
+        uint64_t phys_addr = 0ULL;
+        uint32_t slot = 0U;
+        seq_write_begin(&cache->sync->tlb_seq);
+        if (!tlb_lookup(cache, virt_addr, &phys_addr, &slot)) {
+            tlb_fill(cache, walk.virt_base, walk.phys_base, walk.span_bits, true);
+        }
+        seq_write_end(&cache->sync->tlb_seq);
+    } else {
+        tlb_fill(cache, walk.virt_base, walk.phys_base, walk.span_bits, true);
+    }
+
+    uint64_t offset_mask = mask_from_width(walk.span_bits);
+    *phys_addr_out = ((walk.phys_base & ~offset_mask) | (virt_addr & offset_mask)) & model->phys_addr_mask;
+    return MEMORY_MODEL_STATUS_OK;
+}
+
+static memory_model_status_t translate_concurrent(const memory_model_t *model,
+                                                  uint64_t virt_addr,
+                                                  uint64_t *phys_addr_out)
+{
+    _Atomic uint64_t *tlb_seq = &model->sync->tlb_seq;
+    uint64_t phys_addr = 0ULL;
+    uint32_t slot = 0U;
+    bool hit;
+    bool walker;
+
+    for (;;) {
+        uint64_t seq = seq_read_begin(tlb_seq);
+        hit = tlb_lookup(model, virt_addr, &phys_addr, &slot);
+        walker = SEQ_LOAD(model->page_table.levels) != 0U;
+        if (!seq_read_retry(tlb_seq, seq)) {
+            break;
+        }
+    }
+
+    count_translation(model, hit, virt_addr, slot);
+    if (!hit && walker) {
+        return walk_and_fill(model, virt_addr, phys_addr_out, NULL);
+    }
+    *phys_addr_out = hit ? phys_addr : 0ULL;
+    return hit ? MEMORY_MODEL_STATUS_OK : MEMORY_MODEL_STATUS_ERR_ADDR;
+}
+
+static inline memory_model_status_t translate_unchecked(const memory_model_t *model,
+                                                        uint64_t virt_addr,
+                                                        uint64_t *phys_addr_out)
+{
+    if (model->sync != NULL) {
+        return translate_concurrent(model, virt_addr, phys_addr_out);
+    }
+
+    uint32_t slot = 0U;
+    bool hit = tlb_lookup(model, virt_addr, phys_addr_out, &slot);
+    count_translation(model, hit, virt_addr, slot);
+    if (!hit) {
+        if (model->page_table.levels != 0U) {
+            return walk_and_fill(model, virt_addr, phys_addr_out, NULL);
+        }
+        *phys_addr_out = 0ULL;
+        return MEMORY_MODEL_STATUS_ERR_ADDR;
+    }
+    return MEMORY_MODEL_STATUS_OK;
+}
+
+/*
+ * Concurrent data paths. A read is linearised at its successful stripe
+ * validation and a write at the point it holds the stripe with the TLB
+ * unchanged since translation; both retry if a TLB update intervened.
+ */
+static memory_model_status_t read_concurrent(const memory_model_t *model,
+                                             uint64_t virt_addr,
+                                             uint64_t effective_mask,
+                                             uint8_t *out,
+                                             uint32_t bytes)
+{
+    _Atomic uint64_t *tlb_seq = &model->sync->tlb_seq;
+    memory_model_status_t status = MEMORY_MODEL_STATUS_OK;
+    uint32_t slot = 0U;
+    bool hit;
+    bool counted = false;
+
+    for (;;) {
+        uint64_t seq = seq_read_begin(tlb_seq);
+        uint64_t phys_addr = 0ULL;
+        hit = tlb_lookup(model, virt_addr, &phys_addr, &slot);
+        if (!hit && SEQ_LOAD(model->page_table.levels) != 0U) {
+            if (seq_read_retry(tlb_seq, seq)) {
+                continue;
+            }
+            count_translation(model, false, virt_addr, slot);
+            counted = true;
+            status = walk_and_fill(model, virt_addr, &phys_addr, NULL);
+            if (status != MEMORY_MODEL_STATUS_OK) {
+                break;
+            }
+            continue; /* redo the access against the refilled TLB */
+        }
+        status = hit ? MEMORY_MODEL_STATUS_OK : MEMORY_MODEL_STATUS_ERR_ADDR;
+
+        uint64_t mem_index = phys_addr & model->mem_addr_mask;
+        if (hit && !model->mem_depth_pow2 && mem_index >= model->cfg.mem_depth) {
+            status = MEMORY_MODEL_STATUS_ERR_ACCESS;
+        } else if (hit) {
+            _Atomic uint64_t *stripe_seq = sync_stripe_seq(model, mem_index);
+            uint64_t stripe_start = seq_read_begin(stripe_seq);
+            const uint8_t *word = store_word_for_read(model, mem_index);
+            if (word != NULL) {
+                seq_copy_in(out, word, bytes);
+            } else {
+                memset(out, 0, bytes);
+            }
+            if (seq_read_retry(stripe_seq, stripe_start)) {
+                continue;
+            }
+        }
+
+        if (!seq_read_retry(tlb_seq, seq)) {
+            break;
+        }
+    }
+
+    if (!counted) {
+        count_translation(model, hit, virt_addr, slot);
+    }
+    if (status != MEMORY_MODEL_STATUS_OK) {
+        memset(out, 0, bytes);
+    } else if (effective_mask != wide_mask_for_bytes(bytes)) {
+        masked_read_bytes(model, out, out, effective_mask, bytes);
+    }
+    return status;
+}
+
+static memory_model_status_t write_concurrent(memory_model_t *model,
+                                              uint64_t virt_addr,
+                                              uint64_t byte_mask,
+                                              const uint8_t *in,
+                                              uint32_t bytes)
+{
+    _Atomic uint64_t *tlb_seq = &model->sync->tlb_seq;
+    memory_model_status_t status = MEMORY_MODEL_STATUS_OK;
+    uint32_t slot = 0U;
+    bool hit;
+    bool counted = false;
+
+    for (;;) {
+        uint64_t seq = seq_read_begin(tlb_seq);
+        uint64_t phys_addr = 0ULL;
+        hit = tlb_lookup(model, virt_addr, &phys_addr, &slot);
+        if (!hit && SEQ_LOAD(model->page_table.levels) != 0U) {
+            if (seq_read_retry(tlb_seq, seq)) {
+                continue;
+            }
+            count_translation(model, false, virt_addr, slot);
+            counted = true;
+            status = walk_and_fill(model, virt_addr, &phys_addr, NULL);
+            if (status != MEMORY_MODEL_STATUS_OK) {
+                break;
+            }
+            continue;
+        }
+
+        uint64_t mem_index = phys_addr & model->mem_addr_mask;
+        if (!hit || byte_mask == 0U || (!model->mem_depth_pow2 && mem_index >= model->cfg.mem_depth)) {
+            if (seq_read_retry(tlb_seq, seq)) {
+                continue;
+            }
+            status = !hit ? MEMORY_MODEL_STATUS_ERR_ADDR
+                          : (byte_mask == 0U ? MEMORY_MODEL_STATUS_OK : MEMORY_MODEL_STATUS_ERR_ACCESS);
+            break;
+        }
+
+        _Atomic uint64_t *stripe_seq = sync_stripe_seq(model, mem_index);
+        seq_write_begin(stripe_seq);
+        if (seq_read_retry(tlb_seq, seq)) {
+            seq_write_end(stripe_seq);
+            continue;
+        }
+
+        uint8_t *word = store_word_for_write(model, mem_index);
+        if (word == NULL) {
+            status = MEMORY_MODEL_STATUS_ERR_WRITE;
+        } else {
+            /* Merge privately, then publish the whole word with atomic stores. */
+            uint8_t merged[MEMORY_MODEL_MAX_WORD_BYTES];
+            memcpy(merged, word, bytes);
+            masked_write_bytes(model, merged, in, byte_mask, bytes);
+            seq_copy_out(word, merged, bytes);
+        }
+        seq_write_end(stripe_seq);
+        break;
+    }
+
+    if (!counted) {
+        count_translation(model, hit, virt_addr, slot);
+    }
+    return status;
+}
+
+static inline memory_model_status_t read_unchecked(const memory_model_t *model,
+                                                   uint64_t virt_addr,
+                                                   uint32_t byte_mask,
+                                                   uint64_t *data_out,
+                                                   memory_model_cache_result_t *cache_out)
+{
+    const uint32_t valid_mask = model->word_byte_mask;
+    COUNT(model, reads);
+    if ((byte_mask & ~valid_mask) != 0U) {
+        *data_out = 0ULL;
+        return MEMORY_MODEL_STATUS_ERR_ACCESS;
+    }
+
+    uint32_t effective_mask = byte_mask;
+    if (effective_mask == 0U) {
+        effective_mask = valid_mask;
+    }
+
+    if (model->sync != NULL) {
+        uint8_t lane[8];
+        memory_model_status_t status = read_concurrent(model, virt_addr, effective_mask, lane, model->lane_bytes);
+        *data_out = load_word(lane, model->lane_bytes);
+        return status;
+    }
+
+    uint64_t phys_addr = 0ULL;
+    memory_model_status_t translate_status = translate_unchecked(model, virt_addr, &phys_addr);
+    if (translate_status != MEMORY_MODEL_STATUS_OK) {
+        *data_out = 0ULL;
+        return translate_status;
+    }
+
+    uint64_t mem_index = phys_addr & model->mem_addr_mask;
+    if (!model->mem_depth_pow2 && mem_index >= model->cfg.mem_depth) {
+        *data_out = 0ULL;
+        return MEMORY_MODEL_STATUS_ERR_ACCESS;
+    }
+
+    cache_note(model, mem_index, false, cache_out);
+    *data_out = read_word_masked(model, mem_index, effective_mask);
+    return MEMORY_MODEL_STATUS_OK;
+}
+
+static inline memory_model_status_t write_unchecked(memory_model_t *model,
+                                                    uint64_t virt_addr,
+                                                    uint32_t byte_mask,
+                                                    uint64_t data,
+                                                    memory_model_cache_result_t *cache_out)
+{
+    const uint32_t valid_mask = model->word_byte_mask;
+    COUNT(model, writes);
+    if ((byte_mask & ~valid_mask) != 0U) {
+        return MEMORY_MODEL_STATUS_ERR_WRITE;
+    }
+
+    if (model->sync != NULL) {
+        uint8_t lane[8];
+        store_word(lane, data, model->lane_bytes);
+        return write_concurrent(model, virt_addr, byte_mask, lane, model->lane_bytes);
+    }
+
+    uint64_t phys_addr = 0ULL;
+    memory_model_status_t translate_status = translate_unchecked(model, virt_addr, &phys_addr);
+    if (translate_status != MEMORY_MODEL_STATUS_OK) {
+        return translate_status;
+    }
+
+    if (byte_mask == 0U) {
+        return MEMORY_MODEL_STATUS_OK;
+    }
+
+    uint64_t mem_index = phys_addr & model->mem_addr_mask;
+    if (!model->mem_depth_pow2 && mem_index >= model->cfg.mem_depth) {
+        return MEMORY_MODEL_STATUS_ERR_ACCESS;
+    }
+
+    uint8_t *word = store_word_for_write(model, mem_index);
+    if (word == NULL) {
+        return MEMORY_MODEL_STATUS_ERR_WRITE;
+    }
+    cache_note(model, mem_index, true, cache_out);
+    write_word_masked(model, word, byte_mask, data);
+    return MEMORY_MODEL_STATUS_OK;
+}
+
+/*
+ * Byte-buffer kernels behind the wide API and the concurrent block fallback.
+ * @bytes is the number of leading bytes of the word that take part; the mask
+ * may only select among them.
+ */
+static memory_model_status_t read_bytes_unchecked(const memory_model_t *model,
+                                                  uint64_t virt_addr,
+                                                  uint64_t byte_mask,
+                                                  uint8_t *out,
+                                                  uint32_t bytes)
+{
+    const uint64_t valid_mask = wide_mask_for_bytes(bytes);
+    COUNT(model, reads);
+    if ((byte_mask & ~valid_mask) != 0U) {
+        memset(out, 0, bytes);
+        return MEMORY_MODEL_STATUS_ERR_ACCESS;
+    }
+
+    uint64_t effective_mask = byte_mask != 0U ? byte_mask : valid_mask;
+    if (model->sync != NULL) {
+        return read_concurrent(model, virt_addr, effective_mask, out, bytes);
+    }
+
+    uint64_t phys_addr = 0ULL;
+    memory_model_status_t status = translate_unchecked(model, virt_addr, &phys_addr);
+    uint64_t mem_index = phys_addr & model->mem_addr_mask;
+    if (status == MEMORY_MODEL_STATUS_OK && !model->mem_depth_pow2 && mem_index >= model->cfg.mem_depth) {
+        status = MEMORY_MODEL_STATUS_ERR_ACCESS;
+    }
+    if (status != MEMORY_MODEL_STATUS_OK) {
+        memset(out, 0, bytes);
+        return status;
+    }
+
+    cache_note(model, mem_index, false, NULL);
+    const uint8_t *word = store_word_for_read(model, mem_index);
+    if (word == NULL) {
+        memset(out, 0, bytes);
+    } else {
+        masked_read_bytes(model, out, word, effective_mask, bytes);
+    }
+    return MEMORY_MODEL_STATUS_OK;
+}
+
+static memory_model_status_t write_bytes_unchecked(memory_model_t *model,
+                                                   uint64_t virt_addr,
+                                                   uint64_t byte_mask,
+                                                   const uint8_t *in,
+                                                   uint32_t bytes)
+{
+    COUNT(model, writes);
+    if ((byte_mask & ~wide_mask_for_bytes(bytes)) != 0U) {
+        return MEMORY_MODEL_STATUS_ERR_WRITE;
+    }
+
+    if (model->sync != NULL) {
+        return write_concurrent(model, virt_addr, byte_mask, in, bytes);
+    }
+
+    uint64_t phys_addr = 0ULL;
+    memory_model_status_t status = translate_unchecked(model, virt_addr, &phys_addr);
+    if (status != MEMORY_MODEL_STATUS_OK || byte_mask == 0U) {
+        return status;
+    }
+
+    uint64_t mem_index = phys_addr & model->mem_addr_mask;
+    if (!model->mem_depth_pow2 && mem_index >= model->cfg.mem_depth) {
+        return MEMORY_MODEL_STATUS_ERR_ACCESS;
+    }
+
+    uint8_t *word = store_word_for_write(model, mem_index);
+    if (word == NULL) {
         return MEMORY_MODEL_STATUS_ERR_WRITE;
     }
+    cache_note(model, mem_index, true, NULL);
+    masked_write_bytes(model, word, in, byte_mask, bytes);
+    return MEMORY_MODEL_STATUS_OK;
+}
+
+static inline memory_model_status_t execute_unchecked(memory_model_t *model,
+                                                      memory_model_op_t op,
+                                                      uint64_t virt_addr,
+                                                      uint32_t byte_mask,
+                                                      uint64_t data,
+                                                      uint64_t *data_out)
+{
+    *data_out = 0ULL;
+
+    switch (op) {
+    case MEMORY_MODEL_OP_READ:
+        return read_unchecked(model, virt_addr, byte_mask, data_out, NULL);
+    case MEMORY_MODEL_OP_WRITE:
+        return write_unchecked(model, virt_addr, byte_mask, data, NULL);
+    case MEMORY_MODEL_OP_TLB_LOAD:
+        return memory_model_load_tlb(model, virt_addr, data) == MEMORY_MODEL_ERROR_OK
+                   ? MEMORY_MODEL_STATUS_OK
+                   : MEMORY_MODEL_STATUS_ERR_ACCESS;
+    case MEMORY_MODEL_OP_FLUSH: {
+        memory_model_error_t err = byte_mask != 0U ? memory_model_flush_tlb_page(model, virt_addr)
+                                                   : memory_model_flush_tlb(model);
+        return err == MEMORY_MODEL_ERROR_OK ? MEMORY_MODEL_STATUS_OK : MEMORY_MODEL_STATUS_ERR_ACCESS;
+    }
+    case MEMORY_MODEL_OP_SET_ASID:
+        return data <= MEMORY_MODEL_MAX_ASID && memory_model_set_asid(model, (uint32_t)data) == MEMORY_MODEL_ERROR_OK
+                   ? MEMORY_MODEL_STATUS_OK
+                   : MEMORY_MODEL_STATUS_ERR_ACCESS;
+    default:
+        return MEMORY_MODEL_STATUS_ERR_ACCESS;
+    }
+}
+
+memory_model_status_t memory_model_translate(const memory_model_t *model,
+                                              uint64_t virt_addr,
+                                              uint64_t *phys_addr_out)
+{
+    if (phys_addr_out == NULL || model == NULL) {
+        if (phys_addr_out != NULL) {
+            *phys_addr_out = 0ULL;
+        }
+        return MEMORY_MODEL_STATUS_ERR_ACCESS;
+    }
+
+    return translate_unchecked(model, virt_addr, phys_addr_out);
+}
+
+memory_model_status_t memory_model_lookup(const memory_model_t *model,
+                                          uint64_t virt_addr,
+                                          uint64_t *phys_addr_out)
+{
+    if (phys_addr_out == NULL || model == NULL) {
+        if (phys_addr_out != NULL) {
+            *phys_addr_out = 0ULL;
+        }
+        return MEMORY_MODEL_STATUS_ERR_ACCESS;
+    }
+
+    uint64_t phys_addr = 0ULL;
+    uint32_t slot = 0U;
+    bool hit;
+    if (model->sync != NULL) {
+        _Atomic uint64_t *tlb_seq = &model->sync->tlb_seq;
+        for (;;) {
+            uint64_t seq = seq_read_begin(tlb_seq);
+            hit = tlb_lookup(model, virt_addr, &phys_addr, &slot);
+            if (!seq_read_retry(tlb_seq, seq)) {
+                break;
+            }
+        }
+    } else {
+        hit = tlb_lookup(model, virt_addr, &phys_addr, &slot);
+    }
+    *phys_addr_out = hit ? phys_addr : 0ULL;
+    return hit ? MEMORY_MODEL_STATUS_OK : MEMORY_MODEL_STATUS_ERR_ADDR;
+}
+
+memory_model_status_t memory_model_walk(memory_model_t *model,
+                                        uint64_t virt_addr,
+                                        uint64_t *phys_addr_out,
+                                        uint32_t *depth_out)
+{
+    if (depth_out != NULL) {
+        *depth_out = 0U;
+    }
+    if (phys_addr_out == NULL || model == NULL) {
+        if (phys_addr_out != NULL) {
+            *phys_addr_out = 0ULL;
+        }
+        return MEMORY_MODEL_STATUS_ERR_ACCESS;
+    }
+
+    return walk_and_fill(model, virt_addr, phys_addr_out, depth_out);
+}
+
+memory_model_status_t memory_model_read(const memory_model_t *model,
+                                         uint64_t virt_addr,
+                                         uint32_t byte_mask,
+                                         uint64_t *data_out)
+{
+    if (data_out == NULL || model == NULL) {
+        if (data_out != NULL) {
+            *data_out = 0ULL;
+        }
+        return MEMORY_MODEL_STATUS_ERR_ACCESS;
+    }
+
+    return read_unchecked(model, virt_addr, byte_mask, data_out, NULL);
+}
+
+memory_model_status_t memory_model_write(memory_model_t *model,
+                                          uint64_t virt_addr,
+                                          uint32_t byte_mask,
+                                          uint64_t data)
+{
+    if (model == NULL) {
+        return MEMORY_MODEL_STATUS_ERR_ACCESS;
+    }
+
+    return write_unchecked(model, virt_addr, byte_mask, data, NULL);
+}
+
+memory_model_status_t memory_model_read_cached(const memory_model_t *model,
+                                                uint64_t virt_addr,
+                                                uint32_t byte_mask,
+                                                uint64_t *data_out,
+                                                memory_model_cache_result_t *cache_out)
+{
+    if (cache_out != NULL) {
+        *cache_out = MEMORY_MODEL_CACHE_NONE;
+    }
+    if (data_out == NULL || model == NULL) {
+        if (data_out != NULL) {
+            *data_out = 0ULL;
+        }
+        return MEMORY_MODEL_STATUS_ERR_ACCESS;
+    }
+
+    return read_unchecked(model, virt_addr, byte_mask, data_out, cache_out);
+}
+
+memory_model_status_t memory_model_write_cached(memory_model_t *model,
+                                                 uint64_t virt_addr,
+                                                 uint32_t byte_mask,
+                                                 uint64_t data,
+                                                 memory_model_cache_result_t *cache_out)
+{
+    if (cache_out != NULL) {
+        *cache_out = MEMORY_MODEL_CACHE_NONE;
+    }
+    if (model == NULL) {
+        return MEMORY_MODEL_STATUS_ERR_ACCESS;
+    }
+
+    return write_unchecked(model, virt_addr, byte_mask, data, cache_out);
+}
+
+memory_model_error_t memory_model_flush_cache(memory_model_t *model)
+{
+    if (model == NULL) {
+        return MEMORY_MODEL_ERROR_BAD_ARGUMENT;
+    }
+
+    struct data_cache *cache = model->cache;
+    if (cache == NULL) {
+        return MEMORY_MODEL_ERROR_OK;
+    }
+    for (uint64_t i = 0U; i < cache->lines; ++i) {
+        if (cache->tags[i] != CACHE_LINE_EMPTY && cache->dirty[i]) {
+            COUNT(model, cache_writebacks);
+        }
+    }
+    cache_clear(cache);
+    return MEMORY_MODEL_ERROR_OK;
+}
+
+memory_model_status_t memory_model_read_wide(const memory_model_t *model,
+                                              uint64_t virt_addr,
+                                              uint64_t byte_mask,
+                                              void *data_out)
+{
+    if (model == NULL || data_out == NULL) {
+        return MEMORY_MODEL_STATUS_ERR_ACCESS;
+    }
+
+    return read_bytes_unchecked(model, virt_addr, byte_mask, data_out, model->bytes_per_word);
+}
+
+memory_model_status_t memory_model_write_wide(memory_model_t *model,
+                                               uint64_t virt_addr,
+                                               uint64_t byte_mask,
+                                               const void *data)
+{
+    if (model == NULL || data == NULL) {
+        return MEMORY_MODEL_STATUS_ERR_ACCESS;
+    }
+
+    return write_bytes_unchecked(model, virt_addr, byte_mask, data, model->bytes_per_word);
+}
+
+memory_model_simd_t memory_model_get_simd(const memory_model_t *model)
+{
+    if (model == NULL) {
+        return MEMORY_MODEL_SIMD_AUTO;
+    }
+    return model->wide->level;
+}
+
+/*
+ * Block transfers. Consecutive virtual word addresses within one page map to
+ * consecutive physical words, so a block is translated once per virtual page
+ * and copied with one memcpy per run that stays inside a backing-store page.
+ * Buffers use the store's own byte order (byte i of word w at offset
+ * w * bytes_per_word + i), so no per-word conversion is needed.
+ */
+static inline uint64_t block_run_words(const memory_model_t *model, uint64_t mem_index, uint64_t words)
+{
+    uint64_t run = STORE_PAGE_WORDS - (mem_index & (STORE_PAGE_WORDS - 1U));
+    /* Power-of-two stores wrap like the RTL index; other depths fault at the end. */
+    uint64_t store_left = model->mem_depth_pow2 ? model->mem_addr_mask - mem_index + 1U
+                                                : model->cfg.mem_depth - mem_index;
+    if (store_left < run) {
+        run = store_left;
+    }
+    return words < run ? words : run;
+}
+
+static inline uint64_t block_page_words(const memory_model_t *model, uint64_t virt_addr)
+{
+    return model->page_offset_mask - (virt_addr & model->page_offset_mask) + 1U;
+}
+
+/* Concurrent models keep per-word linearizability by issuing word transactions. */
+static memory_model_status_t read_block_by_word(const memory_model_t *model, uint64_t virt_addr, uint8_t *out,
+                                                size_t length)
+{
+    const size_t bytes_per_word = model->bytes_per_word;
+    for (; length > 0U; ++virt_addr) {
+        size_t bytes = length < bytes_per_word ? length : bytes_per_word;
+        memory_model_status_t status = read_bytes_unchecked(model, virt_addr, 0U, out, (uint32_t)bytes);
+        if (status != MEMORY_MODEL_STATUS_OK) {
+            memset(out, 0, length);
+            return status;
+        }
+        out += bytes;
+        length -= bytes;
+    }
+    return MEMORY_MODEL_STATUS_OK;
+}
+
+static memory_model_status_t write_block_by_word(memory_model_t *model, uint64_t virt_addr, const uint8_t *in,
+                                                 size_t length)
+{
+    const size_t bytes_per_word = model->bytes_per_word;
+    for (; length > 0U; ++virt_addr) {
+        size_t bytes = length < bytes_per_word ? length : bytes_per_word;
+        memory_model_status_t status =
+            write_bytes_unchecked(model, virt_addr, wide_mask_for_bytes((uint32_t)bytes), in, (uint32_t)bytes);
+        if (status != MEMORY_MODEL_STATUS_OK) {
+            return status;
+        }
+        in += bytes;
+        length -= bytes;
+    }
+    return MEMORY_MODEL_STATUS_OK;
+}
+
+memory_model_status_t memory_model_read_block(const memory_model_t *model,
+                                               uint64_t virt_addr,
+                                               void *buffer,
+                                               size_t length)
+{
+    if (model == NULL || (buffer == NULL && length > 0U)) {
+        return MEMORY_MODEL_STATUS_ERR_ACCESS;
+    }
+
+    uint8_t *out = buffer;
+    if (model->sync != NULL) {
+        return read_block_by_word(model, virt_addr, out, length);
+    }
+
+    const size_t bytes_per_word = model->bytes_per_word;
+    while (length > 0U) {
+        uint64_t phys_addr = 0ULL;
+        memory_model_status_t status = translate_unchecked(model, virt_addr, &phys_addr);
+        if (status != MEMORY_MODEL_STATUS_OK) {
+            COUNT(model, reads);
+            memset(out, 0, length);
+            return status;
+        }
+
+        uint64_t page_words = block_page_words(model, virt_addr);
+        uint64_t mem_index = phys_addr & model->mem_addr_mask;
+        virt_addr += page_words;
+
+        while (page_words > 0U && length > 0U) {
+            if (!model->mem_depth_pow2 && mem_index >= model->cfg.mem_depth) {
+                COUNT(model, reads);
+                memset(out, 0, length);
+                return MEMORY_MODEL_STATUS_ERR_ACCESS;
+            }
+
+            uint64_t run = block_run_words(model, mem_index, page_words);
+            size_t bytes = (size_t)run * bytes_per_word < length ? (size_t)run * bytes_per_word : length;
+            const uint8_t *src = store_word_for_read(model, mem_index);
+            if (src != NULL) {
+                memcpy(out, src, bytes);
+            } else {
+                memset(out, 0, bytes);
+            }
+            COUNT_N(model, reads, (bytes + bytes_per_word - 1U) / bytes_per_word);
+            if (model->cache != NULL) {
+                cache_access_run(model, mem_index, (bytes + bytes_per_word - 1U) / bytes_per_word, false);
+            }
+
+            out += bytes;
+            length -= bytes;
+            page_words -= run;
+            mem_index = (mem_index + run) & model->mem_addr_mask;
+        }
+    }
+    return MEMORY_MODEL_STATUS_OK;
+}
+
+memory_model_status_t memory_model_write_block(memory_model_t *model,
+                                                uint64_t virt_addr,
+                                                const void *buffer,
+                                                size_t length)
+{
+    if (model == NULL || (buffer == NULL && length > 0U)) {
+        return MEMORY_MODEL_STATUS_ERR_ACCESS;
+    }
+
+    const uint8_t *in = buffer;
+    if (model->sync != NULL) {
+        return write_block_by_word(model, virt_addr, in, length);
+    }
+
+    const size_t bytes_per_word = model->bytes_per_word;
+    while (length > 0U) {
+        uint64_t phys_addr = 0ULL;
+        memory_model_status_t status = translate_unchecked(model, virt_addr, &phys_addr);
+        if (status != MEMORY_MODEL_STATUS_OK) {
+            COUNT(model, writes);
+            return status;
+        }
+
+        uint64_t page_words = block_page_words(model, virt_addr);
+        uint64_t mem_index = phys_addr & model->mem_addr_mask;
+        virt_addr += page_words;
+
+        while (page_words > 0U && length > 0U) {
+            if (!model->mem_depth_pow2 && mem_index >= model->cfg.mem_depth) {
+                COUNT(model, writes);
+                return MEMORY_MODEL_STATUS_ERR_ACCESS;
+            }
+
+            uint64_t run = block_run_words(model, mem_index, page_words);
+            size_t bytes = (size_t)run * bytes_per_word < length ? (size_t)run * bytes_per_word : length;
+            uint8_t *dst = store_word_for_write(model, mem_index);
+            COUNT_N(model, writes, (bytes + bytes_per_word - 1U) / bytes_per_word);
+            if (dst == NULL) {
+                return MEMORY_MODEL_STATUS_ERR_WRITE;
+            }
+            /* A short final word keeps its upper bytes, as with a masked write. */
+            memcpy(dst, in, bytes);
+            if (model->cache != NULL) {
+                cache_access_run(model, mem_index, (bytes + bytes_per_word - 1U) / bytes_per_word, true);
+            }
+
+            in += bytes;
+            length -= bytes;
+            page_words -= run;
+            mem_index = (mem_index + run) & model->mem_addr_mask;
+        }
+    }
+    return MEMORY_MODEL_STATUS_OK;
+}
+
+memory_model_status_t memory_model_get_direct(memory_model_t *model,
+                                              uint64_t virt_addr,
+                                              memory_model_direct_t *direct_out)
+{
+    if (direct_out == NULL || model == NULL) {
+        return MEMORY_MODEL_STATUS_ERR_ACCESS;
+    }
+    memset(direct_out, 0, sizeof(*direct_out));
+    if (model->sync != NULL) {
+        return MEMORY_MODEL_STATUS_ERR_ACCESS;
+    }
+
+    uint64_t phys_addr = 0ULL;
+    uint32_t slot = 0U;
+    if (!tlb_lookup(model, virt_addr, &phys_addr, &slot)) {
+        return MEMORY_MODEL_STATUS_ERR_ADDR;
+    }
+    uint64_t mem_index = phys_addr & model->mem_addr_mask;
+    if (!model->mem_depth_pow2 && mem_index >= model->cfg.mem_depth) {
+        return MEMORY_MODEL_STATUS_ERR_ACCESS;
+    }
+
+    /* The run stays within the entry's span, one store page and the end of the store. */
+    uint64_t masked_virt = virt_addr & model->virt_addr_mask;
+    uint64_t offset_mask = model->tlb[slot].offset_mask;
+    uint64_t entry_before = masked_virt & offset_mask;
+    uint64_t page_before = mem_index & (STORE_PAGE_WORDS - 1U);
+    uint64_t before = entry_before < page_before ? entry_before : page_before;
+    uint64_t after = block_run_words(model, mem_index, offset_mask - entry_before + 1U);
+
+    /* Materialise the page as a write would: allocated, private and current. */
+    uint8_t *word = store_word_for_write(model, mem_index);
+    if (word == NULL) {
+        return MEMORY_MODEL_STATUS_ERR_ACCESS;
+    }
+    direct_out->host = word - (size_t)before * model->bytes_per_word;
+    direct_out->virt_base = masked_virt - before;
+    direct_out->phys_base = phys_addr - before;
+    direct_out->words = before + after;
+    return MEMORY_MODEL_STATUS_OK;
+}
+
+uint64_t memory_model_direct_epoch(const memory_model_t *model)
+{
+    return model != NULL ? SEQ_LOAD(model->direct_epoch) : 0U;
+}
+
+memory_model_status_t memory_model_execute(memory_model_t *model,
+                                            const memory_model_transaction_t *transaction,
+                                            memory_model_result_t *result)
+{
+    if (model == NULL || transaction == NULL || result == NULL) {
+        if (result != NULL) {
+            result->status = MEMORY_MODEL_STATUS_ERR_ACCESS;
+            result->data = 0ULL;
+        }
+        return MEMORY_MODEL_STATUS_ERR_ACCESS;
+    }
 
-    uint64_t phys_addr = 0ULL;
-    memory_model_status_t translate_status = memory_model_translate(model, virt_addr, &phys_addr);
-    if (translate_status != MEMORY_MODEL_STATUS_OK) {
-        return translate_status;
+    result->status = execute_unchecked(model, transaction->op, transaction->virt_addr,
+                                       transaction->byte_mask, transaction->data, &result->data);
+    return result->status;
+}
+
+memory_model_error_t memory_model_execute_batch(memory_model_t *model,
+                                                const memory_model_batch_t *batch,
+                                                const memory_model_batch_results_t *results)
+{
+    if (model == NULL || batch == NULL || results == NULL) {
+        return MEMORY_MODEL_ERROR_BAD_ARGUMENT;
+    }
+    if (batch->count == 0U) {
+        return MEMORY_MODEL_ERROR_OK;
+    }
+    if (batch->op == NULL || batch->virt_addr == NULL || results->status == NULL ||
+        results->data == NULL) {
+        return MEMORY_MODEL_ERROR_BAD_ARGUMENT;
     }
 
-    if (byte_mask == 0U) {
-        return MEMORY_MODEL_STATUS_OK;
+    const size_t count = batch->count;
+    const uint8_t *op = batch->op;
+    const uint64_t *virt_addr = batch->virt_addr;
+    const uint32_t *byte_mask = batch->byte_mask;
+    const uint64_t *data = batch->data;
+    memory_model_status_t *status = results->status;
+    uint64_t *data_out = results->data;
+
+    for (size_t i = 0U; i < count; ++i) {
+        /* Absent mask/data columns behave as all-zero inputs. */
+        uint32_t mask = byte_mask != NULL ? byte_mask[i] : 0U;
+        uint64_t value = data != NULL ? data[i] : 0ULL;
+
+        status[i] = execute_unchecked(model, (memory_model_op_t)op[i], virt_addr[i], mask, value,
+                                      &data_out[i]);
     }
 
-    size_t mem_index = (size_t)(phys_addr & model->mem_addr_mask);
-    if (!model->mem_depth_pow2 && mem_index >= model->cfg.mem_depth) {
-        return MEMORY_MODEL_STATUS_ERR_ACCESS;
+    return MEMORY_MODEL_ERROR_OK;
+}
+
+/*
+ * Parallel batch executor.
+ *
+ * The batch is cut at every TLB load, flush or ASID switch, which run
+ * serially, so the translation state is fixed within each run of data
+ * operations between them. Each such run is processed in windows of at most
+ * PARALLEL_WINDOW_OPS operations:
+ *
+ *   1. classify: every thread translates a contiguous chunk of the window,
+ *      finalises operations that fail before touching memory, and counts the
+ *      remaining ones per bucket. A bucket is a hash of the backing-store page,
+ *      so all accesses to one page fall into the same bucket.
+ *   2. plan: one thread turns the counts into bucket offsets and allocates any
+ *      L2 directory tables that writes in a sparse model will need.
+ *   3. scatter: every thread writes its chunk's operation offsets into the
+ *      bucket-ordered array. Chunks are ordered, so each bucket lists its
+ *      operations in program order.
+ *   4. execute: buckets touch disjoint pages and are independent. Each thread
+ *      drains a contiguous range of buckets through an atomic cursor and then
+ *      steals from the other threads' cursors.
+ *
+ * Results, memory contents and statistics match memory_model_execute_batch().
+ * Windows too small to amortise the phase barriers run serially.
+ */
+#define PARALLEL_WINDOW_OPS (1U << 20U)
+#define PARALLEL_MIN_OPS_PER_THREAD 2048U
+#define PARALLEL_BUCKETS_PER_THREAD 16U
+#define PARALLEL_MAX_THREADS 256U
+#define PARALLEL_NO_ACCESS UINT64_MAX
+
+struct parallel_barrier {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    uint32_t count;
+    uint32_t arrived;
+    uint64_t phase;
+};
+
+struct parallel_exec;
+
+struct parallel_worker {
+    _Alignas(SYNC_ALIGNMENT) _Atomic uint32_t next_bucket;
+    uint32_t bucket_end;
+
+    struct parallel_exec *exec;
+    uint32_t id;
+    pthread_t thread;
+
+    uint64_t reads;
+    uint64_t writes;
+    uint64_t tlb_hits;
+    uint64_t tlb_misses;
+    uint64_t *slot_hits;
+    uint64_t *miss_pages;
+    size_t miss_count;
+    size_t miss_capacity;
+    size_t pages_allocated;
+};
+
+struct parallel_exec {
+    memory_model_t *model;
+    const memory_model_batch_t *batch;
+    const memory_model_batch_results_t *results;
+
+    uint32_t threads;
+    uint32_t bucket_bits;
+    uint32_t buckets;
+
+    uint64_t *mem_index;     /* per window operation, PARALLEL_NO_ACCESS if finished */
+    uint32_t *order;         /* window offsets grouped by bucket */
+    uint32_t *bucket_cursor; /* threads rows of buckets counts, then scatter cursors */
+    uint32_t *bucket_start;  /* buckets + 1 offsets into order */
+    _Atomic uint64_t *l2_needed; /* bitmap over L1 entries; sparse models only */
+
+    size_t next_op;
+    size_t window_begin;
+    size_t window_end;
+    bool done;
+
+    struct parallel_barrier barrier;
+    struct parallel_worker *workers;
+};
+
+static int parallel_barrier_init(struct parallel_barrier *barrier, uint32_t count)
+{
+    barrier->count = count;
+    barrier->arrived = 0U;
+    barrier->phase = 0U;
+    if (pthread_mutex_init(&barrier->lock, NULL) != 0) {
+        return -1;
+    }
+    if (pthread_cond_init(&barrier->cond, NULL) != 0) {
+        pthread_mutex_destroy(&barrier->lock);
+        return -1;
+    }
+    return 0;
+}
+
+static void parallel_barrier_destroy(struct parallel_barrier *barrier)
+{
+    pthread_cond_destroy(&barrier->cond);
+    pthread_mutex_destroy(&barrier->lock);
+}
+
+static void parallel_barrier_release_if_complete(struct parallel_barrier *barrier)
+{
+    if (barrier->arrived >= barrier->count) {
+        barrier->arrived = 0U;
+        barrier->phase++;
+        pthread_cond_broadcast(&barrier->cond);
     }
+}
+
+static void parallel_barrier_wait(struct parallel_barrier *barrier)
+{
+    pthread_mutex_lock(&barrier->lock);
+    uint64_t phase = barrier->phase;
+    barrier->arrived++;
+    parallel_barrier_release_if_complete(barrier);
+    while (barrier->phase == phase) {
+        pthread_cond_wait(&barrier->cond, &barrier->lock);
+    }
+    pthread_mutex_unlock(&barrier->lock);
+}
+
+/* Used when fewer workers than planned could be started. */
+static void parallel_barrier_resize(struct parallel_barrier *barrier, uint32_t count)
+{
+    pthread_mutex_lock(&barrier->lock);
+    barrier->count = count;
+    parallel_barrier_release_if_complete(barrier);
+    pthread_mutex_unlock(&barrier->lock);
+}
+
+static inline uint32_t parallel_bucket(const struct parallel_exec *exec, uint64_t mem_index)
+{
+    uint64_t page = mem_index >> STORE_PAGE_WORD_BITS;
+    return (uint32_t)((page * 0x9E3779B97F4A7C15ULL) >> (64U - exec->bucket_bits));
+}
+
+static void parallel_record_miss(struct parallel_worker *worker, uint64_t virt_page)
+{
+    worker->tlb_misses++;
+    if (worker->miss_count == worker->miss_capacity) {
+        size_t capacity = worker->miss_capacity != 0U ? worker->miss_capacity * 2U : 64U;
+        uint64_t *pages = realloc(worker->miss_pages, capacity * sizeof(*pages));
+        if (pages == NULL) {
+            return; /* keep the total, drop the per-page detail */
+        }
+        worker->miss_pages = pages;
+        worker->miss_capacity = capacity;
+    }
+    worker->miss_pages[worker->miss_count++] = virt_page;
+}
 
-    size_t offset = mem_index * (size_t)model->bytes_per_word;
-    uint64_t masked_data = data & model->data_mask;
+static void parallel_chunk(const struct parallel_exec *exec, uint32_t id, size_t *begin, size_t *end)
+{
+    size_t length = exec->window_end - exec->window_begin;
+    *begin = exec->window_begin + length * id / exec->threads;
+    *end = exec->window_begin + length * (id + 1U) / exec->threads;
+}
+
+/* Phase 1: mirrors the checks in read_unchecked()/write_unchecked() up to the store access. */
+static void parallel_classify(struct parallel_worker *worker)
+{
+    struct parallel_exec *exec = worker->exec;
+    const memory_model_t *model = exec->model;
+    const memory_model_batch_t *batch = exec->batch;
+    const uint32_t valid_mask = model->word_byte_mask;
+    uint32_t *counts = &exec->bucket_cursor[(size_t)worker->id * exec->buckets];
+    size_t begin;
+    size_t end;
+
+    memset(counts, 0, sizeof(*counts) * exec->buckets);
+    parallel_chunk(exec, worker->id, &begin, &end);
+
+    for (size_t i = begin; i < end; ++i) {
+        size_t offset = i - exec->window_begin;
+        uint8_t op = batch->op[i];
+        uint32_t mask = batch->byte_mask != NULL ? batch->byte_mask[i] : 0U;
+        memory_model_status_t status;
+
+        exec->mem_index[offset] = PARALLEL_NO_ACCESS;
+        exec->results->data[i] = 0ULL;
+
+        if (op == MEMORY_MODEL_OP_READ) {
+            worker->reads++;
+        } else if (op == MEMORY_MODEL_OP_WRITE) {
+            worker->writes++;
+        } else {
+            exec->results->status[i] = MEMORY_MODEL_STATUS_ERR_ACCESS;
+            continue;
+        }
+
+        if ((mask & ~valid_mask) != 0U) {
+            exec->results->status[i] =
+                op == MEMORY_MODEL_OP_READ ? MEMORY_MODEL_STATUS_ERR_ACCESS : MEMORY_MODEL_STATUS_ERR_WRITE;
+            continue;
+        }
+
+        uint64_t phys_addr = 0ULL;
+        uint32_t slot = 0U;
+        if (!tlb_lookup(model, batch->virt_addr[i], &phys_addr, &slot)) {
+            parallel_record_miss(worker, (batch->virt_addr[i] & model->virt_addr_mask) >> model->page_offset_bits);
+            exec->results->status[i] = MEMORY_MODEL_STATUS_ERR_ADDR;
+            continue;
+        }
+        worker->tlb_hits++;
+        worker->slot_hits[slot]++;
 
-    for (uint32_t i = 0U; i < model->bytes_per_word; ++i) {
-        if ((byte_mask & (1U << i)) == 0U) {
+        uint64_t mem_index = phys_addr & model->mem_addr_mask;
+        if (op == MEMORY_MODEL_OP_WRITE && mask == 0U) {
+            status = MEMORY_MODEL_STATUS_OK;
+        } else if (!model->mem_depth_pow2 && mem_index >= model->cfg.mem_depth) {
+            status = MEMORY_MODEL_STATUS_ERR_ACCESS;
+        } else {
+            exec->mem_index[offset] = mem_index;
+            counts[parallel_bucket(exec, mem_index)]++;
+
+            uint64_t l1 = mem_index >> (STORE_PAGE_WORD_BITS + STORE_DIR_L2_BITS);
+            if (op == MEMORY_MODEL_OP_WRITE && exec->l2_needed != NULL && model->store_dir[l1] == NULL) {
+                atomic_fetch_or_explicit(&exec->l2_needed[l1 / 64U], 1ULL << (l1 % 64U), memory_order_relaxed);
+            }
             continue;
         }
-        uint8_t byte_value = (uint8_t)((masked_data >> (i * 8U)) & 0xFFU);
-        model->memory[offset + i] = byte_value;
+        exec->results->status[i] = status;
     }
+}
 
-    return MEMORY_MODEL_STATUS_OK;
+/* Phase 2, single thread: bucket offsets, scatter cursors and directory tables. */
+static void parallel_plan(struct parallel_exec *exec)
+{
+    memory_model_t *model = exec->model;
+    uint32_t total = 0U;
+
+    for (uint32_t bucket = 0U; bucket < exec->buckets; ++bucket) {
+        exec->bucket_start[bucket] = total;
+        for (uint32_t t = 0U; t < exec->threads; ++t) {
+            uint32_t *cursor = &exec->bucket_cursor[(size_t)t * exec->buckets + bucket];
+            uint32_t count = *cursor;
+            *cursor = total;
+            total += count;
+        }
+    }
+    exec->bucket_start[exec->buckets] = total;
+
+    for (uint32_t t = 0U; t < exec->threads; ++t) {
+        struct parallel_worker *worker = &exec->workers[t];
+        atomic_store_explicit(&worker->next_bucket, (uint32_t)((uint64_t)exec->buckets * t / exec->threads),
+                              memory_order_relaxed);
+        worker->bucket_end = (uint32_t)((uint64_t)exec->buckets * (t + 1U) / exec->threads);
+    }
+
+    if (exec->l2_needed == NULL) {
+        return;
+    }
+    /* A failed allocation leaves the table NULL; the affected writes then report ERR_WRITE. */
+    for (uint32_t word = 0U; word < (model->store_l1_entries + 63U) / 64U; ++word) {
+        uint64_t bits = atomic_exchange_explicit(&exec->l2_needed[word], 0U, memory_order_relaxed);
+        while (bits != 0U) {
+            uint32_t l1 = word * 64U + (uint32_t)__builtin_ctzll(bits);
+            bits &= bits - 1U;
+            if (model->store_dir[l1] == NULL) {
+                DIR_STORE(model->store_dir[l1], calloc(STORE_DIR_L2_ENTRIES, sizeof(struct store_page *)));
+            }
+        }
+    }
+}
+
+/* Phase 3: stable scatter of this thread's chunk into bucket order. */
+static void parallel_scatter(struct parallel_worker *worker)
+{
+    struct parallel_exec *exec = worker->exec;
+    uint32_t *cursor = &exec->bucket_cursor[(size_t)worker->id * exec->buckets];
+    size_t begin;
+    size_t end;
+
+    parallel_chunk(exec, worker->id, &begin, &end);
+    for (size_t i = begin; i < end; ++i) {
+        size_t offset = i - exec->window_begin;
+        uint64_t mem_index = exec->mem_index[offset];
+        if (mem_index != PARALLEL_NO_ACCESS) {
+            exec->order[cursor[parallel_bucket(exec, mem_index)]++] = (uint32_t)offset;
+        }
+    }
+}
+
+/*
+ * Pages are owned by exactly one bucket during phase 4, so installing, unsharing
+ * or zeroing one needs no locking. Only the resident page count is shared, and
+ * it is accumulated per worker.
+ */
+static uint8_t *parallel_word_for_write(struct parallel_worker *worker, uint64_t mem_index)
+{
+    memory_model_t *model = worker->exec->model;
+    uint64_t page = mem_index >> STORE_PAGE_WORD_BITS;
+    struct store_page **l2 = model->store_dir[page >> STORE_DIR_L2_BITS];
+    if (l2 == NULL) {
+        return NULL;
+    }
+
+    struct store_page **slot = &l2[page & (STORE_DIR_L2_ENTRIES - 1U)];
+    if (*slot == NULL) {
+        struct store_page *data = store_page_create(model);
+        if (data == NULL) {
+            return NULL;
+        }
+        DIR_STORE(*slot, data);
+        worker->pages_allocated++;
+    }
+    return store_word_for_write(model, mem_index);
+}
+
+static void parallel_run_bucket(struct parallel_worker *worker, uint32_t bucket)
+{
+    struct parallel_exec *exec = worker->exec;
+    const memory_model_batch_t *batch = exec->batch;
+    const memory_model_t *model = exec->model;
+
+    for (uint32_t j = exec->bucket_start[bucket]; j < exec->bucket_start[bucket + 1U]; ++j) {
+        size_t offset = exec->order[j];
+        size_t i = exec->window_begin + offset;
+        uint64_t mem_index = exec->mem_index[offset];
+        uint32_t mask = batch->byte_mask != NULL ? batch->byte_mask[i] : 0U;
+
+        if (batch->op[i] == MEMORY_MODEL_OP_READ) {
+            exec->results->data[i] = read_word_masked(model, mem_index, mask != 0U ? mask : model->word_byte_mask);
+            exec->results->status[i] = MEMORY_MODEL_STATUS_OK;
+        } else {
+            uint8_t *word = parallel_word_for_write(worker, mem_index);
+            if (word == NULL) {
+                exec->results->status[i] = MEMORY_MODEL_STATUS_ERR_WRITE;
+                continue;
+            }
+            write_word_masked(model, word, mask, batch->data != NULL ? batch->data[i] : 0ULL);
+            exec->results->status[i] = MEMORY_MODEL_STATUS_OK;
+        }
+    }
+}
+
+/* Phase 4: drain our own bucket range, then steal from everyone else's. */
+static void parallel_execute(struct parallel_worker *worker)
+{
+    struct parallel_exec *exec = worker->exec;
+
+    for (uint32_t k = 0U; k < exec->threads; ++k) {
+        struct parallel_worker *victim = &exec->workers[(worker->id + k) % exec->threads];
+        for (;;) {
+            uint32_t bucket = atomic_fetch_add_explicit(&victim->next_bucket, 1U, memory_order_relaxed);
+            if (bucket >= victim->bucket_end) {
+                break;
+            }
+            parallel_run_bucket(worker, bucket);
+        }
+    }
+}
+
+/* First TLB load, flush or ASID switch in op[0..limit), or NULL; each one ends a window. */
+static const uint8_t *parallel_find_tlb_op(const uint8_t *op, size_t limit)
+{
+    static const uint8_t tlb_ops[] = {MEMORY_MODEL_OP_TLB_LOAD, MEMORY_MODEL_OP_FLUSH, MEMORY_MODEL_OP_SET_ASID};
+    const uint8_t *first = NULL;
+
+    for (size_t i = 0U; i < sizeof(tlb_ops); ++i) {
+        const uint8_t *hit = memchr(op, tlb_ops[i], first != NULL ? (size_t)(first - op) : limit);
+        if (hit != NULL) {
+            first = hit;
+        }
+    }
+    return first;
+}
+
+/*
+ * Thread 0 only: run TLB updates and short runs serially and stop at the next
+ * window worth parallelising.
+ */
+static void parallel_select_window(struct parallel_exec *exec)
+{
+    const memory_model_batch_t *batch = exec->batch;
+    const size_t min_window = (size_t)exec->threads * PARALLEL_MIN_OPS_PER_THREAD;
+    size_t pos = exec->next_op;
+
+    while (pos < batch->count) {
+        size_t limit = batch->count - pos < PARALLEL_WINDOW_OPS ? batch->count - pos : PARALLEL_WINDOW_OPS;
+        const uint8_t *load = parallel_find_tlb_op(&batch->op[pos], limit);
+        size_t end = load != NULL ? (size_t)(load - batch->op) : pos + limit;
+
+        if (end - pos >= min_window) {
+            exec->window_begin = pos;
+            exec->window_end = end;
+            exec->next_op = end;
+            return;
+        }
+
+        /* Too short to pay for the barriers: run it, and the TLB update ending it, inline. */
+        size_t serial_end = load != NULL ? end + 1U : end;
+        for (size_t i = pos; i < serial_end; ++i) {
+            uint32_t mask = batch->byte_mask != NULL ? batch->byte_mask[i] : 0U;
+            uint64_t value = batch->data != NULL ? batch->data[i] : 0ULL;
+            exec->results->status[i] = execute_unchecked(exec->model, (memory_model_op_t)batch->op[i],
+                                                         batch->virt_addr[i], mask, value,
+                                                         &exec->results->data[i]);
+        }
+        pos = serial_end;
+    }
+
+    exec->next_op = pos;
+    exec->done = true;
+}
+
+static void parallel_run(struct parallel_worker *worker)
+{
+    struct parallel_exec *exec = worker->exec;
+
+    for (;;) {
+        if (worker->id == 0U) {
+            parallel_select_window(exec);
+        }
+        parallel_barrier_wait(&exec->barrier);
+        if (exec->done) {
+            return;
+        }
+
+        parallel_classify(worker);
+        parallel_barrier_wait(&exec->barrier);
+        if (worker->id == 0U) {
+            parallel_plan(exec);
+        }
+        parallel_barrier_wait(&exec->barrier);
+        parallel_scatter(worker);
+        parallel_barrier_wait(&exec->barrier);
+        parallel_execute(worker);
+        parallel_barrier_wait(&exec->barrier);
+    }
+}
+
+static void *parallel_thread(void *arg)
+{
+    parallel_run(arg);
+    return NULL;
+}
+
+/* Fold the workers' private counters into the model once every thread has joined. */
+static void parallel_merge(struct parallel_exec *exec)
+{
+    memory_model_t *model = exec->model;
+
+    for (uint32_t t = 0U; t < exec->threads; ++t) {
+        struct parallel_worker *worker = &exec->workers[t];
+        model->resident_pages += worker->pages_allocated;
+#if MEMORY_MODEL_ENABLE_STATS
+        struct counter_shard *shard = counter_shard_for(model);
+        _Atomic uint64_t *slot_hits =
+            &model->counters->slot_hits[(size_t)counter_shard_index(model) * model->cfg.tlb_entries];
+        counter_add_n(model, &shard->reads, worker->reads);
+        counter_add_n(model, &shard->writes, worker->writes);
+        counter_add_n(model, &shard->tlb_hits, worker->tlb_hits);
+        counter_add_n(model, &shard->tlb_misses, worker->tlb_misses);
+        for (uint32_t slot = 0U; slot < model->cfg.tlb_entries; ++slot) {
+            if (worker->slot_hits[slot] != 0U) {
+                counter_add_n(model, &slot_hits[slot], worker->slot_hits[slot]);
+            }
+        }
+        for (size_t m = 0U; m < worker->miss_count; ++m) {
+            counters_record_miss_locked(model->counters, worker->miss_pages[m]);
+        }
+#endif
+    }
+}
+
+static void parallel_exec_free(struct parallel_exec *exec)
+{
+    if (exec->workers != NULL) {
+        for (uint32_t t = 0U; t < exec->threads; ++t) {
+            free(exec->workers[t].slot_hits);
+            free(exec->workers[t].miss_pages);
+        }
+    }
+    free(exec->workers);
+    free(exec->mem_index);
+    free(exec->order);
+    free(exec->bucket_cursor);
+    free(exec->bucket_start);
+    free(exec->l2_needed);
+}
+
+static bool parallel_exec_init(struct parallel_exec *exec, uint32_t threads)
+{
+    memory_model_t *model = exec->model;
+    size_t window = exec->batch->count < PARALLEL_WINDOW_OPS ? exec->batch->count : PARALLEL_WINDOW_OPS;
+
+    exec->threads = threads;
+    exec->bucket_bits = ceil_log2_u32(threads * PARALLEL_BUCKETS_PER_THREAD);
+    exec->buckets = 1U << exec->bucket_bits;
+
+    exec->workers = aligned_alloc(SYNC_ALIGNMENT, sizeof(struct parallel_worker) * threads);
+    exec->mem_index = malloc(sizeof(*exec->mem_index) * window);
+    exec->order = malloc(sizeof(*exec->order) * window);
+    exec->bucket_cursor = malloc(sizeof(*exec->bucket_cursor) * (size_t)threads * exec->buckets);
+    exec->bucket_start = malloc(sizeof(*exec->bucket_start) * ((size_t)exec->buckets + 1U));
+    if (model->cfg.sparse) {
+        exec->l2_needed = calloc((model->store_l1_entries + 63U) / 64U, sizeof(*exec->l2_needed));
+    }
+    if (exec->workers == NULL || exec->mem_index == NULL || exec->order == NULL || exec->bucket_cursor == NULL ||
+        exec->bucket_start == NULL || (model->cfg.sparse && exec->l2_needed == NULL)) {
+        return false;
+    }
+
+    memset(exec->workers, 0, sizeof(struct parallel_worker) * threads);
+    for (uint32_t t = 0U; t < threads; ++t) {
+        exec->workers[t].exec = exec;
+        exec->workers[t].id = t;
+        exec->workers[t].slot_hits = calloc(model->cfg.tlb_entries, sizeof(uint64_t));
+        if (exec->workers[t].slot_hits == NULL) {
+            return false;
+        }
+    }
+    return true;
+}
+
+memory_model_error_t memory_model_execute_batch_parallel(memory_model_t *model,
+                                                         const memory_model_batch_t *batch,
+                                                         const memory_model_batch_results_t *results,
+                                                         uint32_t threads)
+{
+    if (model == NULL || batch == NULL || results == NULL) {
+        return MEMORY_MODEL_ERROR_BAD_ARGUMENT;
+    }
+    if (batch->count == 0U) {
+        return MEMORY_MODEL_ERROR_OK;
+    }
+    if (batch->op == NULL || batch->virt_addr == NULL || results->status == NULL ||
+        results->data == NULL) {
+        return MEMORY_MODEL_ERROR_BAD_ARGUMENT;
+    }
+
+    if (threads == 0U) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = online > 0 ? (uint32_t)online : 1U;
+    }
+    if (threads > PARALLEL_MAX_THREADS) {
+        threads = PARALLEL_MAX_THREADS;
+    }
+    /*
+     * Classification translates ahead of execution, which a refilling miss
+     * would invalidate, and out of order, which recency tracking and the data
+     * cache cannot follow.
+     */
+    if (threads < 2U || batch->count < (size_t)threads * PARALLEL_MIN_OPS_PER_THREAD ||
+        model->page_table.levels != 0U || tlb_policy_tracks_hits(model->cfg.tlb_policy) || model->cache != NULL) {
+        return memory_model_execute_batch(model, batch, results);
+    }
+
+    struct parallel_exec exec;
+    memset(&exec, 0, sizeof(exec));
+    exec.model = model;
+    exec.batch = batch;
+    exec.results = results;
+
+    /* Without scratch space the serial path gives the same answer, just slower. */
+    if (!parallel_exec_init(&exec, threads) || parallel_barrier_init(&exec.barrier, threads) != 0) {
+        parallel_exec_free(&exec);
+        return memory_model_execute_batch(model, batch, results);
+    }
+
+    uint32_t started = 1U;
+    while (started < threads &&
+           pthread_create(&exec.workers[started].thread, NULL, parallel_thread, &exec.workers[started]) == 0) {
+        started++;
+    }
+    if (started < threads) {
+        /* Workers are parked at the first barrier, so shrinking is still safe here. */
+        exec.threads = started;
+        parallel_barrier_resize(&exec.barrier, started);
+    }
+
+    parallel_run(&exec.workers[0]);
+    for (uint32_t t = 1U; t < started; ++t) {
+        pthread_join(exec.workers[t].thread, NULL);
+    }
+
+    parallel_merge(&exec);
+    parallel_barrier_destroy(&exec.barrier);
+    exec.threads = threads;
+    parallel_exec_free(&exec);
+    return MEMORY_MODEL_ERROR_OK;
+}
+
+/* Read a TLB bookkeeping field consistently with concurrent load_tlb calls. */
+static uint32_t tlb_field_snapshot(const memory_model_t *model, const uint32_t *field)
+{
+    if (model->sync == NULL) {
+        return *field;
+    }
+
+    uint64_t seq;
+    uint32_t value;
+    do {
+        seq = seq_read_begin(&model->sync->tlb_seq);
+        value = SEQ_LOAD(*field);
+    } while (seq_read_retry(&model->sync->tlb_seq, seq));
+    return value;
 }
 
 uint32_t memory_model_active_entries(const memory_model_t *model)
@@ -367,7 +3991,7 @@ uint32_t memory_model_active_entries(const memory_model_t *model)
     if (model == NULL) {
         return 0U;
     }
-    return model->active_entries;
+    return tlb_field_snapshot(model, &model->active_entries);
 }
 
 uint32_t memory_model_tlb_write_index(const memory_model_t *model)
@@ -375,7 +3999,15 @@ uint32_t memory_model_tlb_write_index(const memory_model_t *model)
     if (model == NULL) {
         return 0U;
     }
-    return model->tlb_write_ptr;
+    return tlb_field_snapshot(model, &model->tlb_write_ptr);
+}
+
+uint32_t memory_model_current_asid(const memory_model_t *model)
+{
+    if (model == NULL) {
+        return 0U;
+    }
+    return tlb_field_snapshot(model, &model->tlb_asid);
 }
 
 uint32_t memory_model_tlb_capacity(const memory_model_t *model)
@@ -386,6 +4018,167 @@ uint32_t memory_model_tlb_capacity(const memory_model_t *model)
     return model->cfg.tlb_entries;
 }
 
+size_t memory_model_resident_bytes(const memory_model_t *model)
+{
+    if (model == NULL) {
+        return 0U;
+    }
+    if (model->sync == NULL) {
+        return model->resident_pages * model->store_page_bytes;
+    }
+
+    spin_lock(&model->sync->dir_lock);
+    size_t pages = model->resident_pages;
+    spin_unlock(&model->sync->dir_lock);
+    return pages * model->store_page_bytes;
+}
+
+memory_model_error_t memory_model_get_stats(const memory_model_t *model, memory_model_stats_t *stats_out)
+{
+    if (model == NULL || stats_out == NULL) {
+        return MEMORY_MODEL_ERROR_BAD_ARGUMENT;
+    }
+#if MEMORY_MODEL_ENABLE_STATS
+    const struct model_counters *counters = model->counters;
+    stats_out->read_count = counter_sum(counters, offsetof(struct counter_shard, reads));
+    stats_out->write_count = counter_sum(counters, offsetof(struct counter_shard, writes));
+    stats_out->tlb_load_count = counter_sum(counters, offsetof(struct counter_shard, tlb_loads));
+    stats_out->tlb_hits = counter_sum(counters, offsetof(struct counter_shard, tlb_hits));
+    stats_out->tlb_misses = counter_sum(counters, offsetof(struct counter_shard, tlb_misses));
+    stats_out->tlb_evictions = counter_sum(counters, offsetof(struct counter_shard, tlb_evictions));
+    stats_out->walk_count = counter_sum(counters, offsetof(struct counter_shard, walks));
+    stats_out->walk_pte_reads = counter_sum(counters, offsetof(struct counter_shard, walk_pte_reads));
+    stats_out->walk_faults = counter_sum(counters, offsetof(struct counter_shard, walk_faults));
+    stats_out->cache_read_hits = counter_sum(counters, offsetof(struct counter_shard, cache_read_hits));
+    stats_out->cache_read_misses = counter_sum(counters, offsetof(struct counter_shard, cache_read_misses));
+    stats_out->cache_write_hits = counter_sum(counters, offsetof(struct counter_shard, cache_write_hits));
+    stats_out->cache_write_misses = counter_sum(counters, offsetof(struct counter_shard, cache_write_misses));
+    stats_out->cache_writebacks = counter_sum(counters, offsetof(struct counter_shard, cache_writebacks));
+    return MEMORY_MODEL_ERROR_OK;
+#else
+    memset(stats_out, 0, sizeof(*stats_out));
+    return MEMORY_MODEL_ERROR_UNSUPPORTED;
+#endif
+}
+
+memory_model_error_t memory_model_get_tlb_slot_hits(const memory_model_t *model,
+                                                    uint64_t *hits_out,
+                                                    uint32_t count)
+{
+    if (model == NULL || (hits_out == NULL && count > 0U)) {
+        return MEMORY_MODEL_ERROR_BAD_ARGUMENT;
+    }
+#if MEMORY_MODEL_ENABLE_STATS
+    const struct model_counters *counters = model->counters;
+    uint32_t copied = count < counters->tlb_entries ? count : counters->tlb_entries;
+    for (uint32_t slot = 0U; slot < copied; ++slot) {
+        uint64_t total = 0U;
+        for (uint32_t shard = 0U; shard < counters->shard_count; ++shard) {
+            total += atomic_load_explicit(&counters->slot_hits[(size_t)shard * counters->tlb_entries + slot],
+                                          memory_order_relaxed);
+        }
+        hits_out[slot] = total;
+    }
+    return MEMORY_MODEL_ERROR_OK;
+#else
+    return MEMORY_MODEL_ERROR_UNSUPPORTED;
+#endif
+}
+
+#if MEMORY_MODEL_ENABLE_STATS
+static int compare_miss_entries(const void *lhs, const void *rhs)
+{
+    const memory_model_miss_entry_t *a = lhs;
+    const memory_model_miss_entry_t *b = rhs;
+    if (a->misses != b->misses) {
+        return a->misses > b->misses ? -1 : 1;
+    }
+    return (a->virt_page > b->virt_page) - (a->virt_page < b->virt_page);
+}
+#endif
+
+size_t memory_model_get_miss_histogram(const memory_model_t *model,
+                                       memory_model_miss_entry_t *entries_out,
+                                       size_t capacity)
+{
+#if MEMORY_MODEL_ENABLE_STATS
+    if (model == NULL) {
+        return 0U;
+    }
+
+    struct model_counters *counters = model->counters;
+    if (model->sync != NULL) {
+        spin_lock(&counters->miss_lock);
+    }
+
+    size_t filled = counters->miss_pages;
+    if (entries_out != NULL && capacity >= counters->miss_pages) {
+        filled = 0U;
+        for (size_t i = 0U; i < ((size_t)1U << counters->miss_bits); ++i) {
+            if (counters->miss_table[i].misses != 0U) {
+                entries_out[filled].virt_page = counters->miss_table[i].virt_page;
+                entries_out[filled].misses = counters->miss_table[i].misses;
+                filled++;
+            }
+        }
+    }
+
+    if (model->sync != NULL) {
+        spin_unlock(&counters->miss_lock);
+    }
+    if (entries_out != NULL && capacity >= filled) {
+        qsort(entries_out, filled, sizeof(*entries_out), compare_miss_entries);
+    }
+    return filled;
+#else
+    (void)model;
+    (void)entries_out;
+    (void)capacity;
+    return 0U;
+#endif
+}
+
+memory_model_error_t memory_model_reset_stats(memory_model_t *model)
+{
+    if (model == NULL) {
+        return MEMORY_MODEL_ERROR_BAD_ARGUMENT;
+    }
+#if MEMORY_MODEL_ENABLE_STATS
+    struct model_counters *counters = model->counters;
+    for (uint32_t shard = 0U; shard < counters->shard_count; ++shard) {
+        atomic_store_explicit(&counters->shards[shard].reads, 0U, memory_order_relaxed);
+        atomic_store_explicit(&counters->shards[shard].writes, 0U, memory_order_relaxed);
+        atomic_store_explicit(&counters->shards[shard].tlb_loads, 0U, memory_order_relaxed);
+        atomic_store_explicit(&counters->shards[shard].tlb_hits, 0U, memory_order_relaxed);
+        atomic_store_explicit(&counters->shards[shard].tlb_misses, 0U, memory_order_relaxed);
+        atomic_store_explicit(&counters->shards[shard].tlb_evictions, 0U, memory_order_relaxed);
+        atomic_store_explicit(&counters->shards[shard].walks, 0U, memory_order_relaxed);
+        atomic_store_explicit(&counters->shards[shard].walk_pte_reads, 0U, memory_order_relaxed);
+        atomic_store_explicit(&counters->shards[shard].walk_faults, 0U, memory_order_relaxed);
+        atomic_store_explicit(&counters->shards[shard].cache_read_hits, 0U, memory_order_relaxed);
+        atomic_store_explicit(&counters->shards[shard].cache_read_misses, 0U, memory_order_relaxed);
+        atomic_store_explicit(&counters->shards[shard].cache_write_hits, 0U, memory_order_relaxed);
+        atomic_store_explicit(&counters->shards[shard].cache_write_misses, 0U, memory_order_relaxed);
+        atomic_store_explicit(&counters->shards[shard].cache_writebacks, 0U, memory_order_relaxed);
+    }
+    for (size_t i = 0U; i < (size_t)counters->shard_count * counters->tlb_entries; ++i) {
+        atomic_store_explicit(&counters->slot_hits[i], 0U, memory_order_relaxed);
+    }
+
+    if (model->sync != NULL) {
+        spin_lock(&counters->miss_lock);
+    }
+    memset(counters->miss_table, 0, sizeof(struct miss_bucket) << counters->miss_bits);
+    counters->miss_pages = 0U;
+    if (model->sync != NULL) {
+        spin_unlock(&counters->miss_lock);
+    }
+    return MEMORY_MODEL_ERROR_OK;
+#else
+    return MEMORY_MODEL_ERROR_UNSUPPORTED;
+#endif
+}
+
 const memory_model_config_t *memory_model_get_config(const memory_model_t *model)
 {
     if (model == NULL) {
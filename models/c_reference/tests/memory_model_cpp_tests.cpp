@@ -0,0 +1,308 @@
+#include "memory_model.hpp"
+
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <utility>
+
+namespace {
+
+/* Small xorshift generator so both models see the same reproducible stream. */
+struct TestRng {
+    uint64_t state;
+
+    uint64_t next()
+    {
+        state ^= state << 13U;
+        state ^= state >> 7U;
+        state ^= state << 17U;
+        return state;
+    }
+};
+
+template <typename Model>
+bool same_tlb(const memory_model_t *reference, const Model &model, memory_model_tlb_entry_t *reference_tlb,
+              memory_model_tlb_entry_t *model_tlb)
+{
+    const uint32_t entries = Model::tlb_capacity();
+    if (memory_model_export_tlb(reference, reference_tlb, entries, nullptr) != MEMORY_MODEL_ERROR_OK ||
+        model.export_tlb(model_tlb, entries, nullptr) != MEMORY_MODEL_ERROR_OK) {
+        return false;
+    }
+    for (uint32_t i = 0U; i < entries; ++i) {
+        if (reference_tlb[i].valid != model_tlb[i].valid || reference_tlb[i].span_bits != model_tlb[i].span_bits ||
+            reference_tlb[i].asid != model_tlb[i].asid || reference_tlb[i].virt_base != model_tlb[i].virt_base ||
+            reference_tlb[i].phys_base != model_tlb[i].phys_base) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+ * Drive the template and the C model with the same random trace and require
+ * identical statuses, read data, translations and TLB pointers throughout.
+ * Virtual addresses come from a handful of pages so that hits, misses,
+ * duplicate mappings, overlapping ranges, flushes, switches between three
+ * address spaces and round-robin overwrites all occur. Page-table walkers are
+ * attached over whatever the trace has written, so random words act as PTEs
+ * and walks hit, fault and fill at every level. The exported TLBs are
+ * compared periodically.
+ */
+template <typename Model>
+int run_differential(uint64_t seed, size_t ops)
+{
+    memory_model_config_t cfg = Model::config();
+    memory_model_t *reference = nullptr;
+    if (memory_model_create(&cfg, &reference) != MEMORY_MODEL_ERROR_OK) {
+        std::fprintf(stderr, "Failed to create C model\n");
+        return 0;
+    }
+
+    Model model;
+    std::unique_ptr<memory_model_tlb_entry_t[]> reference_tlb(new memory_model_tlb_entry_t[cfg.tlb_entries]);
+    std::unique_ptr<memory_model_tlb_entry_t[]> model_tlb(new memory_model_tlb_entry_t[cfg.tlb_entries]);
+    TestRng rng = {seed};
+    int ok = 0;
+    const uint64_t page_words = Model::config().page_size;
+    const uint64_t phys_frames = (cfg.mem_depth + page_words - 1U) / page_words + 2U;
+
+    for (size_t i = 0U; i < ops; ++i) {
+        uint64_t r = rng.next();
+        uint64_t virt_addr = ((r >> 8U) % 12U) * page_words + ((r >> 16U) % page_words);
+        uint32_t byte_mask = static_cast<uint32_t>(r >> 32U) & 0x1FFU;
+        uint64_t data = rng.next();
+        uint64_t expected = 0U;
+        uint64_t actual = 0U;
+        memory_model_status_t expected_status;
+        memory_model_status_t actual_status;
+
+        switch (r & 0xFU) {
+        case 0U: {
+            uint64_t phys_base = ((data >> 3U) % phys_frames) * page_words;
+            memory_model_load_tlb(reference, virt_addr, phys_base);
+            model.load_tlb(virt_addr, phys_base);
+            expected_status = MEMORY_MODEL_STATUS_OK;
+            actual_status = MEMORY_MODEL_STATUS_OK;
+            break;
+        }
+        case 1U: {
+            /* Ranges of one to four pages overlap the plain pages above. */
+            uint32_t span_bits = Model::kPageOffsetBits + static_cast<uint32_t>(data % 3U);
+            uint64_t phys_base = ((data >> 3U) % phys_frames) * page_words;
+            if (memory_model_load_tlb_range(reference, virt_addr, phys_base, span_bits) !=
+                model.load_tlb_range(virt_addr, phys_base, span_bits)) {
+                std::fprintf(stderr, "Op %zu: range load results differ\n", i);
+                goto cleanup;
+            }
+            expected_status = MEMORY_MODEL_STATUS_OK;
+            actual_status = MEMORY_MODEL_STATUS_OK;
+            break;
+        }
+        case 2U:
+            /* Lookups never walk, so they must leave both TLBs and pointers alone. */
+            if (((r >> 40U) & 1U) != 0U) {
+                expected_status = memory_model_lookup(reference, virt_addr, &expected);
+                actual_status = static_cast<const Model &>(model).lookup(virt_addr, &actual);
+            } else {
+                expected_status = memory_model_translate(reference, virt_addr, &expected);
+                actual_status = model.translate(virt_addr, &actual);
+            }
+            break;
+        case 3U:
+            switch ((r >> 40U) % 64U) {
+            case 0U:
+                memory_model_reset(reference);
+                model.reset();
+                break;
+            case 1U:
+                memory_model_flush_tlb(reference);
+                model.flush_tlb();
+                break;
+            case 2U:
+            case 3U:
+            case 4U:
+            case 5U:
+                memory_model_flush_tlb_page(reference, virt_addr);
+                model.flush_tlb_page(virt_addr);
+                break;
+            case 6U: {
+                /* Round-trip the C model's table through both import paths. */
+                uint32_t write_index = 0U;
+                memory_model_export_tlb(reference, reference_tlb.get(), cfg.tlb_entries, &write_index);
+                memory_model_import_tlb(reference, reference_tlb.get(), cfg.tlb_entries, write_index);
+                model.import_tlb(reference_tlb.get(), cfg.tlb_entries, write_index);
+                break;
+            }
+            case 7U:
+            case 8U:
+            case 9U:
+            case 10U: {
+                memory_model_transaction_t set_asid = {MEMORY_MODEL_OP_SET_ASID, 0U, 0U, data % 3U};
+                memory_model_result_t result;
+                memory_model_execute(reference, &set_asid, &result);
+                model.execute(set_asid);
+                break;
+            }
+            case 11U:
+            case 12U: {
+                /* One to three levels, wide enough to cover the virtual page number. */
+                memory_model_page_table_t table;
+                table.root = ((data >> 3U) % phys_frames) * page_words;
+                table.levels = 1U + static_cast<uint32_t>(data % 3U);
+                table.index_bits = (cfg.virt_addr_width - Model::kPageOffsetBits + table.levels - 1U) / table.levels;
+                if (memory_model_set_page_table(reference, &table) != model.set_page_table(&table)) {
+                    std::fprintf(stderr, "Op %zu: page table results differ\n", i);
+                    goto cleanup;
+                }
+                break;
+            }
+            case 13U:
+                memory_model_set_page_table(reference, nullptr);
+                model.set_page_table(nullptr);
+                break;
+            case 14U:
+            case 15U: {
+                uint32_t expected_depth = 0U;
+                uint32_t actual_depth = 0U;
+                expected_status = memory_model_walk(reference, virt_addr, &expected, &expected_depth);
+                actual_status = model.walk(virt_addr, &actual, &actual_depth);
+                if (expected_status != actual_status || expected != actual || expected_depth != actual_depth) {
+                    std::fprintf(stderr, "Op %zu: walks of 0x%" PRIx64 " differ\n", i, virt_addr);
+                    goto cleanup;
+                }
+                break;
+            }
+            default:
+                break;
+            }
+            expected_status = MEMORY_MODEL_STATUS_OK;
+            actual_status = MEMORY_MODEL_STATUS_OK;
+            break;
+        case 4U:
+        case 5U:
+        case 6U:
+        case 7U:
+        case 8U:
+        case 9U:
+            expected_status = memory_model_write(reference, virt_addr, byte_mask, data);
+            actual_status = model.write(virt_addr, byte_mask, data);
+            break;
+        default:
+            expected_status = memory_model_read(reference, virt_addr, byte_mask, &expected);
+            actual_status = model.read(virt_addr, byte_mask, &actual);
+            break;
+        }
+
+        if (expected_status != actual_status || expected != actual) {
+            std::fprintf(stderr,
+                         "Op %zu (kind %u, addr 0x%" PRIx64 ", mask 0x%X): C gave %d/0x%" PRIx64
+                         ", template gave %d/0x%" PRIx64 "\n",
+                         i, static_cast<unsigned>(r & 0xFU), virt_addr, byte_mask, expected_status, expected,
+                         actual_status, actual);
+            goto cleanup;
+        }
+        if (memory_model_active_entries(reference) != model.active_entries() ||
+            memory_model_tlb_write_index(reference) != model.tlb_write_index() ||
+            memory_model_current_asid(reference) != model.current_asid()) {
+            std::fprintf(stderr, "Op %zu: TLB pointers diverged\n", i);
+            goto cleanup;
+        }
+        if (i % 256U == 0U && !same_tlb(reference, model, reference_tlb.get(), model_tlb.get())) {
+            std::fprintf(stderr, "Op %zu: exported TLBs differ\n", i);
+            goto cleanup;
+        }
+    }
+
+    ok = 1;
+
+cleanup:
+    memory_model_destroy(reference);
+    return ok;
+}
+
+int test_rtl_geometry_matches_c_model()
+{
+    static_assert(RtlMemoryModel::kPageOffsetBits == 12U, "RTL page offset");
+    static_assert(RtlMemoryModel::kMemAddrMask == 0x3FFFU, "RTL memory index mask");
+    static_assert(sizeof(RtlMemoryModel::word_type) == 8U, "RTL word storage");
+
+    memory_model_config_t expected = memory_model_config_default();
+    memory_model_config_t actual = RtlMemoryModel::config();
+    if (expected.virt_addr_width != actual.virt_addr_width || expected.phys_addr_width != actual.phys_addr_width ||
+        expected.page_size != actual.page_size || expected.data_width != actual.data_width ||
+        expected.mem_depth != actual.mem_depth || expected.tlb_entries != actual.tlb_entries) {
+        std::fprintf(stderr, "RtlMemoryModel does not match memory_model_config_default()\n");
+        return 0;
+    }
+
+    return run_differential<RtlMemoryModel>(0x243F6A8885A308D3ULL, 200000U);
+}
+
+int test_odd_geometry_matches_c_model()
+{
+    /* 24-bit words, a non-power-of-two depth and a five-entry TLB. */
+    typedef MemoryModel<20U, 18U, 256U, 24U, 3000U, 5U> OddModel;
+    static_assert(sizeof(OddModel::word_type) == 4U, "24-bit words use 32-bit storage");
+    static_assert(OddModel::kMemAddrMask == 0xFFFU, "non-power-of-two depth rounds the mask up");
+
+    return run_differential<OddModel>(0x13198A2E03707344ULL, 200000U);
+}
+
+int test_move_only_ownership()
+{
+    RtlMemoryModel first;
+    first.load_tlb(0x1000U, 0x2000U);
+    if (first.write(0x1004U, 0xFFU, 0x1122334455667788ULL) != MEMORY_MODEL_STATUS_OK) {
+        return 0;
+    }
+
+    RtlMemoryModel second(std::move(first));
+    uint64_t data = 0U;
+    if (first.valid() || !second.valid() || second.read(0x1004U, 0U, &data) != MEMORY_MODEL_STATUS_OK ||
+        data != 0x1122334455667788ULL) {
+        std::fprintf(stderr, "Move construction lost state\n");
+        return 0;
+    }
+
+    RtlMemoryModel third;
+    third = std::move(second);
+    if (second.valid() || third.read(0x1004U, 0x0FU, &data) != MEMORY_MODEL_STATUS_OK || data != 0x55667788ULL) {
+        std::fprintf(stderr, "Move assignment lost state\n");
+        return 0;
+    }
+    return 1;
+}
+
+struct TestCase {
+    const char *name;
+    int (*fn)();
+};
+
+} // namespace
+
+int main()
+{
+    const TestCase tests[] = {
+        {"rtl_geometry_matches_c_model", test_rtl_geometry_matches_c_model},
+        {"odd_geometry_matches_c_model", test_odd_geometry_matches_c_model},
+        {"move_only_ownership", test_move_only_ownership},
+    };
+
+    const size_t total = sizeof(tests) / sizeof(tests[0]);
+    size_t passed = 0U;
+
+    for (size_t i = 0U; i < total; ++i) {
+        std::printf("[ RUN     ] %s\n", tests[i].name);
+        if (tests[i].fn()) {
+            std::printf("[     OK ] %s\n", tests[i].name);
+            passed++;
+        } else {
+            std::printf("[ FAILED ] %s\n", tests[i].name);
+        }
+    }
+
+    std::printf("\nSummary: %zu/%zu tests passed.\n", passed, total);
+    return passed == total ? 0 : 1;
+}
@@ -2,8 +2,12 @@
 
 #include <inttypes.h>
 #include <limits.h>
+#include <pthread.h>
+#include <stdatomic.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 static uint64_t mask_width(uint32_t width)
 {
@@ -363,6 +367,2195 @@ cleanup:
     return success;
 }
 
+static int expect_translation(memory_model_t *model, uint64_t virt_addr, uint64_t expected_phys,
+                              const char *context)
+{
+    uint64_t phys_addr = 0ULL;
+    if (memory_model_translate(model, virt_addr, &phys_addr) != MEMORY_MODEL_STATUS_OK) {
+        fprintf(stderr, "%s: translation of 0x%016" PRIx64 " failed\n", context, virt_addr);
+        return 0;
+    }
+    if (phys_addr != expected_phys) {
+        fprintf(stderr, "%s: expected phys 0x%016" PRIx64 " got 0x%016" PRIx64 "\n",
+                context, expected_phys, phys_addr);
+        return 0;
+    }
+    return 1;
+}
+
+static int test_tlb_duplicate_priority(void)
+{
+    int success = 0;
+    memory_model_t *model = NULL;
+    memory_model_config_t cfg = memory_model_config_default();
+    cfg.tlb_entries = 4U;
+
+    if (memory_model_create(&cfg, &model) != MEMORY_MODEL_ERROR_OK) {
+        fprintf(stderr, "test_tlb_duplicate_priority: failed to create model\n");
+        return 0;
+    }
+
+    /* Slots 0 and 2 both map virtual page 0x1; slot 0 must win. */
+    memory_model_load_tlb(model, 0x00001000ULL, 0x00010000ULL);
+    memory_model_load_tlb(model, 0x00002000ULL, 0x00020000ULL);
+    memory_model_load_tlb(model, 0x00001000ULL, 0x00030000ULL);
+    memory_model_load_tlb(model, 0x00003000ULL, 0x00040000ULL);
+    if (!expect_translation(model, 0x00001010ULL, 0x00010010ULL, "test_tlb_duplicate_priority")) {
+        goto cleanup;
+    }
+
+    /* Overwriting slot 0 exposes the duplicate in slot 2. */
+    memory_model_load_tlb(model, 0x00004000ULL, 0x00050000ULL);
+    if (!expect_translation(model, 0x00001010ULL, 0x00030010ULL, "test_tlb_duplicate_priority")) {
+        goto cleanup;
+    }
+
+    /* A new copy in slot 1 takes priority over slot 2. */
+    memory_model_load_tlb(model, 0x00001000ULL, 0x00060000ULL);
+    if (!expect_translation(model, 0x00001010ULL, 0x00060010ULL, "test_tlb_duplicate_priority")) {
+        goto cleanup;
+    }
+
+    /* Overwriting slot 2 leaves slot 1 as the only copy. */
+    memory_model_load_tlb(model, 0x00005000ULL, 0x00070000ULL);
+    if (!expect_translation(model, 0x00001010ULL, 0x00060010ULL, "test_tlb_duplicate_priority")) {
+        goto cleanup;
+    }
+
+    /* Page 0x2 was evicted from slot 1 and must now miss. */
+    uint64_t phys_addr = 0ULL;
+    if (memory_model_translate(model, 0x00002000ULL, &phys_addr) != MEMORY_MODEL_STATUS_ERR_ADDR) {
+        fprintf(stderr, "test_tlb_duplicate_priority: evicted page still translates\n");
+        goto cleanup;
+    }
+
+    success = 1;
+
+cleanup:
+    memory_model_destroy(model);
+    return success;
+}
+
+static int test_tlb_index_matches_linear_scan(void)
+{
+    enum { ENTRIES = 8, PAGES = 12, ROUNDS = 2000 };
+
+    int success = 0;
+    memory_model_t *model = NULL;
+    memory_model_config_t cfg = memory_model_config_default();
+    cfg.tlb_entries = ENTRIES;
+
+    if (memory_model_create(&cfg, &model) != MEMORY_MODEL_ERROR_OK) {
+        fprintf(stderr, "test_tlb_index_matches_linear_scan: failed to create model\n");
+        return 0;
+    }
+
+    uint64_t page_bits = ceil_log2_u32(cfg.page_size);
+    uint64_t shadow_virt[ENTRIES];
+    uint64_t shadow_phys[ENTRIES];
+    int shadow_valid[ENTRIES] = {0};
+    uint32_t write_ptr = 0U;
+    uint32_t lcg = 12345U;
+
+    for (uint32_t round = 0U; round < ROUNDS; ++round) {
+        lcg = lcg * 1103515245U + 12345U;
+        uint64_t virt_page = (lcg >> 16) % PAGES;
+        uint64_t phys_page = round + 1U;
+
+        memory_model_load_tlb(model, virt_page << page_bits, phys_page << page_bits);
+        shadow_virt[write_ptr] = virt_page;
+        shadow_phys[write_ptr] = phys_page;
+        shadow_valid[write_ptr] = 1;
+        write_ptr = (write_ptr + 1U) % ENTRIES;
+
+        for (uint64_t page = 0U; page < PAGES; ++page) {
+            uint64_t expected = 0ULL;
+            memory_model_status_t expected_status = MEMORY_MODEL_STATUS_ERR_ADDR;
+            for (uint32_t i = 0U; i < ENTRIES; ++i) {
+                if (shadow_valid[i] && shadow_virt[i] == page) {
+                    expected = (shadow_phys[i] << page_bits) & mask_width(cfg.phys_addr_width);
+                    expected_status = MEMORY_MODEL_STATUS_OK;
+                    break;
+                }
+            }
+
+            uint64_t actual = 0ULL;
+            memory_model_status_t status = memory_model_translate(model, page << page_bits, &actual);
+            if (status != expected_status || actual != expected) {
+                fprintf(stderr,
+                        "test_tlb_index_matches_linear_scan: round %" PRIu32 " page 0x%" PRIx64
+                        " expected 0x%016" PRIx64 " got 0x%016" PRIx64 "\n",
+                        round, page, expected, actual);
+                goto cleanup;
+            }
+        }
+    }
+
+    success = 1;
+
+cleanup:
+    memory_model_destroy(model);
+    return success;
+}
+
+static int test_tlb_range_longest_prefix(void)
+{
+    enum { ENTRIES = 8, ROUNDS = 3000, PROBES = 16 };
+
+    int success = 0;
+    memory_model_t *model = NULL;
+    memory_model_t *fork = NULL;
+    memory_model_config_t cfg = memory_model_config_default();
+    cfg.tlb_entries = ENTRIES;
+
+    if (memory_model_create(&cfg, &model) != MEMORY_MODEL_ERROR_OK) {
+        fprintf(stderr, "test_tlb_range_longest_prefix: failed to create model\n");
+        return 0;
+    }
+
+    const uint32_t page_bits = ceil_log2_u32(cfg.page_size);
+    if (memory_model_load_tlb_range(model, 0ULL, 0ULL, page_bits - 1U) != MEMORY_MODEL_ERROR_BAD_ARGUMENT ||
+        memory_model_load_tlb_range(model, 0ULL, 0ULL, cfg.phys_addr_width + 1U) !=
+            MEMORY_MODEL_ERROR_BAD_ARGUMENT ||
+        memory_model_active_entries(model) != 0U) {
+        fprintf(stderr, "test_tlb_range_longest_prefix: bad span accepted\n");
+        goto cleanup;
+    }
+
+    /* One 2^18-word range, then a plain page carved out of its middle. */
+    memory_model_load_tlb_range(model, 0x00C40000ULL, 0x01000000ULL, 18U);
+    memory_model_load_tlb(model, 0x00C45000ULL, 0x00002000ULL);
+    if (!expect_translation(model, 0x00C7FFF8ULL, 0x0103FFF8ULL, "test_tlb_range_longest_prefix") ||
+        !expect_translation(model, 0x00C45010ULL, 0x00002010ULL, "test_tlb_range_longest_prefix") ||
+        !expect_translation(model, 0x00C44FFFULL, 0x01004FFFULL, "test_tlb_range_longest_prefix")) {
+        goto cleanup;
+    }
+    if (memory_model_write(model, 0x00C40008ULL, 0xFFU, 0xA5A5A5A5ULL) != MEMORY_MODEL_STATUS_OK) {
+        fprintf(stderr, "test_tlb_range_longest_prefix: write through range failed\n");
+        goto cleanup;
+    }
+
+    /* Forks inherit ranges; reset drops them. */
+    if (memory_model_fork(model, &fork) != MEMORY_MODEL_ERROR_OK ||
+        !expect_translation(fork, 0x00C60000ULL, 0x01020000ULL, "test_tlb_range_longest_prefix")) {
+        goto cleanup;
+    }
+    memory_model_reset(model);
+    uint64_t phys_addr = 0ULL;
+    if (memory_model_translate(model, 0x00C60000ULL, &phys_addr) != MEMORY_MODEL_STATUS_ERR_ADDR ||
+        !expect_translation(fork, 0x00C60000ULL, 0x01020000ULL, "test_tlb_range_longest_prefix")) {
+        fprintf(stderr, "test_tlb_range_longest_prefix: reset did not drop the range\n");
+        goto cleanup;
+    }
+
+    /* Random mixed spans against the RTL rule: smallest span, then lowest slot. */
+    uint64_t shadow_virt[ENTRIES];
+    uint64_t shadow_phys[ENTRIES];
+    uint32_t shadow_span[ENTRIES];
+    int shadow_valid[ENTRIES] = {0};
+    uint32_t write_ptr = 0U;
+    uint32_t lcg = 777U;
+
+    for (uint32_t round = 0U; round < ROUNDS; ++round) {
+        lcg = lcg * 1103515245U + 12345U;
+        uint32_t span = page_bits + ((lcg >> 16) % 4U) * 2U;
+        lcg = lcg * 1103515245U + 12345U;
+        uint64_t virt_base = (uint64_t)((lcg >> 12) & 0xFU) << (page_bits + 2U);
+        uint64_t phys_base = ((uint64_t)round << 20U) | 0x5ULL;
+
+        if (memory_model_load_tlb_range(model, virt_base, phys_base, span) != MEMORY_MODEL_ERROR_OK) {
+            fprintf(stderr, "test_tlb_range_longest_prefix: load failed\n");
+            goto cleanup;
+        }
+        shadow_virt[write_ptr] = virt_base;
+        shadow_phys[write_ptr] = phys_base;
+        shadow_span[write_ptr] = span;
+        shadow_valid[write_ptr] = 1;
+        write_ptr = (write_ptr + 1U) % ENTRIES;
+
+        for (uint32_t probe = 0U; probe < PROBES; ++probe) {
+            lcg = lcg * 1103515245U + 12345U;
+            uint64_t virt_addr = (uint64_t)(lcg >> 8) & mask_width(page_bits + 6U);
+            uint64_t expected = 0ULL;
+            memory_model_status_t expected_status = MEMORY_MODEL_STATUS_ERR_ADDR;
+            uint32_t best_span = 0U;
+            for (uint32_t i = 0U; i < ENTRIES; ++i) {
+                uint64_t offset = mask_width(shadow_span[i]);
+                if (shadow_valid[i] && (shadow_virt[i] & ~offset) == (virt_addr & ~offset) &&
+                    (expected_status != MEMORY_MODEL_STATUS_OK || shadow_span[i] < best_span)) {
+                    expected = ((shadow_phys[i] & ~offset) | (virt_addr & offset)) &
+                               mask_width(cfg.phys_addr_width);
+                    expected_status = MEMORY_MODEL_STATUS_OK;
+                    best_span = shadow_span[i];
+                }
+            }
+
+            uint64_t actual = 0ULL;
+            memory_model_status_t status = memory_model_translate(model, virt_addr, &actual);
+            if (status != expected_status || actual != expected) {
+                fprintf(stderr,
+                        "test_tlb_range_longest_prefix: round %" PRIu32 " addr 0x%" PRIx64
+                        " expected 0x%016" PRIx64 " got 0x%016" PRIx64 "\n",
+                        round, virt_addr, expected, actual);
+                goto cleanup;
+            }
+        }
+    }
+
+    success = 1;
+
+cleanup:
+    memory_model_destroy(fork);
+    memory_model_destroy(model);
+    return success;
+}
+
+static int test_tlb_flush_import_export(void)
+{
+    enum { ENTRIES = 8 };
+
+    int success = 0;
+    memory_model_t *model = NULL;
+    memory_model_config_t cfg = memory_model_config_default();
+    cfg.tlb_entries = ENTRIES;
+    memory_model_tlb_entry_t saved[ENTRIES];
+    memory_model_tlb_entry_t scratch[ENTRIES];
+    uint32_t saved_index = 0U;
+    uint64_t data = 0ULL;
+    uint64_t phys_addr = 0ULL;
+
+    if (memory_model_create(&cfg, &model) != MEMORY_MODEL_ERROR_OK) {
+        fprintf(stderr, "test_tlb_flush_import_export: failed to create model\n");
+        return 0;
+    }
+
+    /* Slot 1 carves page 0x41000 out of the range in slot 4. */
+    memory_model_load_tlb(model, 0x00001000ULL, 0x00002000ULL);
+    memory_model_load_tlb(model, 0x00041000ULL, 0x00003000ULL);
+    memory_model_load_tlb(model, 0x00005000ULL, 0x00006000ULL);
+    memory_model_load_tlb(model, 0x00001000ULL, 0x00007000ULL);
+    memory_model_load_tlb_range(model, 0x00040000ULL, 0x00100000ULL, 16U);
+    memory_model_write(model, 0x00001008ULL, 0xFFU, 0x0123456789ABCDEFULL);
+
+    if (memory_model_export_tlb(model, saved, ENTRIES - 1U, NULL) != MEMORY_MODEL_ERROR_BAD_ARGUMENT ||
+        memory_model_export_tlb(model, saved, ENTRIES, &saved_index) != MEMORY_MODEL_ERROR_OK ||
+        saved_index != 5U || !saved[4].valid || saved[4].span_bits != 16U || saved[5].valid ||
+        saved[0].span_bits != 12U || saved[1].virt_base != 0x00041000ULL) {
+        fprintf(stderr, "test_tlb_flush_import_export: unexpected export\n");
+        goto cleanup;
+    }
+
+    /* A page flush drops the plain page and the range covering it. */
+    memory_model_flush_tlb_page(model, 0x00041234ULL);
+    if (memory_model_translate(model, 0x00041234ULL, &phys_addr) != MEMORY_MODEL_STATUS_ERR_ADDR ||
+        memory_model_translate(model, 0x00048000ULL, &phys_addr) != MEMORY_MODEL_STATUS_ERR_ADDR ||
+        !expect_translation(model, 0x00001010ULL, 0x00002010ULL, "test_tlb_flush_import_export") ||
+        memory_model_active_entries(model) != 3U || memory_model_tlb_write_index(model) != 5U) {
+        fprintf(stderr, "test_tlb_flush_import_export: page flush went wrong\n");
+        goto cleanup;
+    }
+
+    /* Duplicates of a flushed page go too. */
+    memory_model_flush_tlb_page(model, 0x00001000ULL);
+    if (memory_model_translate(model, 0x00001000ULL, &phys_addr) != MEMORY_MODEL_STATUS_ERR_ADDR ||
+        memory_model_active_entries(model) != 1U) {
+        fprintf(stderr, "test_tlb_flush_import_export: duplicate survived a page flush\n");
+        goto cleanup;
+    }
+
+    /* A global flush (here through execute) keeps memory. */
+    memory_model_transaction_t flush = {MEMORY_MODEL_OP_FLUSH, 0ULL, 0U, 0ULL};
+    memory_model_result_t result;
+    if (memory_model_execute(model, &flush, &result) != MEMORY_MODEL_STATUS_OK ||
+        result.status != MEMORY_MODEL_STATUS_OK || memory_model_active_entries(model) != 0U ||
+        memory_model_tlb_write_index(model) != 0U ||
+        memory_model_translate(model, 0x00005000ULL, &phys_addr) != MEMORY_MODEL_STATUS_ERR_ADDR) {
+        fprintf(stderr, "test_tlb_flush_import_export: global flush went wrong\n");
+        goto cleanup;
+    }
+
+    /* Importing the export restores every mapping and the write index. */
+    if (memory_model_import_tlb(model, saved, ENTRIES, saved_index) != MEMORY_MODEL_ERROR_OK ||
+        memory_model_tlb_write_index(model) != 5U || memory_model_active_entries(model) != 5U ||
+        !expect_translation(model, 0x00041010ULL, 0x00003010ULL, "test_tlb_flush_import_export") ||
+        !expect_translation(model, 0x00048000ULL, 0x00108000ULL, "test_tlb_flush_import_export") ||
+        memory_model_read(model, 0x00001008ULL, 0xFFU, &data) != MEMORY_MODEL_STATUS_OK ||
+        data != 0x0123456789ABCDEFULL) {
+        fprintf(stderr, "test_tlb_flush_import_export: import did not restore the TLB\n");
+        goto cleanup;
+    }
+    if (memory_model_export_tlb(model, scratch, ENTRIES, NULL) != MEMORY_MODEL_ERROR_OK) {
+        goto cleanup;
+    }
+    for (uint32_t i = 0U; i < ENTRIES; ++i) {
+        if (scratch[i].valid != saved[i].valid || scratch[i].span_bits != saved[i].span_bits ||
+            scratch[i].virt_base != saved[i].virt_base || scratch[i].phys_base != saved[i].phys_base) {
+            fprintf(stderr, "test_tlb_flush_import_export: slot %" PRIu32 " differs after import\n", i);
+            goto cleanup;
+        }
+    }
+
+    /* Rejected imports leave the TLB alone. */
+    scratch[2].span_bits = 4U;
+    if (memory_model_import_tlb(model, scratch, ENTRIES, 0U) != MEMORY_MODEL_ERROR_BAD_ARGUMENT ||
+        memory_model_import_tlb(model, saved, ENTRIES + 1U, 0U) != MEMORY_MODEL_ERROR_BAD_ARGUMENT ||
+        memory_model_import_tlb(model, saved, ENTRIES, ENTRIES) != MEMORY_MODEL_ERROR_BAD_ARGUMENT ||
+        memory_model_active_entries(model) != 5U) {
+        fprintf(stderr, "test_tlb_flush_import_export: bad import accepted\n");
+        goto cleanup;
+    }
+
+    /* A partial import with span 0 loads plain pages into the leading slots. */
+    memset(scratch, 0, sizeof(scratch));
+    scratch[1].valid = true;
+    scratch[1].virt_base = 0x00009000ULL;
+    scratch[1].phys_base = 0x0000A000ULL;
+    if (memory_model_import_tlb(model, scratch, 2U, 2U) != MEMORY_MODEL_ERROR_OK ||
+        memory_model_active_entries(model) != 1U ||
+        !expect_translation(model, 0x00009FF0ULL, 0x0000AFF0ULL, "test_tlb_flush_import_export") ||
+        memory_model_translate(model, 0x00001000ULL, &phys_addr) != MEMORY_MODEL_STATUS_ERR_ADDR) {
+        fprintf(stderr, "test_tlb_flush_import_export: partial import went wrong\n");
+        goto cleanup;
+    }
+
+    success = 1;
+
+cleanup:
+    memory_model_destroy(model);
+    return success;
+}
+
+static int test_tlb_asid_switch(void)
+{
+    enum { ENTRIES = 8 };
+
+    int success = 0;
+    memory_model_t *model = NULL;
+    memory_model_config_t cfg = memory_model_config_default();
+    cfg.tlb_entries = ENTRIES;
+    memory_model_tlb_entry_t saved[ENTRIES];
+    uint32_t saved_index = 0U;
+    uint64_t data = 0ULL;
+    uint64_t phys_addr = 0ULL;
+    memory_model_result_t result;
+
+    if (memory_model_create(&cfg, &model) != MEMORY_MODEL_ERROR_OK) {
+        fprintf(stderr, "test_tlb_asid_switch: failed to create model\n");
+        return 0;
+    }
+
+    /* The same virtual page maps to a different frame in each address space. */
+    memory_model_load_tlb(model, 0x00001000ULL, 0x00002000ULL);
+    if (memory_model_set_asid(model, 1U) != MEMORY_MODEL_ERROR_OK || memory_model_current_asid(model) != 1U ||
+        memory_model_translate(model, 0x00001000ULL, &phys_addr) != MEMORY_MODEL_STATUS_ERR_ADDR) {
+        fprintf(stderr, "test_tlb_asid_switch: ASID 0 entry visible from ASID 1\n");
+        goto cleanup;
+    }
+    memory_model_load_tlb(model, 0x00001000ULL, 0x00003000ULL);
+    memory_model_load_tlb_range(model, 0x00040000ULL, 0x00100000ULL, 16U);
+    memory_model_write(model, 0x00001008ULL, 0xFFU, 0x1111111111111111ULL);
+
+    /* Switching back needs no reload: every entry stayed resident. */
+    memory_model_set_asid(model, 0U);
+    memory_model_write(model, 0x00001008ULL, 0xFFU, 0x2222222222222222ULL);
+    if (!expect_translation(model, 0x00001010ULL, 0x00002010ULL, "test_tlb_asid_switch") ||
+        memory_model_translate(model, 0x00048000ULL, &phys_addr) != MEMORY_MODEL_STATUS_ERR_ADDR ||
+        memory_model_active_entries(model) != 3U || memory_model_tlb_write_index(model) != 3U) {
+        fprintf(stderr, "test_tlb_asid_switch: wrong translation after switching back\n");
+        goto cleanup;
+    }
+
+    /* A page flush only affects the current address space. */
+    memory_model_flush_tlb_page(model, 0x00001000ULL);
+    memory_model_set_asid(model, 1U);
+    if (memory_model_active_entries(model) != 2U ||
+        !expect_translation(model, 0x00048000ULL, 0x00108000ULL, "test_tlb_asid_switch") ||
+        memory_model_read(model, 0x00001008ULL, 0xFFU, &data) != MEMORY_MODEL_STATUS_OK ||
+        data != 0x1111111111111111ULL) {
+        fprintf(stderr, "test_tlb_asid_switch: page flush reached another ASID\n");
+        goto cleanup;
+    }
+
+    /* Export records each entry's ASID and import restores it. */
+    if (memory_model_export_tlb(model, saved, ENTRIES, &saved_index) != MEMORY_MODEL_ERROR_OK ||
+        saved[0].valid || saved[1].asid != 1U || saved[2].asid != 1U) {
+        fprintf(stderr, "test_tlb_asid_switch: export lost the ASID\n");
+        goto cleanup;
+    }
+    saved[0] = saved[1];
+    saved[0].asid = 7U;
+    saved[0].phys_base = 0x00004000ULL;
+
+    /* The control operation, through execute, and its bounds. */
+    memory_model_transaction_t set_asid = {MEMORY_MODEL_OP_SET_ASID, 0ULL, 0U, 7U};
+    if (memory_model_execute(model, &set_asid, &result) != MEMORY_MODEL_STATUS_OK ||
+        result.status != MEMORY_MODEL_STATUS_OK || memory_model_current_asid(model) != 7U) {
+        fprintf(stderr, "test_tlb_asid_switch: SET_ASID transaction failed\n");
+        goto cleanup;
+    }
+    set_asid.data = MEMORY_MODEL_MAX_ASID + 1ULL;
+    if (memory_model_execute(model, &set_asid, &result) != MEMORY_MODEL_STATUS_ERR_ACCESS ||
+        memory_model_set_asid(model, MEMORY_MODEL_MAX_ASID + 1U) != MEMORY_MODEL_ERROR_BAD_ARGUMENT ||
+        memory_model_current_asid(model) != 7U) {
+        fprintf(stderr, "test_tlb_asid_switch: out-of-range ASID accepted\n");
+        goto cleanup;
+    }
+
+    if (memory_model_import_tlb(model, saved, ENTRIES, saved_index) != MEMORY_MODEL_ERROR_OK ||
+        !expect_translation(model, 0x00001010ULL, 0x00004010ULL, "test_tlb_asid_switch")) {
+        fprintf(stderr, "test_tlb_asid_switch: imported ASID 7 entry not used\n");
+        goto cleanup;
+    }
+    memory_model_set_asid(model, 1U);
+    if (!expect_translation(model, 0x00001010ULL, 0x00003010ULL, "test_tlb_asid_switch")) {
+        goto cleanup;
+    }
+    saved[3] = saved[1];
+    saved[3].asid = MEMORY_MODEL_MAX_ASID + 1U;
+    if (memory_model_import_tlb(model, saved, ENTRIES, 0U) != MEMORY_MODEL_ERROR_BAD_ARGUMENT ||
+        memory_model_active_entries(model) != 3U) {
+        fprintf(stderr, "test_tlb_asid_switch: import with a bad ASID accepted\n");
+        goto cleanup;
+    }
+
+    /* A global flush clears every address space but keeps the ASID; reset returns to 0. */
+    memory_model_flush_tlb(model);
+    memory_model_set_asid(model, 7U);
+    if (memory_model_active_entries(model) != 0U || memory_model_current_asid(model) != 7U ||
+        memory_model_translate(model, 0x00001010ULL, &phys_addr) != MEMORY_MODEL_STATUS_ERR_ADDR) {
+        fprintf(stderr, "test_tlb_asid_switch: global flush missed an address space\n");
+        goto cleanup;
+    }
+    memory_model_reset(model);
+    if (memory_model_current_asid(model) != 0U) {
+        fprintf(stderr, "test_tlb_asid_switch: reset kept the ASID\n");
+        goto cleanup;
+    }
+
+    success = 1;
+
+cleanup:
+    memory_model_destroy(model);
+    return success;
+}
+
+/*
+ * Two-level tables for a 32-bit space of 4 KB pages, 10 index bits per level,
+ * rooted at physical 0x0000: VA 0x00403000 maps to frame 0x2000 through the
+ * level-1 table at 0x1000, root slot 2 is a 4M-word superpage leaf onto
+ * physical 0, root slot 3 is invalid and level-1 slot 4 is a pointer where a
+ * leaf belongs.
+ */
+static int build_page_tables(memory_model_t *model)
+{
+    static const struct {
+        uint64_t phys_addr;
+        uint64_t pte;
+    } ptes[] = {
+        {0x0001ULL, 0x1000ULL | MEMORY_MODEL_PTE_VALID},
+        {0x0002ULL, 0x0000ULL | MEMORY_MODEL_PTE_VALID | MEMORY_MODEL_PTE_LEAF},
+        {0x1003ULL, 0x2000ULL | MEMORY_MODEL_PTE_VALID | MEMORY_MODEL_PTE_LEAF},
+        {0x1004ULL, 0x3000ULL | MEMORY_MODEL_PTE_VALID},
+    };
+
+    /* Tables are written through identity mappings, then the TLB starts cold. */
+    memory_model_load_tlb(model, 0x0000ULL, 0x0000ULL);
+    memory_model_load_tlb(model, 0x1000ULL, 0x1000ULL);
+    for (size_t i = 0U; i < sizeof(ptes) / sizeof(ptes[0]); ++i) {
+        if (memory_model_write(model, ptes[i].phys_addr, 0xFFU, ptes[i].pte) != MEMORY_MODEL_STATUS_OK) {
+            return 0;
+        }
+    }
+    return memory_model_flush_tlb(model) == MEMORY_MODEL_ERROR_OK;
+}
+
+static int test_page_table_walk(void)
+{
+    int success = 0;
+    memory_model_t *model = NULL;
+    memory_model_config_t cfg = memory_model_config_default();
+    cfg.tlb_entries = 4U;
+    memory_model_page_table_t table = {0x0000ULL, 2U, 10U};
+    memory_model_stats_t stats;
+    uint64_t data = 0ULL;
+    uint64_t phys_addr = 0ULL;
+    uint32_t depth = 0U;
+
+    for (int concurrent = 0; concurrent <= 1; ++concurrent) {
+        cfg.concurrent = concurrent != 0;
+        if (memory_model_create(&cfg, &model) != MEMORY_MODEL_ERROR_OK || !build_page_tables(model)) {
+            fprintf(stderr, "test_page_table_walk: failed to set up model\n");
+            goto cleanup;
+        }
+
+        /* Without a walker a miss still fails, and bad layouts are refused. */
+        memory_model_page_table_t bad_index = {0x0000ULL, 2U, 13U};
+        memory_model_page_table_t short_reach = {0x0000ULL, 1U, 10U};
+        memory_model_page_table_t too_deep = {0x0000ULL, MEMORY_MODEL_MAX_PT_LEVELS + 1U, 4U};
+        if (memory_model_read(model, 0x00403010ULL, 0xFFU, &data) != MEMORY_MODEL_STATUS_ERR_ADDR ||
+            memory_model_set_page_table(model, &bad_index) != MEMORY_MODEL_ERROR_BAD_ARGUMENT ||
+            memory_model_set_page_table(model, &short_reach) != MEMORY_MODEL_ERROR_BAD_ARGUMENT ||
+            memory_model_set_page_table(model, &too_deep) != MEMORY_MODEL_ERROR_BAD_ARGUMENT ||
+            memory_model_set_page_table(model, &table) != MEMORY_MODEL_ERROR_OK) {
+            fprintf(stderr, "test_page_table_walk: page table validation failed\n");
+            goto cleanup;
+        }
+        memory_model_reset_stats(model);
+
+        /* A miss walks both levels and fills the round-robin slot; the retry hits. */
+        if (memory_model_write(model, 0x00403010ULL, 0xFFU, 0x0123456789ABCDEFULL) != MEMORY_MODEL_STATUS_OK ||
+            memory_model_read(model, 0x00403010ULL, 0xFFU, &data) != MEMORY_MODEL_STATUS_OK ||
+            data != 0x0123456789ABCDEFULL || memory_model_active_entries(model) != 1U ||
+            memory_model_tlb_write_index(model) != 1U ||
+            !expect_translation(model, 0x00403010ULL, 0x00002010ULL, "test_page_table_walk")) {
+            fprintf(stderr, "test_page_table_walk: demand fill failed\n");
+            goto cleanup;
+        }
+
+        /* A leaf in the root maps a range that aliases the same frame. */
+        if (memory_model_walk(model, 0x00802010ULL, &phys_addr, &depth) != MEMORY_MODEL_STATUS_OK ||
+            phys_addr != 0x00002010ULL || depth != 1U ||
+            memory_model_read(model, 0x00802010ULL, 0xFFU, &data) != MEMORY_MODEL_STATUS_OK ||
+            data != 0x0123456789ABCDEFULL || memory_model_tlb_write_index(model) != 2U) {
+            fprintf(stderr, "test_page_table_walk: superpage leaf not honoured\n");
+            goto cleanup;
+        }
+
+        /* Faults report how far the walk got and leave the TLB alone. */
+        if (memory_model_translate(model, 0x00C00000ULL, &phys_addr) != MEMORY_MODEL_STATUS_ERR_ADDR ||
+            memory_model_walk(model, 0x00404000ULL, &phys_addr, &depth) != MEMORY_MODEL_STATUS_ERR_ADDR ||
+            depth != 2U || phys_addr != 0ULL || memory_model_active_entries(model) != 2U) {
+            fprintf(stderr, "test_page_table_walk: faulting walk misreported\n");
+            goto cleanup;
+        }
+
+        if (memory_model_get_stats(model, &stats) == MEMORY_MODEL_ERROR_OK &&
+            (stats.tlb_misses != 2U || stats.walk_count != 4U || stats.walk_pte_reads != 6U ||
+             stats.walk_faults != 2U || stats.tlb_load_count != 0U)) {
+            fprintf(stderr, "test_page_table_walk: wrong walk statistics\n");
+            goto cleanup;
+        }
+
+        /* Detaching, and reset, bring back software-managed misses. */
+        memory_model_flush_tlb(model);
+        if (memory_model_set_page_table(model, NULL) != MEMORY_MODEL_ERROR_OK ||
+            memory_model_translate(model, 0x00403010ULL, &phys_addr) != MEMORY_MODEL_STATUS_ERR_ADDR ||
+            memory_model_set_page_table(model, &table) != MEMORY_MODEL_ERROR_OK ||
+            memory_model_reset(model) != MEMORY_MODEL_ERROR_OK ||
+            memory_model_walk(model, 0x00403010ULL, &phys_addr, &depth) != MEMORY_MODEL_STATUS_ERR_ADDR ||
+            depth != 0U) {
+            fprintf(stderr, "test_page_table_walk: walker survived detach or reset\n");
+            goto cleanup;
+        }
+
+        memory_model_destroy(model);
+        model = NULL;
+    }
+
+    success = 1;
+
+cleanup:
+    memory_model_destroy(model);
+    return success;
+}
+
+/*
+ * Map virtual pages 0x10 to 0x10 + @pages - 1 onto frame 0x2000 through a
+ * two-level table rooted at 0x0000, attach the walker and flush the TLB.
+ */
+static int attach_linear_page_table(memory_model_t *model, uint32_t pages)
+{
+    const memory_model_page_table_t table = {0x0000ULL, 2U, 10U};
+
+    memory_model_load_tlb(model, 0x0000ULL, 0x0000ULL);
+    memory_model_load_tlb(model, 0x1000ULL, 0x1000ULL);
+    if (memory_model_write(model, 0x0000ULL, 0xFFU, 0x1000ULL | MEMORY_MODEL_PTE_VALID) != MEMORY_MODEL_STATUS_OK) {
+        return 0;
+    }
+    for (uint64_t page = 0U; page < pages; ++page) {
+        if (memory_model_write(model, 0x1010ULL + page, 0xFFU,
+                               0x2000ULL | MEMORY_MODEL_PTE_VALID | MEMORY_MODEL_PTE_LEAF) !=
+            MEMORY_MODEL_STATUS_OK) {
+            return 0;
+        }
+    }
+    return memory_model_flush_tlb(model) == MEMORY_MODEL_ERROR_OK &&
+           memory_model_set_page_table(model, &table) == MEMORY_MODEL_ERROR_OK;
+}
+
+/*
+ * memory_model_lookup() reports the same translation as
+ * memory_model_translate() but never walks or counts: a lookup before the
+ * walk misses and leaves the TLB unfilled.
+ */
+static int test_lookup_has_no_side_effects(void)
+{
+    int success = 0;
+    memory_model_t *model = NULL;
+    memory_model_config_t cfg = memory_model_config_default();
+    memory_model_stats_t stats;
+    const uint64_t virt_addr = (0x10ULL << 12U) | 0x5ULL;
+    uint64_t looked_up = 1ULL;
+    uint64_t translated = 0ULL;
+
+    if (memory_model_create(&cfg, &model) != MEMORY_MODEL_ERROR_OK) {
+        fprintf(stderr, "test_lookup_has_no_side_effects: failed to create model\n");
+        return 0;
+    }
+    if (!attach_linear_page_table(model, 1U)) {
+        fprintf(stderr, "test_lookup_has_no_side_effects: failed to build page tables\n");
+        goto cleanup;
+    }
+    memory_model_reset_stats(model);
+
+    if (memory_model_lookup(model, virt_addr, &looked_up) != MEMORY_MODEL_STATUS_ERR_ADDR || looked_up != 0U ||
+        memory_model_active_entries(model) != 0U) {
+        fprintf(stderr, "test_lookup_has_no_side_effects: lookup walked the page tables\n");
+        goto cleanup;
+    }
+    if (memory_model_translate(model, virt_addr, &translated) != MEMORY_MODEL_STATUS_OK ||
+        memory_model_lookup(model, virt_addr, &looked_up) != MEMORY_MODEL_STATUS_OK || looked_up != translated) {
+        fprintf(stderr, "test_lookup_has_no_side_effects: lookup disagrees with translate\n");
+        goto cleanup;
+    }
+    if (memory_model_get_stats(model, &stats) != MEMORY_MODEL_ERROR_OK || stats.tlb_hits != 0U ||
+        stats.tlb_misses != 1U) {
+        fprintf(stderr, "test_lookup_has_no_side_effects: lookup was counted\n");
+        goto cleanup;
+    }
+
+    success = 1;
+
+cleanup:
+    memory_model_destroy(model);
+    return success;
+}
+
+static int test_tlb_replacement_policies(void)
+{
+    /*
+     * Pages A-D fill a four-entry TLB, A is hit again and E misses: each
+     * policy evicts a different slot. Then E is flushed and F misses again:
+     * only round-robin ignores the hole (f_slot UINT32_MAX means E's slot).
+     */
+    static const struct {
+        memory_model_tlb_policy_t policy;
+        uint32_t e_slot;
+        uint32_t f_slot;
+    } cases[] = {
+        {MEMORY_MODEL_TLB_POLICY_ROUND_ROBIN, 0U, 1U},
+        {MEMORY_MODEL_TLB_POLICY_LRU, 1U, UINT32_MAX},
+        {MEMORY_MODEL_TLB_POLICY_PLRU, 2U, UINT32_MAX},
+        {MEMORY_MODEL_TLB_POLICY_RANDOM, UINT32_MAX, UINT32_MAX},
+        {MEMORY_MODEL_TLB_POLICY_FIFO, 0U, UINT32_MAX},
+    };
+    enum { ENTRIES = 4, PAGES = 6 };
+
+    int success = 0;
+    memory_model_t *model = NULL;
+    memory_model_config_t cfg = memory_model_config_default();
+    cfg.tlb_entries = ENTRIES;
+    memory_model_tlb_entry_t entries[ENTRIES];
+    memory_model_stats_t stats;
+    uint64_t phys_addr = 0ULL;
+
+    cfg.tlb_policy = (memory_model_tlb_policy_t)(MEMORY_MODEL_TLB_POLICY_FIFO + 1);
+    if (memory_model_create(&cfg, &model) != MEMORY_MODEL_ERROR_BAD_ARGUMENT) {
+        fprintf(stderr, "test_tlb_replacement_policies: unknown policy accepted\n");
+        goto cleanup;
+    }
+
+    for (size_t c = 0U; c < sizeof(cases) / sizeof(cases[0]); ++c) {
+        cfg.tlb_policy = cases[c].policy;
+        if (memory_model_create(&cfg, &model) != MEMORY_MODEL_ERROR_OK) {
+            fprintf(stderr, "test_tlb_replacement_policies: failed to create model\n");
+            goto cleanup;
+        }
+
+        /* Pages A, B, ... are virtual pages 0x10 onward. */
+        if (!attach_linear_page_table(model, PAGES)) {
+            fprintf(stderr, "test_tlb_replacement_policies: failed to build page tables\n");
+            goto cleanup;
+        }
+        memory_model_reset_stats(model);
+
+        for (uint64_t page = 0U; page < ENTRIES; ++page) {
+            memory_model_translate(model, (0x10ULL + page) << 12U, &phys_addr);
+        }
+        memory_model_translate(model, 0x10000ULL, &phys_addr);
+        memory_model_translate(model, 0x14000ULL, &phys_addr);
+
+        memory_model_export_tlb(model, entries, ENTRIES, NULL);
+        uint32_t e_slot = UINT32_MAX;
+        for (uint32_t i = 0U; i < ENTRIES; ++i) {
+            if (entries[i].valid && entries[i].virt_base == 0x14000ULL) {
+                e_slot = i;
+            }
+        }
+        if (e_slot == UINT32_MAX || (cases[c].e_slot != UINT32_MAX && e_slot != cases[c].e_slot)) {
+            fprintf(stderr, "test_tlb_replacement_policies: policy %d put E in slot %u\n",
+                    (int)cases[c].policy, e_slot);
+            goto cleanup;
+        }
+
+        /* Policy fills take an empty slot before evicting anything. */
+        uint32_t f_slot = cases[c].f_slot != UINT32_MAX ? cases[c].f_slot : e_slot;
+        memory_model_flush_tlb_page(model, 0x14000ULL);
+        memory_model_translate(model, 0x15000ULL, &phys_addr);
+        memory_model_export_tlb(model, entries, ENTRIES, NULL);
+        if (!entries[f_slot].valid || entries[f_slot].virt_base != 0x15000ULL) {
+            fprintf(stderr, "test_tlb_replacement_policies: policy %d misplaced F\n", (int)cases[c].policy);
+            goto cleanup;
+        }
+
+        if (memory_model_get_stats(model, &stats) == MEMORY_MODEL_ERROR_OK &&
+            (stats.tlb_hits != 1U || stats.tlb_misses != 6U ||
+             stats.tlb_evictions != (cases[c].policy == MEMORY_MODEL_TLB_POLICY_ROUND_ROBIN ? 2U : 1U))) {
+            fprintf(stderr, "test_tlb_replacement_policies: policy %d counted %" PRIu64 "/%" PRIu64 "/%" PRIu64
+                            "\n",
+                    (int)cases[c].policy, stats.tlb_hits, stats.tlb_misses, stats.tlb_evictions);
+            goto cleanup;
+        }
+
+        memory_model_destroy(model);
+        model = NULL;
+    }
+
+    success = 1;
+
+cleanup:
+    memory_model_destroy(model);
+    return success;
+}
+
+static int test_tlb_set_associative(void)
+{
+    enum { ENTRIES = 8, WAYS = 2 };
+
+    int success = 0;
+    memory_model_t *model = NULL;
+    memory_model_config_t cfg = memory_model_config_default();
+    memory_model_tlb_entry_t entries[ENTRIES];
+    uint32_t write_index = 0U;
+    uint64_t phys_addr = 0ULL;
+
+    /* Ways must split the TLB into a power-of-two number of sets. */
+    static const struct {
+        uint32_t entries;
+        uint32_t ways;
+        memory_model_tlb_policy_t policy;
+    } bad[] = {
+        {8U, 3U, MEMORY_MODEL_TLB_POLICY_ROUND_ROBIN},
+        {12U, 4U, MEMORY_MODEL_TLB_POLICY_ROUND_ROBIN},
+        {8U, 16U, MEMORY_MODEL_TLB_POLICY_ROUND_ROBIN},
+        {6U, 3U, MEMORY_MODEL_TLB_POLICY_PLRU},
+    };
+    for (size_t i = 0U; i < sizeof(bad) / sizeof(bad[0]); ++i) {
+        cfg.tlb_entries = bad[i].entries;
+        cfg.tlb_ways = bad[i].ways;
+        cfg.tlb_policy = bad[i].policy;
+        if (memory_model_create(&cfg, &model) != MEMORY_MODEL_ERROR_BAD_ARGUMENT) {
+            fprintf(stderr, "test_tlb_set_associative: %u entries in %u ways accepted\n", bad[i].entries,
+                    bad[i].ways);
+            goto cleanup;
+        }
+    }
+
+    cfg.tlb_entries = ENTRIES;
+    cfg.tlb_ways = WAYS;
+    cfg.tlb_policy = MEMORY_MODEL_TLB_POLICY_ROUND_ROBIN;
+    if (memory_model_create(&cfg, &model) != MEMORY_MODEL_ERROR_OK) {
+        fprintf(stderr, "test_tlb_set_associative: failed to create model\n");
+        goto cleanup;
+    }
+
+    /* Virtual pages 0, 4 and 8 share set 0, so the third load evicts the first. */
+    memory_model_load_tlb(model, 0x0000ULL, 0x1000ULL);
+    memory_model_load_tlb(model, 0x4000ULL, 0x2000ULL);
+    memory_model_load_tlb(model, 0x1000ULL, 0x3000ULL);
+    memory_model_load_tlb(model, 0x8000ULL, 0x0000ULL);
+    if (memory_model_translate(model, 0x0010ULL, &phys_addr) != MEMORY_MODEL_STATUS_ERR_ADDR ||
+        !expect_translation(model, 0x4010ULL, 0x2010ULL, "test_tlb_set_associative") ||
+        !expect_translation(model, 0x8010ULL, 0x0010ULL, "test_tlb_set_associative") ||
+        !expect_translation(model, 0x1010ULL, 0x3010ULL, "test_tlb_set_associative") ||
+        memory_model_active_entries(model) != 3U || memory_model_tlb_write_index(model) != 1U) {
+        fprintf(stderr, "test_tlb_set_associative: set 0 did not replace its own ways\n");
+        goto cleanup;
+    }
+
+    /* A range entry is placed by its address above its own span: 0x40000 >> 14 lands in set 0. */
+    memory_model_load_tlb_range(model, 0x40000ULL, 0x0000ULL, 14U);
+    if (memory_model_export_tlb(model, entries, ENTRIES, &write_index) != MEMORY_MODEL_ERROR_OK ||
+        !entries[1].valid || entries[1].virt_base != 0x40000ULL || !entries[2].valid ||
+        entries[2].virt_base != 0x1000ULL || write_index != 0U) {
+        fprintf(stderr, "test_tlb_set_associative: range entry misplaced\n");
+        goto cleanup;
+    }
+
+    /* Imports must keep every entry in its set, and resume the write index's set. */
+    if (memory_model_import_tlb(model, entries, ENTRIES, 3U) != MEMORY_MODEL_ERROR_OK) {
+        fprintf(stderr, "test_tlb_set_associative: round trip rejected\n");
+        goto cleanup;
+    }
+    memory_model_load_tlb(model, 0x5000ULL, 0x1000ULL);
+    if (memory_model_export_tlb(model, entries, ENTRIES, &write_index) != MEMORY_MODEL_ERROR_OK ||
+        entries[3].virt_base != 0x5000ULL || entries[2].virt_base != 0x1000ULL || write_index != 2U) {
+        fprintf(stderr, "test_tlb_set_associative: import lost the set's write way\n");
+        goto cleanup;
+    }
+    entries[4] = entries[2];
+    if (memory_model_import_tlb(model, entries, ENTRIES, 0U) != MEMORY_MODEL_ERROR_BAD_ARGUMENT) {
+        fprintf(stderr, "test_tlb_set_associative: entry in the wrong set imported\n");
+        goto cleanup;
+    }
+    memory_model_destroy(model);
+    model = NULL;
+
+    /* Walker fills evict within the set: LRU keeps page 0x10 and drops 0x14. */
+    cfg.tlb_policy = MEMORY_MODEL_TLB_POLICY_LRU;
+    if (memory_model_create(&cfg, &model) != MEMORY_MODEL_ERROR_OK || !attach_linear_page_table(model, 9U)) {
+        fprintf(stderr, "test_tlb_set_associative: failed to set up walker\n");
+        goto cleanup;
+    }
+    memory_model_translate(model, 0x10000ULL, &phys_addr);
+    memory_model_translate(model, 0x14000ULL, &phys_addr);
+    memory_model_translate(model, 0x11000ULL, &phys_addr);
+    memory_model_translate(model, 0x10000ULL, &phys_addr);
+    memory_model_translate(model, 0x18000ULL, &phys_addr);
+    if (memory_model_export_tlb(model, entries, ENTRIES, NULL) != MEMORY_MODEL_ERROR_OK ||
+        entries[0].virt_base != 0x10000ULL || entries[1].virt_base != 0x18000ULL ||
+        entries[2].virt_base != 0x11000ULL || memory_model_active_entries(model) != 3U) {
+        fprintf(stderr, "test_tlb_set_associative: LRU evicted outside the set\n");
+        goto cleanup;
+    }
+
+    success = 1;
+
+cleanup:
+    memory_model_destroy(model);
+    return success;
+}
+
+static int expect_cache(memory_model_t *model, bool write, uint64_t virt_addr, memory_model_cache_result_t expected)
+{
+    memory_model_cache_result_t result = MEMORY_MODEL_CACHE_NONE;
+    uint64_t data = 0ULL;
+    memory_model_status_t status = write ? memory_model_write_cached(model, virt_addr, 0xFFU, virt_addr, &result)
+                                         : memory_model_read_cached(model, virt_addr, 0xFFU, &data, &result);
+    if (status != MEMORY_MODEL_STATUS_OK || result != expected) {
+        fprintf(stderr, "test_data_cache: %s 0x%llx gave cache result %d, expected %d\n", write ? "write" : "read",
+                (unsigned long long)virt_addr, (int)result, (int)expected);
+        return 0;
+    }
+    return 1;
+}
+
+static int test_data_cache(void)
+{
+    int success = 0;
+    memory_model_t *model = NULL;
+    memory_model_t *fork = NULL;
+    memory_model_config_t cfg = memory_model_config_default();
+    memory_model_cache_result_t result = MEMORY_MODEL_CACHE_HIT;
+    memory_model_stats_t stats;
+    uint64_t data = 0ULL;
+    uint8_t block[20U * 8U];
+
+    /* Geometry rules mirror the TLB's, plus whole power-of-two lines of words. */
+    static const struct {
+        uint64_t size;
+        uint32_t line;
+        uint32_t ways;
+    } bad[] = {
+        {512U, 48U, 2U}, {500U, 64U, 2U}, {512U, 64U, 3U}, {768U, 64U, 4U}, {512U, 64U, 16U}, {512U, 0U, 2U},
+    };
+    for (size_t i = 0U; i < sizeof(bad) / sizeof(bad[0]); ++i) {
+        cfg.cache_size = bad[i].size;
+        cfg.cache_line_size = bad[i].line;
+        cfg.cache_ways = bad[i].ways;
+        if (memory_model_create(&cfg, &model) != MEMORY_MODEL_ERROR_BAD_ARGUMENT) {
+            fprintf(stderr, "test_data_cache: bad geometry %u accepted\n", (unsigned)i);
+            goto cleanup;
+        }
+    }
+    cfg.cache_size = 256U;
+    cfg.cache_line_size = 64U;
+    cfg.cache_ways = 2U;
+    cfg.concurrent = true;
+    if (memory_model_create(&cfg, &model) != MEMORY_MODEL_ERROR_UNSUPPORTED) {
+        fprintf(stderr, "test_data_cache: concurrent cache accepted\n");
+        goto cleanup;
+    }
+
+    /* Four 8-word lines in two sets of two ways, write-back with LRU. */
+    cfg.concurrent = false;
+    if (memory_model_create(&cfg, &model) != MEMORY_MODEL_ERROR_OK ||
+        memory_model_load_tlb(model, 0x0000ULL, 0x0000ULL) != MEMORY_MODEL_ERROR_OK) {
+        fprintf(stderr, "test_data_cache: failed to create model\n");
+        goto cleanup;
+    }
+    if (!expect_cache(model, false, 0x00ULL, MEMORY_MODEL_CACHE_MISS) ||
+        !expect_cache(model, false, 0x07ULL, MEMORY_MODEL_CACHE_HIT) ||
+        !expect_cache(model, false, 0x08ULL, MEMORY_MODEL_CACHE_MISS) ||
+        !expect_cache(model, true, 0x10ULL, MEMORY_MODEL_CACHE_MISS) ||
+        !expect_cache(model, false, 0x20ULL, MEMORY_MODEL_CACHE_MISS) ||
+        !expect_cache(model, false, 0x30ULL, MEMORY_MODEL_CACHE_MISS_WRITEBACK) ||
+        !expect_cache(model, false, 0x00ULL, MEMORY_MODEL_CACHE_MISS)) {
+        goto cleanup;
+    }
+
+    /* The cache only keeps tags: evicted data still reads back, through another miss. */
+    if (memory_model_read(model, 0x10ULL, 0xFFU, &data) != MEMORY_MODEL_STATUS_OK || data != 0x10ULL) {
+        fprintf(stderr, "test_data_cache: evicted write lost\n");
+        goto cleanup;
+    }
+
+    /* Accesses that never reach memory leave the cache alone. */
+    if (memory_model_write_cached(model, 0x00ULL, 0U, 0ULL, &result) != MEMORY_MODEL_STATUS_OK ||
+        result != MEMORY_MODEL_CACHE_NONE ||
+        memory_model_read_cached(model, 0x5000ULL, 0xFFU, &data, &result) != MEMORY_MODEL_STATUS_ERR_ADDR ||
+        result != MEMORY_MODEL_CACHE_NONE) {
+        fprintf(stderr, "test_data_cache: faulting access reported a cache result\n");
+        goto cleanup;
+    }
+
+    if (memory_model_get_stats(model, &stats) == MEMORY_MODEL_ERROR_OK &&
+        (stats.cache_read_hits != 1U || stats.cache_read_misses != 6U || stats.cache_write_hits != 0U ||
+         stats.cache_write_misses != 1U || stats.cache_writebacks != 1U)) {
+        fprintf(stderr, "test_data_cache: counters %llu/%llu/%llu/%llu/%llu\n",
+                (unsigned long long)stats.cache_read_hits, (unsigned long long)stats.cache_read_misses,
+                (unsigned long long)stats.cache_write_hits, (unsigned long long)stats.cache_write_misses,
+                (unsigned long long)stats.cache_writebacks);
+        goto cleanup;
+    }
+
+    /* A flush writes back dirty lines only, and empties the cache. */
+    memory_model_reset_stats(model);
+    if (!expect_cache(model, true, 0x00ULL, MEMORY_MODEL_CACHE_HIT) ||
+        memory_model_flush_cache(model) != MEMORY_MODEL_ERROR_OK ||
+        !expect_cache(model, false, 0x00ULL, MEMORY_MODEL_CACHE_MISS)) {
+        goto cleanup;
+    }
+
+    /* A 20-word block over three lines probes each line once and hits for the rest. */
+    if (memory_model_read_block(model, 0x84ULL, block, sizeof(block)) != MEMORY_MODEL_STATUS_OK) {
+        fprintf(stderr, "test_data_cache: block read failed\n");
+        goto cleanup;
+    }
+    if (memory_model_get_stats(model, &stats) == MEMORY_MODEL_ERROR_OK &&
+        (stats.cache_writebacks != 1U || stats.cache_read_misses != 4U || stats.cache_read_hits != 17U ||
+         stats.cache_write_hits != 1U)) {
+        fprintf(stderr, "test_data_cache: flush or block counted wrong\n");
+        goto cleanup;
+    }
+
+    /* Forks carry the cache; reset empties it. */
+    if (memory_model_fork(model, &fork) != MEMORY_MODEL_ERROR_OK ||
+        !expect_cache(fork, false, 0x90ULL, MEMORY_MODEL_CACHE_HIT) ||
+        memory_model_reset(fork) != MEMORY_MODEL_ERROR_OK ||
+        memory_model_load_tlb(fork, 0x0000ULL, 0x0000ULL) != MEMORY_MODEL_ERROR_OK ||
+        !expect_cache(fork, false, 0x90ULL, MEMORY_MODEL_CACHE_MISS)) {
+        fprintf(stderr, "test_data_cache: fork or reset mishandled the cache\n");
+        goto cleanup;
+    }
+    memory_model_destroy(fork);
+    fork = NULL;
+    memory_model_destroy(model);
+    model = NULL;
+
+    /*
+     * Write-through never allocates on a write miss and never writes back.
+     * FIFO evicts line 0, the oldest fill, despite its later hit.
+     */
+    cfg.cache_write_policy = MEMORY_MODEL_CACHE_WRITE_THROUGH;
+    cfg.cache_policy = MEMORY_MODEL_TLB_POLICY_FIFO;
+    if (memory_model_create(&cfg, &model) != MEMORY_MODEL_ERROR_OK ||
+        memory_model_load_tlb(model, 0x0000ULL, 0x0000ULL) != MEMORY_MODEL_ERROR_OK) {
+        fprintf(stderr, "test_data_cache: failed to create write-through model\n");
+        goto cleanup;
+    }
+    if (!expect_cache(model, true, 0x00ULL, MEMORY_MODEL_CACHE_MISS) ||
+        !expect_cache(model, false, 0x00ULL, MEMORY_MODEL_CACHE_MISS) ||
+        !expect_cache(model, true, 0x01ULL, MEMORY_MODEL_CACHE_HIT) ||
+        !expect_cache(model, false, 0x10ULL, MEMORY_MODEL_CACHE_MISS) ||
+        !expect_cache(model, false, 0x00ULL, MEMORY_MODEL_CACHE_HIT) ||
+        !expect_cache(model, false, 0x20ULL, MEMORY_MODEL_CACHE_MISS) ||
+        !expect_cache(model, false, 0x10ULL, MEMORY_MODEL_CACHE_HIT) ||
+        !expect_cache(model, false, 0x00ULL, MEMORY_MODEL_CACHE_MISS) ||
+        memory_model_flush_cache(model) != MEMORY_MODEL_ERROR_OK) {
+        goto cleanup;
+    }
+    if (memory_model_get_stats(model, &stats) == MEMORY_MODEL_ERROR_OK && stats.cache_writebacks != 0U) {
+        fprintf(stderr, "test_data_cache: write-through wrote back\n");
+        goto cleanup;
+    }
+
+    success = 1;
+
+cleanup:
+    memory_model_destroy(fork);
+    memory_model_destroy(model);
+    return success;
+}
+
+static int test_masked_access_all_widths(void)
+{
+    for (uint32_t width = 8U; width <= 64U; width += 8U) {
+        memory_model_t *model = NULL;
+        memory_model_config_t cfg = memory_model_config_default();
+        cfg.data_width = width;
+
+        if (memory_model_create(&cfg, &model) != MEMORY_MODEL_ERROR_OK) {
+            fprintf(stderr, "test_masked_access_all_widths: failed to create %" PRIu32 "-bit model\n", width);
+            return 0;
+        }
+        /* The mapped frame ends at the last word of the backing store. */
+        memory_model_load_tlb(model, 0x00000000ULL, cfg.mem_depth - cfg.page_size);
+
+        const uint32_t bytes = width / 8U;
+        const uint32_t full_mask = (1U << bytes) - 1U;
+        const uint64_t data_mask = mask_width(width);
+        uint64_t shadow = 0ULL;
+        uint64_t pattern = 0x0123456789ABCDEFULL;
+
+        for (uint32_t mask = 0U; mask <= full_mask; ++mask) {
+            pattern = pattern * 6364136223846793005ULL + 1442695040888963407ULL;
+
+            /* The second address is the final word, so kernels must not touch past it. */
+            const uint64_t addrs[2] = {0x00000010ULL, cfg.page_size - 1U};
+            for (size_t a = 0U; a < 2U; ++a) {
+                if (memory_model_write(model, addrs[a], mask, pattern) != MEMORY_MODEL_STATUS_OK) {
+                    fprintf(stderr, "test_masked_access_all_widths: write failed (width %" PRIu32 ")\n", width);
+                    memory_model_destroy(model);
+                    return 0;
+                }
+            }
+            for (uint32_t i = 0U; i < bytes; ++i) {
+                if ((mask & (1U << i)) != 0U) {
+                    uint64_t lane = 0xFFULL << (i * 8U);
+                    shadow = (shadow & ~lane) | (pattern & lane);
+                }
+            }
+
+            for (uint32_t read_mask = 0U; read_mask <= full_mask; read_mask += (read_mask == 0U) ? 1U : read_mask) {
+                uint64_t expected = 0ULL;
+                uint32_t effective = (read_mask == 0U) ? full_mask : read_mask;
+                for (uint32_t i = 0U; i < bytes; ++i) {
+                    if ((effective & (1U << i)) != 0U) {
+                        expected |= shadow & (0xFFULL << (i * 8U));
+                    }
+                }
+                expected &= data_mask;
+
+                for (size_t a = 0U; a < 2U; ++a) {
+                    uint64_t data = 0ULL;
+                    if (memory_model_read(model, addrs[a], read_mask, &data) != MEMORY_MODEL_STATUS_OK ||
+                        data != expected) {
+                        fprintf(stderr,
+                                "test_masked_access_all_widths: width %" PRIu32 " mask 0x%" PRIx32
+                                " read 0x%016" PRIx64 " expected 0x%016" PRIx64 "\n",
+                                width, read_mask, data, expected);
+                        memory_model_destroy(model);
+                        return 0;
+                    }
+                }
+            }
+        }
+
+        memory_model_destroy(model);
+    }
+
+    return 1;
+}
+
+static int test_execute_batch_matches_single_ops(void)
+{
+    enum { OPS = 512 };
+
+    int success = 0;
+    memory_model_t *batch_model = NULL;
+    memory_model_t *single_model = NULL;
+    memory_model_config_t cfg = memory_model_config_default();
+    cfg.tlb_entries = 4U;
+
+    if (memory_model_create(&cfg, &batch_model) != MEMORY_MODEL_ERROR_OK ||
+        memory_model_create(&cfg, &single_model) != MEMORY_MODEL_ERROR_OK) {
+        fprintf(stderr, "test_execute_batch_matches_single_ops: failed to create models\n");
+        goto cleanup;
+    }
+
+    static uint8_t op[OPS];
+    static uint64_t virt_addr[OPS];
+    static uint32_t byte_mask[OPS];
+    static uint64_t data[OPS];
+    static memory_model_status_t status[OPS];
+    static uint64_t data_out[OPS];
+    uint32_t lcg = 99U;
+
+    for (size_t i = 0U; i < OPS; ++i) {
+        lcg = lcg * 1103515245U + 12345U;
+        uint32_t pick = (lcg >> 16) % 16U;
+        /* Mostly reads/writes over five pages, with occasional TLB reloads and bad opcodes. */
+        op[i] = pick < 7U ? MEMORY_MODEL_OP_READ
+              : pick < 14U ? MEMORY_MODEL_OP_WRITE
+              : pick < 15U ? MEMORY_MODEL_OP_TLB_LOAD
+                           : 0x7U;
+        virt_addr[i] = ((uint64_t)(lcg % 5U) << 12) | ((lcg >> 8) & 0x3FU);
+        byte_mask[i] = (lcg >> 3) & 0x1FFU; /* occasionally out of range */
+        data[i] = ((uint64_t)lcg << 32) ^ (i * 0x9E3779B97F4A7C15ULL);
+        if (op[i] == MEMORY_MODEL_OP_TLB_LOAD) {
+            virt_addr[i] &= ~0xFFFULL;
+            data[i] = (uint64_t)((lcg >> 4) % 4U) << 12;
+        }
+    }
+
+    const memory_model_batch_t batch = {OPS, op, virt_addr, byte_mask, data};
+    const memory_model_batch_results_t results = {status, data_out};
+    if (memory_model_execute_batch(batch_model, &batch, &results) != MEMORY_MODEL_ERROR_OK) {
+        fprintf(stderr, "test_execute_batch_matches_single_ops: batch rejected\n");
+        goto cleanup;
+    }
+
+    for (size_t i = 0U; i < OPS; ++i) {
+        const memory_model_transaction_t trans = {(memory_model_op_t)op[i], virt_addr[i], byte_mask[i], data[i]};
+        memory_model_result_t expected;
+        memory_model_execute(single_model, &trans, &expected);
+        if (status[i] != expected.status || data_out[i] != expected.data) {
+            fprintf(stderr,
+                    "test_execute_batch_matches_single_ops: op %zu status %d/%d data 0x%016" PRIx64
+                    "/0x%016" PRIx64 "\n",
+                    i, (int)status[i], (int)expected.status, data_out[i], expected.data);
+            goto cleanup;
+        }
+    }
+
+    const memory_model_batch_t missing_column = {1U, op, NULL, byte_mask, data};
+    if (memory_model_execute_batch(batch_model, &missing_column, &results) != MEMORY_MODEL_ERROR_BAD_ARGUMENT) {
+        fprintf(stderr, "test_execute_batch_matches_single_ops: missing column accepted\n");
+        goto cleanup;
+    }
+
+    success = 1;
+
+cleanup:
+    memory_model_destroy(single_model);
+    memory_model_destroy(batch_model);
+    return success;
+}
+
+static int test_sparse_backing_store(void)
+{
+    int success = 0;
+    memory_model_t *model = NULL;
+    memory_model_config_t cfg = memory_model_config_default();
+    cfg.phys_addr_width = 36U;
+    cfg.mem_depth = 1ULL << 36;
+    cfg.sparse = true;
+
+    if (memory_model_create(&cfg, &model) != MEMORY_MODEL_ERROR_OK) {
+        fprintf(stderr, "test_sparse_backing_store: failed to create model\n");
+        return 0;
+    }
+
+    if (memory_model_resident_bytes(model) != 0U) {
+        fprintf(stderr, "test_sparse_backing_store: pages allocated before first write\n");
+        goto cleanup;
+    }
+
+    const uint64_t frames[3] = {0x000001000ULL, 0x7FFFFF000ULL, 0xFFFFFF000ULL};
+    for (size_t i = 0U; i < 3U; ++i) {
+        memory_model_load_tlb(model, (uint64_t)(i + 1U) << 12, frames[i]);
+    }
+
+    uint64_t data = 1ULL;
+    if (memory_model_read(model, 0x00002040ULL, 0xFFU, &data) != MEMORY_MODEL_STATUS_OK || data != 0ULL) {
+        fprintf(stderr, "test_sparse_backing_store: untouched page did not read as zero\n");
+        goto cleanup;
+    }
+    if (memory_model_resident_bytes(model) != 0U) {
+        fprintf(stderr, "test_sparse_backing_store: read allocated a page\n");
+        goto cleanup;
+    }
+
+    for (size_t i = 0U; i < 3U; ++i) {
+        uint64_t virt = ((uint64_t)(i + 1U) << 12) | 0xFFFU;
+        if (memory_model_write(model, virt, 0xFFU, 0xA5A5000000000000ULL | i) != MEMORY_MODEL_STATUS_OK) {
+            fprintf(stderr, "test_sparse_backing_store: write %zu failed\n", i);
+            goto cleanup;
+        }
+    }
+
+    for (size_t i = 0U; i < 3U; ++i) {
+        uint64_t virt = ((uint64_t)(i + 1U) << 12) | 0xFFFU;
+        if (memory_model_read(model, virt, 0xFFU, &data) != MEMORY_MODEL_STATUS_OK ||
+            data != (0xA5A5000000000000ULL | i)) {
+            fprintf(stderr, "test_sparse_backing_store: readback %zu mismatch (0x%016" PRIx64 ")\n", i, data);
+            goto cleanup;
+        }
+    }
+
+    /* Three scattered pages out of a 512 GiB store. */
+    size_t resident = memory_model_resident_bytes(model);
+    if (resident == 0U || resident > 3U * 1024U * 8U) {
+        fprintf(stderr, "test_sparse_backing_store: unexpected footprint %zu bytes\n", resident);
+        goto cleanup;
+    }
+
+    /* Reset keeps the pages for reuse but they must read back as zero. */
+    if (memory_model_reset(model) != MEMORY_MODEL_ERROR_OK || memory_model_resident_bytes(model) != resident) {
+        fprintf(stderr, "test_sparse_backing_store: reset changed the footprint\n");
+        goto cleanup;
+    }
+    memory_model_load_tlb(model, 0x00001000ULL, frames[0]);
+    if (memory_model_read(model, 0x00001FFFULL, 0xFFU, &data) != MEMORY_MODEL_STATUS_OK || data != 0ULL) {
+        fprintf(stderr, "test_sparse_backing_store: stale page visible after reset\n");
+        goto cleanup;
+    }
+
+    success = 1;
+
+cleanup:
+    memory_model_destroy(model);
+    return success;
+}
+
+static int test_lazy_reset_zeroes_on_touch(void)
+{
+    int success = 0;
+    memory_model_t *model = NULL;
+    memory_model_config_t cfg = memory_model_config_default();
+
+    if (memory_model_create(&cfg, &model) != MEMORY_MODEL_ERROR_OK) {
+        fprintf(stderr, "test_lazy_reset_zeroes_on_touch: failed to create model\n");
+        return 0;
+    }
+
+    for (uint32_t round = 0U; round < 3U; ++round) {
+        memory_model_load_tlb(model, 0x00000000ULL, 0x00001000ULL);
+        memory_model_load_tlb(model, 0x00001000ULL, 0x00002000ULL);
+
+        uint64_t data = 0ULL;
+        /* Both words were fully written in the previous round. */
+        if (memory_model_read(model, 0x00000008ULL, 0xFFU, &data) != MEMORY_MODEL_STATUS_OK || data != 0ULL) {
+            fprintf(stderr, "test_lazy_reset_zeroes_on_touch: round %" PRIu32 " untouched word not zero\n", round);
+            goto cleanup;
+        }
+
+        /* A partial write to a stale page must not resurrect the other bytes. */
+        if (memory_model_write(model, 0x00001010ULL, 0x01U, 0x77ULL + round) != MEMORY_MODEL_STATUS_OK ||
+            memory_model_read(model, 0x00001010ULL, 0xFFU, &data) != MEMORY_MODEL_STATUS_OK ||
+            data != 0x77ULL + round) {
+            fprintf(stderr, "test_lazy_reset_zeroes_on_touch: round %" PRIu32 " partial write read 0x%016" PRIx64 "\n",
+                    round, data);
+            goto cleanup;
+        }
+
+        memory_model_write(model, 0x00000008ULL, 0xFFU, UINT64_MAX);
+        memory_model_write(model, 0x00001010ULL, 0xFFU, UINT64_MAX);
+
+        if (memory_model_reset(model) != MEMORY_MODEL_ERROR_OK) {
+            fprintf(stderr, "test_lazy_reset_zeroes_on_touch: reset failed\n");
+            goto cleanup;
+        }
+
+        uint64_t phys_addr = 0ULL;
+        if (memory_model_translate(model, 0x00001010ULL, &phys_addr) != MEMORY_MODEL_STATUS_ERR_ADDR ||
+            memory_model_active_entries(model) != 0U) {
+            fprintf(stderr, "test_lazy_reset_zeroes_on_touch: TLB survived reset\n");
+            goto cleanup;
+        }
+    }
+
+    success = 1;
+
+cleanup:
+    memory_model_destroy(model);
+    return success;
+}
+
+static int expect_read(memory_model_t *model, uint64_t virt_addr, memory_model_status_t expected_status,
+                       uint64_t expected_data, const char *context)
+{
+    uint64_t data = 0ULL;
+    memory_model_status_t status = memory_model_read(model, virt_addr, 0xFFU, &data);
+    if (status != expected_status || data != expected_data) {
+        fprintf(stderr, "%s: read 0x%016" PRIx64 " returned status %d data 0x%016" PRIx64
+                        " (expected %d / 0x%016" PRIx64 ")\n",
+                context, virt_addr, (int)status, data, (int)expected_status, expected_data);
+        return 0;
+    }
+    return 1;
+}
+
+static int test_fork_copy_on_write(void)
+{
+    int success = 0;
+    memory_model_t *parent = NULL;
+    memory_model_t *child = NULL;
+    memory_model_config_t cfg = memory_model_config_default();
+    cfg.sparse = true;
+
+    if (memory_model_create(&cfg, &parent) != MEMORY_MODEL_ERROR_OK) {
+        fprintf(stderr, "test_fork_copy_on_write: failed to create model\n");
+        return 0;
+    }
+
+    memory_model_load_tlb(parent, 0x00000000ULL, 0x00001000ULL);
+    memory_model_write(parent, 0x00000010ULL, 0xFFU, 0x1111111111111111ULL);
+    memory_model_write(parent, 0x00000020ULL, 0xFFU, 0x2222222222222222ULL);
+
+    if (memory_model_fork(parent, &child) != MEMORY_MODEL_ERROR_OK) {
+        fprintf(stderr, "test_fork_copy_on_write: fork failed\n");
+        goto cleanup;
+    }
+
+    /* Diverge both sides on the shared page and on the TLB. */
+    memory_model_write(child, 0x00000010ULL, 0x0FU, 0x00000000AAAAAAAAULL);
+    memory_model_write(parent, 0x00000020ULL, 0xFFU, 0x3333333333333333ULL);
+    memory_model_load_tlb(child, 0x00001000ULL, 0x00002000ULL);
+
+    if (!expect_read(parent, 0x00000010ULL, MEMORY_MODEL_STATUS_OK, 0x1111111111111111ULL, "test_fork_copy_on_write") ||
+        !expect_read(parent, 0x00000020ULL, MEMORY_MODEL_STATUS_OK, 0x3333333333333333ULL, "test_fork_copy_on_write") ||
+        !expect_read(parent, 0x00001000ULL, MEMORY_MODEL_STATUS_ERR_ADDR, 0ULL, "test_fork_copy_on_write") ||
+        !expect_read(child, 0x00000010ULL, MEMORY_MODEL_STATUS_OK, 0x11111111AAAAAAAAULL, "test_fork_copy_on_write") ||
+        !expect_read(child, 0x00000020ULL, MEMORY_MODEL_STATUS_OK, 0x2222222222222222ULL, "test_fork_copy_on_write") ||
+        !expect_read(child, 0x00001000ULL, MEMORY_MODEL_STATUS_OK, 0ULL, "test_fork_copy_on_write")) {
+        goto cleanup;
+    }
+
+    /* Resetting the parent must not disturb the child's view of shared pages. */
+    memory_model_write(parent, 0x00000030ULL, 0xFFU, 0x4444444444444444ULL);
+    memory_model_reset(parent);
+    memory_model_destroy(parent);
+    parent = NULL;
+
+    if (!expect_read(child, 0x00000020ULL, MEMORY_MODEL_STATUS_OK, 0x2222222222222222ULL, "test_fork_copy_on_write") ||
+        !expect_read(child, 0x00000030ULL, MEMORY_MODEL_STATUS_OK, 0ULL, "test_fork_copy_on_write")) {
+        goto cleanup;
+    }
+
+    success = 1;
+
+cleanup:
+    memory_model_destroy(child);
+    memory_model_destroy(parent);
+    return success;
+}
+
+static int test_snapshot_restore(void)
+{
+    int success = 0;
+    memory_model_t *model = NULL;
+    memory_model_t *other = NULL;
+    memory_model_snapshot_t *snapshot = NULL;
+    memory_model_config_t cfg = memory_model_config_default();
+
+    if (memory_model_create(&cfg, &model) != MEMORY_MODEL_ERROR_OK) {
+        fprintf(stderr, "test_snapshot_restore: failed to create model\n");
+        return 0;
+    }
+
+    memory_model_load_tlb(model, 0x00004000ULL, 0x00001000ULL);
+    memory_model_write(model, 0x00004008ULL, 0xFFU, 0x0123456789ABCDEFULL);
+
+    if (memory_model_snapshot(model, &snapshot) != MEMORY_MODEL_ERROR_OK) {
+        fprintf(stderr, "test_snapshot_restore: snapshot failed\n");
+        goto cleanup;
+    }
+
+    for (uint32_t run = 0U; run < 3U; ++run) {
+        /* Each "test" scribbles over the warm state in a different way. */
+        if (run == 0U) {
+            memory_model_write(model, 0x00004008ULL, 0xFFU, UINT64_MAX);
+        } else if (run == 1U) {
+            memory_model_reset(model);
+        } else {
+            memory_model_load_tlb(model, 0x00004000ULL, 0x00002000ULL);
+            memory_model_write(model, 0x00004008ULL, 0x01U, 0x55ULL);
+        }
+
+        if (memory_model_restore(model, snapshot) != MEMORY_MODEL_ERROR_OK) {
+            fprintf(stderr, "test_snapshot_restore: restore %" PRIu32 " failed\n", run);
+            goto cleanup;
+        }
+        if (!expect_read(model, 0x00004008ULL, MEMORY_MODEL_STATUS_OK, 0x0123456789ABCDEFULL, "test_snapshot_restore") ||
+            memory_model_active_entries(model) != 1U || memory_model_tlb_write_index(model) != 1U) {
+            fprintf(stderr, "test_snapshot_restore: state not restored on run %" PRIu32 "\n", run);
+            goto cleanup;
+        }
+    }
+
+    cfg.tlb_entries = 8U;
+    if (memory_model_create(&cfg, &other) != MEMORY_MODEL_ERROR_OK) {
+        fprintf(stderr, "test_snapshot_restore: failed to create second model\n");
+        goto cleanup;
+    }
+    if (memory_model_restore(other, snapshot) != MEMORY_MODEL_ERROR_BAD_ARGUMENT) {
+        fprintf(stderr, "test_snapshot_restore: restore across configurations accepted\n");
+        goto cleanup;
+    }
+
+    success = 1;
+
+cleanup:
+    memory_model_snapshot_destroy(snapshot);
+    memory_model_destroy(other);
+    memory_model_destroy(model);
+    return success;
+}
+
+static int test_stats_counters(void)
+{
+    int success = 0;
+    memory_model_t *model = NULL;
+    memory_model_t *fork = NULL;
+    memory_model_config_t cfg = memory_model_config_default();
+    memory_model_stats_t stats;
+    memory_model_miss_entry_t misses[4];
+    uint64_t slot_hits[4] = {0};
+    uint64_t data = 0ULL;
+
+    if (memory_model_create(&cfg, &model) != MEMORY_MODEL_ERROR_OK) {
+        fprintf(stderr, "test_stats_counters: failed to create model\n");
+        return 0;
+    }
+
+    memory_model_load_tlb(model, 0x00004000ULL, 0x00001000ULL);
+    memory_model_load_tlb(model, 0x00005000ULL, 0x00002000ULL);
+    memory_model_write(model, 0x00004008ULL, 0xFFU, 0x1ULL);
+    memory_model_read(model, 0x00004008ULL, 0xFFU, &data);
+    memory_model_read(model, 0x00005000ULL, 0xFFU, &data);
+    memory_model_read(model, 0x00009000ULL, 0xFFU, &data);
+    memory_model_write(model, 0x00009010ULL, 0xFFU, 0x2ULL);
+    memory_model_read(model, 0x0000A000ULL, 0xFFU, &data);
+
+    if (memory_model_get_stats(model, &stats) != MEMORY_MODEL_ERROR_OK ||
+        stats.read_count != 4U || stats.write_count != 2U || stats.tlb_load_count != 2U ||
+        stats.tlb_hits != 3U || stats.tlb_misses != 3U) {
+        fprintf(stderr, "test_stats_counters: unexpected aggregate counters\n");
+        goto cleanup;
+    }
+
+    if (memory_model_get_tlb_slot_hits(model, slot_hits, 4U) != MEMORY_MODEL_ERROR_OK ||
+        slot_hits[0] != 2U || slot_hits[1] != 1U || slot_hits[2] != 0U) {
+        fprintf(stderr, "test_stats_counters: unexpected per-slot hits\n");
+        goto cleanup;
+    }
+
+    if (memory_model_get_miss_histogram(model, NULL, 0U) != 2U ||
+        memory_model_get_miss_histogram(model, misses, 4U) != 2U ||
+        misses[0].virt_page != 0x9U || misses[0].misses != 2U ||
+        misses[1].virt_page != 0xAU || misses[1].misses != 1U) {
+        fprintf(stderr, "test_stats_counters: unexpected miss histogram\n");
+        goto cleanup;
+    }
+
+    /* Counters belong to the instance: they survive reset, forks start clean. */
+    memory_model_reset(model);
+    if (memory_model_fork(model, &fork) != MEMORY_MODEL_ERROR_OK) {
+        fprintf(stderr, "test_stats_counters: fork failed\n");
+        goto cleanup;
+    }
+    memory_model_get_stats(model, &stats);
+    if (stats.read_count != 4U) {
+        fprintf(stderr, "test_stats_counters: counters cleared by reset\n");
+        goto cleanup;
+    }
+    memory_model_get_stats(fork, &stats);
+    if (stats.read_count != 0U || memory_model_get_miss_histogram(fork, NULL, 0U) != 0U) {
+        fprintf(stderr, "test_stats_counters: fork inherited counters\n");
+        goto cleanup;
+    }
+
+    memory_model_reset_stats(model);
+    memory_model_get_stats(model, &stats);
+    memory_model_get_tlb_slot_hits(model, slot_hits, 4U);
+    if (stats.read_count != 0U || stats.tlb_misses != 0U || slot_hits[0] != 0U ||
+        memory_model_get_miss_histogram(model, NULL, 0U) != 0U) {
+        fprintf(stderr, "test_stats_counters: reset_stats left residue\n");
+        goto cleanup;
+    }
+
+    success = 1;
+
+cleanup:
+    memory_model_destroy(fork);
+    memory_model_destroy(model);
+    return success;
+}
+
+/*
+ * Direct grants: the run around an address stops at its store page, writes
+ * through the pointer are visible to the API and vice versa, and the epoch
+ * moves on evictions, ASID switches, forks and resets but not on fills into
+ * empty slots. A grant taken after a fork writes a private copy.
+ */
+static int test_direct_access(void)
+{
+    int success = 0;
+    memory_model_t *model = NULL;
+    memory_model_t *fork = NULL;
+    memory_model_t *small = NULL;
+    memory_model_config_t cfg = memory_model_config_default();
+    memory_model_direct_t direct;
+    uint64_t data = 0ULL;
+    uint64_t phys = 0ULL;
+    uint64_t epoch;
+
+    cfg.sparse = true;
+    if (memory_model_create(&cfg, &model) != MEMORY_MODEL_ERROR_OK) {
+        fprintf(stderr, "test_direct_access: failed to create model\n");
+        return 0;
+    }
+
+    if (memory_model_get_direct(model, 0x00004008ULL, &direct) != MEMORY_MODEL_STATUS_ERR_ADDR ||
+        direct.host != NULL) {
+        fprintf(stderr, "test_direct_access: grant without a translation\n");
+        goto cleanup;
+    }
+
+    /* Page 0x4 maps to frame 0x1000: words 0x1000-0x13FF share a store page. */
+    memory_model_load_tlb(model, 0x00004000ULL, 0x00001000ULL);
+    memory_model_write(model, 0x00004008ULL, 0xFFU, 0x1122334455667788ULL);
+    if (memory_model_get_direct(model, 0x00004008ULL, &direct) != MEMORY_MODEL_STATUS_OK ||
+        direct.virt_base != 0x00004000ULL || direct.phys_base != 0x00001000ULL || direct.words != 1024U) {
+        fprintf(stderr, "test_direct_access: unexpected grant range\n");
+        goto cleanup;
+    }
+    if (direct.host[8U * 8U] != 0x88U || direct.host[8U * 8U + 7U] != 0x11U) {
+        fprintf(stderr, "test_direct_access: grant does not show API writes\n");
+        goto cleanup;
+    }
+    direct.host[9U * 8U] = 0xA5U;
+    if (memory_model_read(model, 0x00004009ULL, 0xFFU, &data) != MEMORY_MODEL_STATUS_OK || data != 0xA5U) {
+        fprintf(stderr, "test_direct_access: API does not show direct writes\n");
+        goto cleanup;
+    }
+
+    epoch = memory_model_direct_epoch(model);
+    memory_model_load_tlb(model, 0x00005000ULL, 0x00002000ULL);
+    if (memory_model_direct_epoch(model) != epoch) {
+        fprintf(stderr, "test_direct_access: fill into an empty slot revoked grants\n");
+        goto cleanup;
+    }
+    memory_model_set_asid(model, 1U);
+    if (memory_model_direct_epoch(model) == epoch ||
+        memory_model_get_direct(model, 0x00004008ULL, &direct) != MEMORY_MODEL_STATUS_ERR_ADDR) {
+        fprintf(stderr, "test_direct_access: ASID switch kept the grant\n");
+        goto cleanup;
+    }
+    memory_model_set_asid(model, 0U);
+    epoch = memory_model_direct_epoch(model);
+    memory_model_flush_tlb_page(model, 0x00005000ULL);
+    if (memory_model_direct_epoch(model) == epoch) {
+        fprintf(stderr, "test_direct_access: page flush kept grants\n");
+        goto cleanup;
+    }
+
+    /* A page loaded into an empty slot inside a granted range shadows it. */
+    memory_model_load_tlb_range(model, 0x00010000ULL, 0x00020000ULL, 16U);
+    if (memory_model_get_direct(model, 0x00011000ULL, &direct) != MEMORY_MODEL_STATUS_OK ||
+        direct.phys_base != 0x00021000ULL) {
+        fprintf(stderr, "test_direct_access: no grant through a range entry\n");
+        goto cleanup;
+    }
+    epoch = memory_model_direct_epoch(model);
+    memory_model_load_tlb(model, 0x00011000ULL, 0x00003000ULL);
+    if (memory_model_translate(model, 0x00011000ULL, &phys) != MEMORY_MODEL_STATUS_OK || phys != 0x00003000ULL ||
+        memory_model_direct_epoch(model) == epoch) {
+        fprintf(stderr, "test_direct_access: shadowing page kept the range grant\n");
+        goto cleanup;
+    }
+
+    epoch = memory_model_direct_epoch(model);
+    if (memory_model_fork(model, &fork) != MEMORY_MODEL_ERROR_OK || memory_model_direct_epoch(model) == epoch) {
+        fprintf(stderr, "test_direct_access: fork kept grants\n");
+        goto cleanup;
+    }
+    if (memory_model_get_direct(model, 0x00004009ULL, &direct) != MEMORY_MODEL_STATUS_OK) {
+        fprintf(stderr, "test_direct_access: no grant after fork\n");
+        goto cleanup;
+    }
+    direct.host[9U * 8U] = 0x5AU;
+    if (memory_model_read(fork, 0x00004009ULL, 0xFFU, &data) != MEMORY_MODEL_STATUS_OK || data != 0xA5U) {
+        fprintf(stderr, "test_direct_access: direct write leaked into the fork\n");
+        goto cleanup;
+    }
+
+    epoch = memory_model_direct_epoch(model);
+    memory_model_reset(model);
+    if (memory_model_direct_epoch(model) == epoch) {
+        fprintf(stderr, "test_direct_access: reset kept grants\n");
+        goto cleanup;
+    }
+
+    /*
+     * Slot 0 is freed and the write pointer wraps to it: a duplicate of the
+     * page in slot 1 lands below it and wins, so its grant is stale.
+     */
+    cfg.tlb_entries = 4U;
+    if (memory_model_create(&cfg, &small) != MEMORY_MODEL_ERROR_OK) {
+        fprintf(stderr, "test_direct_access: failed to create small-TLB model\n");
+        goto cleanup;
+    }
+    memory_model_load_tlb(small, 0x00001000ULL, 0x00001000ULL);
+    memory_model_load_tlb(small, 0x00004000ULL, 0x00002000ULL);
+    memory_model_flush_tlb_page(small, 0x00001000ULL);
+    memory_model_load_tlb(small, 0x00005000ULL, 0x00003000ULL);
+    memory_model_load_tlb(small, 0x00006000ULL, 0x00003000ULL);
+    if (memory_model_get_direct(small, 0x00004000ULL, &direct) != MEMORY_MODEL_STATUS_OK ||
+        direct.phys_base != 0x00002000ULL) {
+        fprintf(stderr, "test_direct_access: no grant on the small-TLB model\n");
+        goto cleanup;
+    }
+    epoch = memory_model_direct_epoch(small);
+    memory_model_load_tlb(small, 0x00004000ULL, 0x00000000ULL);
+    if (memory_model_translate(small, 0x00004000ULL, &phys) != MEMORY_MODEL_STATUS_OK || phys != 0ULL ||
+        memory_model_direct_epoch(small) == epoch) {
+        fprintf(stderr, "test_direct_access: duplicate page kept the old grant\n");
+        goto cleanup;
+    }
+
+    success = 1;
+
+cleanup:
+    memory_model_destroy(small);
+    memory_model_destroy(fork);
+    memory_model_destroy(model);
+    return success;
+}
+
+/*
+ * A 10.375-word block starting six words before the end of one page: it lands
+ * in two unrelated physical frames and ends in a partial word whose upper bytes
+ * must survive. Run on a plain and a concurrent model, whose block paths differ.
+ */
+static int test_block_transfer_spans_pages(void)
+{
+    enum { BLOCK_BYTES = 83 };
+
+    int success = 0;
+    memory_model_t *model = NULL;
+    uint8_t pattern[BLOCK_BYTES];
+    uint8_t readback[BLOCK_BYTES];
+
+    for (size_t i = 0U; i < BLOCK_BYTES; ++i) {
+        pattern[i] = (uint8_t)(i * 7U + 1U);
+    }
+
+    for (int concurrent = 0; concurrent <= 1; ++concurrent) {
+        memory_model_config_t cfg = memory_model_config_default();
+        cfg.concurrent = concurrent != 0;
+        if (memory_model_create(&cfg, &model) != MEMORY_MODEL_ERROR_OK) {
+            fprintf(stderr, "test_block_transfer_spans_pages: failed to create model\n");
+            return 0;
+        }
+
+        memory_model_load_tlb(model, 0x00001000ULL, 0x00003000ULL);
+        memory_model_load_tlb(model, 0x00002000ULL, 0x00001000ULL);
+        memory_model_write(model, 0x00002004ULL, 0xFFU, UINT64_MAX);
+
+        if (memory_model_write_block(model, 0x00001FFAULL, pattern, BLOCK_BYTES) !=
+            MEMORY_MODEL_STATUS_OK) {
+            fprintf(stderr, "test_block_transfer_spans_pages: block write failed\n");
+            goto cleanup;
+        }
+
+        /* Check every word through the single-word API. */
+        for (uint64_t w = 0U; w < 11U; ++w) {
+            uint64_t expected = 0ULL;
+            for (uint32_t b = 0U; b < 8U; ++b) {
+                size_t index = (size_t)(w * 8U + b);
+                uint64_t byte = index < BLOCK_BYTES ? pattern[index] : 0xFFU;
+                expected |= byte << (b * 8U);
+            }
+            if (!expect_read(model, 0x00001FFAULL + w, MEMORY_MODEL_STATUS_OK, expected,
+                             "test_block_transfer_spans_pages")) {
+                goto cleanup;
+            }
+        }
+
+        memset(readback, 0xCC, sizeof(readback));
+        if (memory_model_read_block(model, 0x00001FFAULL, readback, BLOCK_BYTES) != MEMORY_MODEL_STATUS_OK ||
+            memcmp(readback, pattern, BLOCK_BYTES) != 0) {
+            fprintf(stderr, "test_block_transfer_spans_pages: block read mismatch\n");
+            goto cleanup;
+        }
+
+        /* Running off the end of the mapped pages stops at the first unmapped word. */
+        memset(readback, 0xCC, sizeof(readback));
+        if (memory_model_write_block(model, 0x00002FFEULL, pattern, 32U) != MEMORY_MODEL_STATUS_ERR_ADDR ||
+            memory_model_read_block(model, 0x00002FFEULL, readback, 32U) != MEMORY_MODEL_STATUS_ERR_ADDR ||
+            memcmp(readback, pattern, 16U) != 0 || readback[16] != 0U || readback[31] != 0U) {
+            fprintf(stderr, "test_block_transfer_spans_pages: partial failure not reported as expected\n");
+            goto cleanup;
+        }
+
+        memory_model_destroy(model);
+        model = NULL;
+    }
+
+    success = 1;
+
+cleanup:
+    memory_model_destroy(model);
+    return success;
+}
+
+/*
+ * Random masked wide-word traffic checked against a flat shadow copy, for each
+ * kernel ceiling and for widths that exercise whole vectors and ragged tails.
+ * The 64-bit API must see the low eight bytes of each word.
+ */
+static int test_wide_word_masked_access(void)
+{
+    enum { WORDS = 64, OPS = 4000 };
+    static const uint32_t widths[] = {128U, 200U, 256U, 512U};
+
+    int success = 0;
+    memory_model_t *model = NULL;
+    uint8_t shadow[WORDS][MEMORY_MODEL_MAX_WORD_BYTES];
+    uint8_t buffer[MEMORY_MODEL_MAX_WORD_BYTES];
+    uint8_t expected[MEMORY_MODEL_MAX_WORD_BYTES];
+
+    for (uint32_t simd = MEMORY_MODEL_SIMD_SCALAR; simd <= MEMORY_MODEL_SIMD_AVX512; ++simd) {
+        for (size_t w = 0U; w < sizeof(widths) / sizeof(widths[0]); ++w) {
+            const uint32_t bytes = widths[w] / 8U;
+            const uint64_t full_mask = bytes >= 64U ? UINT64_MAX : (1ULL << bytes) - 1ULL;
+
+            memory_model_config_t cfg = memory_model_config_default();
+            cfg.data_width = widths[w];
+            cfg.simd = (memory_model_simd_t)simd;
+            cfg.concurrent = (w & 1U) != 0U;
+            if (memory_model_create(&cfg, &model) != MEMORY_MODEL_ERROR_OK) {
+                fprintf(stderr, "test_wide_word_masked_access: failed to create %u-bit model\n", widths[w]);
+                return 0;
+            }
+            if ((uint32_t)memory_model_get_simd(model) > simd) {
+                fprintf(stderr, "test_wide_word_masked_access: kernel level exceeds its ceiling\n");
+                goto cleanup;
+            }
+
+            memory_model_load_tlb(model, 0x00005000ULL, 0x00002000ULL);
+            memset(shadow, 0, sizeof(shadow));
+
+            uint32_t lcg = 7U + simd;
+            for (uint32_t op = 0U; op < OPS; ++op) {
+                lcg = lcg * 1103515245U + 12345U;
+                uint32_t index = (lcg >> 8) % WORDS;
+                uint64_t mask = ((uint64_t)lcg << 32 | (lcg * 2654435761U)) & full_mask;
+                if ((lcg & 0x7U) == 0U) {
+                    mask = full_mask;
+                }
+
+                if ((lcg >> 4) & 1U) {
+                    for (uint32_t b = 0U; b < bytes; ++b) {
+                        buffer[b] = (uint8_t)(lcg >> (b % 24U)) ^ (uint8_t)(b * 13U);
+                        if ((mask >> b) & 1U) {
+                            shadow[index][b] = buffer[b];
+                        }
+                    }
+                    if (memory_model_write_wide(model, 0x00005000ULL + index, mask, buffer) !=
+                        MEMORY_MODEL_STATUS_OK) {
+                        fprintf(stderr, "test_wide_word_masked_access: write failed\n");
+                        goto cleanup;
+                    }
+                } else {
+                    for (uint32_t b = 0U; b < bytes; ++b) {
+                        expected[b] = (mask == 0U || ((mask >> b) & 1U)) ? shadow[index][b] : 0U;
+                    }
+                    memset(buffer, 0xCC, sizeof(buffer));
+                    if (memory_model_read_wide(model, 0x00005000ULL + index, mask, buffer) !=
+                            MEMORY_MODEL_STATUS_OK ||
+                        memcmp(buffer, expected, bytes) != 0) {
+                        fprintf(stderr, "test_wide_word_masked_access: %u-bit read mismatch (simd %u, mask 0x%" PRIx64
+                                        ")\n",
+                                widths[w], simd, mask);
+                        goto cleanup;
+                    }
+                }
+            }
+
+            /* The 64-bit API reaches the low lane only. */
+            uint64_t lane = 0ULL;
+            for (uint32_t b = 0U; b < 8U; ++b) {
+                lane |= (uint64_t)shadow[3][b] << (b * 8U);
+            }
+            uint64_t data = 0ULL;
+            if (memory_model_read(model, 0x00005003ULL, 0U, &data) != MEMORY_MODEL_STATUS_OK || data != lane ||
+                memory_model_read(model, 0x00005003ULL, 0x1FFU, &data) != MEMORY_MODEL_STATUS_ERR_ACCESS ||
+                memory_model_write(model, 0x00005003ULL, 0xFFU, ~lane) != MEMORY_MODEL_STATUS_OK ||
+                memory_model_read_wide(model, 0x00005003ULL, 0U, buffer) != MEMORY_MODEL_STATUS_OK ||
+                memcmp(buffer + 8, shadow[3] + 8, bytes - 8U) != 0) {
+                fprintf(stderr, "test_wide_word_masked_access: 64-bit API escaped the low lane\n");
+                goto cleanup;
+            }
+
+            if (bytes < 64U && (memory_model_read_wide(model, 0x00005000ULL, full_mask + 1U, buffer) !=
+                                    MEMORY_MODEL_STATUS_ERR_ACCESS ||
+                                memory_model_write_wide(model, 0x00005000ULL, full_mask + 1U, buffer) !=
+                                    MEMORY_MODEL_STATUS_ERR_WRITE)) {
+                fprintf(stderr, "test_wide_word_masked_access: out-of-word mask accepted\n");
+                goto cleanup;
+            }
+
+            memory_model_destroy(model);
+            model = NULL;
+        }
+    }
+
+    success = 1;
+
+cleanup:
+    memory_model_destroy(model);
+    return success;
+}
+
+/*
+ * A trace over 16 virtual pages in a sparse 1M-word store, run serially and in
+ * parallel from identical starting states: long runs exercise the parallel
+ * windows, a burst of TLB reloads exercises the serial fallback, and unmapped
+ * pages, bad masks and bad opcodes exercise every early-out.
+ */
+static int test_parallel_batch_matches_serial(void)
+{
+    enum { OPS = 1 << 18, FRAMES = 256, PROBE_VIRT = 0x00100000 };
+
+    int success = 0;
+    memory_model_t *serial = NULL;
+    memory_model_t *parallel = NULL;
+    memory_model_config_t cfg = memory_model_config_default();
+    cfg.mem_depth = (uint64_t)FRAMES << 12;
+    cfg.tlb_entries = 16U;
+    cfg.sparse = true;
+
+    uint8_t *op = malloc(OPS);
+    uint64_t *virt_addr = malloc(OPS * sizeof(uint64_t));
+    uint32_t *byte_mask = malloc(OPS * sizeof(uint32_t));
+    uint64_t *data = malloc(OPS * sizeof(uint64_t));
+    memory_model_status_t *status[2] = {malloc(OPS * sizeof(memory_model_status_t)),
+                                        malloc(OPS * sizeof(memory_model_status_t))};
+    uint64_t *data_out[2] = {malloc(OPS * sizeof(uint64_t)), malloc(OPS * sizeof(uint64_t))};
+
+    if (op == NULL || virt_addr == NULL || byte_mask == NULL || data == NULL || status[0] == NULL ||
+        status[1] == NULL || data_out[0] == NULL || data_out[1] == NULL ||
+        memory_model_create(&cfg, &serial) != MEMORY_MODEL_ERROR_OK) {
+        fprintf(stderr, "test_parallel_batch_matches_serial: setup failed\n");
+        goto cleanup;
+    }
+
+    uint32_t lcg = 7U;
+    for (uint64_t page = 0U; page < 12U; ++page) {
+        lcg = lcg * 1103515245U + 12345U;
+        memory_model_load_tlb(serial, page << 12, (uint64_t)((lcg >> 8) % FRAMES) << 12);
+    }
+    if (memory_model_fork(serial, &parallel) != MEMORY_MODEL_ERROR_OK) {
+        fprintf(stderr, "test_parallel_batch_matches_serial: fork failed\n");
+        goto cleanup;
+    }
+    memory_model_reset_stats(serial); /* the fork starts with fresh counters */
+
+    for (size_t i = 0U; i < OPS; ++i) {
+        lcg = lcg * 1103515245U + 12345U;
+        uint32_t pick = (lcg >> 20) % 1000U;
+        bool burst = i >= 100000U && i < 100400U;
+        bool reload = burst ? (i % 16U) == 0U : pick == 0U && (lcg & 0x3FU) == 0U;
+        bool switch_asid = burst && (i % 64U) == 8U;
+
+        op[i] = switch_asid ? MEMORY_MODEL_OP_SET_ASID
+              : reload ? MEMORY_MODEL_OP_TLB_LOAD
+              : pick < 480U ? MEMORY_MODEL_OP_READ
+              : pick < 995U ? MEMORY_MODEL_OP_WRITE
+                            : 0x7U;
+        virt_addr[i] = ((uint64_t)((lcg >> 4) % 16U) << 12) | ((lcg >> 9) & 0xFFFU);
+        byte_mask[i] = pick < 990U ? (lcg >> 12) & 0xFFU : 0x1FFU;
+        data[i] = ((uint64_t)lcg << 32) ^ (i * 0x9E3779B97F4A7C15ULL);
+        if (reload) {
+            virt_addr[i] &= ~0xFFFULL;
+            data[i] = (uint64_t)((lcg >> 8) % FRAMES) << 12;
+        } else if (switch_asid) {
+            /* Alternate address spaces during the burst; ASID 0 is current again afterwards. */
+            data[i] = (i / 64U) & 1U;
+        }
+    }
+
+    const memory_model_batch_t batch = {OPS, op, virt_addr, byte_mask, data};
+    const memory_model_batch_results_t serial_results = {status[0], data_out[0]};
+    const memory_model_batch_results_t parallel_results = {status[1], data_out[1]};
+    if (memory_model_execute_batch(serial, &batch, &serial_results) != MEMORY_MODEL_ERROR_OK ||
+        memory_model_execute_batch_parallel(parallel, &batch, &parallel_results, 4U) != MEMORY_MODEL_ERROR_OK) {
+        fprintf(stderr, "test_parallel_batch_matches_serial: batch rejected\n");
+        goto cleanup;
+    }
+
+    for (size_t i = 0U; i < OPS; ++i) {
+        if (status[0][i] != status[1][i] || data_out[0][i] != data_out[1][i]) {
+            fprintf(stderr,
+                    "test_parallel_batch_matches_serial: op %zu status %d/%d data 0x%016" PRIx64 "/0x%016" PRIx64
+                    "\n",
+                    i, (int)status[0][i], (int)status[1][i], data_out[0][i], data_out[1][i]);
+            goto cleanup;
+        }
+    }
+
+    memory_model_stats_t stats[2];
+    uint64_t slot_hits[2][16];
+    memory_model_miss_entry_t misses[2][16];
+    memory_model_get_stats(serial, &stats[0]);
+    memory_model_get_stats(parallel, &stats[1]);
+    memory_model_get_tlb_slot_hits(serial, slot_hits[0], 16U);
+    memory_model_get_tlb_slot_hits(parallel, slot_hits[1], 16U);
+    size_t miss_pages = memory_model_get_miss_histogram(serial, misses[0], 16U);
+    if (memcmp(&stats[0], &stats[1], sizeof(stats[0])) != 0 || memcmp(slot_hits[0], slot_hits[1], sizeof(slot_hits[0])) != 0 ||
+        miss_pages == 0U || memory_model_get_miss_histogram(parallel, misses[1], 16U) != miss_pages ||
+        memcmp(misses[0], misses[1], miss_pages * sizeof(misses[0][0])) != 0 ||
+        memory_model_resident_bytes(serial) != memory_model_resident_bytes(parallel)) {
+        fprintf(stderr, "test_parallel_batch_matches_serial: statistics differ\n");
+        goto cleanup;
+    }
+
+    for (uint64_t frame = 0U; frame < FRAMES; ++frame) {
+        memory_model_load_tlb(serial, PROBE_VIRT, frame << 12);
+        memory_model_load_tlb(parallel, PROBE_VIRT, frame << 12);
+        for (uint64_t word = 0U; word < 4096U; ++word) {
+            uint64_t expected = 0ULL;
+            uint64_t actual = 0ULL;
+            memory_model_read(serial, PROBE_VIRT + word, 0xFFU, &expected);
+            memory_model_read(parallel, PROBE_VIRT + word, 0xFFU, &actual);
+            if (expected != actual) {
+                fprintf(stderr,
+                        "test_parallel_batch_matches_serial: word 0x%" PRIx64 " holds 0x%016" PRIx64
+                        " (expected 0x%016" PRIx64 ")\n",
+                        (frame << 12) + word, actual, expected);
+                goto cleanup;
+            }
+        }
+    }
+
+    success = 1;
+
+cleanup:
+    memory_model_destroy(parallel);
+    memory_model_destroy(serial);
+    free(op);
+    free(virt_addr);
+    free(byte_mask);
+    free(data);
+    for (size_t i = 0U; i < 2U; ++i) {
+        free(status[i]);
+        free(data_out[i]);
+    }
+    return success;
+}
+
+/*
+ * Concurrent stress: eight writers each own one byte lane of a set of shared
+ * words and count it up from 1 to 255 with masked writes; readers check that
+ * every lane only ever moves forward, while another thread keeps remapping an
+ * alias page between two physical pages with distinct fill patterns. A
+ * linearizable model never loses a lane update, never shows a lane going
+ * backwards, and never shows anything but one of the two alias patterns.
+ */
+#define STRESS_WRITERS 8U
+#define STRESS_READERS 2U
+#define STRESS_WORDS 64U
+#define STRESS_WORD_STRIDE 61U
+#define STRESS_DATA_VIRT 0x00010000ULL
+#define STRESS_ALIAS_VIRT 0x00020000ULL
+#define STRESS_PATTERN_A 0xAAAAAAAAAAAAAAAAULL
+#define STRESS_PATTERN_B 0x5555555555555555ULL
+
+struct stress_context {
+    memory_model_t *model;
+    atomic_bool stop;
+    atomic_uint failures;
+    atomic_uint_fast64_t reads;
+    atomic_uint_fast64_t tlb_loads;
+};
+
+struct stress_worker {
+    struct stress_context *ctx;
+    uint32_t id;
+};
+
+static void stress_fail(struct stress_context *ctx, const char *message, uint64_t detail)
+{
+    if (atomic_fetch_add(&ctx->failures, 1U) == 0U) {
+        fprintf(stderr, "test_concurrent_linearizable: %s (0x%016" PRIx64 ")\n", message, detail);
+    }
+}
+
+static void *stress_writer(void *arg)
+{
+    const struct stress_worker *worker = arg;
+    struct stress_context *ctx = worker->ctx;
+    const uint32_t lane = worker->id;
+
+    for (uint64_t value = 1U; value <= 0xFFU; ++value) {
+        for (uint32_t w = 0U; w < STRESS_WORDS; ++w) {
+            uint64_t virt = STRESS_DATA_VIRT + (uint64_t)w * STRESS_WORD_STRIDE;
+            if (memory_model_write(ctx->model, virt, 1U << lane, value << (lane * 8U)) != MEMORY_MODEL_STATUS_OK) {
+                stress_fail(ctx, "lane write failed", virt);
+                return NULL;
+            }
+        }
+    }
+    return NULL;
+}
+
+static void *stress_reader(void *arg)
+{
+    const struct stress_worker *worker = arg;
+    struct stress_context *ctx = worker->ctx;
+    uint8_t last[STRESS_WORDS][STRESS_WRITERS] = {{0}};
+    uint64_t rng = 0x9E3779B97F4A7C15ULL * (worker->id + 1U);
+    uint64_t reads = 0U;
+
+    while (!atomic_load(&ctx->stop) && atomic_load(&ctx->failures) == 0U) {
+        rng ^= rng << 13U;
+        rng ^= rng >> 7U;
+        rng ^= rng << 17U;
+
+        uint32_t w = (uint32_t)(rng % STRESS_WORDS);
+        uint64_t data = 0ULL;
+        if (memory_model_read(ctx->model, STRESS_DATA_VIRT + (uint64_t)w * STRESS_WORD_STRIDE, 0xFFU, &data) !=
+            MEMORY_MODEL_STATUS_OK) {
+            stress_fail(ctx, "lane read failed", w);
+            break;
+        }
+        for (uint32_t lane = 0U; lane < STRESS_WRITERS; ++lane) {
+            uint8_t byte = (uint8_t)(data >> (lane * 8U));
+            if (byte < last[w][lane]) {
+                stress_fail(ctx, "lane went backwards", data);
+                break;
+            }
+            last[w][lane] = byte;
+        }
+
+        if (memory_model_read(ctx->model, STRESS_ALIAS_VIRT, 0xFFU, &data) != MEMORY_MODEL_STATUS_OK ||
+            (data != STRESS_PATTERN_A && data != STRESS_PATTERN_B)) {
+            stress_fail(ctx, "alias read saw a torn or missing mapping", data);
+            break;
+        }
+        reads += 2U;
+    }
+
+    atomic_fetch_add(&ctx->reads, reads);
+    return NULL;
+}
+
+static void *stress_remapper(void *arg)
+{
+    struct stress_context *ctx = arg;
+    uint64_t loads = 0U;
+
+    /* Reload the data mapping alongside the alias so round-robin eviction never drops it. */
+    while (!atomic_load(&ctx->stop)) {
+        memory_model_load_tlb(ctx->model, STRESS_DATA_VIRT, 0x0ULL);
+        memory_model_load_tlb(ctx->model, STRESS_ALIAS_VIRT, (loads & 2U) != 0U ? 0x2000ULL : 0x1000ULL);
+        loads += 2U;
+    }
+
+    atomic_fetch_add(&ctx->tlb_loads, loads);
+    return NULL;
+}
+
+static int test_concurrent_linearizable(void)
+{
+    int success = 0;
+    memory_model_config_t cfg = memory_model_config_default();
+    cfg.sparse = true;
+    cfg.concurrent = true;
+
+    struct stress_context ctx;
+    ctx.model = NULL;
+    atomic_init(&ctx.stop, false);
+    atomic_init(&ctx.failures, 0U);
+    atomic_init(&ctx.reads, 0U);
+    atomic_init(&ctx.tlb_loads, 0U);
+
+    if (memory_model_create(&cfg, &ctx.model) != MEMORY_MODEL_ERROR_OK) {
+        fprintf(stderr, "test_concurrent_linearizable: failed to create model\n");
+        return 0;
+    }
+
+    memory_model_load_tlb(ctx.model, 0x00030000ULL, 0x1000ULL);
+    memory_model_load_tlb(ctx.model, 0x00040000ULL, 0x2000ULL);
+    memory_model_write(ctx.model, 0x00030000ULL, 0xFFU, STRESS_PATTERN_A);
+    memory_model_write(ctx.model, 0x00040000ULL, 0xFFU, STRESS_PATTERN_B);
+    memory_model_load_tlb(ctx.model, STRESS_DATA_VIRT, 0x0ULL);
+    memory_model_load_tlb(ctx.model, STRESS_ALIAS_VIRT, 0x1000ULL);
+
+    pthread_t writers[STRESS_WRITERS];
+    pthread_t readers[STRESS_READERS];
+    pthread_t remapper;
+    struct stress_worker writer_args[STRESS_WRITERS];
+    struct stress_worker reader_args[STRESS_READERS];
+    uint32_t writers_started = 0U;
+    uint32_t readers_started = 0U;
+    bool remapper_started = false;
+
+    for (uint32_t i = 0U; i < STRESS_READERS; ++i) {
+        reader_args[i].ctx = &ctx;
+        reader_args[i].id = i;
+        if (pthread_create(&readers[i], NULL, stress_reader, &reader_args[i]) != 0) {
+            break;
+        }
+        readers_started++;
+    }
+    remapper_started = pthread_create(&remapper, NULL, stress_remapper, &ctx) == 0;
+    for (uint32_t i = 0U; i < STRESS_WRITERS; ++i) {
+        writer_args[i].ctx = &ctx;
+        writer_args[i].id = i;
+        if (pthread_create(&writers[i], NULL, stress_writer, &writer_args[i]) != 0) {
+            break;
+        }
+        writers_started++;
+    }
+
+    for (uint32_t i = 0U; i < writers_started; ++i) {
+        pthread_join(writers[i], NULL);
+    }
+    atomic_store(&ctx.stop, true);
+    for (uint32_t i = 0U; i < readers_started; ++i) {
+        pthread_join(readers[i], NULL);
+    }
+    if (remapper_started) {
+        pthread_join(remapper, NULL);
+    }
+
+    if (writers_started != STRESS_WRITERS || readers_started != STRESS_READERS || !remapper_started) {
+        fprintf(stderr, "test_concurrent_linearizable: failed to start threads\n");
+        goto cleanup;
+    }
+    if (atomic_load(&ctx.failures) != 0U) {
+        goto cleanup;
+    }
+
+    for (uint32_t w = 0U; w < STRESS_WORDS; ++w) {
+        if (!expect_read(ctx.model, STRESS_DATA_VIRT + (uint64_t)w * STRESS_WORD_STRIDE, MEMORY_MODEL_STATUS_OK,
+                         UINT64_MAX, "test_concurrent_linearizable (lost lane update)")) {
+            goto cleanup;
+        }
+    }
+
+    /* Sharded counters must add up exactly once every thread has finished. */
+    memory_model_stats_t stats;
+    memory_model_get_stats(ctx.model, &stats);
+    if (stats.write_count != 2U + (uint64_t)STRESS_WRITERS * 0xFFU * STRESS_WORDS ||
+        stats.read_count != atomic_load(&ctx.reads) + STRESS_WORDS ||
+        stats.tlb_load_count != 4U + atomic_load(&ctx.tlb_loads) || stats.tlb_misses != 0U) {
+        fprintf(stderr, "test_concurrent_linearizable: counters do not add up\n");
+        goto cleanup;
+    }
+
+    success = 1;
+
+cleanup:
+    memory_model_destroy(ctx.model);
+    return success;
+}
+
 struct test_case {
     const char *name;
     int (*fn)(void);
@@ -377,6 +2570,28 @@ int main(void)
         {"tlb_wraparound", test_tlb_wraparound},
         {"reset_clears_state", test_reset_clears_state},
         {"translation_preserves_offset", test_translation_preserves_offset},
+        {"tlb_duplicate_priority", test_tlb_duplicate_priority},
+        {"tlb_index_matches_linear_scan", test_tlb_index_matches_linear_scan},
+        {"tlb_range_longest_prefix", test_tlb_range_longest_prefix},
+        {"tlb_flush_import_export", test_tlb_flush_import_export},
+        {"tlb_asid_switch", test_tlb_asid_switch},
+        {"page_table_walk", test_page_table_walk},
+        {"lookup_has_no_side_effects", test_lookup_has_no_side_effects},
+        {"tlb_replacement_policies", test_tlb_replacement_policies},
+        {"tlb_set_associative", test_tlb_set_associative},
+        {"data_cache", test_data_cache},
+        {"masked_access_all_widths", test_masked_access_all_widths},
+        {"execute_batch_matches_single_ops", test_execute_batch_matches_single_ops},
+        {"sparse_backing_store", test_sparse_backing_store},
+        {"lazy_reset_zeroes_on_touch", test_lazy_reset_zeroes_on_touch},
+        {"fork_copy_on_write", test_fork_copy_on_write},
+        {"snapshot_restore", test_snapshot_restore},
+        {"stats_counters", test_stats_counters},
+        {"concurrent_linearizable", test_concurrent_linearizable},
+        {"parallel_batch_matches_serial", test_parallel_batch_matches_serial},
+        {"block_transfer_spans_pages", test_block_transfer_spans_pages},
+        {"direct_access", test_direct_access},
+        {"wide_word_masked_access", test_wide_word_masked_access},
     };
 
     const size_t total = sizeof(tests) / sizeof(tests[0]);
@@ -0,0 +1,191 @@
+#include "memory_timing.h"
+
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+
+namespace {
+
+/*
+ * Small geometry so that every latency can be worked out by hand: two banks
+ * of 16-word rows, one 4-cycle burst per 64 bytes, tCL 2, tRCD 3, tRP 5 and a
+ * one-cycle turnaround at 100 ps per cycle. Rows map row:bank:column, so word
+ * addresses 0-15 are bank 0 row 0, 16-31 bank 1 row 0 and 32-47 bank 0 row 1.
+ * A single 8-byte access moves one burst, 400 ps on the bus.
+ */
+DramTimingConfig small_config()
+{
+    DramTimingConfig cfg;
+    cfg.banks = 2U;
+    cfg.row_words = 16U;
+    cfg.word_bytes = 8U;
+    cfg.burst_bytes = 64U;
+    cfg.burst_cycles = 4U;
+    cfg.t_rcd = 3U;
+    cfg.t_cl = 2U;
+    cfg.t_rp = 5U;
+    cfg.t_turnaround = 1U;
+    cfg.clock_ps = 100U;
+    cfg.open_page = true;
+    return cfg;
+}
+
+bool expect_ps(const char *what, uint64_t actual, uint64_t expected)
+{
+    if (actual != expected) {
+        std::fprintf(stderr, "%s: got %" PRIu64 " ps, expected %" PRIu64 " ps\n", what, actual, expected);
+        return false;
+    }
+    return true;
+}
+
+bool expect_stats(const DramTimingStats &stats, uint64_t accesses, uint64_t hits, uint64_t empty,
+                  uint64_t conflicts, uint64_t turnarounds, uint64_t data_bus_ps)
+{
+    if (stats.accesses != accesses || stats.row_hits != hits || stats.row_empty != empty ||
+        stats.row_conflicts != conflicts || stats.turnarounds != turnarounds || stats.data_bus_ps != data_bus_ps) {
+        std::fprintf(stderr,
+                     "stats: accesses %" PRIu64 " hits %" PRIu64 " empty %" PRIu64 " conflicts %" PRIu64
+                     " turnarounds %" PRIu64 " bus %" PRIu64 " ps\n",
+                     stats.accesses, stats.row_hits, stats.row_empty, stats.row_conflicts, stats.turnarounds,
+                     stats.data_bus_ps);
+        return false;
+    }
+    return true;
+}
+
+/*
+ * Open page: an idle bank pays tRCD + tCL, a hit tCL once the bank is ready
+ * (tCL before the previous data ends) and a conflict tRP + tRCD + tCL.
+ */
+int test_row_outcomes()
+{
+    DramTimingModel dram(small_config());
+    bool ok = true;
+
+    /* Bank 0 idle: 0 + (3 + 2) * 100 = 500, data 500-900; bank ready at 700. */
+    ok &= expect_ps("row empty", dram.access(0U, false, 8U, 0U), 900U);
+    /* Row hit issued at 900: 900 + 2 * 100 = 1100, data 1100-1500. */
+    ok &= expect_ps("row hit", dram.access(1U, false, 8U, 900U), 1500U);
+    /* Bank 0 row 1 replaces row 0: 1500 + (5 + 3 + 2) * 100 = 2500, data 2500-2900. */
+    ok &= expect_ps("row conflict", dram.access(32U, false, 8U, 1500U), 2900U);
+    /* Bank 1 idle; the bus needs 100 ps to turn to writes, which the activate hides. */
+    ok &= expect_ps("write to idle bank", dram.access(16U, true, 8U, 2900U), 3800U);
+    /* Bank 1 hit back to reads: 3800 + 200 = 4000 against a bus ready at 3900. */
+    ok &= expect_ps("read hit after write", dram.access(17U, false, 8U, 3800U), 4400U);
+
+    ok &= expect_stats(dram.stats(), 5U, 2U, 2U, 1U, 2U, 2000U);
+
+    dram.reset_stats();
+    ok &= expect_stats(dram.stats(), 0U, 0U, 0U, 0U, 0U, 0U);
+    return ok ? 1 : 0;
+}
+
+/* A write right behind a read hit waits for the bus to turn around. */
+int test_bus_turnaround()
+{
+    DramTimingModel same(small_config());
+    DramTimingModel turned(small_config());
+    bool ok = true;
+
+    ok &= expect_ps("first read", same.access(0U, false, 8U, 0U), 900U);
+    ok &= expect_ps("first read", turned.access(0U, false, 8U, 0U), 900U);
+
+    /* Hit at 700 + 200 = 900; the bus is free at 900, or at 1000 once turned. */
+    ok &= expect_ps("read behind read", same.access(1U, false, 8U, 0U), 1300U);
+    ok &= expect_ps("write behind read", turned.access(1U, true, 8U, 0U), 1400U);
+
+    ok &= expect_stats(same.stats(), 2U, 1U, 1U, 0U, 0U, 800U);
+    ok &= expect_stats(turned.stats(), 2U, 1U, 1U, 0U, 1U, 800U);
+    return ok ? 1 : 0;
+}
+
+/* Closed page: every access finds its bank idle, which stays busy for tRP after the data. */
+int test_closed_page_precharge()
+{
+    DramTimingConfig cfg = small_config();
+    cfg.open_page = false;
+    DramTimingModel dram(cfg);
+    bool ok = true;
+
+    /* 0 + 500, data 500-900; precharge keeps bank 0 busy until 900 + 500 = 1400. */
+    ok &= expect_ps("first access", dram.access(0U, false, 8U, 0U), 900U);
+    /* Same row again, but it was closed: 1400 + 500 = 1900, data 1900-2300. */
+    ok &= expect_ps("same row after precharge", dram.access(1U, false, 8U, 900U), 2300U);
+    /* The other bank is not held up by bank 0's precharge: 2300 + 500 = 2800. */
+    ok &= expect_ps("other bank", dram.access(16U, false, 8U, 2300U), 3200U);
+
+    ok &= expect_stats(dram.stats(), 3U, 0U, 3U, 0U, 0U, 1200U);
+    return ok ? 1 : 0;
+}
+
+/* A run crossing a row boundary is one access of two rows, each timed on its own bank. */
+int test_row_split()
+{
+    DramTimingModel dram(small_config());
+    bool ok = true;
+
+    /*
+     * Words 14-15 (16 bytes) on bank 0: 500, data 500-900. Words 16-17 on
+     * bank 1: activate done at 500 but the bus is busy until 900, data
+     * 900-1300. A 128-byte read of one row takes two bursts, 800 ps.
+     */
+    ok &= expect_ps("split run", dram.access(14U, false, 32U, 0U), 1300U);
+    ok &= expect_stats(dram.stats(), 1U, 0U, 2U, 0U, 0U, 800U);
+
+    /* Words 32-47 are bank 0 row 1: conflict from 700, 700 + 1000 = 1700, two bursts. */
+    ok &= expect_ps("two bursts", dram.access(32U, false, 128U, 0U), 2500U);
+    ok &= expect_stats(dram.stats(), 2U, 0U, 2U, 1U, 0U, 1600U);
+
+    ok &= expect_ps("empty access", dram.access(0U, false, 0U, 3000U), 3000U);
+    ok &= expect_stats(dram.stats(), 2U, 0U, 2U, 1U, 0U, 1600U);
+    return ok ? 1 : 0;
+}
+
+/* reset() closes every row and idles the bus, but leaves the counters alone. */
+int test_reset_idles_device()
+{
+    DramTimingModel dram(small_config());
+    bool ok = true;
+
+    ok &= expect_ps("before reset", dram.access(0U, true, 8U, 0U), 900U);
+    dram.reset();
+    /* Row 0 is closed again and the bus has no direction to turn from. */
+    ok &= expect_ps("after reset", dram.access(0U, false, 8U, 0U), 900U);
+    ok &= expect_stats(dram.stats(), 2U, 0U, 2U, 0U, 0U, 800U);
+    return ok ? 1 : 0;
+}
+
+struct TestCase {
+    const char *name;
+    int (*fn)();
+};
+
+} // namespace
+
+int main()
+{
+    const TestCase tests[] = {
+        {"row_outcomes", test_row_outcomes},
+        {"bus_turnaround", test_bus_turnaround},
+        {"closed_page_precharge", test_closed_page_precharge},
+        {"row_split", test_row_split},
+        {"reset_idles_device", test_reset_idles_device},
+    };
+
+    const size_t total = sizeof(tests) / sizeof(tests[0]);
+    size_t passed = 0U;
+
+    for (size_t i = 0U; i < total; ++i) {
+        std::printf("[ RUN     ] %s\n", tests[i].name);
+        if (tests[i].fn()) {
+            std::printf("[     OK ] %s\n", tests[i].name);
+            passed++;
+        } else {
+            std::printf("[ FAILED ] %s\n", tests[i].name);
+        }
+    }
+
+    std::printf("\nSummary: %zu/%zu tests passed.\n", passed, total);
+    return passed == total ? 0 : 1;
+}
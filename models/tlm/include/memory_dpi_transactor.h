@@ -10,23 +10,24 @@
 
 #include "../../common/memory_dpi.h"
 
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 #include <string>
 
 using namespace std;
 
-// DPI Bridge Transactor - Connects TLM to RTL via DPI
-class MemoryDPIBridge : public sc_module, public MemoryTarget {
+// DPI Bridge Transactor - Connects TLM to RTL via DPI. The inherited
+// MemoryTarget socket carries both b_transport and the approximately-timed
+// protocol; every transaction reaches the RTL through execute_transaction().
+// Block and wide-word payloads, whose data lives in the payload buffer, go
+// to the RTL one word at a time through the wide DPI calls.
+class MemoryDPIBridge : public MemoryTarget {
 public:
-    // TLM socket
-    tlm_utils::simple_target_socket<MemoryDPIBridge> socket;
-    
     // Constructor
     SC_HAS_PROCESS(MemoryDPIBridge);
     MemoryDPIBridge(sc_module_name name, memory_model_t* ref_model = nullptr) 
-        : sc_module(name), socket("socket"), MemoryTarget(name, ref_model) {
-        
-        socket.bind(*this);
+        : MemoryTarget(name, ref_model), ref_model(ref_model) {
         
         SC_THREAD(process_dpi_thread);
         sensitive << clk.pos();
@@ -47,39 +48,251 @@ public:
     // SystemC clock for timing
     sc_in<bool> clk;
     
+    // Bulk TLB copies go to the RTL through DPI; imports also update the
+    // reference model so that later comparisons stay meaningful
+    virtual memory_model_error_t export_tlb(std::vector<memory_model_tlb_entry_t>& entries,
+                                            uint32_t* write_index) {
+        std::vector<mem_dpi_tlb_entry_t> rtl_entries(MEM_DPI_MAX_TLB_ENTRIES);
+        uint32_t count = 0;
+        uint32_t rtl_write_index = 0;
+        if (memory_dpi_tlb_export(rtl_entries.data(), static_cast<uint32_t>(rtl_entries.size()),
+                                  &count, &rtl_write_index) != MEM_DPI_OK) {
+            return MEMORY_MODEL_ERROR_BAD_ARGUMENT;
+        }
+        entries.resize(count);
+        for (uint32_t i = 0; i < count; i++) {
+            entries[i].valid = rtl_entries[i].valid != 0;
+            entries[i].span_bits = rtl_entries[i].valid ? rtl_entries[i].span_bits : 0U;
+            entries[i].asid = rtl_entries[i].valid ? rtl_entries[i].asid : 0U;
+            entries[i].virt_base = rtl_entries[i].valid ? rtl_entries[i].virt_base : 0U;
+            entries[i].phys_base = rtl_entries[i].valid ? rtl_entries[i].phys_base : 0U;
+        }
+        if (write_index) {
+            *write_index = rtl_write_index;
+        }
+        return MEMORY_MODEL_ERROR_OK;
+    }
+    
+    virtual memory_model_error_t import_tlb(const std::vector<memory_model_tlb_entry_t>& entries,
+                                            uint32_t write_index) {
+        std::vector<mem_dpi_tlb_entry_t> rtl_entries(entries.size());
+        for (size_t i = 0; i < entries.size(); i++) {
+            rtl_entries[i].valid = entries[i].valid ? 1 : 0;
+            rtl_entries[i].span_bits = entries[i].span_bits;
+            rtl_entries[i].asid = entries[i].asid;
+            rtl_entries[i].virt_base = entries[i].virt_base;
+            rtl_entries[i].phys_base = entries[i].phys_base;
+        }
+        if (memory_dpi_tlb_import(rtl_entries.data(), static_cast<uint32_t>(rtl_entries.size()),
+                                  write_index) != MEM_DPI_OK) {
+            return MEMORY_MODEL_ERROR_BAD_ARGUMENT;
+        }
+        return ref_model ? memory_model_import_tlb(ref_model, entries.data(),
+                                                   static_cast<uint32_t>(entries.size()), write_index)
+                         : MEMORY_MODEL_ERROR_OK;
+    }
+    
 protected:
-    // TLM transport interface
-    virtual tlm::tlm_sync_enum nb_transport_fw(tlm::tlm_generic_payload& trans,
-                                              tlm::tlm_phase& phase,
-                                              sc_time& delay) {
+    // Called by MemoryTarget for b_transport and for each accepted
+    // approximately-timed request; delay comes back as the response latency
+    virtual void execute_transaction(tlm::tlm_generic_payload& trans, sc_time& delay) {
+        MemoryTransaction* mem_trans = nullptr;
+        trans.get_extension(mem_trans);
         
-        if (phase != tlm::BEGIN_REQ) {
-            return tlm::TLM_REJECTED;
+        // As in MemoryTarget::process_transaction(), plain payloads and
+        // accesses whose data pointer is not the extension's data word are
+        // block or wide transfers; the extension only receives the status
+        bool is_block = mem_trans &&
+                        trans.get_data_ptr() != reinterpret_cast<unsigned char*>(&mem_trans->data) &&
+                        (mem_trans->op_type == MemoryTransaction::OP_READ ||
+                         mem_trans->op_type == MemoryTransaction::OP_WRITE);
+        if (!mem_trans || is_block) {
+            mem_dpi_status_e status = process_dpi_payload(trans);
+            if (mem_trans) {
+                mem_trans->timestamp = sc_time_stamp().value();
+                mem_trans->status = convert_dpi_status(status);
+                mem_trans->response_ready = true;
+            }
+            delay = dpi_block_latency(trans, status, delay);
+            return;
         }
         
-        MemoryTransaction* mem_trans = 
-            static_cast<MemoryTransaction*>(trans.get_extension<MemoryTransaction>());
+        // Process transaction via DPI
+        process_dpi_transaction(*mem_trans);
         
-        if (!mem_trans) {
-            SC_REPORT_ERROR("MemoryDPIBridge", "No MemoryTransaction extension found");
-            return tlm::TLM_REJECTED;
+        delay = dpi_latency(*mem_trans, delay);
+        trans.set_response_status(tlm::TLM_OK_RESPONSE);
+    }
+    
+    // The data lives in the RTL; pointers into the reference model would
+    // bypass it
+    virtual bool dmi_supported() const {
+        return false;
+    }
+    
+    // Annotated delay: the incoming delay plus the timing model's latency at
+    // the physical address the reference model translates to, else plus a
+    // flat 10 ns RTL processing delay. The lookup has no side effects, so timing
+    // never perturbs the reference comparison.
+    sc_time dpi_latency(MemoryTransaction& trans, const sc_time& delay) {
+        MemoryTimingModel* timing = get_timing_model();
+        bool is_access = trans.op_type == MemoryTransaction::OP_READ ||
+                         trans.op_type == MemoryTransaction::OP_WRITE;
+        uint64_t phys_addr = 0;
+        if (!timing || !ref_model || !is_access || trans.status != MemoryTransaction::STATUS_OK ||
+            memory_model_lookup(ref_model, trans.virt_addr, &phys_addr) != MEMORY_MODEL_STATUS_OK) {
+            return delay + sc_time(10, SC_NS);
         }
+        trans.phys_addr = phys_addr;
         
-        // Process transaction via DPI
-        process_dpi_transaction(*mem_trans);
+        uint64_t issue_ps = static_cast<uint64_t>((sc_time_stamp() + delay).to_seconds() * 1e12 + 0.5);
+        uint64_t done_ps = timing->access(phys_addr, trans.op_type == MemoryTransaction::OP_WRITE,
+                                          memory_model_get_config(ref_model)->data_width / 8U, issue_ps);
+        return delay + sc_time(static_cast<double>(done_ps - issue_ps), SC_PS);
+    }
+    
+    // Block payloads are charged per page run at the physical address the
+    // reference model translates to, as MemoryTarget does; without a timing
+    // or reference model, or on failure, the flat 10 ns applies
+    sc_time dpi_block_latency(tlm::tlm_generic_payload& trans, mem_dpi_status_e status,
+                              const sc_time& delay) {
+        MemoryTimingModel* timing = get_timing_model();
+        if (!timing || !ref_model || status != MEM_DPI_OK || !(trans.is_read() || trans.is_write())) {
+            return delay + sc_time(10, SC_NS);
+        }
+        
+        const memory_model_config_t* cfg = memory_model_get_config(ref_model);
+        uint64_t bytes_per_word = cfg->data_width / 8U;
+        uint64_t page_words = cfg->page_size;
+        uint64_t virt_addr = trans.get_address();
+        uint64_t length = trans.get_data_length();
+        uint64_t issue_ps = static_cast<uint64_t>((sc_time_stamp() + delay).to_seconds() * 1e12 + 0.5);
+        uint64_t done_ps = issue_ps;
+        
+        while (length > 0) {
+            uint64_t run_words = page_words - (virt_addr & (page_words - 1U));
+            uint64_t run_bytes = std::min(length, run_words * bytes_per_word);
+            uint64_t phys_addr = 0;
+            if (memory_model_lookup(ref_model, virt_addr, &phys_addr) == MEMORY_MODEL_STATUS_OK) {
+                done_ps = std::max(done_ps, timing->access(phys_addr, trans.is_write(), run_bytes, issue_ps));
+            }
+            virt_addr += run_words;
+            length -= run_bytes;
+        }
+        return delay + sc_time(static_cast<double>(done_ps - issue_ps), SC_PS);
+    }
+    
+    // Bytes per RTL word: the reference model's data width, else the RTL's
+    // default DATA_WIDTH of 64
+    uint32_t dpi_word_bytes() const {
+        return ref_model ? memory_model_get_config(ref_model)->data_width / 8U : 8U;
+    }
+    
+    // Block or wide payload: one memory_dpi_read_wide()/memory_dpi_write_wide()
+    // per word, masked by the word's own byte enables (the pattern repeats
+    // across the burst) or fully enabled. Words with no byte enabled are
+    // skipped; the first failing word ends the payload. Payloads the bridge
+    // cannot carry (streaming bursts, words wider than MEM_DPI_MAX_DATA_BYTES)
+    // get TLM_GENERIC_ERROR_RESPONSE.
+    mem_dpi_status_e process_dpi_payload(tlm::tlm_generic_payload& trans) {
+        if (!trans.is_read() && !trans.is_write()) {
+            trans.set_response_status(tlm::TLM_OK_RESPONSE);
+            return MEM_DPI_OK;
+        }
+        
+        uint32_t word_bytes = dpi_word_bytes();
+        if (word_bytes == 0U || word_bytes > MEM_DPI_MAX_DATA_BYTES ||
+            (trans.get_streaming_width() != 0U && trans.get_streaming_width() < trans.get_data_length())) {
+            trans.set_response_status(tlm::TLM_GENERIC_ERROR_RESPONSE);
+            return MEM_DPI_ERR_ACCESS;
+        }
+        
+        unsigned char* data = trans.get_data_ptr();
+        unsigned int length = trans.get_data_length();
+        const unsigned char* be = trans.get_byte_enable_ptr();
+        unsigned int be_length = be ? trans.get_byte_enable_length() : 0U;
+        uint64_t virt_addr = trans.get_address();
+        mem_dpi_status_e status = MEM_DPI_OK;
+        
+        for (unsigned int offset = 0; offset < length && status == MEM_DPI_OK; offset += word_bytes, virt_addr++) {
+            unsigned int bytes = std::min(word_bytes, length - offset);
+            uint64_t byte_mask = 0;
+            for (unsigned int b = 0; b < bytes; b++) {
+                if (be_length == 0U || be[(offset + b) % be_length] != tlm::TLM_BYTE_DISABLED) {
+                    byte_mask |= 1ULL << b;
+                }
+            }
+            if (byte_mask == 0U) {
+                continue;
+            }
+            
+            uint8_t word[MEM_DPI_MAX_DATA_BYTES] = {};
+            uint32_t timestamp;
+            if (trans.is_read()) {
+                status = memory_dpi_read_wide(virt_addr, byte_mask, word, word_bytes, &timestamp);
+                for (unsigned int b = 0; b < bytes; b++) {
+                    if ((byte_mask >> b) & 1U) {
+                        data[offset + b] = word[b];
+                    }
+                }
+            } else {
+                std::memcpy(word, data + offset, bytes);
+                status = memory_dpi_write_wide(virt_addr, byte_mask, word, word_bytes, &timestamp);
+            }
+            
+            if (ref_model) {
+                check_wide_with_ref_model(trans.is_write(), virt_addr, byte_mask, word, status);
+            }
+        }
         
-        // Complete transaction
-        phase = tlm::END_REQ;
-        delay = sc_time(10, SC_NS); // RTL processing delay
+        cout << sc_time_stamp() << " [DPI_BRIDGE] " << (trans.is_read() ? "BLOCK_READ" : "BLOCK_WRITE")
+             << ": addr=0x" << hex << trans.get_address()
+             << " bytes=" << dec << length
+             << " status=" << convert_dpi_status(status) << endl;
         
-        return tlm::TLM_UPDATED;
+        switch (status) {
+            case MEM_DPI_OK:
+                trans.set_response_status(tlm::TLM_OK_RESPONSE);
+                break;
+            case MEM_DPI_ERR_ADDR:
+                trans.set_response_status(tlm::TLM_ADDRESS_ERROR_RESPONSE);
+                break;
+            default:
+                trans.set_response_status(tlm::TLM_GENERIC_ERROR_RESPONSE);
+                break;
+        }
+        return status;
+    }
+    
+    // Mirror one wide word into the reference model; reads are compared on
+    // the enabled bytes
+    void check_wide_with_ref_model(bool is_write, uint64_t virt_addr, uint64_t byte_mask,
+                                   const uint8_t* rtl_word, mem_dpi_status_e rtl_status) {
+        if (is_write) {
+            memory_model_write_wide(ref_model, virt_addr, byte_mask, rtl_word);
+            return;
+        }
+        
+        uint8_t ref_word[MEM_DPI_MAX_DATA_BYTES] = {};
+        memory_model_status_t ref_status = memory_model_read_wide(ref_model, virt_addr, byte_mask, ref_word);
+        if (ref_status != MEMORY_MODEL_STATUS_OK || rtl_status != MEM_DPI_OK) {
+            return;
+        }
+        for (uint32_t b = 0; b < dpi_word_bytes(); b++) {
+            if (((byte_mask >> b) & 1U) && ref_word[b] != rtl_word[b]) {
+                cout << sc_time_stamp() << " [DPI_BRIDGE] WARNING: "
+                     << "RTL vs Ref Model wide data mismatch at addr=0x" << hex << virt_addr
+                     << " byte " << dec << b << endl;
+                return;
+            }
+        }
     }
     
     // DPI transaction processing thread
     void process_dpi_thread() {
         while (true) {
             wait();
-            // DPI transactions are processed synchronously in nb_transport_fw
+            // DPI transactions are processed in execute_transaction()
         }
     }
     
@@ -118,14 +331,45 @@ protected:
             }
             
             case MemoryTransaction::OP_TLB_LOAD: {
-                status = memory_dpi_tlb_load(trans.tlb_virt_base, trans.tlb_phys_base,
-                                           &timestamp);
+                if (trans.tlb_span_bits != 0U) {
+                    status = memory_dpi_tlb_load_range(trans.tlb_virt_base, trans.tlb_phys_base,
+                                                     trans.tlb_span_bits, &timestamp);
+                } else {
+                    status = memory_dpi_tlb_load(trans.tlb_virt_base, trans.tlb_phys_base,
+                                               &timestamp);
+                }
                 trans.status = convert_dpi_status(status);
                 
                 cout << sc_time_stamp() << " [DPI_BRIDGE] TLB_LOAD: "
                      << "virt=0x" << hex << trans.tlb_virt_base
                      << " phys=0x" << trans.tlb_phys_base
-                     << " status=" << trans.status << dec << endl;
+                     << " span=" << dec << trans.tlb_span_bits
+                     << " status=" << trans.status << endl;
+                break;
+            }
+            
+            case MemoryTransaction::OP_FLUSH: {
+                status = trans.tlb_flush_all ? memory_dpi_tlb_flush(&timestamp)
+                                             : memory_dpi_tlb_flush_page(trans.virt_addr, &timestamp);
+                trans.status = convert_dpi_status(status);
+                
+                cout << sc_time_stamp() << " [DPI_BRIDGE] TLB_FLUSH: ";
+                if (trans.tlb_flush_all) {
+                    cout << "all";
+                } else {
+                    cout << "addr=0x" << hex << trans.virt_addr << dec;
+                }
+                cout << " status=" << trans.status << endl;
+                break;
+            }
+            
+            case MemoryTransaction::OP_SET_ASID: {
+                status = memory_dpi_set_asid(trans.asid, &timestamp);
+                trans.status = convert_dpi_status(status);
+                
+                cout << sc_time_stamp() << " [DPI_BRIDGE] SET_ASID: "
+                     << "asid=" << trans.asid
+                     << " status=" << trans.status << endl;
                 break;
             }
             
@@ -142,7 +386,7 @@ protected:
     }
     
     // Convert DPI status to TLM status
-    MemoryTransaction::status_e convert_dpi_status(mem_dpi_status_e dpi_status) {
+    MemoryTransaction::StatusCode convert_dpi_status(mem_dpi_status_e dpi_status) {
         switch (dpi_status) {
             case MEM_DPI_OK:        return MemoryTransaction::STATUS_OK;
             case MEM_DPI_ERR_ADDR:  return MemoryTransaction::STATUS_ERR_ADDR;
@@ -157,28 +401,45 @@ protected:
     void process_transaction_with_ref_model(MemoryTransaction& trans) {
         if (!ref_model) return;
         
-        memory_transaction_t ref_trans;
-        memory_result_t ref_result;
+        memory_model_transaction_t ref_trans = {};
+        memory_model_result_t ref_result;
         
         // Convert to reference model format
         switch (trans.op_type) {
             case MemoryTransaction::OP_READ:
-                ref_trans.type = MEMORY_READ;
+                ref_trans.op = MEMORY_MODEL_OP_READ;
                 ref_trans.virt_addr = trans.virt_addr;
                 ref_trans.byte_mask = trans.byte_mask;
                 break;
                 
             case MemoryTransaction::OP_WRITE:
-                ref_trans.type = MEMORY_WRITE;
+                ref_trans.op = MEMORY_MODEL_OP_WRITE;
                 ref_trans.virt_addr = trans.virt_addr;
                 ref_trans.byte_mask = trans.byte_mask;
                 ref_trans.data = trans.data;
                 break;
                 
+            case MemoryTransaction::OP_FLUSH:
+                ref_trans.op = MEMORY_MODEL_OP_FLUSH;
+                ref_trans.virt_addr = trans.virt_addr;
+                ref_trans.byte_mask = trans.tlb_flush_all ? 0U : 1U;
+                break;
+                
+            case MemoryTransaction::OP_SET_ASID:
+                ref_trans.op = MEMORY_MODEL_OP_SET_ASID;
+                ref_trans.data = trans.asid;
+                break;
+                
             case MemoryTransaction::OP_TLB_LOAD:
-                ref_trans.type = MEMORY_TLB_LOAD;
-                ref_trans.tlb_virt_base = trans.tlb_virt_base;
-                ref_trans.tlb_phys_base = trans.tlb_phys_base;
+                if (trans.tlb_span_bits != 0U) {
+                    // Range loads have no execute() encoding; the result carries no data
+                    memory_model_load_tlb_range(ref_model, trans.tlb_virt_base, trans.tlb_phys_base,
+                                                trans.tlb_span_bits);
+                    return;
+                }
+                ref_trans.op = MEMORY_MODEL_OP_TLB_LOAD;
+                ref_trans.virt_addr = trans.tlb_virt_base;
+                ref_trans.data = trans.tlb_phys_base;
                 break;
         }
         
@@ -186,7 +447,7 @@ protected:
         memory_model_execute(ref_model, &ref_trans, &ref_result);
         
         // Compare results (for debugging)
-        if (ref_result.status == MEMORY_OK && trans.status == MemoryTransaction::STATUS_OK) {
+        if (ref_result.status == MEMORY_MODEL_STATUS_OK && trans.status == MemoryTransaction::STATUS_OK) {
             if (trans.op_type == MemoryTransaction::OP_READ) {
                 if (ref_result.data != trans.data) {
                     cout << sc_time_stamp() << " [DPI_BRIDGE] WARNING: "
@@ -0,0 +1,67 @@
+#ifndef MEMORY_PAYLOAD_POOL_H
+#define MEMORY_PAYLOAD_POOL_H
+
+#include "tlm.h"
+#include "tlm_transaction.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Counters reported by MemoryPayloadPool::get_stats()
+ */
+struct MemoryPayloadPoolStats {
+    uint64_t created;      // Payloads constructed, each with its own extension
+    uint64_t allocations;  // allocate() calls
+    uint64_t recycled;     // allocate() calls served from the free list
+    uint64_t released;     // Payloads returned by their last release()
+    uint64_t in_use;       // Payloads currently handed out
+    uint64_t peak_in_use;  // High-water mark of in_use
+
+    MemoryPayloadPoolStats()
+        : created(0), allocations(0), recycled(0), released(0), in_use(0), peak_in_use(0)
+    {
+    }
+};
+
+/**
+ * @brief Free-list pool of generic payloads with a MemoryTransaction attached
+ *
+ * allocate() hands out a payload whose reference count is already one and
+ * whose fields and extension hold their defaults. Holders acquire() and
+ * release() as usual; the last release() returns the payload here through
+ * free() rather than to the heap, so once the pool has grown to the number
+ * of payloads in flight, transactions make no heap allocations. Extensions
+ * other modules attach with set_auto_extension() are dropped on the way
+ * back. All payloads must be released before the pool is destroyed. Like the
+ * SystemC kernel it serves, the pool is not thread-safe.
+ */
+class MemoryPayloadPool : public tlm::tlm_mm_interface
+{
+public:
+    MemoryPayloadPool() {}
+    virtual ~MemoryPayloadPool();
+
+    MemoryPayloadPool(const MemoryPayloadPool &) = delete;
+    MemoryPayloadPool &operator=(const MemoryPayloadPool &) = delete;
+
+    // A payload with reference count one; ext_out receives its extension
+    tlm::tlm_generic_payload *allocate(MemoryTransaction *&ext_out);
+
+    // Grow the free list to at least count payloads ahead of time
+    void reserve(size_t count);
+
+    // tlm_mm_interface: the payload's last release() lands here
+    virtual void free(tlm::tlm_generic_payload *trans);
+
+    const MemoryPayloadPoolStats &get_stats() const { return stats; }
+    size_t free_count() const { return free_list.size(); }
+
+private:
+    std::vector<tlm::tlm_generic_payload *> free_list;
+    MemoryPayloadPoolStats stats;
+
+    tlm::tlm_generic_payload *create();
+};
+
+#endif /* MEMORY_PAYLOAD_POOL_H */
@@ -5,6 +5,125 @@
 #include "tlm_transaction.h"
 #include "memory_transactor.h"
 #include "memory_scoreboard.h"
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * @brief MemoryTarget that keeps a copy of each payload's data once executed
+ *
+ * The initiator recycles a payload as soon as its response completes, so
+ * this is where the scenario sees what a read left in the payload's buffer.
+ */
+class RecordingTarget : public MemoryTarget
+{
+public:
+    RecordingTarget(sc_module_name name, memory_model_t *model)
+        : MemoryTarget(name, model), last_response(tlm::TLM_INCOMPLETE_RESPONSE)
+    {
+    }
+
+    const std::vector<unsigned char> &get_last_data() const { return last_data; }
+    tlm::tlm_response_status get_last_response() const { return last_response; }
+
+    // Data of the last payload executed at this address; empty if none was
+    std::vector<unsigned char> get_data_at(uint64_t addr) const
+    {
+        std::map<uint64_t, std::vector<unsigned char> >::const_iterator it = data_by_address.find(addr);
+        return it != data_by_address.end() ? it->second : std::vector<unsigned char>();
+    }
+
+protected:
+    virtual void execute_transaction(transaction_type &trans, sc_time &delay)
+    {
+        MemoryTarget::execute_transaction(trans, delay);
+        unsigned char *data = trans.get_data_ptr();
+        last_data.assign(data, data ? data + trans.get_data_length() : data);
+        last_response = trans.get_response_status();
+        data_by_address[trans.get_address()] = last_data;
+    }
+
+private:
+    std::vector<unsigned char> last_data;
+    tlm::tlm_response_status last_response;
+    std::map<uint64_t, std::vector<unsigned char> > data_by_address;
+};
+
+/**
+ * @brief Timing model with one fixed latency per address region
+ *
+ * Physical words below split_addr take slow_ps and the rest fast_ps. Unlike
+ * DramTimingModel, whose shared data bus completes accesses in issue order,
+ * nothing serialises them, so a fast request overtakes an earlier slow one.
+ */
+class SplitLatencyModel : public MemoryTimingModel
+{
+public:
+    SplitLatencyModel(uint64_t split_addr, uint64_t slow_ps, uint64_t fast_ps)
+        : split_addr(split_addr), slow_ps(slow_ps), fast_ps(fast_ps)
+    {
+    }
+
+    virtual uint64_t access(uint64_t phys_addr, bool, uint64_t, uint64_t issue_ps)
+    {
+        return issue_ps + (phys_addr < split_addr ? slow_ps : fast_ps);
+    }
+    virtual void reset() {}
+
+private:
+    uint64_t split_addr;
+    uint64_t slow_ps;
+    uint64_t fast_ps;
+};
+
+/**
+ * @brief Target that finishes every request inside nb_transport_fw()
+ *
+ * BEGIN_REQ is answered with TLM_COMPLETED, the base protocol's shortcut
+ * through all four phases. Only MemoryTransaction reads and writes are
+ * understood; they run on the model at once and take 5 ns.
+ */
+class CompletingTarget : public sc_module
+{
+public:
+    tlm_utils::simple_target_socket<CompletingTarget> socket;
+
+    CompletingTarget(sc_module_name name, memory_model_t *model)
+        : sc_module(name), socket("socket"), model(model), completed(0), last_read(0)
+    {
+        socket.register_nb_transport_fw(this, &CompletingTarget::nb_transport_fw);
+    }
+
+    unsigned int get_completed() const { return completed; }
+    uint64_t get_last_read() const { return last_read; }
+
+private:
+    memory_model_t *model;
+    unsigned int completed;
+    uint64_t last_read;
+
+    tlm::tlm_sync_enum nb_transport_fw(tlm::tlm_generic_payload &trans, tlm::tlm_phase &phase, sc_time &delay)
+    {
+        MemoryTransaction *ext = nullptr;
+        trans.get_extension(ext);
+        memory_model_status_t status = MEMORY_MODEL_STATUS_ERR_ACCESS;
+        if (phase == tlm::BEGIN_REQ && ext && ext->op_type == MemoryTransaction::OP_READ) {
+            status = memory_model_read(model, ext->virt_addr, ext->byte_mask, &ext->data);
+            last_read = ext->data;
+        } else if (phase == tlm::BEGIN_REQ && ext && ext->op_type == MemoryTransaction::OP_WRITE) {
+            status = memory_model_write(model, ext->virt_addr, ext->byte_mask, ext->data);
+        }
+        if (ext) {
+            ext->status = static_cast<MemoryTransaction::StatusCode>(status);
+            ext->response_ready = true;
+        }
+        trans.set_response_status(status == MEMORY_MODEL_STATUS_OK ? tlm::TLM_OK_RESPONSE
+                                                                   : tlm::TLM_GENERIC_ERROR_RESPONSE);
+        delay += sc_time(5, SC_NS);
+        completed++;
+        return tlm::TLM_COMPLETED;
+    }
+};
 
 /**
  * @brief Basic memory test scenario using TLM components
@@ -14,6 +133,14 @@
  * 2. Read/write transactions with byte masks
  * 3. Error handling for translation misses
  * 4. Sequential read-after-write verification
+ * 5. Block transfers of a word or less, checked against a C model
+ *    behind its own initiator/target pair
+ * 6. Byte-enabled wide-word transfers at 64- and 128-bit data widths
+ * 7. The approximately-timed protocol: END_REQ back-pressure, several
+ *    requests in flight, out-of-order responses and the TLM_COMPLETED
+ *    shortcut
+ * 8. Request-ring credit stalls, payload recycling over a long run and
+ *    loosely-timed quantum synchronisation
  */
 class MemoryTestScenario : public sc_module
 {
@@ -43,6 +170,21 @@ private:
     unsigned int test_count;
     unsigned int tests_passed;
 
+    // Initiator and recording target over a C model the tests can inspect
+    struct Loopback {
+        memory_model_t *model;
+        MemoryInitiator *init;
+        RecordingTarget *target;
+    };
+    Loopback narrow;  // 64-bit words
+    Loopback wide;    // 128-bit words
+    Loopback timed;   // 64-bit words behind timed_latency
+    SplitLatencyModel timed_latency;
+    MemoryInitiator *completing_init;     // Drives completing_target over timed.model
+    CompletingTarget *completing_target;
+    Loopback paced;   // 64-bit words, a short request ring, 10 ns per word
+    SplitLatencyModel paced_latency;
+
     // Individual test methods
     void test_tlb_load();
     void test_basic_write();
@@ -50,9 +192,19 @@ private:
     void test_masked_write();
     void test_sequential_rw();
     void test_error_handling();
+    void test_short_blocks();
+    void test_wide_words();
+    bool check_wide_words(Loopback &lb, size_t word_bytes);
+    void test_approximately_timed();
+    void test_initiator_resources();
 
     // Helper methods
     void wait_cycles(unsigned int n);
+    bool wait_for_responses(MemoryInitiator *initiator, uint64_t count, unsigned int max_cycles);
+    static std::vector<unsigned char> word_bytes_of(uint64_t value);
+    Loopback create_loopback(const char *prefix, uint32_t data_width, size_t queue_depth = 256);
+    bool expect_bytes(const std::vector<unsigned char> &actual, const std::vector<unsigned char> &expected,
+                      const char *what);
     void log_test(const std::string &name, bool passed);
 };
 
@@ -0,0 +1,117 @@
+#ifndef MEMORY_TIMING_H
+#define MEMORY_TIMING_H
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Latency model a target consults to annotate transaction delays
+ *
+ * Times are picoseconds of simulated time. access() is called once per
+ * physically contiguous run a transaction touches and returns when the run's
+ * last data beat completes; the model keeps whatever state (open rows, busy
+ * banks, bus direction) makes later accesses cheaper or dearer. It never
+ * sees or changes data, so attaching one alters timing and nothing else.
+ */
+class MemoryTimingModel
+{
+public:
+    virtual ~MemoryTimingModel() {}
+
+    // Move bytes starting at physical word address phys_addr, issued at
+    // issue_ps; returns the completion time (never earlier than issue_ps)
+    virtual uint64_t access(uint64_t phys_addr, bool is_write, uint64_t bytes, uint64_t issue_ps) = 0;
+
+    // Close all rows and idle the device, as after power-on
+    virtual void reset() = 0;
+};
+
+/**
+ * @brief Geometry and timing of DramTimingModel
+ *
+ * Cycle counts are in controller clocks of clock_ps. The defaults are a
+ * DDR4-1600-like 11-11-11 part with eight banks of 8 KiB rows. Zero counts
+ * for banks, row_words, word_bytes or burst_bytes are treated as one.
+ */
+struct DramTimingConfig {
+    uint32_t banks;          // Banks, each with one row buffer
+    uint32_t row_words;      // Physical words per row
+    uint32_t word_bytes;     // Bytes per physical word address
+    uint32_t burst_bytes;    // Bytes moved per burst
+    uint32_t burst_cycles;   // Data-bus cycles per burst
+    uint32_t t_rcd;          // Activate to column command
+    uint32_t t_cl;           // Column command to first data (CAS latency)
+    uint32_t t_rp;           // Precharge to activate
+    uint32_t t_turnaround;   // Idle bus cycles when the data direction changes
+    uint64_t clock_ps;       // Controller clock period
+    bool open_page;          // Leave rows open after an access; else auto-precharge
+
+    DramTimingConfig()
+        : banks(8), row_words(1024), word_bytes(8), burst_bytes(64), burst_cycles(4),
+          t_rcd(11), t_cl(11), t_rp(11), t_turnaround(2), clock_ps(1250), open_page(true)
+    {
+    }
+};
+
+/**
+ * @brief Row-buffer outcome counters of DramTimingModel
+ *
+ * Every row an access touches counts as exactly one of row_hits, row_empty
+ * (bank idle, activate only) or row_conflicts (another row open, precharge
+ * and activate). data_bus_ps over the simulated span gives bus utilisation.
+ */
+struct DramTimingStats {
+    uint64_t accesses;
+    uint64_t row_hits;
+    uint64_t row_empty;
+    uint64_t row_conflicts;
+    uint64_t turnarounds;
+    uint64_t data_bus_ps;
+
+    DramTimingStats()
+        : accesses(0), row_hits(0), row_empty(0), row_conflicts(0), turnarounds(0), data_bus_ps(0)
+    {
+    }
+};
+
+/**
+ * @brief Banked DRAM with per-bank row buffers and a shared data bus
+ *
+ * Physical word addresses map row:bank:column, so consecutive rows land in
+ * consecutive banks and a linear stream rotates through them. A row hit costs
+ * tCL, an idle bank tRCD + tCL and a row conflict tRP + tRCD + tCL; in
+ * closed-page mode every access finds its bank idle but keeps it busy for tRP
+ * afterwards. Column commands to an open row pipeline, so a stream of hits is
+ * limited by the data bus alone, and reversing the bus direction costs
+ * t_turnaround cycles. Accesses crossing a row boundary are split per row.
+ */
+class DramTimingModel : public MemoryTimingModel
+{
+public:
+    explicit DramTimingModel(const DramTimingConfig &config = DramTimingConfig());
+
+    uint64_t access(uint64_t phys_addr, bool is_write, uint64_t bytes, uint64_t issue_ps) override;
+    void reset() override;
+
+    const DramTimingConfig &config() const { return cfg; }
+    const DramTimingStats &stats() const { return counters; }
+    void reset_stats() { counters = DramTimingStats(); }
+
+private:
+    struct Bank {
+        bool open;
+        uint64_t row;
+        uint64_t ready_ps;  // Earliest next command to this bank
+    };
+
+    DramTimingConfig cfg;
+    DramTimingStats counters;
+    std::vector<Bank> banks;
+    uint64_t bus_free_ps;
+    bool bus_used;
+    bool bus_write;
+
+    uint64_t access_row(uint64_t phys_addr, bool is_write, uint64_t bytes, uint64_t issue_ps);
+};
+
+#endif /* MEMORY_TIMING_H */
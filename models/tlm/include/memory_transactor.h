@@ -4,10 +4,17 @@
 #include "systemc.h"
 #include "tlm.h"
 #include "tlm_utils/simple_initiator_socket.h"
+#include "tlm_utils/peq_with_get.h"
 #include "tlm_utils/simple_target_socket.h"
+#include "tlm_utils/tlm_quantumkeeper.h"
 #include "tlm_transaction.h"
 #include "memory_model.h"
-#include <queue>
+#include "memory_model.hpp"
+#include "memory_payload_pool.h"
+#include "memory_timing.h"
+#include <deque>
+#include <utility>
+#include <vector>
 
 /**
  * @brief TLM Initiator that drives memory transactions to the target
@@ -15,6 +22,25 @@
  * The MemoryInitiator sends read/write transactions via its TLM socket.
  * It can be connected to a target model (like the RTL via DPI or the
  * reference model directly).
+ *
+ * Payloads come from a MemoryPayloadPool with their MemoryTransaction
+ * already attached and go back to it on their last release(), so a long
+ * stimulus run allocates only as many payloads as are ever in flight.
+ *
+ * send_*() calls post into a fixed ring of queue_depth requests; a free slot
+ * is the caller's credit. A caller that finds the ring full hands it to the
+ * sending thread and waits for a slot, so queued memory stays bounded
+ * however fast stimulus is produced. Each send notifies the sending thread
+ * once, except inside send_batch(), which notifies once for the whole batch.
+ *
+ * By default the initiator is approximately timed: it runs the base
+ * protocol's four phases over nb_transport_fw()/nb_transport_bw(), keeps up
+ * to set_max_outstanding() requests in flight and matches responses to
+ * requests by payload, so a target may answer out of order. After
+ * set_quantum() the initiator is loosely timed instead: it calls
+ * b_transport() with its local time offset, keeps the annotated delay in a
+ * tlm_quantumkeeper and yields to the kernel only when the offset reaches the
+ * global quantum or the queue runs dry, not once per transaction.
  */
 class MemoryInitiator : public sc_module
 {
@@ -28,26 +54,161 @@ public:
 
     SC_HAS_PROCESS(MemoryInitiator);
     
-    MemoryInitiator(sc_module_name name);
+    MemoryInitiator(sc_module_name name, size_t queue_depth = 256);
     virtual ~MemoryInitiator();
 
     // Push a transaction to the queue for sending
     void send_read(uint64_t virt_addr, uint32_t byte_mask);
     void send_write(uint64_t virt_addr, uint32_t byte_mask, uint64_t data);
     void send_tlb_load(uint64_t virt_base, uint64_t phys_base);
+    // One TLB entry covering 2^span_bits addresses; see memory_model_load_tlb_range()
+    void send_tlb_load_range(uint64_t virt_base, uint64_t phys_base, uint32_t span_bits);
+    // MEM_FLUSH of the whole TLB, or of the current ASID's entries translating virt_addr
+    void send_tlb_flush();
+    void send_tlb_flush_page(uint64_t virt_addr);
+    // MEM_SET_ASID: later loads and lookups use asid; nothing is flushed
+    void send_set_asid(uint32_t asid);
+
+    // Block transfers over consecutive virtual word addresses (length in bytes)
+    void send_block_read(uint64_t virt_addr, size_t length);
+    void send_block_write(uint64_t virt_addr, const std::vector<unsigned char> &data);
+
+    // Single wide-word transfers (data_width > 64); bit i of byte_mask enables byte i
+    void send_wide_read(uint64_t virt_addr, uint64_t byte_mask, size_t word_bytes);
+    void send_wide_write(uint64_t virt_addr, uint64_t byte_mask, const std::vector<unsigned char> &word);
+
+    // Queue count operations in memory_model_execute()'s encoding with a
+    // single notification. Call from a thread if count may exceed the free
+    // slots; a full ring then blocks until the sending thread drains it.
+    void send_batch(const memory_model_transaction_t *ops, size_t count);
+
+    // Request ring occupancy; credit stalls count waits for a free slot
+    size_t get_queue_depth() const { return request_ring.size(); }
+    size_t get_queued() const { return ring_count; }
+    size_t get_peak_queued() const { return peak_queued; }
+    uint64_t get_credit_stalls() const { return credit_stalls; }
+
+    // Switch to loosely-timed b_transport with this global quantum; a zero
+    // quantum returns to nb_transport_fw
+    void set_quantum(const sc_time &quantum);
+    bool is_loosely_timed() const { return loosely_timed; }
+    // Kernel synchronisations made in loosely-timed mode
+    uint64_t get_quantum_syncs() const { return quantum_syncs; }
+
+    // Approximately-timed requests allowed in flight at once (at least one)
+    void set_max_outstanding(unsigned int count) { max_outstanding = count != 0U ? count : 1U; }
+
+    // Approximately-timed response statistics; latency runs from BEGIN_REQ
+    // to BEGIN_RESP, and a response is out of order if an older request is
+    // still waiting
+    uint64_t get_responses() const { return responses; }
+    uint64_t get_out_of_order_responses() const { return out_of_order_responses; }
+    unsigned int get_peak_outstanding() const { return peak_outstanding; }
+    sc_time get_mean_latency() const
+    {
+        return responses != 0U ? total_latency / static_cast<double>(responses) : SC_ZERO_TIME;
+    }
+
+    // Pre-build payloads for the expected number in flight, and inspect reuse
+    void reserve_payloads(size_t count) { payload_pool.reserve(count); }
+    const MemoryPayloadPoolStats &get_payload_pool_stats() const { return payload_pool.get_stats(); }
 
 private:
     void main_process();
-    std::queue<transaction_type *> pending_transactions;
+    void post(transaction_type *trans);
+    transaction_type *take();
+    // Block payloads built but not yet posted, so callers can finish them first
+    transaction_type *make_block_read(uint64_t virt_addr, size_t length);
+    transaction_type *make_block_write(uint64_t virt_addr, const std::vector<unsigned char> &data);
+    void sync_local_time();
+    void send_approximately_timed(transaction_type *trans);
+    sync_enum_type nb_transport_bw(transaction_type &trans, phase_type &phase, sc_time &delay);
+    void response_process();
+    void complete_response(transaction_type &trans);
+    MemoryPayloadPool payload_pool;
+    tlm_utils::tlm_quantumkeeper quantum_keeper;
+    bool loosely_timed;
+    uint64_t quantum_syncs;
+
+    // Approximately-timed state: requests in issue order with their start
+    // times, and the one request whose END_REQ is still due
+    tlm_utils::peq_with_get<transaction_type> response_peq;
+    std::deque<std::pair<transaction_type *, sc_time> > in_flight;
+    transaction_type *request_in_progress;
+    sc_event end_req_event;
+    sc_event response_done_event;
+    unsigned int max_outstanding;
+    unsigned int peak_outstanding;
+    uint64_t responses;
+    uint64_t out_of_order_responses;
+    sc_time total_latency;
+
+    // Request ring: ring_count entries from ring_head, produced by send_*()
+    // and consumed by main_process(). The kernel runs one process at a time,
+    // so head and count need no locking.
+    std::vector<transaction_type *> request_ring;
+    size_t ring_head;
+    size_t ring_count;
+    unsigned int batch_depth;
+    bool producer_waiting;
+    uint64_t credit_stalls;
+    size_t peak_queued;
     sc_event transaction_available;
+    sc_event credit_available;
 };
 
+/**
+ * @brief Global quantum from a --quantum=<ns> command-line argument
+ *
+ * Returns SC_ZERO_TIME when the argument is absent or not positive, which
+ * keeps the initiator on nb_transport_fw.
+ */
+sc_time memory_quantum_from_args(int argc, char *argv[]);
+
 /**
  * @brief TLM Target that receives and processes memory transactions
  * 
  * The MemoryTarget receives transactions from the initiator via TLM.
  * This is a placeholder for eventual connection to RTL via DPI or
  * direct connection to the reference model.
+ *
+ * Besides MemoryTransaction-tagged requests it accepts plain generic
+ * payloads: the address is the model's virtual word address, data_length
+ * may span any number of words and pages, and byte-enable patterns of any
+ * length are honoured. Words wider than 64 bits travel whole in one payload.
+ * A tagged request whose data pointer is not the extension's data word is
+ * handled the same way, so block transfers of a word or less keep their
+ * buffer and byte enables.
+ *
+ * The target runs against either the opaque C model or, for the default RTL
+ * geometry, an RtlMemoryModel whose translate and access paths inline into
+ * process_transaction(). When both are set the RtlMemoryModel is used.
+ *
+ * With a MemoryTimingModel attached, every successful read or write adds its
+ * memory latency to the b_transport delay, starting from the initiator's
+ * local time (sc_time_stamp() + delay). Only traffic that reaches the
+ * backing store is charged: with a data cache configured, hits are free, a
+ * miss fills one line (a dirty victim is charged as a line write ahead of
+ * it) and write-through stores go straight to memory. Block payloads stream
+ * from memory per page run, bypassing the cache in timing though not in the
+ * cache counters. Failed accesses and TLB operations take no time.
+ *
+ * Running on the C model without a data cache, the target grants DMI for
+ * translated addresses: a host pointer to the backing-store words around the
+ * address that share one TLB entry and one store page (see
+ * memory_model_get_direct()). DMI addresses are virtual word addresses, as
+ * for transport, so address a sits (a - start) * (data_width / 8) bytes into
+ * the grant. Once a TLB entry is overwritten or flushed, the ASID changes or
+ * the model is reset, the next transport call invalidates every outstanding
+ * grant through invalidate_direct_mem_ptr().
+ *
+ * Besides b_transport the target speaks the approximately-timed base
+ * protocol. A BEGIN_REQ enters a peq_with_get at its annotated time and is
+ * accepted with END_REQ once fewer than set_max_outstanding() requests are
+ * in flight; withholding END_REQ is the back-pressure. The model executes
+ * the request on acceptance, and BEGIN_RESP follows after its latency (from
+ * the timing model, if any), one response at a time, so requests with
+ * shorter latencies overtake longer ones.
  */
 class MemoryTarget : public sc_module
 {
@@ -67,16 +228,165 @@ public:
     // Set the reference model for this target
     void set_memory_model(memory_model_t *model) { mem_model = model; }
 
+    // Use the compile-time RTL-geometry model instead of the C model
+    void set_rtl_model(RtlMemoryModel *model) { rtl_model = model; }
+
+    // Annotate read/write latency from this model (not owned); nullptr leaves
+    // delays untouched
+    void set_timing_model(MemoryTimingModel *model) { timing_model = model; }
+    MemoryTimingModel *get_timing_model() const { return timing_model; }
+
+    // Latencies reported in DMI grants; zero by default
+    void set_dmi_latency(const sc_time &read, const sc_time &write)
+    {
+        dmi_read_latency = read;
+        dmi_write_latency = write;
+    }
+
+    // Approximately-timed requests accepted at once (at least one)
+    void set_max_outstanding(unsigned int count) { max_outstanding = count != 0U ? count : 1U; }
+    unsigned int get_peak_outstanding() const { return peak_outstanding; }
+
+    // Invalidate outstanding DMI grants if the model changed under them.
+    // Transport and TLB import do this themselves; call it after driving the
+    // model directly (for example memory_model_reset()).
+    void refresh_dmi();
+
+    // Backdoor copy of the whole TLB in slot order, for checkpointing between
+    // tests; see memory_model_export_tlb() and memory_model_import_tlb()
+    virtual memory_model_error_t export_tlb(std::vector<memory_model_tlb_entry_t> &entries,
+                                            uint32_t *write_index);
+    virtual memory_model_error_t import_tlb(const std::vector<memory_model_tlb_entry_t> &entries,
+                                            uint32_t write_index);
+
     // Get transaction statistics
     unsigned int get_transactions_processed() const { return transactions_processed; }
     unsigned int get_errors() const { return error_count; }
 
+    // Aggregate model counters, including data-cache hits, misses and
+    // writebacks; see memory_model_get_stats(). The RTL-geometry model keeps
+    // no counters.
+    memory_model_error_t get_model_stats(memory_model_stats_t &stats) const
+    {
+        return (mem_model && !rtl_model) ? memory_model_get_stats(mem_model, &stats)
+                                         : MEMORY_MODEL_ERROR_UNSUPPORTED;
+    }
+
+protected:
+    // Carry out one transaction and add its latency to delay. Both the
+    // b_transport and the approximately-timed paths come through here.
+    virtual void execute_transaction(transaction_type &trans, sc_time &delay)
+    {
+        process_transaction(trans, delay);
+    }
+
+    // Direct accesses would bypass the cache model, and the RTL-geometry
+    // model keeps no grant epoch
+    virtual bool dmi_supported() const
+    {
+        return mem_model && !rtl_model && memory_model_get_config(mem_model)->cache_size == 0U;
+    }
+
 private:
     memory_model_t *mem_model;
+    RtlMemoryModel *rtl_model;
+    MemoryTimingModel *timing_model;
+    sc_time dmi_read_latency;
+    sc_time dmi_write_latency;
+    bool dmi_granted;           // Grants may be outstanding over [dmi_start, dmi_end]
+    uint64_t dmi_start;
+    uint64_t dmi_end;
+    uint64_t dmi_epoch;         // memory_model_direct_epoch() when they were made
     unsigned int transactions_processed;
     unsigned int error_count;
 
+    // Approximately-timed state: requests wait in request_peq for their
+    // annotated time and a free slot, responses in response_peq for their
+    // latency and the response channel
+    tlm_utils::peq_with_get<transaction_type> request_peq;
+    tlm_utils::peq_with_get<transaction_type> response_peq;
+    transaction_type *response_in_progress;
+    sc_event slot_freed;
+    sc_event end_resp_received;
+    unsigned int max_outstanding;
+    unsigned int outstanding;
+    unsigned int peak_outstanding;
+
+    void b_transport(transaction_type &trans, sc_time &delay) { execute_transaction(trans, delay); }
+    sync_enum_type nb_transport_fw(transaction_type &trans, phase_type &phase, sc_time &delay);
+    void request_thread();
+    void response_thread();
+    void finish_response(transaction_type &trans);
     void process_transaction(transaction_type &trans, sc_time &delay);
+    bool get_direct_mem_ptr(transaction_type &trans, tlm::tlm_dmi &dmi);
+    memory_model_status_t process_payload(transaction_type &trans);
+    memory_model_status_t process_byte_enabled(transaction_type &trans, uint32_t bytes_per_word,
+                                               const unsigned char *be, unsigned int be_length);
+    memory_model_status_t model_read_word(uint64_t virt_addr, uint64_t byte_mask, unsigned char *word);
+    memory_model_status_t model_write_word(uint64_t virt_addr, uint64_t byte_mask, const unsigned char *word);
+    uint64_t time_word(uint64_t phys_addr, bool is_write, memory_model_cache_result_t cache, uint64_t issue_ps);
+    uint64_t time_block(uint64_t virt_addr, uint64_t length, bool is_write, uint64_t issue_ps);
+
+    // Where an access landed, without counting, walking or touching recency;
+    // after a successful access the mapping is always in the TLB
+    memory_model_status_t model_lookup(uint64_t virt_addr, uint64_t *phys_addr)
+    {
+        return rtl_model ? rtl_model->lookup(virt_addr, phys_addr)
+                         : memory_model_lookup(mem_model, virt_addr, phys_addr);
+    }
+
+    // Dispatch to whichever model is attached. The RTL-geometry model has no
+    // cache, so cache_out, if given, stays MEMORY_MODEL_CACHE_NONE.
+    memory_model_status_t model_read(uint64_t virt_addr, uint32_t byte_mask, uint64_t *data,
+                                     memory_model_cache_result_t *cache_out = nullptr)
+    {
+        if (rtl_model) {
+            if (cache_out) {
+                *cache_out = MEMORY_MODEL_CACHE_NONE;
+            }
+            return rtl_model->read(virt_addr, byte_mask, data);
+        }
+        return memory_model_read_cached(mem_model, virt_addr, byte_mask, data, cache_out);
+    }
+    memory_model_status_t model_write(uint64_t virt_addr, uint32_t byte_mask, uint64_t data,
+                                      memory_model_cache_result_t *cache_out = nullptr)
+    {
+        if (rtl_model) {
+            if (cache_out) {
+                *cache_out = MEMORY_MODEL_CACHE_NONE;
+            }
+            return rtl_model->write(virt_addr, byte_mask, data);
+        }
+        return memory_model_write_cached(mem_model, virt_addr, byte_mask, data, cache_out);
+    }
+    memory_model_error_t model_load_tlb(uint64_t virt_base, uint64_t phys_base, uint32_t span_bits)
+    {
+        if (span_bits != 0U) {
+            return rtl_model ? rtl_model->load_tlb_range(virt_base, phys_base, span_bits)
+                             : memory_model_load_tlb_range(mem_model, virt_base, phys_base, span_bits);
+        }
+        if (rtl_model) {
+            rtl_model->load_tlb(virt_base, phys_base);
+            return MEMORY_MODEL_ERROR_OK;
+        }
+        return memory_model_load_tlb(mem_model, virt_base, phys_base);
+    }
+    memory_model_error_t model_flush_tlb(bool all, uint64_t virt_addr)
+    {
+        if (rtl_model) {
+            if (all) {
+                rtl_model->flush_tlb();
+            } else {
+                rtl_model->flush_tlb_page(virt_addr);
+            }
+            return MEMORY_MODEL_ERROR_OK;
+        }
+        return all ? memory_model_flush_tlb(mem_model) : memory_model_flush_tlb_page(mem_model, virt_addr);
+    }
+    memory_model_error_t model_set_asid(uint32_t asid)
+    {
+        return rtl_model ? rtl_model->set_asid(asid) : memory_model_set_asid(mem_model, asid);
+    }
 };
 
 /**
@@ -4,6 +4,7 @@
 #include "tlm.h"
 #include <cstdint>
 #include <cstring>
+#include <vector>
 
 /**
  * @brief TLM extension for memory transaction attributes
@@ -18,7 +19,9 @@ public:
     enum OpType {
         OP_READ = 0x0,      // MEM_READ
         OP_WRITE = 0x1,     // MEM_WRITE
-        OP_TLB_LOAD = 0x3   // MEM_TLB_LD
+        OP_FLUSH = 0x2,     // MEM_FLUSH
+        OP_TLB_LOAD = 0x3,  // MEM_TLB_LD
+        OP_SET_ASID = 0x4   // MEM_SET_ASID
     };
 
     // Status codes matching RTL memory_pkg.sv
@@ -30,6 +33,14 @@ public:
         STATUS_PENDING = 0xF      // MEM_PENDING
     };
 
+    // Data-cache outcome, matching memory_model_cache_result_t
+    enum CacheResult {
+        CACHE_NONE = 0,           // No cache, or the access never reached memory
+        CACHE_HIT = 1,
+        CACHE_MISS = 2,
+        CACHE_MISS_WRITEBACK = 3  // Miss whose fill evicted a dirty line
+    };
+
     // Constructor
     MemoryTransaction() 
         : op_type(OP_READ),
@@ -40,6 +51,10 @@ public:
           data(0),
           tlb_virt_base(0),
           tlb_phys_base(0),
+          tlb_span_bits(0),
+          tlb_flush_all(true),
+          asid(0),
+          cache_result(CACHE_NONE),
           timestamp(0),
           response_ready(false)
     {
@@ -78,11 +93,39 @@ public:
             data = from->data;
             tlb_virt_base = from->tlb_virt_base;
             tlb_phys_base = from->tlb_phys_base;
+            tlb_span_bits = from->tlb_span_bits;
+            tlb_flush_all = from->tlb_flush_all;
+            asid = from->asid;
+            cache_result = from->cache_result;
             timestamp = from->timestamp;
             response_ready = from->response_ready;
+            block_data = from->block_data;
+            byte_enables = from->byte_enables;
         }
     }
 
+    // Restore the constructor's defaults so a pooled payload can carry a new
+    // request; the vectors keep their capacity
+    void reset()
+    {
+        op_type = OP_READ;
+        status = STATUS_PENDING;
+        byte_mask = 0xFF;
+        virt_addr = 0;
+        phys_addr = 0;
+        data = 0;
+        tlb_virt_base = 0;
+        tlb_phys_base = 0;
+        tlb_span_bits = 0;
+        tlb_flush_all = true;
+        asid = 0;
+        cache_result = CACHE_NONE;
+        timestamp = 0;
+        response_ready = false;
+        block_data.clear();
+        byte_enables.clear();
+    }
+
     // Transaction attributes
     OpType op_type;          // Operation type (read/write/tlb_load)
     StatusCode status;       // Response status
@@ -92,8 +135,14 @@ public:
     uint64_t data;           // Data (for write or read response)
     uint64_t tlb_virt_base;  // Virtual base for TLB load
     uint64_t tlb_phys_base;  // Physical base for TLB load
+    uint32_t tlb_span_bits;  // log2 of the TLB load's span; 0 loads a single page
+    bool tlb_flush_all;      // Flush everything, or only entries translating virt_addr
+    uint32_t asid;           // Address space to switch to for OP_SET_ASID
+    CacheResult cache_result; // Data-cache outcome of a single-word read or write
     uint64_t timestamp;      // Transaction timestamp
     bool response_ready;     // Response data valid
+    std::vector<unsigned char> block_data; // Payload storage for block and wide-word transfers
+    std::vector<unsigned char> byte_enables; // TLM byte-enable storage for masked wide-word transfers
 };
 
 #endif /* TLM_TRANSACTION_H */
@@ -0,0 +1,73 @@
+#include "memory_payload_pool.h"
+
+MemoryPayloadPool::~MemoryPayloadPool()
+{
+    // Deleting a payload deletes the extensions still attached to it
+    for (size_t i = 0; i < free_list.size(); i++) {
+        delete free_list[i];
+    }
+}
+
+tlm::tlm_generic_payload *MemoryPayloadPool::create()
+{
+    tlm::tlm_generic_payload *trans = new tlm::tlm_generic_payload(this);
+    trans->set_extension(new MemoryTransaction());
+    stats.created++;
+    return trans;
+}
+
+tlm::tlm_generic_payload *MemoryPayloadPool::allocate(MemoryTransaction *&ext_out)
+{
+    tlm::tlm_generic_payload *trans;
+    if (free_list.empty()) {
+        trans = create();
+    } else {
+        trans = free_list.back();
+        free_list.pop_back();
+        stats.recycled++;
+    }
+
+    trans->acquire();
+    trans->get_extension(ext_out);
+    stats.allocations++;
+    stats.in_use++;
+    if (stats.in_use > stats.peak_in_use) {
+        stats.peak_in_use = stats.in_use;
+    }
+    return trans;
+}
+
+void MemoryPayloadPool::reserve(size_t count)
+{
+    free_list.reserve(count);
+    while (free_list.size() < count) {
+        free_list.push_back(create());
+    }
+}
+
+void MemoryPayloadPool::free(tlm::tlm_generic_payload *trans)
+{
+    // reset() frees auto extensions only; ours stays attached for reuse
+    trans->reset();
+    MemoryTransaction *mem_ext = nullptr;
+    trans->get_extension(mem_ext);
+    if (mem_ext) {
+        mem_ext->reset();
+    } else {
+        trans->set_extension(new MemoryTransaction());
+    }
+
+    trans->set_command(tlm::TLM_IGNORE_COMMAND);
+    trans->set_address(0);
+    trans->set_data_ptr(nullptr);
+    trans->set_data_length(0);
+    trans->set_streaming_width(0);
+    trans->set_byte_enable_ptr(nullptr);
+    trans->set_byte_enable_length(0);
+    trans->set_dmi_allowed(false);
+    trans->set_response_status(tlm::TLM_INCOMPLETE_RESPONSE);
+
+    free_list.push_back(trans);
+    stats.released++;
+    stats.in_use--;
+}
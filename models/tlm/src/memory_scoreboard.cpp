@@ -63,13 +63,33 @@ void MemoryScoreboard::submit_request(const MemoryTransaction &req)
         }
         
         case MemoryTransaction::OP_TLB_LOAD: {
-            memory_model_error_t err = memory_model_load_tlb(ref_model,
-                                                            req.tlb_virt_base,
-                                                            req.tlb_phys_base);
+            memory_model_error_t err = req.tlb_span_bits != 0U
+                ? memory_model_load_tlb_range(ref_model, req.tlb_virt_base, req.tlb_phys_base, req.tlb_span_bits)
+                : memory_model_load_tlb(ref_model, req.tlb_virt_base, req.tlb_phys_base);
             expected->status = (err == MEMORY_MODEL_ERROR_OK) ?
                              MemoryTransaction::STATUS_OK : MemoryTransaction::STATUS_ERR_ACCESS;
             expected->tlb_virt_base = req.tlb_virt_base;
             expected->tlb_phys_base = req.tlb_phys_base;
+            expected->tlb_span_bits = req.tlb_span_bits;
+            break;
+        }
+        
+        case MemoryTransaction::OP_FLUSH: {
+            memory_model_error_t err = req.tlb_flush_all
+                ? memory_model_flush_tlb(ref_model)
+                : memory_model_flush_tlb_page(ref_model, req.virt_addr);
+            expected->status = (err == MEMORY_MODEL_ERROR_OK) ?
+                             MemoryTransaction::STATUS_OK : MemoryTransaction::STATUS_ERR_ACCESS;
+            expected->virt_addr = req.virt_addr;
+            expected->tlb_flush_all = req.tlb_flush_all;
+            break;
+        }
+        
+        case MemoryTransaction::OP_SET_ASID: {
+            memory_model_error_t err = memory_model_set_asid(ref_model, req.asid);
+            expected->status = (err == MEMORY_MODEL_ERROR_OK) ?
+                             MemoryTransaction::STATUS_OK : MemoryTransaction::STATUS_ERR_ACCESS;
+            expected->asid = req.asid;
             break;
         }
         
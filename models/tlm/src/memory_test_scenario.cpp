@@ -1,4 +1,6 @@
 #include "memory_test_scenario.h"
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 #include <iomanip>
 
@@ -6,13 +8,38 @@ MemoryTestScenario::MemoryTestScenario(sc_module_name name,
                                        MemoryInitiator *initiator,
                                        MemoryScoreboard *scoreboard)
     : sc_module(name), init(initiator), sb(scoreboard),
-      test_passed(true), test_count(0), tests_passed(0)
+      test_passed(true), test_count(0), tests_passed(0),
+      timed_latency(0x1000, 100000, 10000),  // Words below 0x1000 take 100 ns, the rest 10 ns
+      paced_latency(0, 0, 10000)             // Every word takes 10 ns
 {
+    narrow = create_loopback("narrow", 64U);
+    wide = create_loopback("wide", 128U);
+    timed = create_loopback("timed", 64U);
+    timed.target->set_timing_model(&timed_latency);
+    completing_init = new MemoryInitiator("completing_init");
+    completing_target = new CompletingTarget("completing_target", timed.model);
+    completing_init->socket.bind(completing_target->socket);
+    paced = create_loopback("paced", 64U, 16U);
+    paced.target->set_timing_model(&paced_latency);
     SC_THREAD(run_tests);
 }
 
 MemoryTestScenario::~MemoryTestScenario()
 {
+    delete narrow.init;
+    delete narrow.target;
+    memory_model_destroy(narrow.model);
+    delete wide.init;
+    delete wide.target;
+    memory_model_destroy(wide.model);
+    delete completing_init;
+    delete completing_target;
+    delete timed.init;
+    delete timed.target;
+    memory_model_destroy(timed.model);
+    delete paced.init;
+    delete paced.target;
+    memory_model_destroy(paced.model);
 }
 
 void MemoryTestScenario::run_tests()
@@ -30,6 +57,10 @@ void MemoryTestScenario::run_tests()
     test_masked_write();
     test_sequential_rw();
     test_error_handling();
+    test_short_blocks();
+    test_wide_words();
+    test_approximately_timed();
+    test_initiator_resources();
 
     // Print final results
     std::cout << "\n=== Memory TLM Test Scenario Complete ===" << std::endl;
@@ -178,11 +209,319 @@ void MemoryTestScenario::test_error_handling()
     else test_passed = false;
 }
 
+void MemoryTestScenario::test_short_blocks()
+{
+    std::cout << "\n>>> Test 7: Short Block Transfers" << std::endl;
+    
+    test_count++;
+    bool local_pass = true;
+    memory_model_t *model = narrow.model;
+
+    memory_model_load_tlb(model, 0x1000, 0x2000);
+    memory_model_write(model, 0x1000, 0xFF, 0x8877665544332211ULL);
+
+    // A three-byte block replaces the word's leading bytes only
+    const unsigned char short_bytes[] = {0xA0, 0xA1, 0xA2};
+    narrow.init->send_block_write(0x1000, std::vector<unsigned char>(short_bytes, short_bytes + 3));
+    wait_cycles(2);
+
+    // Exactly one word
+    std::vector<unsigned char> word_bytes(8);
+    for (size_t i = 0; i < word_bytes.size(); i++) {
+        word_bytes[i] = static_cast<unsigned char>(0xB0 + i);
+    }
+    narrow.init->send_block_write(0x1001, word_bytes);
+    wait_cycles(2);
+
+    std::vector<unsigned char> stored(16);
+    memory_model_read_block(model, 0x1000, stored.data(), stored.size());
+    const unsigned char first_word[] = {0xA0, 0xA1, 0xA2, 0x44, 0x55, 0x66, 0x77, 0x88};
+    std::vector<unsigned char> expected(first_word, first_word + 8);
+    expected.insert(expected.end(), word_bytes.begin(), word_bytes.end());
+    local_pass &= expect_bytes(stored, expected, "short block writes");
+
+    narrow.init->send_block_read(0x1000, 5);
+    wait_cycles(2);
+    local_pass &= expect_bytes(narrow.target->get_last_data(),
+                               std::vector<unsigned char>(first_word, first_word + 5), "five-byte block read");
+
+    narrow.init->send_block_read(0x1001, 8);
+    wait_cycles(2);
+    local_pass &= expect_bytes(narrow.target->get_last_data(), word_bytes, "one-word block read");
+
+    std::cout << "    Short block test completed" << std::endl;
+    log_test("Short Blocks", local_pass);
+    if (local_pass) tests_passed++;
+    else test_passed = false;
+}
+
+void MemoryTestScenario::test_wide_words()
+{
+    std::cout << "\n>>> Test 8: Byte-Enabled Wide Words" << std::endl;
+    
+    test_count++;
+    bool local_pass = true;
+
+    // At 64 bits a wide word is a single model word, which must still
+    // honour the byte enables
+    local_pass &= check_wide_words(narrow, 8);
+    local_pass &= check_wide_words(wide, 16);
+
+    std::cout << "    Wide word test completed" << std::endl;
+    log_test("Wide Words", local_pass);
+    if (local_pass) tests_passed++;
+    else test_passed = false;
+}
+
+bool MemoryTestScenario::check_wide_words(Loopback &lb, size_t word_bytes)
+{
+    const uint64_t addr = 0x1002;
+    bool pass = true;
+
+    memory_model_load_tlb(lb.model, 0x1000, 0x2000);
+    std::vector<unsigned char> expected(word_bytes);
+    for (size_t i = 0; i < word_bytes; i++) {
+        expected[i] = static_cast<unsigned char>(0x10 + i);
+    }
+    memory_model_write_block(lb.model, addr, expected.data(), expected.size());
+
+    // Even bytes only
+    std::vector<unsigned char> word(word_bytes);
+    uint64_t even_mask = 0;
+    for (size_t i = 0; i < word_bytes; i++) {
+        word[i] = static_cast<unsigned char>(0xC0 + i);
+        if (i % 2 == 0) {
+            even_mask |= 1ULL << i;
+            expected[i] = word[i];
+        }
+    }
+    lb.init->send_wide_write(addr, even_mask, word);
+    wait_cycles(2);
+
+    std::vector<unsigned char> stored(word_bytes);
+    memory_model_read_block(lb.model, addr, stored.data(), stored.size());
+    pass &= expect_bytes(stored, expected, "masked wide write");
+
+    // Low half only; disabled bytes keep the zeroed buffer
+    lb.init->send_wide_read(addr, (1ULL << (word_bytes / 2)) - 1, word_bytes);
+    wait_cycles(2);
+    std::fill(expected.begin() + word_bytes / 2, expected.end(), 0);
+    pass &= expect_bytes(lb.target->get_last_data(), expected, "masked wide read");
+    return pass;
+}
+
+void MemoryTestScenario::test_approximately_timed()
+{
+    std::cout << "\n>>> Test 9: Approximately-Timed Protocol" << std::endl;
+    
+    test_count++;
+    bool local_pass = true;
+    MemoryInitiator *at = timed.init;
+
+    // Virtual page 0 sits in the slow region, page 0x1000 in the fast one
+    memory_model_load_tlb(timed.model, 0x0000, 0x0000);
+    memory_model_load_tlb(timed.model, 0x1000, 0x1000);
+
+    // Back-pressure: the target accepts two requests and withholds END_REQ
+    // from the third, so the fourth never leaves the initiator and the slow
+    // writes take two 100 ns waves
+    at->set_max_outstanding(4);
+    timed.target->set_max_outstanding(2);
+    sc_time start = sc_time_stamp();
+    for (uint64_t i = 0; i < 4; i++) {
+        at->send_write(i, 0xFF, 0xD000 + i);
+    }
+    local_pass &= wait_for_responses(at, 4, 50);
+    sc_time elapsed = sc_time_stamp() - start;
+    if (timed.target->get_peak_outstanding() != 2 || at->get_peak_outstanding() != 3 ||
+        elapsed < sc_time(200, SC_NS)) {
+        std::cout << "    Back-pressure: target peak " << timed.target->get_peak_outstanding()
+                  << ", initiator peak " << at->get_peak_outstanding() << ", " << elapsed << std::endl;
+        local_pass = false;
+    }
+
+    // A full window of four: the fast write and read overtake the slow reads
+    // around them, and every read still sees the writes accepted before it
+    timed.target->set_max_outstanding(4);
+    uint64_t out_of_order = at->get_out_of_order_responses();
+    start = sc_time_stamp();
+    at->send_read(0x0000, 0xFF);
+    at->send_write(0x1000, 0xFF, 0xE000);
+    at->send_read(0x1000, 0xFF);
+    at->send_read(0x0003, 0xFF);
+    local_pass &= wait_for_responses(at, 8, 50);
+    elapsed = sc_time_stamp() - start;
+    if (timed.target->get_peak_outstanding() != 4 || at->get_peak_outstanding() != 4 ||
+        at->get_out_of_order_responses() <= out_of_order || elapsed >= sc_time(200, SC_NS)) {
+        std::cout << "    Full window: target peak " << timed.target->get_peak_outstanding()
+                  << ", initiator peak " << at->get_peak_outstanding() << ", "
+                  << (at->get_out_of_order_responses() - out_of_order) << " out of order, " << elapsed << std::endl;
+        local_pass = false;
+    }
+    local_pass &= expect_bytes(timed.target->get_data_at(0x0000), word_bytes_of(0xD000), "slow read");
+    local_pass &= expect_bytes(timed.target->get_data_at(0x1000), word_bytes_of(0xE000), "overtaking read");
+    local_pass &= expect_bytes(timed.target->get_data_at(0x0003), word_bytes_of(0xD003), "last slow read");
+
+    // TLM_COMPLETED to BEGIN_REQ ends the transaction without further phases
+    completing_init->send_write(0x1008, 0xFF, 0xF00D);
+    completing_init->send_read(0x1008, 0xFF);
+    local_pass &= wait_for_responses(completing_init, 2, 10);
+    uint64_t stored = 0;
+    memory_model_read(timed.model, 0x1008, 0xFF, &stored);
+    if (completing_target->get_completed() != 2 || completing_init->get_out_of_order_responses() != 0 ||
+        completing_target->get_last_read() != 0xF00D || stored != 0xF00D) {
+        std::cout << "    TLM_COMPLETED: " << completing_target->get_completed() << " completed, read 0x"
+                  << std::hex << completing_target->get_last_read() << ", stored 0x" << stored << std::dec
+                  << std::endl;
+        local_pass = false;
+    }
+
+    std::cout << "    Mean latency " << at->get_mean_latency() << " over " << at->get_responses()
+              << " responses" << std::endl;
+    log_test("Approximately Timed", local_pass);
+    if (local_pass) tests_passed++;
+    else test_passed = false;
+}
+
+void MemoryTestScenario::test_initiator_resources()
+{
+    std::cout << "\n>>> Test 10: Request Ring, Payload Pool and Quantum" << std::endl;
+    
+    test_count++;
+    bool local_pass = true;
+    MemoryInitiator *pi = paced.init;
+    const size_t depth = pi->get_queue_depth();
+    
+    memory_model_load_tlb(paced.model, 0x0000, 0x0000);
+    
+    // Approximately timed, one request in flight: a batch four times the
+    // ring runs out of credits, but every write and read still executes
+    std::vector<memory_model_transaction_t> ops(4 * depth);
+    const size_t half = ops.size() / 2;
+    for (size_t i = 0; i < ops.size(); i++) {
+        ops[i].op = i < half ? MEMORY_MODEL_OP_WRITE : MEMORY_MODEL_OP_READ;
+        ops[i].virt_addr = i % half;
+        ops[i].byte_mask = 0xFF;
+        ops[i].data = 0xA000 + i;
+    }
+    pi->send_batch(ops.data(), ops.size());
+    local_pass &= wait_for_responses(pi, ops.size(), 4 * ops.size());
+    if (pi->get_credit_stalls() == 0 || pi->get_peak_queued() != depth ||
+        paced.target->get_transactions_processed() != ops.size()) {
+        std::cout << "    Ring: " << pi->get_credit_stalls() << " credit stalls, peak " << pi->get_peak_queued()
+                  << " of " << depth << ", " << paced.target->get_transactions_processed() << " of "
+                  << ops.size() << " executed" << std::endl;
+        local_pass = false;
+    }
+    for (size_t i = 0; i < half; i++) {
+        local_pass &= expect_bytes(paced.target->get_data_at(i), word_bytes_of(0xA000 + i), "batched read");
+    }
+    
+    // Loosely timed: a batch that fits the ring runs without yielding, so the
+    // kernel sees one sync per quantum of annotated delay, not one per write
+    const sc_time saved_quantum = tlm_utils::tlm_quantumkeeper::get_global_quantum();
+    const sc_time quantum(40, SC_NS);
+    const uint64_t syncs_before = pi->get_quantum_syncs();
+    pi->set_quantum(quantum);
+    for (size_t i = 0; i < depth; i++) {
+        ops[i].op = MEMORY_MODEL_OP_WRITE;
+        ops[i].virt_addr = half + i;
+        ops[i].data = 0xB000 + i;
+    }
+    pi->send_batch(ops.data(), depth);
+    wait_cycles(2 * depth);
+    pi->set_quantum(SC_ZERO_TIME);
+    tlm_utils::tlm_quantumkeeper::set_global_quantum(saved_quantum);
+    
+    // The first quantum boundary falls wherever the run started, so allow one either side
+    const uint64_t syncs = pi->get_quantum_syncs() - syncs_before;
+    const uint64_t expected_syncs = static_cast<uint64_t>(sc_time(10, SC_NS) * static_cast<double>(depth) / quantum);
+    uint64_t last = 0;
+    memory_model_read(paced.model, half + depth - 1, 0xFF, &last);
+    if (syncs + 1 < expected_syncs || syncs > expected_syncs + 1 || last != 0xB000 + depth - 1) {
+        std::cout << "    Quantum: " << syncs << " syncs for " << depth << " writes, expected about "
+                  << expected_syncs << "; last word 0x" << std::hex << last << std::dec << std::endl;
+        local_pass = false;
+    }
+    
+    // Every payload went back to the pool, which never grew past what the
+    // ring, the request in flight and one blocked send could hold at once
+    const MemoryPayloadPoolStats &pool = pi->get_payload_pool_stats();
+    if (pool.in_use != 0 || pool.created != pool.peak_in_use || pool.created > depth + 2 ||
+        pool.recycled != pool.allocations - pool.created) {
+        std::cout << "    Pool: " << pool.created << " created, " << pool.allocations << " allocations, "
+                  << pool.recycled << " recycled, " << pool.in_use << " in use" << std::endl;
+        local_pass = false;
+    }
+    
+    log_test("Initiator Resources", local_pass);
+    if (local_pass) tests_passed++;
+    else test_passed = false;
+}
+
+MemoryTestScenario::Loopback MemoryTestScenario::create_loopback(const char *prefix, uint32_t data_width,
+                                                                 size_t queue_depth)
+{
+    Loopback lb = {nullptr, nullptr, nullptr};
+    memory_model_config_t cfg = memory_model_config_default();
+    cfg.data_width = data_width;
+    if (memory_model_create(&cfg, &lb.model) != MEMORY_MODEL_ERROR_OK) {
+        SC_REPORT_FATAL("MemoryTestScenario", "Failed to create loopback model");
+    }
+    
+    std::string name(prefix);
+    lb.init = new MemoryInitiator((name + "_init").c_str(), queue_depth);
+    lb.target = new RecordingTarget((name + "_target").c_str(), lb.model);
+    lb.init->socket.bind(lb.target->socket);
+    return lb;
+}
+
+bool MemoryTestScenario::expect_bytes(const std::vector<unsigned char> &actual,
+                                      const std::vector<unsigned char> &expected, const char *what)
+{
+    if (actual == expected) {
+        return true;
+    }
+    
+    std::cout << "    MISMATCH in " << what << ":" << std::hex << std::setfill('0');
+    for (size_t i = 0; i < actual.size(); i++) {
+        std::cout << " " << std::setw(2) << static_cast<unsigned int>(actual[i]);
+    }
+    std::cout << " (expected";
+    for (size_t i = 0; i < expected.size(); i++) {
+        std::cout << " " << std::setw(2) << static_cast<unsigned int>(expected[i]);
+    }
+    std::cout << ")" << std::dec << std::setfill(' ') << std::endl;
+    return false;
+}
+
 void MemoryTestScenario::wait_cycles(unsigned int n)
 {
     wait(n * 10, SC_NS);  // Assuming 10ns clock period
 }
 
+// Wait, a cycle at a time, until initiator has seen count responses in all
+bool MemoryTestScenario::wait_for_responses(MemoryInitiator *initiator, uint64_t count, unsigned int max_cycles)
+{
+    for (unsigned int i = 0; i < max_cycles && initiator->get_responses() < count; i++) {
+        wait_cycles(1);
+    }
+    if (initiator->get_responses() < count) {
+        std::cout << "    Timed out with " << initiator->get_responses() << " of " << count << " responses"
+                  << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// A 64-bit data word as it sits in a payload buffer
+std::vector<unsigned char> MemoryTestScenario::word_bytes_of(uint64_t value)
+{
+    std::vector<unsigned char> bytes(sizeof(value));
+    std::memcpy(bytes.data(), &value, sizeof(value));
+    return bytes;
+}
+
 void MemoryTestScenario::log_test(const std::string &name, bool passed)
 {
     std::cout << "    Result: " << (passed ? "PASS" : "FAIL") 
@@ -0,0 +1,84 @@
+#include "memory_timing.h"
+#include <algorithm>
+
+DramTimingModel::DramTimingModel(const DramTimingConfig &config)
+    : cfg(config), bus_free_ps(0), bus_used(false), bus_write(false)
+{
+    cfg.banks = std::max(cfg.banks, 1U);
+    cfg.row_words = std::max(cfg.row_words, 1U);
+    cfg.word_bytes = std::max(cfg.word_bytes, 1U);
+    cfg.burst_bytes = std::max(cfg.burst_bytes, 1U);
+    reset();
+}
+
+void DramTimingModel::reset()
+{
+    Bank idle = {false, 0, 0};
+    banks.assign(cfg.banks, idle);
+    bus_free_ps = 0;
+    bus_used = false;
+    bus_write = false;
+}
+
+uint64_t DramTimingModel::access(uint64_t phys_addr, bool is_write, uint64_t bytes, uint64_t issue_ps)
+{
+    uint64_t done_ps = issue_ps;
+    if (bytes == 0) {
+        return done_ps;
+    }
+
+    counters.accesses++;
+    // Each row the run touches is its own activate/column sequence
+    while (bytes > 0) {
+        uint64_t row_left = (cfg.row_words - phys_addr % cfg.row_words) * cfg.word_bytes;
+        uint64_t chunk = std::min(bytes, row_left);
+        done_ps = std::max(done_ps, access_row(phys_addr, is_write, chunk, issue_ps));
+        phys_addr += (chunk + cfg.word_bytes - 1) / cfg.word_bytes;
+        bytes -= chunk;
+    }
+    return done_ps;
+}
+
+uint64_t DramTimingModel::access_row(uint64_t phys_addr, bool is_write, uint64_t bytes, uint64_t issue_ps)
+{
+    uint64_t row_index = phys_addr / cfg.row_words;
+    Bank &bank = banks[row_index % cfg.banks];
+    uint64_t row = row_index / cfg.banks;
+    uint64_t start_ps = std::max(issue_ps, bank.ready_ps);
+
+    uint64_t cycles = cfg.t_cl;
+    if (!bank.open) {
+        cycles += cfg.t_rcd;
+        counters.row_empty++;
+    } else if (bank.row != row) {
+        cycles += cfg.t_rp + cfg.t_rcd;
+        counters.row_conflicts++;
+    } else {
+        counters.row_hits++;
+    }
+
+    uint64_t bus_ready_ps = bus_free_ps;
+    if (bus_used && bus_write != is_write) {
+        bus_ready_ps += cfg.t_turnaround * cfg.clock_ps;
+        counters.turnarounds++;
+    }
+    uint64_t data_ps = std::max(start_ps + cycles * cfg.clock_ps, bus_ready_ps);
+    uint64_t transfer_ps = (bytes + cfg.burst_bytes - 1) / cfg.burst_bytes * cfg.burst_cycles * cfg.clock_ps;
+    uint64_t done_ps = data_ps + transfer_ps;
+
+    bus_free_ps = done_ps;
+    bus_used = true;
+    bus_write = is_write;
+    counters.data_bus_ps += transfer_ps;
+
+    if (cfg.open_page) {
+        // The next column command may issue tCL ahead of this data finishing
+        bank.open = true;
+        bank.row = row;
+        bank.ready_ps = std::max(start_ps, done_ps - std::min(done_ps, cfg.t_cl * cfg.clock_ps));
+    } else {
+        bank.open = false;
+        bank.ready_ps = done_ps + cfg.t_rp * cfg.clock_ps;
+    }
+    return done_ps;
+}
@@ -1,4 +1,7 @@
 #include "memory_transactor.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <sstream>
 
@@ -6,25 +9,124 @@
 // MemoryInitiator Implementation
 // ============================================================================
 
-MemoryInitiator::MemoryInitiator(sc_module_name name)
-    : sc_module(name), socket("socket")
+MemoryInitiator::MemoryInitiator(sc_module_name name, size_t queue_depth)
+    : sc_module(name), socket("socket"), loosely_timed(false), quantum_syncs(0),
+      response_peq("response_peq"), request_in_progress(nullptr), max_outstanding(1),
+      peak_outstanding(0), responses(0), out_of_order_responses(0), total_latency(SC_ZERO_TIME),
+      request_ring(queue_depth != 0U ? queue_depth : 1U, nullptr), ring_head(0), ring_count(0),
+      batch_depth(0), producer_waiting(false), credit_stalls(0), peak_queued(0)
 {
+    socket.register_nb_transport_bw(this, &MemoryInitiator::nb_transport_bw);
     SC_THREAD(main_process);
+    SC_THREAD(response_process);
 }
 
 MemoryInitiator::~MemoryInitiator()
 {
-    // Clean up pending transactions
-    while (!pending_transactions.empty()) {
-        delete pending_transactions.front();
-        pending_transactions.pop();
+    // Return unsent transactions to the pool
+    while (ring_count > 0) {
+        take()->release();
+    }
+}
+
+void MemoryInitiator::set_quantum(const sc_time &quantum)
+{
+    loosely_timed = quantum > SC_ZERO_TIME;
+    if (loosely_timed) {
+        tlm_utils::tlm_quantumkeeper::set_global_quantum(quantum);
+        quantum_keeper.reset();
+    }
+}
+
+sc_time memory_quantum_from_args(int argc, char *argv[])
+{
+    static const char prefix[] = "--quantum=";
+    for (int i = 1; i < argc; i++) {
+        if (std::strncmp(argv[i], prefix, sizeof(prefix) - 1) == 0) {
+            double ns = std::atof(argv[i] + sizeof(prefix) - 1);
+            return ns > 0.0 ? sc_time(ns, SC_NS) : SC_ZERO_TIME;
+        }
+    }
+    return SC_ZERO_TIME;
+}
+
+void MemoryInitiator::post(transaction_type *trans)
+{
+    // Out of credits: hand the queue to main_process and wait for a slot.
+    // Only a thread can wait; anywhere else a full queue is a usage error.
+    while (ring_count == request_ring.size()) {
+        if (sc_get_current_process_handle().proc_kind() != SC_THREAD_PROC_) {
+            SC_REPORT_ERROR("MemoryInitiator", "Request queue full outside a thread; raise queue_depth");
+            trans->release();
+            return;
+        }
+        credit_stalls++;
+        producer_waiting = true;
+        transaction_available.notify();
+        wait(credit_available);
+    }
+
+    request_ring[(ring_head + ring_count) % request_ring.size()] = trans;
+    ring_count++;
+    peak_queued = std::max(peak_queued, ring_count);
+    if (batch_depth == 0) {
+        transaction_available.notify();
+    }
+}
+
+MemoryInitiator::transaction_type *MemoryInitiator::take()
+{
+    transaction_type *trans = request_ring[ring_head];
+    request_ring[ring_head] = nullptr;
+    ring_head = (ring_head + 1) % request_ring.size();
+    ring_count--;
+    if (producer_waiting) {
+        producer_waiting = false;
+        credit_available.notify();
+    }
+    return trans;
+}
+
+void MemoryInitiator::send_batch(const memory_model_transaction_t *ops, size_t count)
+{
+    batch_depth++;
+    for (size_t i = 0; i < count; i++) {
+        const memory_model_transaction_t &op = ops[i];
+        switch (op.op) {
+            case MEMORY_MODEL_OP_READ:
+                send_read(op.virt_addr, op.byte_mask);
+                break;
+            case MEMORY_MODEL_OP_WRITE:
+                send_write(op.virt_addr, op.byte_mask, op.data);
+                break;
+            case MEMORY_MODEL_OP_FLUSH:
+                if (op.byte_mask == 0U) {
+                    send_tlb_flush();
+                } else {
+                    send_tlb_flush_page(op.virt_addr);
+                }
+                break;
+            case MEMORY_MODEL_OP_TLB_LOAD:
+                send_tlb_load(op.virt_addr, op.data);
+                break;
+            case MEMORY_MODEL_OP_SET_ASID:
+                send_set_asid(static_cast<uint32_t>(op.data));
+                break;
+            default:
+                SC_REPORT_ERROR("MemoryInitiator", "Unknown operation in batch");
+                break;
+        }
+    }
+    batch_depth--;
+    if (batch_depth == 0 && ring_count > 0) {
+        transaction_available.notify();
     }
 }
 
 void MemoryInitiator::send_read(uint64_t virt_addr, uint32_t byte_mask)
 {
-    transaction_type *trans = new transaction_type();
-    MemoryTransaction *mem_ext = new MemoryTransaction();
+    MemoryTransaction *mem_ext = nullptr;
+    transaction_type *trans = payload_pool.allocate(mem_ext);
     
     mem_ext->op_type = MemoryTransaction::OP_READ;
     mem_ext->virt_addr = virt_addr;
@@ -36,16 +138,14 @@ void MemoryInitiator::send_read(uint64_t virt_addr, uint32_t byte_mask)
     trans->set_data_length(8);
     trans->set_data_ptr(reinterpret_cast<unsigned char *>(&mem_ext->data));
     trans->set_byte_enable_ptr(reinterpret_cast<unsigned char *>(&mem_ext->byte_mask));
-    trans->set_extension(mem_ext);
     
-    pending_transactions.push(trans);
-    transaction_available.notify();
+    post(trans);
 }
 
 void MemoryInitiator::send_write(uint64_t virt_addr, uint32_t byte_mask, uint64_t data)
 {
-    transaction_type *trans = new transaction_type();
-    MemoryTransaction *mem_ext = new MemoryTransaction();
+    MemoryTransaction *mem_ext = nullptr;
+    transaction_type *trans = payload_pool.allocate(mem_ext);
     
     mem_ext->op_type = MemoryTransaction::OP_WRITE;
     mem_ext->virt_addr = virt_addr;
@@ -58,85 +158,527 @@ void MemoryInitiator::send_write(uint64_t virt_addr, uint32_t byte_mask, uint64_
     trans->set_data_length(8);
     trans->set_data_ptr(reinterpret_cast<unsigned char *>(&mem_ext->data));
     trans->set_byte_enable_ptr(reinterpret_cast<unsigned char *>(&mem_ext->byte_mask));
-    trans->set_extension(mem_ext);
     
-    pending_transactions.push(trans);
-    transaction_available.notify();
+    post(trans);
 }
 
 void MemoryInitiator::send_tlb_load(uint64_t virt_base, uint64_t phys_base)
 {
-    transaction_type *trans = new transaction_type();
-    MemoryTransaction *mem_ext = new MemoryTransaction();
+    MemoryTransaction *mem_ext = nullptr;
+    transaction_type *trans = payload_pool.allocate(mem_ext);
+    
+    mem_ext->op_type = MemoryTransaction::OP_TLB_LOAD;
+    mem_ext->tlb_virt_base = virt_base;
+    mem_ext->tlb_phys_base = phys_base;
+    mem_ext->timestamp = sc_time_stamp().value();
+    
+    trans->set_address(0);
+    trans->set_read();
+    
+    post(trans);
+}
+
+void MemoryInitiator::send_tlb_load_range(uint64_t virt_base, uint64_t phys_base, uint32_t span_bits)
+{
+    MemoryTransaction *mem_ext = nullptr;
+    transaction_type *trans = payload_pool.allocate(mem_ext);
     
     mem_ext->op_type = MemoryTransaction::OP_TLB_LOAD;
     mem_ext->tlb_virt_base = virt_base;
     mem_ext->tlb_phys_base = phys_base;
+    mem_ext->tlb_span_bits = span_bits;
+    mem_ext->timestamp = sc_time_stamp().value();
+    
+    trans->set_address(0);
+    trans->set_read();
+    
+    post(trans);
+}
+
+void MemoryInitiator::send_tlb_flush()
+{
+    MemoryTransaction *mem_ext = nullptr;
+    transaction_type *trans = payload_pool.allocate(mem_ext);
+    
+    mem_ext->op_type = MemoryTransaction::OP_FLUSH;
+    mem_ext->tlb_flush_all = true;
+    mem_ext->timestamp = sc_time_stamp().value();
+    
+    trans->set_address(0);
+    trans->set_read();
+    
+    post(trans);
+}
+
+void MemoryInitiator::send_tlb_flush_page(uint64_t virt_addr)
+{
+    MemoryTransaction *mem_ext = nullptr;
+    transaction_type *trans = payload_pool.allocate(mem_ext);
+    
+    mem_ext->op_type = MemoryTransaction::OP_FLUSH;
+    mem_ext->tlb_flush_all = false;
+    mem_ext->virt_addr = virt_addr;
+    mem_ext->timestamp = sc_time_stamp().value();
+    
+    trans->set_address(virt_addr);
+    trans->set_read();
+    
+    post(trans);
+}
+
+void MemoryInitiator::send_set_asid(uint32_t asid)
+{
+    MemoryTransaction *mem_ext = nullptr;
+    transaction_type *trans = payload_pool.allocate(mem_ext);
+    
+    mem_ext->op_type = MemoryTransaction::OP_SET_ASID;
+    mem_ext->asid = asid;
     mem_ext->timestamp = sc_time_stamp().value();
     
     trans->set_address(0);
     trans->set_read();
-    trans->set_extension(mem_ext);
     
-    pending_transactions.push(trans);
-    transaction_available.notify();
+    post(trans);
+}
+
+void MemoryInitiator::send_block_read(uint64_t virt_addr, size_t length)
+{
+    post(make_block_read(virt_addr, length));
+}
+
+void MemoryInitiator::send_block_write(uint64_t virt_addr, const std::vector<unsigned char> &data)
+{
+    post(make_block_write(virt_addr, data));
+}
+
+MemoryInitiator::transaction_type *MemoryInitiator::make_block_read(uint64_t virt_addr, size_t length)
+{
+    MemoryTransaction *mem_ext = nullptr;
+    transaction_type *trans = payload_pool.allocate(mem_ext);
+    
+    mem_ext->op_type = MemoryTransaction::OP_READ;
+    mem_ext->virt_addr = virt_addr;
+    mem_ext->block_data.assign(length, 0);
+    mem_ext->timestamp = sc_time_stamp().value();
+    
+    trans->set_address(virt_addr);
+    trans->set_read();
+    trans->set_data_length(static_cast<unsigned int>(length));
+    trans->set_streaming_width(static_cast<unsigned int>(length));
+    trans->set_data_ptr(mem_ext->block_data.data());
+    trans->set_byte_enable_ptr(nullptr);
+    return trans;
+}
+
+MemoryInitiator::transaction_type *MemoryInitiator::make_block_write(uint64_t virt_addr,
+                                                                     const std::vector<unsigned char> &data)
+{
+    MemoryTransaction *mem_ext = nullptr;
+    transaction_type *trans = payload_pool.allocate(mem_ext);
+    
+    mem_ext->op_type = MemoryTransaction::OP_WRITE;
+    mem_ext->virt_addr = virt_addr;
+    mem_ext->block_data = data;
+    mem_ext->timestamp = sc_time_stamp().value();
+    
+    trans->set_address(virt_addr);
+    trans->set_write();
+    trans->set_data_length(static_cast<unsigned int>(data.size()));
+    trans->set_streaming_width(static_cast<unsigned int>(data.size()));
+    trans->set_data_ptr(mem_ext->block_data.data());
+    trans->set_byte_enable_ptr(nullptr);
+    return trans;
 }
 
-// No explicit interface methods needed - simple_initiator_socket handles this
+// Attach a byte-enable array for a partial wide-word mask; full masks need none
+static void attach_byte_enables(MemoryInitiator::transaction_type *trans, uint64_t byte_mask,
+                                size_t word_bytes)
+{
+    uint64_t full_mask = word_bytes >= 64 ? UINT64_MAX : (1ULL << word_bytes) - 1;
+    if (byte_mask == 0 || (byte_mask & full_mask) == full_mask) {
+        return;
+    }
+    
+    MemoryTransaction *mem_ext = nullptr;
+    trans->get_extension(mem_ext);
+    mem_ext->byte_enables.resize(word_bytes);
+    for (size_t b = 0; b < word_bytes; b++) {
+        mem_ext->byte_enables[b] = ((byte_mask >> b) & 1U) ? tlm::TLM_BYTE_ENABLED : tlm::TLM_BYTE_DISABLED;
+    }
+    trans->set_byte_enable_ptr(mem_ext->byte_enables.data());
+    trans->set_byte_enable_length(static_cast<unsigned int>(word_bytes));
+}
+
+void MemoryInitiator::send_wide_read(uint64_t virt_addr, uint64_t byte_mask, size_t word_bytes)
+{
+    // Complete the payload before it is posted; post() may drop it
+    transaction_type *trans = make_block_read(virt_addr, word_bytes);
+    attach_byte_enables(trans, byte_mask, word_bytes);
+    post(trans);
+}
+
+void MemoryInitiator::send_wide_write(uint64_t virt_addr, uint64_t byte_mask,
+                                      const std::vector<unsigned char> &word)
+{
+    transaction_type *trans = make_block_write(virt_addr, word);
+    attach_byte_enables(trans, byte_mask, word.size());
+    post(trans);
+}
 
 void MemoryInitiator::main_process()
 {
     while (true) {
-        wait(transaction_available | sc_event(sc_gen_unique_name("timeout")));
-        
-        while (!pending_transactions.empty()) {
-            transaction_type *trans = pending_transactions.front();
-            pending_transactions.pop();
-            
-            tlm::tlm_generic_payload *payload = trans;
-            tlm::tlm_phase phase = tlm::BEGIN_REQ;
-            sc_time delay = sc_time(0, SC_NS);
+        // Drain before waiting: requests posted while this thread was busy
+        // or before it first ran have already had their notification
+        while (ring_count > 0) {
+            transaction_type *trans = take();
             
-            socket->nb_transport_fw(*payload, phase, delay);
-            
-            delete trans;
+            if (loosely_timed) {
+                // The target adds its latency to our local time offset
+                sc_time delay = quantum_keeper.get_local_time();
+                socket->b_transport(*trans, delay);
+                quantum_keeper.set(delay);
+                if (quantum_keeper.need_sync()) {
+                    sync_local_time();
+                }
+                // The target may still hold a reference; the last one recycles it
+                trans->release();
+            } else {
+                // Released when its response completes
+                send_approximately_timed(trans);
+            }
+        }
+        
+        // Catch up before blocking, so new requests are not stamped in the past
+        if (loosely_timed && quantum_keeper.get_local_time() > SC_ZERO_TIME) {
+            sync_local_time();
+        }
+        if (ring_count == 0) {
+            wait(transaction_available);
+        }
+    }
+}
+
+void MemoryInitiator::sync_local_time()
+{
+    quantum_keeper.sync();
+    quantum_syncs++;
+}
+
+void MemoryInitiator::send_approximately_timed(transaction_type *trans)
+{
+    while (in_flight.size() >= max_outstanding) {
+        wait(response_done_event);
+    }
+    // The base protocol allows one request phase at a time per socket
+    while (request_in_progress) {
+        wait(end_req_event);
+    }
+
+    in_flight.push_back(std::make_pair(trans, sc_time_stamp()));
+    peak_outstanding = std::max(peak_outstanding, static_cast<unsigned int>(in_flight.size()));
+    request_in_progress = trans;
+
+    phase_type phase = tlm::BEGIN_REQ;
+    sc_time delay = SC_ZERO_TIME;
+    sync_enum_type status = socket->nb_transport_fw(*trans, phase, delay);
+
+    if (status == tlm::TLM_UPDATED) {
+        if (phase == tlm::END_REQ) {
+            request_in_progress = nullptr;
+            end_req_event.notify(delay);
+        } else if (phase == tlm::BEGIN_RESP) {
+            request_in_progress = nullptr;
+            end_req_event.notify(delay);
+            response_peq.notify(*trans, delay);
+        }
+    } else if (status == tlm::TLM_COMPLETED) {
+        // The target finished all four phases in one call
+        request_in_progress = nullptr;
+        end_req_event.notify(delay);
+        complete_response(*trans);
+    }
+}
+
+MemoryInitiator::sync_enum_type MemoryInitiator::nb_transport_bw(transaction_type &trans, phase_type &phase,
+                                                                 sc_time &delay)
+{
+    if (phase == tlm::END_REQ || phase == tlm::BEGIN_RESP) {
+        // BEGIN_RESP ends the request phase too if the target skipped END_REQ
+        if (&trans == request_in_progress) {
+            request_in_progress = nullptr;
+            end_req_event.notify(delay);
+        }
+        if (phase == tlm::BEGIN_RESP) {
+            response_peq.notify(trans, delay);
         }
+        return tlm::TLM_ACCEPTED;
     }
+
+    SC_REPORT_ERROR("MemoryInitiator", "Unexpected phase on the backward path");
+    return tlm::TLM_COMPLETED;
+}
+
+void MemoryInitiator::response_process()
+{
+    while (true) {
+        wait(response_peq.get_event());
+
+        transaction_type *trans;
+        while ((trans = response_peq.get_next_transaction()) != nullptr) {
+            phase_type phase = tlm::END_RESP;
+            sc_time delay = SC_ZERO_TIME;
+            socket->nb_transport_fw(*trans, phase, delay);
+            complete_response(*trans);
+        }
+    }
+}
+
+void MemoryInitiator::complete_response(transaction_type &trans)
+{
+    // Responses may overtake older requests, so match them by payload
+    for (auto it = in_flight.begin(); it != in_flight.end(); ++it) {
+        if (it->first == &trans) {
+            if (it != in_flight.begin()) {
+                out_of_order_responses++;
+            }
+            total_latency += sc_time_stamp() - it->second;
+            in_flight.erase(it);
+            break;
+        }
+    }
+    responses++;
+    response_done_event.notify(SC_ZERO_TIME);
+    trans.release();
 }
 
 // ============================================================================
 // MemoryTarget Implementation
 // ============================================================================
 
+// Timing models count whole picoseconds whatever the kernel's resolution
+static uint64_t time_to_ps(const sc_time &time)
+{
+    return static_cast<uint64_t>(time.to_seconds() * 1e12 + 0.5);
+}
+
 MemoryTarget::MemoryTarget(sc_module_name name, memory_model_t *model)
-    : sc_module(name), socket("socket"), mem_model(model),
-      transactions_processed(0), error_count(0)
+    : sc_module(name), socket("socket"), mem_model(model), rtl_model(nullptr), timing_model(nullptr),
+      dmi_read_latency(SC_ZERO_TIME), dmi_write_latency(SC_ZERO_TIME), dmi_granted(false),
+      dmi_start(0), dmi_end(0), dmi_epoch(0), transactions_processed(0), error_count(0),
+      request_peq("request_peq"), response_peq("response_peq"), response_in_progress(nullptr),
+      max_outstanding(1), outstanding(0), peak_outstanding(0)
 {
-    socket.register_b_transport(this, &MemoryTarget::process_transaction);
+    socket.register_b_transport(this, &MemoryTarget::b_transport);
+    socket.register_nb_transport_fw(this, &MemoryTarget::nb_transport_fw);
+    socket.register_get_direct_mem_ptr(this, &MemoryTarget::get_direct_mem_ptr);
+    SC_THREAD(request_thread);
+    SC_THREAD(response_thread);
 }
 
 MemoryTarget::~MemoryTarget()
 {
 }
 
+memory_model_error_t MemoryTarget::export_tlb(std::vector<memory_model_tlb_entry_t> &entries,
+                                             uint32_t *write_index)
+{
+    if (rtl_model) {
+        entries.resize(RtlMemoryModel::tlb_capacity());
+        return rtl_model->export_tlb(entries.data(), static_cast<uint32_t>(entries.size()), write_index);
+    }
+    if (!mem_model) {
+        return MEMORY_MODEL_ERROR_BAD_ARGUMENT;
+    }
+    entries.resize(memory_model_tlb_capacity(mem_model));
+    return memory_model_export_tlb(mem_model, entries.data(), static_cast<uint32_t>(entries.size()), write_index);
+}
+
+memory_model_error_t MemoryTarget::import_tlb(const std::vector<memory_model_tlb_entry_t> &entries,
+                                             uint32_t write_index)
+{
+    uint32_t count = static_cast<uint32_t>(entries.size());
+    if (rtl_model) {
+        return rtl_model->import_tlb(entries.data(), count, write_index);
+    }
+    if (!mem_model) {
+        return MEMORY_MODEL_ERROR_BAD_ARGUMENT;
+    }
+    memory_model_error_t err = memory_model_import_tlb(mem_model, entries.data(), count, write_index);
+    refresh_dmi();
+    return err;
+}
+
+bool MemoryTarget::get_direct_mem_ptr(transaction_type &trans, tlm::tlm_dmi &dmi)
+{
+    // The default dmi denies every address
+    if (!dmi_supported()) {
+        return false;
+    }
+    
+    uint64_t virt_addr = trans.get_address();
+    memory_model_direct_t direct;
+    if (memory_model_get_direct(mem_model, virt_addr, &direct) != MEMORY_MODEL_STATUS_OK) {
+        dmi.set_start_address(virt_addr);
+        dmi.set_end_address(virt_addr);
+        return false;
+    }
+    
+    uint64_t start = direct.virt_base;
+    uint64_t end = direct.virt_base + direct.words - 1U;
+    dmi.set_dmi_ptr(direct.host);
+    dmi.set_start_address(start);
+    dmi.set_end_address(end);
+    dmi.allow_read_write();
+    dmi.set_read_latency(dmi_read_latency);
+    dmi.set_write_latency(dmi_write_latency);
+    
+    // Grants issued in one epoch are revoked together
+    uint64_t epoch = memory_model_direct_epoch(mem_model);
+    if (!dmi_granted || epoch != dmi_epoch) {
+        refresh_dmi();
+        dmi_granted = true;
+        dmi_start = start;
+        dmi_end = end;
+        dmi_epoch = epoch;
+    } else {
+        dmi_start = std::min(dmi_start, start);
+        dmi_end = std::max(dmi_end, end);
+    }
+    return true;
+}
+
+void MemoryTarget::refresh_dmi()
+{
+    if (dmi_granted && (!mem_model || memory_model_direct_epoch(mem_model) != dmi_epoch)) {
+        dmi_granted = false;
+        socket->invalidate_direct_mem_ptr(dmi_start, dmi_end);
+    }
+}
+
+MemoryTarget::sync_enum_type MemoryTarget::nb_transport_fw(transaction_type &trans, phase_type &phase,
+                                                           sc_time &delay)
+{
+    if (phase == tlm::BEGIN_REQ) {
+        // Held until END_RESP; END_REQ waits for a free slot
+        if (trans.has_mm()) {
+            trans.acquire();
+        }
+        request_peq.notify(trans, delay);
+        return tlm::TLM_ACCEPTED;
+    }
+    if (phase == tlm::END_RESP && &trans == response_in_progress) {
+        finish_response(trans);
+        return tlm::TLM_COMPLETED;
+    }
+
+    SC_REPORT_ERROR("MemoryTarget", "Unexpected phase on the forward path");
+    return tlm::TLM_COMPLETED;
+}
+
+void MemoryTarget::request_thread()
+{
+    while (true) {
+        wait(request_peq.get_event());
+
+        transaction_type *trans;
+        while ((trans = request_peq.get_next_transaction()) != nullptr) {
+            while (outstanding >= max_outstanding) {
+                wait(slot_freed);
+            }
+            outstanding++;
+            peak_outstanding = std::max(peak_outstanding, outstanding);
+
+            phase_type phase = tlm::END_REQ;
+            sc_time delay = SC_ZERO_TIME;
+            socket->nb_transport_bw(*trans, phase, delay);
+
+            // The model acts on acceptance; the response is due once its latency elapses
+            sc_time latency = SC_ZERO_TIME;
+            execute_transaction(*trans, latency);
+            response_peq.notify(*trans, latency);
+        }
+    }
+}
+
+void MemoryTarget::response_thread()
+{
+    while (true) {
+        wait(response_peq.get_event());
+
+        transaction_type *trans;
+        while ((trans = response_peq.get_next_transaction()) != nullptr) {
+            // One response phase at a time; the rest queue in completion order
+            while (response_in_progress) {
+                wait(end_resp_received);
+            }
+            response_in_progress = trans;
+
+            phase_type phase = tlm::BEGIN_RESP;
+            sc_time delay = SC_ZERO_TIME;
+            sync_enum_type status = socket->nb_transport_bw(*trans, phase, delay);
+            if (status == tlm::TLM_COMPLETED || (status == tlm::TLM_UPDATED && phase == tlm::END_RESP)) {
+                finish_response(*trans);
+            }
+        }
+    }
+}
+
+void MemoryTarget::finish_response(transaction_type &trans)
+{
+    response_in_progress = nullptr;
+    outstanding--;
+    slot_freed.notify(SC_ZERO_TIME);
+    end_resp_received.notify(SC_ZERO_TIME);
+    if (trans.has_mm()) {
+        trans.release();
+    }
+}
+
 void MemoryTarget::process_transaction(transaction_type &trans, sc_time &delay)
 {
     MemoryTransaction *mem_ext = nullptr;
     trans.get_extension(mem_ext);
     
-    if (!mem_ext || !mem_model) {
+    if (!mem_model && !rtl_model) {
         trans.set_response_status(tlm::TLM_GENERIC_ERROR_RESPONSE);
         return;
     }
     
+    // Plain generic payloads and block transfers, whose data lives in the
+    // payload's buffer rather than the extension's data word, go through the
+    // block path whatever their length; the extension, if any, only receives
+    // the resulting status. Their cache activity shows up in
+    // get_model_stats() alone.
+    bool is_block = mem_ext &&
+                    trans.get_data_ptr() != reinterpret_cast<unsigned char *>(&mem_ext->data) &&
+                    (mem_ext->op_type == MemoryTransaction::OP_READ ||
+                     mem_ext->op_type == MemoryTransaction::OP_WRITE);
+    if (!mem_ext || is_block) {
+        memory_model_status_t block_status = process_payload(trans);
+        if (timing_model && block_status == MEMORY_MODEL_STATUS_OK && (trans.is_read() || trans.is_write())) {
+            uint64_t issue_ps = time_to_ps(sc_time_stamp() + delay);
+            uint64_t done_ps = time_block(trans.get_address(), trans.get_data_length(), trans.is_write(), issue_ps);
+            delay += sc_time(static_cast<double>(done_ps - issue_ps), SC_PS);
+        }
+        if (mem_ext) {
+            mem_ext->status = static_cast<MemoryTransaction::StatusCode>(block_status);
+            mem_ext->cache_result = MemoryTransaction::CACHE_NONE;
+            mem_ext->response_ready = true;
+        }
+        refresh_dmi();
+        return;
+    }
+    
     memory_model_status_t status;
     
     switch (mem_ext->op_type) {
         case MemoryTransaction::OP_READ: {
             uint64_t data = 0;
-            status = memory_model_read(mem_model, mem_ext->virt_addr, 
-                                      mem_ext->byte_mask, &data);
+            memory_model_cache_result_t cache = MEMORY_MODEL_CACHE_NONE;
+            status = model_read(mem_ext->virt_addr, mem_ext->byte_mask, &data, &cache);
             mem_ext->data = data;
+            mem_ext->cache_result = static_cast<MemoryTransaction::CacheResult>(cache);
             mem_ext->status = static_cast<MemoryTransaction::StatusCode>(status);
             mem_ext->response_ready = true;
             transactions_processed++;
@@ -147,8 +689,9 @@ void MemoryTarget::process_transaction(transaction_type &trans, sc_time &delay)
         }
         
         case MemoryTransaction::OP_WRITE: {
-            status = memory_model_write(mem_model, mem_ext->virt_addr,
-                                       mem_ext->byte_mask, mem_ext->data);
+            memory_model_cache_result_t cache = MEMORY_MODEL_CACHE_NONE;
+            status = model_write(mem_ext->virt_addr, mem_ext->byte_mask, mem_ext->data, &cache);
+            mem_ext->cache_result = static_cast<MemoryTransaction::CacheResult>(cache);
             mem_ext->status = static_cast<MemoryTransaction::StatusCode>(status);
             mem_ext->response_ready = true;
             transactions_processed++;
@@ -159,9 +702,9 @@ void MemoryTarget::process_transaction(transaction_type &trans, sc_time &delay)
         }
         
         case MemoryTransaction::OP_TLB_LOAD: {
-            memory_model_error_t err = memory_model_load_tlb(mem_model,
-                                                            mem_ext->tlb_virt_base,
-                                                            mem_ext->tlb_phys_base);
+            memory_model_error_t err = model_load_tlb(mem_ext->tlb_virt_base,
+                                                      mem_ext->tlb_phys_base,
+                                                      mem_ext->tlb_span_bits);
             mem_ext->status = (err == MEMORY_MODEL_ERROR_OK) ? 
                              MemoryTransaction::STATUS_OK : MemoryTransaction::STATUS_ERR_ACCESS;
             mem_ext->response_ready = true;
@@ -172,15 +715,232 @@ void MemoryTarget::process_transaction(transaction_type &trans, sc_time &delay)
             break;
         }
         
+        case MemoryTransaction::OP_FLUSH: {
+            memory_model_error_t err = model_flush_tlb(mem_ext->tlb_flush_all, mem_ext->virt_addr);
+            mem_ext->status = (err == MEMORY_MODEL_ERROR_OK) ?
+                             MemoryTransaction::STATUS_OK : MemoryTransaction::STATUS_ERR_ACCESS;
+            mem_ext->response_ready = true;
+            transactions_processed++;
+            if (err != MEMORY_MODEL_ERROR_OK) {
+                error_count++;
+            }
+            break;
+        }
+        
+        case MemoryTransaction::OP_SET_ASID: {
+            memory_model_error_t err = model_set_asid(mem_ext->asid);
+            mem_ext->status = (err == MEMORY_MODEL_ERROR_OK) ?
+                             MemoryTransaction::STATUS_OK : MemoryTransaction::STATUS_ERR_ACCESS;
+            mem_ext->response_ready = true;
+            transactions_processed++;
+            if (err != MEMORY_MODEL_ERROR_OK) {
+                error_count++;
+            }
+            break;
+        }
+        
         default:
             error_count++;
             trans.set_response_status(tlm::TLM_GENERIC_ERROR_RESPONSE);
             return;
     }
     
+    // TLB operations, and walker fills during accesses, may revoke grants
+    refresh_dmi();
+    
+    bool is_access = mem_ext->op_type == MemoryTransaction::OP_READ || mem_ext->op_type == MemoryTransaction::OP_WRITE;
+    uint64_t phys_addr = 0;
+    if (is_access && mem_ext->status == MemoryTransaction::STATUS_OK &&
+        model_lookup(mem_ext->virt_addr, &phys_addr) == MEMORY_MODEL_STATUS_OK) {
+        mem_ext->phys_addr = phys_addr;
+        trans.set_dmi_allowed(dmi_supported());
+        // A write with no byte enabled never reaches memory
+        bool is_write = mem_ext->op_type == MemoryTransaction::OP_WRITE;
+        if (timing_model && !(is_write && mem_ext->byte_mask == 0U)) {
+            uint64_t issue_ps = time_to_ps(sc_time_stamp() + delay);
+            uint64_t done_ps = time_word(phys_addr, is_write,
+                                         static_cast<memory_model_cache_result_t>(mem_ext->cache_result), issue_ps);
+            delay += sc_time(static_cast<double>(done_ps - issue_ps), SC_PS);
+        }
+    }
+    
     trans.set_response_status(tlm::TLM_OK_RESPONSE);
 }
 
+// Memory traffic behind one word access, given its cache outcome
+uint64_t MemoryTarget::time_word(uint64_t phys_addr, bool is_write, memory_model_cache_result_t cache,
+                                 uint64_t issue_ps)
+{
+    if (rtl_model) {
+        return timing_model->access(phys_addr, is_write, RtlMemoryModel::kBytesPerWord, issue_ps);
+    }
+    
+    const memory_model_config_t *cfg = memory_model_get_config(mem_model);
+    uint64_t word_bytes = cfg->data_width / 8U;
+    if (cfg->cache_size == 0U || (is_write && cfg->cache_write_policy == MEMORY_MODEL_CACHE_WRITE_THROUGH)) {
+        return timing_model->access(phys_addr, is_write, word_bytes, issue_ps);
+    }
+    if (cache != MEMORY_MODEL_CACHE_MISS && cache != MEMORY_MODEL_CACHE_MISS_WRITEBACK) {
+        return issue_ps;
+    }
+    
+    // The victim's address is not reported, so its writeback is charged to
+    // the incoming line: that costs the bus time and turnaround it would.
+    uint64_t line_words = cfg->cache_line_size / word_bytes;
+    uint64_t line_addr = phys_addr & ~(line_words - 1U);
+    if (cache == MEMORY_MODEL_CACHE_MISS_WRITEBACK) {
+        issue_ps = timing_model->access(line_addr, true, cfg->cache_line_size, issue_ps);
+    }
+    return timing_model->access(line_addr, false, cfg->cache_line_size, issue_ps);
+}
+
+// A burst of length bytes from virt_addr, one memory access per page run
+uint64_t MemoryTarget::time_block(uint64_t virt_addr, uint64_t length, bool is_write, uint64_t issue_ps)
+{
+    uint64_t bytes_per_word = rtl_model ? RtlMemoryModel::kBytesPerWord
+                                        : memory_model_get_config(mem_model)->data_width / 8U;
+    uint64_t page_words = rtl_model ? (1ULL << RtlMemoryModel::kPageOffsetBits)
+                                    : memory_model_get_config(mem_model)->page_size;
+    uint64_t done_ps = issue_ps;
+    
+    while (length > 0) {
+        uint64_t run_words = page_words - (virt_addr & (page_words - 1U));
+        uint64_t run_bytes = std::min(length, run_words * bytes_per_word);
+        uint64_t phys_addr;
+        if (model_lookup(virt_addr, &phys_addr) == MEMORY_MODEL_STATUS_OK) {
+            done_ps = std::max(done_ps, timing_model->access(phys_addr, is_write, run_bytes, issue_ps));
+        }
+        virt_addr += run_words;
+        length -= run_bytes;
+    }
+    return done_ps;
+}
+
+memory_model_status_t MemoryTarget::process_payload(transaction_type &trans)
+{
+    memory_model_status_t status = MEMORY_MODEL_STATUS_OK;
+    
+    if (trans.is_read() || trans.is_write()) {
+        uint32_t bytes_per_word = rtl_model ? RtlMemoryModel::kBytesPerWord
+                                            : memory_model_get_config(mem_model)->data_width / 8U;
+        
+        // Streaming (FIFO-style) bursts have no meaning for a flat memory
+        if (trans.get_streaming_width() != 0U &&
+            trans.get_streaming_width() < trans.get_data_length()) {
+            error_count++;
+            trans.set_response_status(tlm::TLM_BURST_ERROR_RESPONSE);
+            return MEMORY_MODEL_STATUS_ERR_ACCESS;
+        }
+        
+        if (trans.get_byte_enable_ptr() && trans.get_byte_enable_length() != 0U) {
+            status = process_byte_enabled(trans, bytes_per_word, trans.get_byte_enable_ptr(),
+                                          trans.get_byte_enable_length());
+        } else if (rtl_model) {
+            static const unsigned char all_enabled = tlm::TLM_BYTE_ENABLED;
+            status = process_byte_enabled(trans, bytes_per_word, &all_enabled, 1U);
+        } else if (trans.is_read()) {
+            status = memory_model_read_block(mem_model, trans.get_address(),
+                                             trans.get_data_ptr(), trans.get_data_length());
+        } else {
+            status = memory_model_write_block(mem_model, trans.get_address(),
+                                              trans.get_data_ptr(), trans.get_data_length());
+        }
+    }
+    
+    transactions_processed++;
+    switch (status) {
+        case MEMORY_MODEL_STATUS_OK:
+            trans.set_response_status(tlm::TLM_OK_RESPONSE);
+            break;
+        case MEMORY_MODEL_STATUS_ERR_ADDR:
+            error_count++;
+            trans.set_response_status(tlm::TLM_ADDRESS_ERROR_RESPONSE);
+            break;
+        default:
+            error_count++;
+            trans.set_response_status(tlm::TLM_GENERIC_ERROR_RESPONSE);
+            break;
+    }
+    return status;
+}
+
+memory_model_status_t MemoryTarget::process_byte_enabled(transaction_type &trans,
+                                                         uint32_t bytes_per_word,
+                                                         const unsigned char *be,
+                                                         unsigned int be_length)
+{
+    unsigned char *data = trans.get_data_ptr();
+    unsigned int length = trans.get_data_length();
+    uint64_t virt_addr = trans.get_address();
+    
+    // The byte-enable pattern repeats across the burst, so each word gets the
+    // mask of its own byte positions rather than a single shared mask.
+    for (unsigned int offset = 0; offset < length; offset += bytes_per_word, virt_addr++) {
+        unsigned int word_bytes = std::min(bytes_per_word, length - offset);
+        uint64_t byte_mask = 0;
+        unsigned char word[MEMORY_MODEL_MAX_WORD_BYTES] = {};
+        
+        for (unsigned int b = 0; b < word_bytes; b++) {
+            if (be[(offset + b) % be_length] != tlm::TLM_BYTE_DISABLED) {
+                byte_mask |= 1ULL << b;
+            }
+        }
+        if (byte_mask == 0U) {
+            continue;
+        }
+        
+        memory_model_status_t status;
+        if (trans.is_read()) {
+            status = model_read_word(virt_addr, byte_mask, word);
+            if (status != MEMORY_MODEL_STATUS_OK) {
+                return status;
+            }
+            for (unsigned int b = 0; b < word_bytes; b++) {
+                if ((byte_mask >> b) & 1U) {
+                    data[offset + b] = word[b];
+                }
+            }
+        } else {
+            std::memcpy(word, data + offset, word_bytes);
+            status = model_write_word(virt_addr, byte_mask, word);
+            if (status != MEMORY_MODEL_STATUS_OK) {
+                return status;
+            }
+        }
+    }
+    return MEMORY_MODEL_STATUS_OK;
+}
+
+// Whole-word access at any data width; the RTL-geometry model has 64-bit words
+memory_model_status_t MemoryTarget::model_read_word(uint64_t virt_addr, uint64_t byte_mask,
+                                                    unsigned char *word)
+{
+    if (!rtl_model) {
+        return memory_model_read_wide(mem_model, virt_addr, byte_mask, word);
+    }
+    
+    uint64_t value = 0;
+    memory_model_status_t status = model_read(virt_addr, static_cast<uint32_t>(byte_mask), &value);
+    for (unsigned int b = 0; b < RtlMemoryModel::kBytesPerWord; b++) {
+        word[b] = static_cast<unsigned char>(value >> (8U * b));
+    }
+    return status;
+}
+
+memory_model_status_t MemoryTarget::model_write_word(uint64_t virt_addr, uint64_t byte_mask,
+                                                     const unsigned char *word)
+{
+    if (!rtl_model) {
+        return memory_model_write_wide(mem_model, virt_addr, byte_mask, word);
+    }
+    
+    uint64_t value = 0;
+    for (unsigned int b = 0; b < RtlMemoryModel::kBytesPerWord; b++) {
+        value |= static_cast<uint64_t>(word[b]) << (8U * b);
+    }
+    return model_write(virt_addr, static_cast<uint32_t>(byte_mask), value);
+}
+
 // ============================================================================
 // MemoryMonitor Implementation
 // ============================================================================
@@ -15,7 +15,7 @@ class MemoryTLMDPITestBench : public sc_module {
 public:
     // Constructor
     SC_HAS_PROCESS(MemoryTLMDPITestBench);
-    MemoryTLMDPITestBench(sc_module_name name) : sc_module(name) {
+    MemoryTLMDPITestBench(sc_module_name name, const sc_time& quantum = SC_ZERO_TIME) : sc_module(name) {
         
         cout << "=== Memory TLM-DPI Testbench ===" << endl;
         cout << "SystemC Version: " << SC_VERSION << endl;
@@ -49,6 +49,9 @@ public:
         // Bind initiator to DPI bridge (instead of regular target)
         initiator->socket.bind(dpi_bridge->socket);
         
+        // A non-zero quantum sends over b_transport with temporal decoupling
+        initiator->set_quantum(quantum);
+        
         // Connect scoreboard to monitor transactions
         initiator->ap.bind(*scoreboard);
         
@@ -115,8 +118,8 @@ protected:
         cout << "Active TLB Entries: " << tlb_entries << endl;
         
         // Reference model statistics
-        memory_stats_t ref_stats;
-        if (memory_model_get_stats(ref_model, &ref_stats) == MEMORY_OK) {
+        memory_model_stats_t ref_stats;
+        if (memory_model_get_stats(ref_model, &ref_stats) == MEMORY_MODEL_ERROR_OK) {
             cout << "Reference Model Statistics:" << endl;
             cout << "  Reads: " << ref_stats.read_count << endl;
             cout << "  Writes: " << ref_stats.write_count << endl;
@@ -155,8 +158,8 @@ private:
 // Main function for standalone execution
 int sc_main(int argc, char* argv[]) {
     try {
-        // Create testbench
-        MemoryTLMDPITestBench testbench("testbench");
+        // Create testbench; --quantum=<ns> selects loosely-timed transport
+        MemoryTLMDPITestBench testbench("testbench", memory_quantum_from_args(argc, argv));
         
         // Start simulation
         cout << "\nStarting simulation..." << endl;
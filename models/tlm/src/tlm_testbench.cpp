@@ -3,7 +3,7 @@
 #include "memory_transactor.h"
 #include "memory_scoreboard.h"
 #include "memory_test_scenario.h"
-#include "memory_model.h"
+#include "memory_model.hpp"
 
 /**
  * @brief Top-level TLM testbench
@@ -13,13 +13,15 @@
  * - MemoryTarget: TLM slave that processes transactions using the reference model
  * - MemoryScoreboard: Verification component that checks responses
  * - MemoryTestScenario: Test driver that exercises the system
+ *
+ * A non-zero quantum runs the initiator loosely timed over b_transport.
  */
 class MemoryTLMTestBench : public sc_module
 {
 public:
     SC_HAS_PROCESS(MemoryTLMTestBench);
     
-    MemoryTLMTestBench(sc_module_name name)
+    MemoryTLMTestBench(sc_module_name name, const sc_time &quantum = SC_ZERO_TIME)
         : sc_module(name)
     {
         // Create components
@@ -31,12 +33,10 @@ public:
         // Connect initiator to target via TLM
         initiator->socket.bind(target->socket);
         
-        // Create reference model for the target
-        memory_model_t *ref_model = nullptr;
-        memory_model_config_t cfg = memory_model_config_default();
-        if (memory_model_create(&cfg, &ref_model) == MEMORY_MODEL_ERROR_OK) {
-            target->set_memory_model(ref_model);
-        }
+        // The target runs the default RTL geometry, so use the inlined model
+        target->set_rtl_model(&target_model);
+        
+        initiator->set_quantum(quantum);
         
         SC_THREAD(monitor_process);
     }
@@ -54,6 +54,7 @@ private:
     MemoryTarget *target;
     MemoryScoreboard *scoreboard;
     MemoryTestScenario *test_scenario;
+    RtlMemoryModel target_model;
     
     void monitor_process()
     {
@@ -76,8 +77,14 @@ int sc_main(int argc, char *argv[])
     std::cout << "SystemC Version: " << SC_VERSION << std::endl;
     std::cout << std::endl;
     
+    // --quantum=<ns> selects loosely-timed transport with that global quantum
+    sc_time quantum = memory_quantum_from_args(argc, argv);
+    if (quantum > SC_ZERO_TIME) {
+        std::cout << "Loosely timed, global quantum " << quantum << std::endl;
+    }
+    
     // Create the testbench
-    MemoryTLMTestBench tb("tb");
+    MemoryTLMTestBench tb("tb", quantum);
     
     // Run simulation
     std::cout << "Starting simulation..." << std::endl;
@@ -16,7 +16,8 @@ package memory_pkg;
     MEM_READ    = 4'h0,
     MEM_WRITE   = 4'h1,
     MEM_FLUSH   = 4'h2,
-    MEM_TLB_LD  = 4'h3
+    MEM_TLB_LD  = 4'h3,
+    MEM_SET_ASID = 4'h4
   } mem_command_e;
 
   // Response status codes
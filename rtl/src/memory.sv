@@ -10,7 +10,21 @@ module memory
   parameter int MEM_DEPTH = 16384,
   parameter int PAGE_SIZE = 4096,
   parameter int DATA_WIDTH = 64,
-  parameter int PT_ENTRIES = 256
+  parameter int PT_ENTRIES = 256,
+  // Width of the per-entry span field. An entry loaded with span s maps
+  // PAGE_SIZE << s addresses; 0 keeps every entry a single page.
+  parameter int TLB_SPAN_WIDTH = 0,
+  // Width of the address space identifier. Entries are tagged with the ASID
+  // current when they were loaded and only translate while it is current;
+  // 0 leaves a single address space.
+  parameter int ASID_WIDTH = 0,
+  // Ways per TLB set. An entry lives in the set selected by the virtual
+  // address bits just above its span, and lookups compare one set per span
+  // value; 0 (or PT_ENTRIES) keeps the TLB fully associative. PT_ENTRIES /
+  // TLB_WAYS must be a power of two.
+  parameter int TLB_WAYS = 0,
+  localparam int TLB_SPAN_PORT_WIDTH = (TLB_SPAN_WIDTH > 0) ? TLB_SPAN_WIDTH : 1,
+  localparam int ASID_PORT_WIDTH = (ASID_WIDTH > 0) ? ASID_WIDTH : 1
 ) (
   input  logic                          clk,
   input  logic                          rst_n,
@@ -43,10 +57,23 @@ module memory
   input  logic                          tlb_load_valid,
   input  logic [VIRT_ADDR_WIDTH-1:0]   tlb_load_virt_base,
   input  logic [PHYS_ADDR_WIDTH-1:0]   tlb_load_phys_base,
+  input  logic [TLB_SPAN_PORT_WIDTH-1:0] tlb_load_span,
   output logic                          tlb_load_ready,
+
+  // TLB flush (MEM_FLUSH): all entries, or those translating tlb_flush_addr
+  input  logic                          tlb_flush_valid,
+  input  logic                          tlb_flush_all,
+  input  logic [VIRT_ADDR_WIDTH-1:0]   tlb_flush_addr,
+  output logic                          tlb_flush_ready,
+
+  // Address space switch (MEM_SET_ASID)
+  input  logic                          asid_set_valid,
+  input  logic [ASID_PORT_WIDTH-1:0]    asid_set_value,
+  output logic                          asid_set_ready,
   
   // Control/Status
-  output logic [$clog2(PT_ENTRIES)-1:0] tlb_num_entries
+  output logic [$clog2(PT_ENTRIES)-1:0] tlb_num_entries,
+  output logic [ASID_PORT_WIDTH-1:0]    current_asid
 );
 
   // Status code constants
@@ -60,6 +87,13 @@ module memory
   localparam int PHYS_PAGE_BITS = PHYS_ADDR_WIDTH - PAGE_OFFSET_WIDTH;
   localparam int MEM_ADDR_WIDTH = $clog2(MEM_DEPTH);
 
+  // TLB set geometry
+  localparam bit TLB_SET_ASSOC = (TLB_WAYS > 0) && (TLB_WAYS < PT_ENTRIES);
+  localparam int TLB_WAY_COUNT = TLB_SET_ASSOC ? TLB_WAYS : PT_ENTRIES;
+  localparam int TLB_SETS = PT_ENTRIES / TLB_WAY_COUNT;
+  localparam int TLB_WAY_BITS = (TLB_WAY_COUNT > 1) ? $clog2(TLB_WAY_COUNT) : 1;
+  localparam int TLB_SPAN_VALUES = 1 << TLB_SPAN_WIDTH;
+
   // Memory storage
   logic [DATA_WIDTH-1:0] mem_array [0:MEM_DEPTH-1];
 
@@ -67,7 +101,12 @@ module memory
   logic [VIRT_ADDR_WIDTH-1:0] tlb_virt [0:PT_ENTRIES-1];
   logic [PHYS_ADDR_WIDTH-1:0] tlb_phys [0:PT_ENTRIES-1];
   logic tlb_valid [0:PT_ENTRIES-1];
+  logic [TLB_SPAN_PORT_WIDTH-1:0] tlb_span [0:PT_ENTRIES-1];
+  logic [ASID_PORT_WIDTH-1:0] tlb_asid [0:PT_ENTRIES-1];
   logic [$clog2(PT_ENTRIES)-1:0] tlb_write_ptr;
+  // Next way to load in each set (set-associative only)
+  logic [TLB_WAY_BITS-1:0] tlb_way_ptr [0:TLB_SETS-1];
+  logic [ASID_PORT_WIDTH-1:0] asid_q;
 
   // Signals for pipelined read/write
   logic [PHYS_ADDR_WIDTH-1:0] translated_read_addr;
@@ -75,6 +114,11 @@ module memory
   logic [3:0] read_translate_status;
   logic [3:0] write_translate_status;
 
+  // Set that an entry of the given span covering addr must live in
+  function automatic int tlb_set_of(input logic [VIRT_ADDR_WIDTH-1:0] addr, input int span);
+    return (TLB_SETS > 1) ? int'((addr >> (PAGE_OFFSET_WIDTH + span)) % TLB_SETS) : 0;
+  endfunction
+
   // Initialize memory and TLB
   initial begin
     integer i;
@@ -85,29 +129,60 @@ module memory
       tlb_valid[i] = 1'b0;
       tlb_phys[i] = {PHYS_ADDR_WIDTH{1'b0}};
       tlb_virt[i] = {VIRT_ADDR_WIDTH{1'b0}};
+      tlb_span[i] = {TLB_SPAN_PORT_WIDTH{1'b0}};
+      tlb_asid[i] = {ASID_PORT_WIDTH{1'b0}};
     end
     tlb_write_ptr = {($clog2(PT_ENTRIES)){1'b0}};
+    for (i = 0; i < TLB_SETS; i++) begin
+      tlb_way_ptr[i] = {TLB_WAY_BITS{1'b0}};
+    end
+    asid_q = {ASID_PORT_WIDTH{1'b0}};
   end
 
   // Virtual-to-Physical address translation for read
+  // Among entries of the current ASID, the matching entry with the smallest
+  // span wins (longest prefix), then the lowest index; with single-page
+  // entries this is the first match. A set-associative TLB only compares
+  // the ways of the set each span value selects.
   always_comb begin
     integer i;
-    logic [VIRT_PAGE_BITS-1:0] virt_page;
-    logic [PAGE_OFFSET_WIDTH-1:0] page_offset;
+    integer s;
+    integer w;
+    logic [VIRT_ADDR_WIDTH-1:0] virt_mask;
+    logic [PHYS_ADDR_WIDTH-1:0] phys_mask;
+    logic [TLB_SPAN_PORT_WIDTH-1:0] best_span;
     logic found;
 
-    virt_page = read_req_addr[VIRT_ADDR_WIDTH-1:PAGE_OFFSET_WIDTH];
-    page_offset = read_req_addr[PAGE_OFFSET_WIDTH-1:0];
-
     found = 1'b0;
+    best_span = {TLB_SPAN_PORT_WIDTH{1'b0}};
     translated_read_addr = {PHYS_ADDR_WIDTH{1'b0}};
     read_translate_status = MEM_OK;
 
-    for (i = 0; i < PT_ENTRIES; i++) begin
-      if (!found && tlb_valid[i] && 
-          tlb_virt[i][VIRT_ADDR_WIDTH-1:PAGE_OFFSET_WIDTH] == virt_page) begin
-        found = 1'b1;
-        translated_read_addr = {tlb_phys[i][PHYS_ADDR_WIDTH-1:PAGE_OFFSET_WIDTH], page_offset};
+    if (TLB_SET_ASSOC) begin
+      for (s = 0; s < TLB_SPAN_VALUES; s++) begin
+        virt_mask = {VIRT_ADDR_WIDTH{1'b1}} << (PAGE_OFFSET_WIDTH + s);
+        phys_mask = {PHYS_ADDR_WIDTH{1'b1}} << (PAGE_OFFSET_WIDTH + s);
+        for (w = 0; w < TLB_WAY_COUNT; w++) begin
+          i = tlb_set_of(read_req_addr, s) * TLB_WAY_COUNT + w;
+          if (!found && tlb_valid[i] && int'(tlb_span[i]) == s && tlb_asid[i] == asid_q &&
+              ((tlb_virt[i] ^ read_req_addr) & virt_mask) == '0) begin
+            found = 1'b1;
+            translated_read_addr = (tlb_phys[i] & phys_mask) |
+                                     (PHYS_ADDR_WIDTH'(read_req_addr) & ~phys_mask);
+          end
+        end
+      end
+    end else begin
+      for (i = 0; i < PT_ENTRIES; i++) begin
+        virt_mask = {VIRT_ADDR_WIDTH{1'b1}} << (PAGE_OFFSET_WIDTH + tlb_span[i]);
+        phys_mask = {PHYS_ADDR_WIDTH{1'b1}} << (PAGE_OFFSET_WIDTH + tlb_span[i]);
+        if (tlb_valid[i] && tlb_asid[i] == asid_q && ((tlb_virt[i] ^ read_req_addr) & virt_mask) == '0 &&
+            (!found || tlb_span[i] < best_span)) begin
+          found = 1'b1;
+          best_span = tlb_span[i];
+          translated_read_addr = (tlb_phys[i] & phys_mask) |
+                                   (PHYS_ADDR_WIDTH'(read_req_addr) & ~phys_mask);
+        end
       end
     end
 
@@ -118,24 +193,49 @@ module memory
   end
 
   // Virtual-to-Physical address translation for write
+  // Among entries of the current ASID, the matching entry with the smallest
+  // span wins (longest prefix), then the lowest index; with single-page
+  // entries this is the first match. A set-associative TLB only compares
+  // the ways of the set each span value selects.
   always_comb begin
     integer i;
-    logic [VIRT_PAGE_BITS-1:0] virt_page;
-    logic [PAGE_OFFSET_WIDTH-1:0] page_offset;
+    integer s;
+    integer w;
+    logic [VIRT_ADDR_WIDTH-1:0] virt_mask;
+    logic [PHYS_ADDR_WIDTH-1:0] phys_mask;
+    logic [TLB_SPAN_PORT_WIDTH-1:0] best_span;
     logic found;
 
-    virt_page = write_req_addr[VIRT_ADDR_WIDTH-1:PAGE_OFFSET_WIDTH];
-    page_offset = write_req_addr[PAGE_OFFSET_WIDTH-1:0];
-
     found = 1'b0;
+    best_span = {TLB_SPAN_PORT_WIDTH{1'b0}};
     translated_write_addr = {PHYS_ADDR_WIDTH{1'b0}};
     write_translate_status = MEM_OK;
 
-    for (i = 0; i < PT_ENTRIES; i++) begin
-      if (!found && tlb_valid[i] && 
-          tlb_virt[i][VIRT_ADDR_WIDTH-1:PAGE_OFFSET_WIDTH] == virt_page) begin
-        found = 1'b1;
-        translated_write_addr = {tlb_phys[i][PHYS_ADDR_WIDTH-1:PAGE_OFFSET_WIDTH], page_offset};
+    if (TLB_SET_ASSOC) begin
+      for (s = 0; s < TLB_SPAN_VALUES; s++) begin
+        virt_mask = {VIRT_ADDR_WIDTH{1'b1}} << (PAGE_OFFSET_WIDTH + s);
+        phys_mask = {PHYS_ADDR_WIDTH{1'b1}} << (PAGE_OFFSET_WIDTH + s);
+        for (w = 0; w < TLB_WAY_COUNT; w++) begin
+          i = tlb_set_of(write_req_addr, s) * TLB_WAY_COUNT + w;
+          if (!found && tlb_valid[i] && int'(tlb_span[i]) == s && tlb_asid[i] == asid_q &&
+              ((tlb_virt[i] ^ write_req_addr) & virt_mask) == '0) begin
+            found = 1'b1;
+            translated_write_addr = (tlb_phys[i] & phys_mask) |
+                                     (PHYS_ADDR_WIDTH'(write_req_addr) & ~phys_mask);
+          end
+        end
+      end
+    end else begin
+      for (i = 0; i < PT_ENTRIES; i++) begin
+        virt_mask = {VIRT_ADDR_WIDTH{1'b1}} << (PAGE_OFFSET_WIDTH + tlb_span[i]);
+        phys_mask = {PHYS_ADDR_WIDTH{1'b1}} << (PAGE_OFFSET_WIDTH + tlb_span[i]);
+        if (tlb_valid[i] && tlb_asid[i] == asid_q && ((tlb_virt[i] ^ write_req_addr) & virt_mask) == '0 &&
+            (!found || tlb_span[i] < best_span)) begin
+          found = 1'b1;
+          best_span = tlb_span[i];
+          translated_write_addr = (tlb_phys[i] & phys_mask) |
+                                   (PHYS_ADDR_WIDTH'(write_req_addr) & ~phys_mask);
+        end
       end
     end
 
@@ -191,17 +291,61 @@ module memory
     end
   end
 
-  // TLB load handler
+  // Span a load installs and the slot it goes to. A set-associative TLB
+  // places it at its set's way pointer; otherwise at the write pointer.
+  logic [TLB_SPAN_PORT_WIDTH-1:0] tlb_load_span_eff;
+  int tlb_load_set;
+  int tlb_load_slot;
+
+  assign tlb_load_span_eff = (TLB_SPAN_WIDTH > 0) ? tlb_load_span : {TLB_SPAN_PORT_WIDTH{1'b0}};
+  assign tlb_load_set = tlb_set_of(tlb_load_virt_base, int'(tlb_load_span_eff));
+  assign tlb_load_slot = TLB_SET_ASSOC ? tlb_load_set * TLB_WAY_COUNT + int'(tlb_way_ptr[tlb_load_set])
+                                       : int'(tlb_write_ptr);
+
+  // TLB load and flush handler. A flush takes the cycle; loads wait for
+  // tlb_load_ready. A global flush clears every address space and rewinds
+  // the write pointer and every set's way pointer; a selective flush only
+  // touches the current ASID. In a set-associative TLB the write pointer
+  // shows the next slot of the most recently loaded set.
   always @(posedge clk or negedge rst_n) begin
+    integer i;
     if (!rst_n) begin
       tlb_write_ptr <= {($clog2(PT_ENTRIES)){1'b0}};
+      for (i = 0; i < TLB_SETS; i++) begin
+        tlb_way_ptr[i] <= {TLB_WAY_BITS{1'b0}};
+      end
     end else begin
-      if (tlb_load_valid && tlb_load_ready) begin
-        tlb_valid[tlb_write_ptr] <= 1'b1;
-        tlb_virt[tlb_write_ptr] <= tlb_load_virt_base;
-        tlb_phys[tlb_write_ptr] <= tlb_load_phys_base;
+      if (tlb_flush_valid && tlb_flush_ready) begin
+        for (i = 0; i < PT_ENTRIES; i++) begin
+          if (tlb_flush_all ||
+              (tlb_asid[i] == asid_q &&
+               ((tlb_virt[i] ^ tlb_flush_addr) &
+                ({VIRT_ADDR_WIDTH{1'b1}} << (PAGE_OFFSET_WIDTH + tlb_span[i]))) == '0)) begin
+            tlb_valid[i] <= 1'b0;
+          end
+        end
+        if (tlb_flush_all) begin
+          tlb_write_ptr <= {($clog2(PT_ENTRIES)){1'b0}};
+          for (i = 0; i < TLB_SETS; i++) begin
+            tlb_way_ptr[i] <= {TLB_WAY_BITS{1'b0}};
+          end
+        end
+      end else if (tlb_load_valid && tlb_load_ready) begin
+        tlb_valid[tlb_load_slot] <= 1'b1;
+        tlb_virt[tlb_load_slot] <= tlb_load_virt_base;
+        tlb_phys[tlb_load_slot] <= tlb_load_phys_base;
+        tlb_span[tlb_load_slot] <= tlb_load_span_eff;
+        tlb_asid[tlb_load_slot] <= asid_q;
         
-        if (tlb_write_ptr < ($clog2(PT_ENTRIES)'(PT_ENTRIES - 1))) begin
+        if (TLB_SET_ASSOC) begin
+          if (int'(tlb_way_ptr[tlb_load_set]) < TLB_WAY_COUNT - 1) begin
+            tlb_way_ptr[tlb_load_set] <= tlb_way_ptr[tlb_load_set] + 1'b1;
+            tlb_write_ptr <= $clog2(PT_ENTRIES)'(tlb_load_slot + 1);
+          end else begin
+            tlb_way_ptr[tlb_load_set] <= {TLB_WAY_BITS{1'b0}};
+            tlb_write_ptr <= $clog2(PT_ENTRIES)'(tlb_load_set * TLB_WAY_COUNT);
+          end
+        end else if (tlb_write_ptr < ($clog2(PT_ENTRIES)'(PT_ENTRIES - 1))) begin
           tlb_write_ptr <= tlb_write_ptr + 1;
         end else begin
           tlb_write_ptr <= {($clog2(PT_ENTRIES)){1'b0}};
@@ -210,13 +354,26 @@ module memory
     end
   end
 
+  // Current ASID. A load in the same cycle as a switch is tagged with the
+  // old ASID; a switch flushes nothing.
+  always @(posedge clk or negedge rst_n) begin
+    if (!rst_n) begin
+      asid_q <= {ASID_PORT_WIDTH{1'b0}};
+    end else if (asid_set_valid && asid_set_ready && ASID_WIDTH > 0) begin
+      asid_q <= asid_set_value;
+    end
+  end
+
   // Ready signals (combinatorial - module is always ready)
   assign read_req_ready = 1'b1;
   assign write_req_ready = 1'b1;
-  assign tlb_load_ready = 1'b1;
+  assign tlb_load_ready = !tlb_flush_valid;
+  assign tlb_flush_ready = 1'b1;
+  assign asid_set_ready = 1'b1;
 
   // Status output
   assign tlb_num_entries = tlb_write_ptr;
+  assign current_asid = asid_q;
 
 endmodule
 
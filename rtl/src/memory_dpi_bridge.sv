@@ -47,7 +47,17 @@ export "DPI-C" function sv_memory_dpi_reset;
 export "DPI-C" function sv_memory_dpi_finalize;
 export "DPI-C" function sv_memory_dpi_read;
 export "DPI-C" function sv_memory_dpi_write;
+export "DPI-C" function sv_memory_dpi_read_wide;
+export "DPI-C" function sv_memory_dpi_write_wide;
 export "DPI-C" function sv_memory_dpi_tlb_load;
+export "DPI-C" function sv_memory_dpi_tlb_load_range;
+export "DPI-C" function sv_memory_dpi_tlb_flush;
+export "DPI-C" function sv_memory_dpi_tlb_read_entry;
+export "DPI-C" function sv_memory_dpi_tlb_check_entry;
+export "DPI-C" function sv_memory_dpi_tlb_write_entry;
+export "DPI-C" function sv_memory_dpi_tlb_set_write_index;
+export "DPI-C" function sv_memory_dpi_set_asid;
+export "DPI-C" function sv_memory_dpi_get_asid;
 export "DPI-C" function sv_memory_dpi_get_response;
 export "DPI-C" function sv_memory_dpi_get_tlb_entries;
 export "DPI-C" function sv_memory_dpi_is_ready;
@@ -61,7 +71,11 @@ module memory_dpi_bridge #(
     parameter MEM_DEPTH = 16384,
     parameter PAGE_SIZE = 4096,
     parameter DATA_WIDTH = 64,
-    parameter PT_ENTRIES = 256
+    parameter PT_ENTRIES = 256,
+    parameter TLB_SPAN_WIDTH = 5,
+    parameter ASID_WIDTH = 16,
+    // 0 keeps the TLB fully associative; see memory.sv
+    parameter int TLB_WAYS = 0
 ) (
     input logic clk,
     input logic rst_n,
@@ -77,7 +91,10 @@ module memory_dpi_bridge #(
         .MEM_DEPTH(MEM_DEPTH),
         .PAGE_SIZE(PAGE_SIZE),
         .DATA_WIDTH(DATA_WIDTH),
-        .PT_ENTRIES(PT_ENTRIES)
+        .PT_ENTRIES(PT_ENTRIES),
+        .TLB_SPAN_WIDTH(TLB_SPAN_WIDTH),
+        .ASID_WIDTH(ASID_WIDTH),
+        .TLB_WAYS(TLB_WAYS)
     ) dut (
         .clk(clk),
         .rst_n(rst_n),
@@ -106,12 +123,30 @@ module memory_dpi_bridge #(
         .tlb_load_valid(dpi_tlb_load_valid),
         .tlb_load_virt_base(dpi_tlb_load_virt_base),
         .tlb_load_phys_base(dpi_tlb_load_phys_base),
+        .tlb_load_span(dpi_tlb_load_span),
         .tlb_load_ready(dpi_tlb_load_ready),
+        .tlb_flush_valid(dpi_tlb_flush_valid),
+        .tlb_flush_all(dpi_tlb_flush_all),
+        .tlb_flush_addr(dpi_tlb_flush_addr),
+        .tlb_flush_ready(dpi_tlb_flush_ready),
+        .asid_set_valid(dpi_asid_set_valid),
+        .asid_set_value(dpi_asid_set_value),
+        .asid_set_ready(dpi_asid_set_ready),
         
         // Control/Status
-        .tlb_num_entries(dpi_tlb_num_entries)
+        .tlb_num_entries(dpi_tlb_num_entries),
+        .current_asid(dpi_current_asid)
     );
 
+    localparam int PAGE_OFFSET_WIDTH = $clog2(PAGE_SIZE);
+    localparam int TLB_SPAN_PORT_WIDTH = (TLB_SPAN_WIDTH > 0) ? TLB_SPAN_WIDTH : 1;
+    localparam int ASID_PORT_WIDTH = (ASID_WIDTH > 0) ? ASID_WIDTH : 1;
+    // Same set geometry as the DUT's
+    localparam bit TLB_SET_ASSOC = (TLB_WAYS > 0) && (TLB_WAYS < PT_ENTRIES);
+    localparam int TLB_WAY_COUNT = TLB_SET_ASSOC ? TLB_WAYS : PT_ENTRIES;
+    localparam int TLB_SETS = PT_ENTRIES / TLB_WAY_COUNT;
+    localparam int TLB_WAY_BITS = (TLB_WAY_COUNT > 1) ? $clog2(TLB_WAY_COUNT) : 1;
+
     // DPI control signals
     logic dpi_trace_enabled = 0;
     assign trace_enabled = dpi_trace_enabled;
@@ -138,8 +173,17 @@ module memory_dpi_bridge #(
     logic dpi_tlb_load_valid = 0;
     logic [VIRT_ADDR_WIDTH-1:0] dpi_tlb_load_virt_base;
     logic [PHYS_ADDR_WIDTH-1:0] dpi_tlb_load_phys_base;
+    logic [TLB_SPAN_PORT_WIDTH-1:0] dpi_tlb_load_span = '0;
     logic dpi_tlb_load_ready;
+    logic dpi_tlb_flush_valid = 0;
+    logic dpi_tlb_flush_all = 0;
+    logic [VIRT_ADDR_WIDTH-1:0] dpi_tlb_flush_addr = '0;
+    logic dpi_tlb_flush_ready;
+    logic dpi_asid_set_valid = 0;
+    logic [ASID_PORT_WIDTH-1:0] dpi_asid_set_value = '0;
+    logic dpi_asid_set_ready;
     logic [$clog2(PT_ENTRIES)-1:0] dpi_tlb_num_entries;
+    logic [ASID_PORT_WIDTH-1:0] dpi_current_asid;
 
     // DPI timestamp counter
     logic [31:0] dpi_timestamp = 0;
@@ -231,6 +275,70 @@ module memory_dpi_bridge #(
         return dpi_write_resp_status;
     endfunction
 
+    // Wide-word variants for DATA_WIDTH up to 512. The 2-state vectors map to
+    // svBitVecVal arrays on the C side.
+    function int sv_memory_dpi_read_wide(
+        input bit [63:0] virt_addr,
+        input bit [63:0] byte_mask,
+        output bit [511:0] data,
+        output bit [31:0] timestamp
+    );
+        logic [VIRT_ADDR_WIDTH-1:0] addr;
+        logic [(DATA_WIDTH/8)-1:0] mask;
+        
+        addr = virt_addr[VIRT_ADDR_WIDTH-1:0];
+        mask = byte_mask[(DATA_WIDTH/8)-1:0];
+        
+        if (dpi_trace_enabled) begin
+            $display("[Memory DPI] READ_WIDE: addr=0x%h mask=0x%h @%0t", addr, mask, $time);
+        end
+        
+        dpi_read_req_valid <= 1;
+        dpi_read_req_addr <= addr;
+        dpi_read_req_mask <= mask;
+        
+        #10;
+        
+        dpi_read_req_valid <= 0;
+        data = '0;
+        data[DATA_WIDTH-1:0] = dpi_read_resp_data;
+        timestamp = dpi_timestamp;
+        
+        return dpi_read_resp_status;
+    endfunction
+
+    function int sv_memory_dpi_write_wide(
+        input bit [63:0] virt_addr,
+        input bit [63:0] byte_mask,
+        input bit [511:0] data,
+        output bit [31:0] timestamp
+    );
+        logic [VIRT_ADDR_WIDTH-1:0] addr;
+        logic [(DATA_WIDTH/8)-1:0] mask;
+        logic [DATA_WIDTH-1:0] wdata;
+        
+        addr = virt_addr[VIRT_ADDR_WIDTH-1:0];
+        mask = byte_mask[(DATA_WIDTH/8)-1:0];
+        wdata = data[DATA_WIDTH-1:0];
+        
+        if (dpi_trace_enabled) begin
+            $display("[Memory DPI] WRITE_WIDE: addr=0x%h mask=0x%h data=0x%h @%0t",
+                     addr, mask, wdata, $time);
+        end
+        
+        dpi_write_req_valid <= 1;
+        dpi_write_req_addr <= addr;
+        dpi_write_req_mask <= mask;
+        dpi_write_req_data <= wdata;
+        
+        #10;
+        
+        dpi_write_req_valid <= 0;
+        timestamp = dpi_timestamp;
+        
+        return dpi_write_resp_status;
+    endfunction
+
     function int sv_memory_dpi_tlb_load(
         input logic [63:0] virt_base,
         input logic [63:0] phys_base,
@@ -250,6 +358,7 @@ module memory_dpi_bridge #(
         dpi_tlb_load_valid <= 1;
         dpi_tlb_load_virt_base <= vbase;
         dpi_tlb_load_phys_base <= pbase;
+        dpi_tlb_load_span <= '0;
         
         // Wait for response (simplified for DPI)
         #10;
@@ -260,6 +369,181 @@ module memory_dpi_bridge #(
         return 0; // Success status
     endfunction
 
+    // span_bits is log2 of the mapped span in address units, as in
+    // memory_model_load_tlb_range(); the RTL stores it relative to the page.
+    function int sv_memory_dpi_tlb_load_range(
+        input logic [63:0] virt_base,
+        input logic [63:0] phys_base,
+        input int span_bits,
+        output logic [31:0] timestamp
+    );
+        logic [VIRT_ADDR_WIDTH-1:0] vbase;
+        logic [PHYS_ADDR_WIDTH-1:0] pbase;
+        int span;
+        
+        timestamp = dpi_timestamp;
+        span = span_bits - PAGE_OFFSET_WIDTH;
+        if (span < 0 || span >= (1 << TLB_SPAN_WIDTH) ||
+            span_bits > VIRT_ADDR_WIDTH || span_bits > PHYS_ADDR_WIDTH) begin
+            return 2; // Access error: span not supported by this configuration
+        end
+        
+        vbase = virt_base[VIRT_ADDR_WIDTH-1:0];
+        pbase = phys_base[PHYS_ADDR_WIDTH-1:0];
+        
+        if (dpi_trace_enabled) begin
+            $display("[Memory DPI] TLB_LOAD_RANGE: virt=0x%h phys=0x%h span=%0d @%0t",
+                     vbase, pbase, span_bits, $time);
+        end
+        
+        dpi_tlb_load_valid <= 1;
+        dpi_tlb_load_virt_base <= vbase;
+        dpi_tlb_load_phys_base <= pbase;
+        dpi_tlb_load_span <= TLB_SPAN_PORT_WIDTH'(span);
+        
+        #10;
+        
+        dpi_tlb_load_valid <= 0;
+        timestamp = dpi_timestamp;
+        
+        return 0;
+    endfunction
+
+    // MEM_FLUSH: every entry of every ASID when all is non-zero, else the
+    // current ASID's entries that translate virt_addr (plain pages and
+    // covering ranges alike)
+    function int sv_memory_dpi_tlb_flush(
+        input int all,
+        input logic [63:0] virt_addr,
+        output logic [31:0] timestamp
+    );
+        if (dpi_trace_enabled) begin
+            $display("[Memory DPI] TLB_FLUSH: all=%0d addr=0x%h @%0t", all, virt_addr, $time);
+        end
+        
+        dpi_tlb_flush_valid <= 1;
+        dpi_tlb_flush_all <= (all != 0);
+        dpi_tlb_flush_addr <= virt_addr[VIRT_ADDR_WIDTH-1:0];
+        
+        #10;
+        
+        dpi_tlb_flush_valid <= 0;
+        timestamp = dpi_timestamp;
+        
+        return 0;
+    endfunction
+
+    // MEM_SET_ASID: later loads are tagged with asid and lookups only match
+    // its entries. Nothing is flushed.
+    function int sv_memory_dpi_set_asid(
+        input int asid,
+        output logic [31:0] timestamp
+    );
+        timestamp = dpi_timestamp;
+        if (asid < 0 || asid >= (1 << ASID_WIDTH)) begin
+            return 2; // Access error: ASID wider than ASID_WIDTH
+        end
+        
+        if (dpi_trace_enabled) begin
+            $display("[Memory DPI] SET_ASID: asid=%0d @%0t", asid, $time);
+        end
+        
+        dpi_asid_set_valid <= 1;
+        dpi_asid_set_value <= ASID_PORT_WIDTH'(asid);
+        
+        #10;
+        
+        dpi_asid_set_valid <= 0;
+        timestamp = dpi_timestamp;
+        
+        return 0;
+    endfunction
+
+    function int sv_memory_dpi_get_asid();
+        return (ASID_WIDTH > 0) ? int'(dpi_current_asid) : 0;
+    endfunction
+
+    // Bulk TLB import/export. These access the TLB arrays directly, take no
+    // simulation time and are meant for checkpointing between tests.
+    function int sv_memory_dpi_tlb_read_entry(
+        input int slot,
+        output int valid,
+        output logic [63:0] virt_base,
+        output logic [63:0] phys_base,
+        output int span_bits,
+        output int asid
+    );
+        if (slot < 0 || slot >= PT_ENTRIES) begin
+            return 2;
+        end
+        valid = dut.tlb_valid[slot];
+        virt_base = 64'(dut.tlb_virt[slot]);
+        phys_base = 64'(dut.tlb_phys[slot]);
+        span_bits = PAGE_OFFSET_WIDTH + int'(dut.tlb_span[slot]);
+        asid = (ASID_WIDTH > 0) ? int'(dut.tlb_asid[slot]) : 0;
+        return 0;
+    endfunction
+
+    // span_bits < 0 checks only the slot; 0 means a single page
+    function int sv_memory_dpi_tlb_check_entry(input int slot, input int span_bits, input int asid);
+        int span;
+        
+        if (slot < 0 || slot >= PT_ENTRIES) begin
+            return 2;
+        end
+        if (span_bits < 0) begin
+            return 0;
+        end
+        if (asid < 0 || asid >= (1 << ASID_WIDTH)) begin
+            return 2;
+        end
+        if (span_bits == 0) begin
+            return 0;
+        end
+        span = span_bits - PAGE_OFFSET_WIDTH;
+        if (span < 0 || span >= (1 << TLB_SPAN_WIDTH) ||
+            span_bits > VIRT_ADDR_WIDTH || span_bits > PHYS_ADDR_WIDTH) begin
+            return 2;
+        end
+        return 0;
+    endfunction
+
+    function int sv_memory_dpi_tlb_write_entry(
+        input int slot,
+        input int valid,
+        input logic [63:0] virt_base,
+        input logic [63:0] phys_base,
+        input int span_bits,
+        input int asid
+    );
+        if (sv_memory_dpi_tlb_check_entry(slot, (valid != 0) ? span_bits : -1, asid) != 0) begin
+            return 2;
+        end
+        dut.tlb_valid[slot] = (valid != 0);
+        dut.tlb_virt[slot] = virt_base[VIRT_ADDR_WIDTH-1:0];
+        dut.tlb_phys[slot] = phys_base[PHYS_ADDR_WIDTH-1:0];
+        dut.tlb_span[slot] = (valid != 0 && span_bits > 0) ?
+                             TLB_SPAN_PORT_WIDTH'(span_bits - PAGE_OFFSET_WIDTH) : '0;
+        dut.tlb_asid[slot] = (valid != 0) ? ASID_PORT_WIDTH'(asid) : '0;
+        return 0;
+    endfunction
+
+    function int sv_memory_dpi_tlb_set_write_index(input int index);
+        if (index < 0 || index >= PT_ENTRIES) begin
+            return 2;
+        end
+        dut.tlb_write_ptr = index;
+        // As memory_model_import_tlb(): the set holding index resumes at its
+        // way, and every other set restarts at way 0
+        if (TLB_SET_ASSOC) begin
+            for (int s = 0; s < TLB_SETS; s++) begin
+                dut.tlb_way_ptr[s] = '0;
+            end
+            dut.tlb_way_ptr[index / TLB_WAY_COUNT] = TLB_WAY_BITS'(index % TLB_WAY_COUNT);
+        end
+        return 0;
+    endfunction
+
     function int sv_memory_dpi_get_response(
         input int ctx_id,
         output int status,
@@ -289,6 +573,7 @@ module memory_dpi_bridge #(
     function void sv_memory_dpi_dump_state();
         $display("[Memory DPI] State Dump:");
         $display("  TLB Entries: %0d", dpi_tlb_num_entries);
+        $display("  Current ASID: %0d", sv_memory_dpi_get_asid());
         $display("  Timestamp: %0d", dpi_timestamp);
         $display("  Trace Enabled: %0d", dpi_trace_enabled);
     endfunction
@@ -80,8 +80,17 @@ module memory_tb;
     .tlb_load_valid(tlb_load_valid),
     .tlb_load_virt_base(tlb_load_virt_base),
     .tlb_load_phys_base(tlb_load_phys_base),
+    .tlb_load_span('0),
+    .tlb_flush_valid(1'b0),
+    .tlb_flush_all(1'b0),
+    .tlb_flush_addr('0),
+    .tlb_flush_ready(),
+    .asid_set_valid(1'b0),
+    .asid_set_value('0),
+    .asid_set_ready(),
     .tlb_load_ready(tlb_load_ready),
-    .tlb_num_entries(tlb_num_entries)
+    .tlb_num_entries(tlb_num_entries),
+    .current_asid()
   );
 
   // Clock generation